@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_RECORDINGBENCHMARK_H
+#define TRACERAYER_RECORDINGBENCHMARK_H
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Instances recorded every frame, each with its own constants and a fill of its slot.
+#define RECORDING_BENCHMARK_ITEMS 50000
+#define RECORDING_BENCHMARK_SLOTS 1024
+#define RECORDING_BENCHMARK_FRAMES 16
+#define RECORDING_BENCHMARK_WARMUP 2                // Frames that grow the pools, left out of the timings
+
+/**
+ * Records the same frame of instances into secondary command buffers with 1, 2, 4 and
+ * so on up to one thread per processor, then writes the median recording time of every
+ * thread count and its speedup over one thread to outputPath as JSON. The last frame of
+ * every thread count is executed on the graphics queue, so a driver rejecting the
+ * buffers fails the benchmark.
+ */
+TR_STATUS RunRecordingBenchmark( IN TRCString outputPath );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
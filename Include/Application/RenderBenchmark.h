@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_RENDERBENCHMARK_H
+#define TRACERAYER_RENDERBENCHMARK_H
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame size and quality of every benchmark render.
+#define RENDER_BENCHMARK_SIZE 256
+#define RENDER_BENCHMARK_SAMPLES 64
+#define RENDER_BENCHMARK_DEPTH 8
+
+// The compute tracer may stray this much further from the reference than two reference renders do from each other.
+#define RENDER_BENCHMARK_TOLERANCE 1.5
+
+/**
+ * Renders the Cornell box with the compute tracer and the CPU reference, then writes
+ * their timings and errors to outputPath as JSON. The GPU image is compared against
+ * a reference render of another seed, and passes when its error stays within the
+ * noise two reference renders show against each other.
+ */
+TR_STATUS RunRenderBenchmark( IN TRCString outputPath );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
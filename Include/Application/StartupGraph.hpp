@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_STARTUPGRAPH_HPP
+#define TRACERAYER_STARTUPGRAPH_HPP
+
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Object.h>
+#include <Types.h>
+
+namespace TR::Application
+{
+    enum class StartupThread
+    {
+        Main,       // The GTK main context, for anything that touches widgets
+        Worker      // The async thread pool, for anything that only blocks
+    };
+
+    /**
+     * Startup work as a dependency graph instead of one straight line. A phase is
+     * queued as soon as every phase it runs after has finished, so independent
+     * phases overlap and the main thread only runs what has to be there. Marks
+     * record points in time that are not phases of their own, like the first frame.
+     *
+     * The graph has finished once every phase ran and every expected mark was
+     * reached. With --startup-profile each phase's wall time is logged then, and
+     * marks reached later are logged as they come in. Phases also show up as zones
+     * in the --trace-out trace, and as startup marks for --benchmark-startup.
+     */
+    class StartupGraph : public std::enable_shared_from_this<StartupGraph>
+    {
+    public:
+        using Phase = std::function<void()>;
+
+        // Queued phases keep the graph alive, the caller can drop it after Run().
+        static std::shared_ptr<StartupGraph> Create();
+
+        /**
+         * Adds a phase running after the named ones, which have to be added first. Names
+         * are kept by pointer, so they have to be string literals. A phase that throws
+         * skips everything depending on it.
+         */
+        StartupGraph &Add( TRCString name, StartupThread thread, std::initializer_list<TRCString> after, Phase phase );
+
+        // Thread safe, and fine to call before or after the phases have finished.
+        void Mark( TRCString name );
+
+        // Holds the graph's completion back until name is marked. Must be called before Run().
+        StartupGraph &Expect( TRCString name );
+
+        // Runs on the main context once the graph has finished. Must be called before Run().
+        StartupGraph &OnFinished( std::function<void()> finished );
+
+        void Run();
+
+    private:
+        struct Node
+        {
+            TRCString name;
+            StartupThread thread;
+            Phase phase;
+            std::vector<TRSize> dependents;
+            std::atomic<TRSize> waiting;    // Phases this one still runs after
+            std::atomic<TRBool> skipped;    // Something it runs after failed or was skipped
+            TRBool failed;
+            TRULong start;
+            TRULong end;
+        };
+
+        struct Milestone
+        {
+            TRCString name;
+            TRULong at;
+        };
+
+        StartupGraph() = default;
+
+        void Dispatch( TRSize index );
+        void Execute( TRSize index );
+        void Finish( TRSize index );
+        void Complete();
+        void Report();
+
+        static TR_STATUS RunWorkerPhase( _UnknownObject *invoker, void *param, PropVariant *result );
+        static TRInt RunMainPhase( void *param );
+        static TRInt RunFinished( void *param );
+
+        std::vector<std::unique_ptr<Node>> nodes_;
+        std::atomic<TRSize> remaining_ = 0;    // Phases yet to run and marks yet to be reached
+        TRULong origin_ = 0;
+        std::vector<std::function<void()>> finished_;
+
+        std::mutex marksLock_;
+        std::vector<Milestone> marks_;
+        std::vector<TRCString> expected_;
+        TRBool reported_ = false;
+    };
+}
+
+#endif
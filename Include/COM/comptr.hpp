@@ -66,4 +66,46 @@ protected:
     T* detach() { T* t = ptr_; ptr_ = nullptr; return t; }
 };
 
+struct _UnknownObject;
+
+/**
+ * A non-owning view of a COM object through its wrapper, which never touches
+ * the reference count. It is only valid while an owning reference is held
+ * elsewhere, so it can not be taken from a temporary. Take() upgrades it to
+ * an owning reference.
+ */
+template<typename Wrapper>
+class ComRef
+{
+public:
+    template<typename P>
+    explicit ComRef( P* p ) : wrapper_( reinterpret_cast<_UnknownObject*>( p ) ) {}
+
+    ComRef( const Wrapper& owner ) : ComRef( owner.get() ) {}
+    ComRef( Wrapper&& ) = delete;
+
+    ComRef( const ComRef& other ) : ComRef( other.get() ) {}
+    ComRef& operator = ( const ComRef& ) = delete;
+
+    // wrapper_ is never destroyed, so the borrowed pointer is never released.
+    ~ComRef() {}
+
+    const Wrapper& operator * () const { return wrapper_; }
+    const Wrapper* operator -> () const { return &wrapper_; }
+    operator const Wrapper& () const { return wrapper_; }
+
+    auto get() const { return wrapper_.get(); }
+
+    [[nodiscard]]
+    Wrapper Take() const
+    {
+        auto p = get();
+        p->lpVtbl->AddRef( p );
+        return Wrapper( reinterpret_cast<_UnknownObject*>( p ) );
+    }
+
+private:
+    union { Wrapper wrapper_; };
+};
+
 #endif
\ No newline at end of file
@@ -74,6 +74,8 @@ TR_STATUS TR_API new_async_info_object_override_callback_and_outer( IN UnknownOb
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( AsyncInfoObject, AsyncStateObject, async_info_object, AsyncStateObject_impl )
+
 namespace TR
 {
     namespace Core::Async
@@ -95,6 +95,8 @@ TR_STATUS TR_API new_async_operation_object_override_callback( IN UnknownObject
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( AsyncOperationObject, AsyncInfoObject, async_operation_object, AsyncInfoObject_impl )
+
 namespace TR
 {
     namespace Core::Async
@@ -118,11 +120,11 @@ namespace TR
             static constexpr const TRUUID &classId = IID_AsyncOperationObject;
 
             template<typename From>
-            explicit AsyncOperationObject( From invoker, void *param, AsyncOperationCallbackSafe<From> callback )
+            explicit AsyncOperationObject( const From &invoker, void *param, AsyncOperationCallbackSafe<From> callback )
             {
                 // Deleted in AsyncOperationCallbackHandler.
                 AsyncOperationCallbackSafeObj<From>* callbackObj = new AsyncOperationCallbackSafeObj<From>{ callback, param };
-                check_tr_( new_async_operation_object_override_callback( reinterpret_cast<_UnknownObject *>( invoker->get() ), callbackObj, AsyncOperationCallbackHandler, put() ) );
+                check_tr_( new_async_operation_object_override_callback( reinterpret_cast<_UnknownObject *>( invoker.get() ), callbackObj, AsyncOperationCallbackHandler<From>, put() ) );
             }
 
             // Implements an AsyncInfoObject
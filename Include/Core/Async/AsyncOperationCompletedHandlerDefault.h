@@ -70,7 +70,7 @@ namespace TR
 
             try
             {
-                safeCallback->callback( AsyncOperationObject( invoker ), safeCallback->param, status );
+                safeCallback->callback( *ComRef<AsyncOperationObject>( invoker ), safeCallback->param, status );
             } catch ( const TRException &e )
             {
                 return e.status;
@@ -98,12 +98,12 @@ struct async_state_object
 
     // --- Private Members --- //
     async_operation_callback callback;
-    GThreadPool *pool;
     UnknownObject *invoker;
     UnknownObject *outer;
     void *param;
     pthread_mutex_t lock;
     PropVariant *result;
+    TRULong flowId;
     ATOMIC(TRLong) ref;
 };
 
@@ -126,7 +126,7 @@ namespace TR
     namespace Core::Async
     {
         template <typename From>
-        using AsyncOperationCallbackSafe = void (*)( From invoker, void *param, PropVariant *result );
+        using AsyncOperationCallbackSafe = void (*)( const From &invoker, void *param, PropVariant *result );
 
         template <typename From>
         struct AsyncOperationCallbackSafeObj
@@ -135,26 +135,28 @@ namespace TR
             void *param;
         };
 
+        template <typename From>
         inline TR_STATUS
         AsyncOperationCallbackHandler(
             IN _UnknownObject *invoker,
             IN void *param,
             OUT PropVariant *result
         ) {
-            const auto *safeCallback = static_cast<AsyncOperationCallbackSafeObj<TR::UnknownObject<_UnknownObject>> *>( param );
+            // Callback is only invoked once. It's safe to delete on either path.
+            const auto *safeCallback = static_cast<AsyncOperationCallbackSafeObj<From> *>( param );
+            TR_STATUS status = T_SUCCESS;
 
             try
             {
-                invoker->lpVtbl->AddRef( invoker );
-                safeCallback->callback( TR::UnknownObject<_UnknownObject>( invoker ), safeCallback->param, result );
+                // The invoker is only borrowed for the duration of the callback.
+                safeCallback->callback( *ComRef<From>( invoker ), safeCallback->param, result );
             } catch ( const TRException &e )
             {
-                return e.status;
+                status = e.status;
             }
 
-            // Callback is only invoked once. It's safe to delete here.
             delete safeCallback;
-            return T_SUCCESS;
+            return status;
         }
     }
 }
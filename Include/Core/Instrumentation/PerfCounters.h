@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_PERFCOUNTERS_H
+#define TRACERAYER_PERFCOUNTERS_H
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _TR_PerfCounter
+{
+    PERF_COUNTER_CYCLES = 0,
+    PERF_COUNTER_INSTRUCTIONS = 1,
+    PERF_COUNTER_L1D_MISSES = 2,
+    PERF_COUNTER_LLC_MISSES = 3,
+    PERF_COUNTER_BRANCH_MISSES = 4,
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+/**
+ * A named phase measured with the calling thread's hardware counters. Like
+ * zones, phase names are kept by pointer and have to be string literals.
+ */
+typedef struct _TR_PerfPhase
+{
+    TRCString Name;
+    TRULong Start[PERF_COUNTER_COUNT];
+    TRULong StartEnabled;
+    TRULong StartRunning;
+} PerfPhase;
+
+typedef struct _TR_PerfPhaseTotals
+{
+    TRCString Name;
+    TRULong Calls;
+    TRULong Counters[PERF_COUNTER_COUNT];
+    TRBool Available[PERF_COUNTER_COUNT];
+} PerfPhaseTotals;
+
+// Set once by InitializePerfCounters(). Cleared again if perf events turn out not to be permitted.
+extern TRBool TR_API PerfCountersEnabled;
+
+/**
+ * Enables per-thread perf_event counter groups and reports the per-phase totals at exit.
+ * Always succeeds, perf_event_open() failures only disable the counters with a warning.
+ */
+TR_STATUS TR_API InitializePerfCounters( IN TRBool enable );
+
+void TR_API PerfPhaseBegin( IN PerfPhase *phase, IN TRCString name );
+void TR_API PerfPhaseEnd( IN PerfPhase *phase );
+
+// Logs IPC and miss rates for every phase seen so far, e.g. once per frame with reset set.
+void TR_API PerfCountersReport( IN TRBool reset );
+
+#define TR_PERF_JOIN_( a, b ) a##b
+#define TR_PERF_JOIN( a, b ) TR_PERF_JOIN_( a, b )
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    struct ScopedPerfPhase
+    {
+        PerfPhase phase = {};
+
+        explicit ScopedPerfPhase( TRCString name )
+        {
+            if ( __builtin_expect( PerfCountersEnabled, 0 ) )
+                PerfPhaseBegin( &phase, name );
+        }
+
+        ~ScopedPerfPhase()
+        {
+            if ( phase.Name )
+                PerfPhaseEnd( &phase );
+        }
+
+        ScopedPerfPhase( const ScopedPerfPhase & ) = delete;
+        ScopedPerfPhase &operator=( const ScopedPerfPhase & ) = delete;
+    };
+}
+
+// TR_PERF_PHASE( "Traversal" ); attributes the counters until the end of the enclosing scope to that phase.
+#define TR_PERF_PHASE( name ) \
+    TR::ScopedPerfPhase TR_PERF_JOIN( _perfPhase, __LINE__ )( name )
+
+#else
+
+static inline void
+PerfPhaseCleanup(
+    IN PerfPhase *phase
+) {
+    if ( phase->Name )
+        PerfPhaseEnd( phase );
+}
+
+// TR_PERF_PHASE( "Traversal" ); attributes the counters until the end of the enclosing scope to that phase.
+#define TR_PERF_PHASE( name ) \
+    __attribute__((cleanup(PerfPhaseCleanup))) PerfPhase TR_PERF_JOIN( _perfPhase, __LINE__ ) = {}; \
+    if ( __builtin_expect( PerfCountersEnabled, 0 ) ) PerfPhaseBegin( &TR_PERF_JOIN( _perfPhase, __LINE__ ), name )
+
+#endif
+
+#endif
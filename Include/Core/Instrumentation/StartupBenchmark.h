@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_STARTUPBENCHMARK_H
+#define TRACERAYER_STARTUPBENCHMARK_H
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Set by the runner script to its CLOCK_MONOTONIC time in ns right before it starts the process.
+#define STARTUP_BENCHMARK_LAUNCH_ENV "TRACERAYER_BENCHMARK_LAUNCH"
+
+/**
+ * Timestamps for the way from process launch to the first frame. Marks are always
+ * recorded, a handful per run, so the ones taken before the command line is parsed
+ * are not lost. Names are kept by pointer and have to be string literals.
+ */
+void TR_API StartupMark( IN TRCString name );
+
+// Set once by InitializeStartupBenchmark(), when --benchmark-startup was given.
+extern TRBool TR_API StartupBenchmarkEnabled;
+
+TR_STATUS TR_API InitializeStartupBenchmark( IN TRCString outputPath );
+
+/**
+ * Writes every mark so far as JSON, in ms since launch when the runner passed its
+ * launch time and since the executable's constructors ran otherwise. The gap between
+ * the two is the dynamic loader mapping and relocating the shared libraries.
+ */
+TR_STATUS TR_API WriteStartupBenchmark();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
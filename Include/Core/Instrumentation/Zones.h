@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_ZONES_H
+#define TRACERAYER_ZONES_H
+
+#include <time.h>
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A named, timed scope. Zone names are stored by pointer until the trace is
+ * exported, so they have to be string literals (or otherwise outlive the process).
+ */
+typedef struct _TR_Zone
+{
+    TRCString Name;
+    TRULong Start;
+} Zone;
+
+// Set once by InitializeZones(), before any other thread is started.
+extern TRBool TR_API ZonesEnabled;
+
+/**
+ * Enables zone recording and exports everything recorded to outputPath as
+ * Chrome trace JSON at exit. Does nothing if outputPath is nullptr.
+ */
+TR_STATUS TR_API InitializeZones( IN TRCString outputPath );
+TR_STATUS TR_API ExportZones( IN TRCString outputPath );
+
+// Records a complete event with explicit timestamps, in ns on CLOCK_MONOTONIC.
+void TR_API ZoneRecord( IN TRCString name, IN TRULong start, IN TRULong duration );
+
+// Flows link zones across threads, e.g. an async operation's Start() with its completion.
+TRULong TR_API ZoneFlowBegin( IN TRCString name );
+void TR_API ZoneFlowStep( IN TRCString name, IN TRULong id );
+void TR_API ZoneFlowEnd( IN TRCString name, IN TRULong id );
+
+/**
+ * A timeline of its own in the trace, for work that does not run on a CPU thread, e.g.
+ * a GPU queue. Tracks live until exit and are nullptr with zones disabled, recording to
+ * nullptr does nothing. Appending to a track has to be serialized by the caller.
+ */
+typedef struct _TR_ZoneThread ZoneTrack;
+
+ZoneTrack TR_API *ZoneTrackCreate( IN TRCString name );
+void TR_API ZoneTrackRecord( IN ZoneTrack *track, IN TRCString name, IN TRULong start, IN TRULong duration );
+
+static inline TRULong
+ZoneTimestamp()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (TRULong)now.tv_sec * 1000000000UL + (TRULong)now.tv_nsec;
+}
+
+static inline void
+ZoneBegin(
+    IN Zone *zone,
+    IN TRCString name
+) {
+    zone->Name = name;
+    zone->Start = ZoneTimestamp();
+}
+
+static inline void
+ZoneEnd(
+    IN Zone *zone
+) {
+    if ( zone->Name )
+        ZoneRecord( zone->Name, zone->Start, ZoneTimestamp() - zone->Start );
+}
+
+#define TR_ZONE_JOIN_( a, b ) a##b
+#define TR_ZONE_JOIN( a, b ) TR_ZONE_JOIN_( a, b )
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    struct ScopedZone
+    {
+        Zone zone = {};
+
+        explicit ScopedZone( TRCString name )
+        {
+            if ( __builtin_expect( ZonesEnabled, 0 ) )
+                ZoneBegin( &zone, name );
+        }
+
+        ~ScopedZone()
+        {
+            ZoneEnd( &zone );
+        }
+
+        ScopedZone( const ScopedZone & ) = delete;
+        ScopedZone &operator=( const ScopedZone & ) = delete;
+    };
+}
+
+/**
+ * TR_ZONE( "BVH build" ); times everything from here to the end of the enclosing scope.
+ * With zones disabled this costs one well predicted branch.
+ */
+#define TR_ZONE( name ) \
+    TR::ScopedZone TR_ZONE_JOIN( _zone, __LINE__ )( name )
+
+#else
+
+static inline void
+ZoneCleanup(
+    IN Zone *zone
+) {
+    ZoneEnd( zone );
+}
+
+/**
+ * TR_ZONE( "BVH build" ); times everything from here to the end of the enclosing scope.
+ * With zones disabled this costs one well predicted branch.
+ */
+#define TR_ZONE( name ) \
+    __attribute__((cleanup(ZoneCleanup))) Zone TR_ZONE_JOIN( _zone, __LINE__ ) = {}; \
+    if ( __builtin_expect( ZonesEnabled, 0 ) ) ZoneBegin( &TR_ZONE_JOIN( _zone, __LINE__ ), name )
+
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_MEMORY_H
+#define TRACERAYER_MEMORY_H
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Every allocation is charged to the subsystem that made it, so growth can
+ * be attributed when a scene gets too large.
+ */
+typedef enum _TR_MemoryTag
+{
+    MEMORY_TAG_OBJECT = 0,
+    MEMORY_TAG_ASYNC = 1,
+    MEMORY_TAG_LOGGING = 2,
+    MEMORY_TAG_PATH = 3,
+    MEMORY_TAG_GEOMETRY = 4,
+    MEMORY_TAG_TEXTURE = 5,
+    MEMORY_TAG_VULKAN = 6,
+    MEMORY_TAG_INSTRUMENTATION = 7,
+    MEMORY_TAG_COUNT
+} MemoryTag;
+
+typedef struct _TR_MemoryStatistics
+{
+    TRCString Name;
+    TRSize LiveBytes;
+    TRSize LiveCount;
+    TRSize PeakBytes;
+    TRULong TotalCount;
+} MemoryStatistics;
+
+/**
+ * Blocks returned by these functions must be released with TRFree(), never with free().
+ * Every block carries a 16 byte header holding its size and tag.
+ */
+void TR_API *TRAlloc( IN TRSize size, IN MemoryTag tag );
+void TR_API *TRCalloc( IN TRSize count, IN TRSize size, IN MemoryTag tag );
+void TR_API *TRRealloc( IN void *block, IN TRSize size, IN MemoryTag tag );
+void TR_API *TRAlignedAlloc( IN TRSize alignment, IN TRSize size, IN MemoryTag tag );
+void TR_API *TRAlignedRealloc( IN void *block, IN TRSize alignment, IN TRSize size, IN MemoryTag tag );
+TRString TR_API TRStrdup( IN TRCString string, IN MemoryTag tag );
+void TR_API TRFree( IN void *block );
+
+// Accounts for memory that never went through TRAlloc(), like the objects of a slab cache.
+void TR_API MemoryCharge( IN MemoryTag tag, IN TRSize size );
+void TR_API MemoryCredit( IN MemoryTag tag, IN TRSize size );
+
+TR_STATUS TR_API MemoryQueryStatistics( IN MemoryTag tag, OUT MemoryStatistics *out );
+void TR_API MemoryDumpStatistics();
+
+// Dumps the statistics at exit and on SIGUSR1.
+TR_STATUS TR_API InitializeMemoryAccounting();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
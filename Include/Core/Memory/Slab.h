@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_SLAB_H
+#define TRACERAYER_SLAB_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include <Types.h>
+#include <Core/Memory/Memory.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _TR_SlabMagazine SlabMagazine;
+
+/**
+ * A pool of fixed size objects carved out of 64KiB slabs. Every object starts on
+ * a cache line and its stride is rounded up to one, so neighbouring objects never
+ * share a line. Each thread keeps a magazine of free objects per cache, the depot
+ * behind the lock is only touched when a magazine runs empty or full.
+ * Slabs are kept for the lifetime of the process. Tag is charged for the live objects,
+ * not for the slabs holding them.
+ */
+typedef struct _TR_SlabCache
+{
+    TRCString Name;
+    TRSize Size;
+    TRSize RefOffset;               // Of the object's ATOMIC(TRLong) reference count
+    MemoryTag Tag;
+    pthread_mutex_t Lock;
+
+    // --- Private Members --- //
+    ATOMIC(TRUInt) Index;
+    TRSize Stride;
+    SlabMagazine *Depot;            // Magazines holding at least one object
+    SlabMagazine *EmptyMagazines;
+    void *FreeObjects;              // Loose objects, linked through their first word
+    TRChar *Cursor;                 // Unused tail of the newest slab
+    TRChar *Limit;
+    TRSize SlabCount;
+    ATOMIC(TRSize) LiveCount;
+} SlabCache;
+
+#define DEFINE_SLAB_CACHE( impl, tag ) \
+    static SlabCache impl##_cache = { #impl, sizeof( struct impl ), offsetof( struct impl, ref ), tag, PTHREAD_MUTEX_INITIALIZER }
+
+// Returns a zeroed object, or nullptr when out of memory.
+void TR_API *SlabAlloc( IN SlabCache *cache );
+void TR_API SlabFree( IN SlabCache *cache, IN void *object );
+
+/**
+ * Finds the slab object containing address, along with its cache. Objects too large
+ * for a slab are not tracked, T_NOTIMPL is returned for them and for foreign memory.
+ */
+TR_STATUS TR_API SlabLookup( IN const void *address, OUT SlabCache **cache, OUT void **object );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
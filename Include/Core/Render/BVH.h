@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_BVH_H
+#define TRACERAYER_BVH_H
+
+#include <Types.h>
+
+#include <Core/Render/Scene.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BVH_SAH_BINS 16
+#define BVH_STACK_SIZE 64                           // Traversal stack, BVHBuild turns nodes this deep into leaves
+#define BVH_NO_HIT 0xFFFFFFFFu
+
+/**
+ * A flattened node, 32 bytes like the shaders' std430 struct. Interior nodes have a
+ * Count of 0 and their children at LeftOrFirst and LeftOrFirst + 1, leaves cover
+ * Count triangles from LeftOrFirst.
+ */
+typedef struct _TR_BVHNode
+{
+    Vector3 Min;
+    TRUInt LeftOrFirst;
+    Vector3 Max;
+    TRUInt Count;
+} BVHNode;
+
+typedef struct _TR_BVH
+{
+    BVHNode *Nodes;
+    TRUInt NodeCount;
+} BVH;
+
+typedef struct _TR_BVHHit
+{
+    float T;
+    TRUInt Triangle;                                // BVH_NO_HIT on a miss
+} BVHHit;
+
+/**
+ * Builds a binned SAH hierarchy and reorders the scene's triangles so every leaf
+ * covers a contiguous range, the lights are indexed again afterwards.
+ */
+TR_STATUS TR_API BVHBuild( INOUT Scene *scene, OUT BVH *bvh );
+
+void TR_API BVHFree( IN BVH *bvh );
+
+/**
+ * Finds the closest triangle in (0, tMax), or any triangle when anyHit is set, which
+ * is enough for shadow rays.
+ */
+void TR_API BVHIntersect( IN const BVH *bvh, IN const Scene *scene, IN Vector3 origin, IN Vector3 direction,
+                          IN float tMax, IN TRBool anyHit, OUT BVHHit *hit );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_REFERENCE_H
+#define TRACERAYER_REFERENCE_H
+
+#include <Types.h>
+
+#include <Core/Render/BVH.h>
+#include <Core/Render/Scene.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Path traces the scene on every core into out, Width * Height RGB triples, with
+ * the same estimator as the compute tracer. It is slow and only meant to check
+ * the GPU renderers against.
+ */
+TR_STATUS TR_API RenderReference( IN const Scene *scene, IN const BVH *bvh, IN const RenderSettings *settings, OUT float *out );
+
+// Over count floats.
+TRFloat TR_API RenderRootMeanSquareError( IN const float *a, IN const float *b, IN TRSize count );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
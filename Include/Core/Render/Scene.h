@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_SCENE_H
+#define TRACERAYER_SCENE_H
+
+#include <Types.h>
+
+#include <Core/Vector/Vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Triangles and materials are laid out like the std430 structs of the compute
+ * tracer's shaders, so both renderers read the very same arrays.
+ */
+typedef struct _TR_SceneTriangle
+{
+    Vector3 V0;
+    TRUInt Material;
+    Vector3 Edge1;                                  // V1 - V0
+    float Reserved0;
+    Vector3 Edge2;                                  // V2 - V0, the front face is where Edge1 x Edge2 points
+    float Reserved1;
+} SceneTriangle;
+
+typedef struct _TR_SceneMaterial
+{
+    Vector3 Albedo;                                 // Lambertian
+    float Reserved0;
+    Vector3 Emission;                               // Radiance leaving the front face, lights do not reflect
+    float Reserved1;
+} SceneMaterial;
+
+typedef struct _TR_SceneCamera
+{
+    Vector3 Origin;
+    Vector3 Target;
+    Vector3 Up;
+    float FovY;                                     // Degrees
+} SceneCamera;
+
+typedef struct _TR_Scene
+{
+    SceneTriangle *Triangles;
+    TRUInt TriangleCount;
+    SceneMaterial *Materials;
+    TRUInt MaterialCount;
+    TRUInt *Lights;                                 // Indices of the emissive triangles
+    TRUInt LightCount;
+    SceneCamera Camera;
+} Scene;
+
+// Shared with Shaders/Common.glsl, both renderers have to agree on them.
+#define RENDER_RAY_OFFSET 1e-4f                     // Along the normal, keeps rays off the surface they leave
+#define RENDER_SHADOW_EPSILON 1e-3f                 // Shadow rays stop this fraction short of the light
+#define RENDER_ROULETTE_DEPTH 3
+
+/**
+ * What both renderers compute per pixel: the average of Samples paths, each of at
+ * most MaxDepth segments, with a light sampled at every diffuse vertex. Emission
+ * is only counted when seen directly, Russian roulette starts at the third bounce.
+ */
+typedef struct _TR_RenderSettings
+{
+    TRUInt Width;
+    TRUInt Height;
+    TRUInt Samples;
+    TRUInt MaxDepth;
+    TRUInt Seed;
+} RenderSettings;
+
+// The classic box, 1 unit wide, lit by a quad under the ceiling.
+TR_STATUS TR_API SceneCreateCornellBox( OUT Scene *scene );
+
+// Collects the emissive triangles again, after they were reordered.
+TR_STATUS TR_API SceneIndexLights( INOUT Scene *scene );
+
+void TR_API SceneFree( IN Scene *scene );
+
+/**
+ * The direction through the image centre and the vectors from there to the right
+ * and top edges of the image plane, at distance 1.
+ */
+void TR_API SceneCameraBasis( IN const SceneCamera *camera, IN TRUInt width, IN TRUInt height,
+                              OUT Vector3 *forward, OUT Vector3 *right, OUT Vector3 *up );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
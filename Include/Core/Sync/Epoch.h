@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_EPOCH_H
+#define TRACERAYER_EPOCH_H
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Epoch based reclamation for data published through an atomic pointer. Readers
+ * bracket their accesses with EpochEnter()/EpochExit(), which only touches a
+ * thread-local counter, and writers swap the pointer and hand the old data to
+ * EpochRetire(). It is destroyed once every thread that could still see it has
+ * left its critical section. Sections nest, and must not block on a writer.
+ */
+typedef void (*EpochDestroy)( void *object );
+
+void TR_API EpochEnter();
+void TR_API EpochExit();
+
+// Destroys object after a grace period, or right away when no reader is active.
+TR_STATUS TR_API EpochRetire( IN void *object, IN EpochDestroy destroy );
+
+// Destroys whatever retired data no reader can reach anymore.
+void TR_API EpochCollect();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -23,4 +23,50 @@
 #ifndef TRACERAYER_VECTOR_H
 #define TRACERAYER_VECTOR_H
 
+#include <math.h>
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Single precision on purpose, scene data is uploaded to the GPU as is and the CPU
+ * reference has to see the same numbers the shaders do.
+ */
+typedef struct _TR_Vector3
+{
+    float X;
+    float Y;
+    float Z;
+} Vector3;
+
+static inline Vector3 Vector3Make( float x, float y, float z ) { return (Vector3){ x, y, z }; }
+static inline Vector3 Vector3Add( Vector3 a, Vector3 b ) { return (Vector3){ a.X + b.X, a.Y + b.Y, a.Z + b.Z }; }
+static inline Vector3 Vector3Sub( Vector3 a, Vector3 b ) { return (Vector3){ a.X - b.X, a.Y - b.Y, a.Z - b.Z }; }
+static inline Vector3 Vector3Mul( Vector3 a, Vector3 b ) { return (Vector3){ a.X * b.X, a.Y * b.Y, a.Z * b.Z }; }
+static inline Vector3 Vector3Scale( Vector3 a, float s ) { return (Vector3){ a.X * s, a.Y * s, a.Z * s }; }
+static inline float Vector3Dot( Vector3 a, Vector3 b ) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+static inline float Vector3Length( Vector3 a ) { return sqrtf( Vector3Dot( a, a ) ); }
+static inline Vector3 Vector3Normalize( Vector3 a ) { return Vector3Scale( a, 1.0f / Vector3Length( a ) ); }
+static inline Vector3 Vector3Min( Vector3 a, Vector3 b ) { return (Vector3){ fminf( a.X, b.X ), fminf( a.Y, b.Y ), fminf( a.Z, b.Z ) }; }
+static inline Vector3 Vector3Max( Vector3 a, Vector3 b ) { return (Vector3){ fmaxf( a.X, b.X ), fmaxf( a.Y, b.Y ), fmaxf( a.Z, b.Z ) }; }
+static inline float Vector3MaxComponent( Vector3 a ) { return fmaxf( a.X, fmaxf( a.Y, a.Z ) ); }
+
+static inline Vector3 Vector3Cross( Vector3 a, Vector3 b )
+{
+    return (Vector3){ a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X };
+}
+
+// axis 0, 1 or 2 for X, Y or Z.
+static inline float Vector3Axis( Vector3 a, TRUInt axis )
+{
+    return axis == 0 ? a.X : axis == 1 ? a.Y : a.Z;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
 #endif
\ No newline at end of file
@@ -29,6 +29,8 @@
 #include <Types.h>
 
 #include <Core/Vulkan/VulkanDevice.h>
+#include <Core/Vulkan/VulkanInventory.h>
+#include <UI/Representation.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,7 +46,7 @@ typedef struct _VulkanInterface
 
     /**
      * @Method: VulkanDeviceObject* VulkanObject::CreateDevice( TRCString deviceName )
-     * @Description: Creates a Vulkan device from the given Name
+     * @Description: Creates a Vulkan device from the given Name, as reported by the driver.
      * @Status: Returns T_SUCCESS if the device was found, otherwise, T_NOINIT.
      *          Returns T_ERROR if a vulkan call fails.
      */
@@ -64,6 +66,38 @@ typedef struct _VulkanInterface
         TRUInt               index,
         VulkanDeviceObject  **out );
 
+    /**
+     * @Method: VulkanDeviceObject* VulkanObject::CreateDevice()
+     * @Description: Creates a Vulkan device from the highest scoring physical device. Discrete
+     *               GPUs win over integrated ones and those over CPU implementations, then
+     *               ray tracing support and device local memory break the tie.
+     * @Status: Returns T_SUCCESS if a usable device was found, otherwise, T_NOINIT.
+     */
+    TR_STATUS (*CreateDefaultDevice)(
+        VulkanObject        *This,
+        VulkanDeviceObject  **out );
+
+    /**
+     * @Method: VkSurfaceKHR VulkanObject::CreateSurface( const WindowRepresentation *window )
+     * @Description: Creates a surface for the native window of a UI window. Destroy it with
+     *               DestroySurface, after every swapchain on it.
+     * @Status: Returns T_NOTIMPL if the instance was created for another platform than the
+     *          window's, T_ERROR if a vulkan call fails.
+     */
+    TR_STATUS (*CreateSurface)(
+        VulkanObject                *This,
+        const WindowRepresentation  *window,
+        VkSurfaceKHR                *out );
+
+    /**
+     * @Method: void VulkanObject::DestroySurface( VkSurfaceKHR surface )
+     * @Description: Destroys a surface created by CreateSurface.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*DestroySurface)(
+        VulkanObject        *This,
+        VkSurfaceKHR         surface );
+
     END_INTERFACE
 } VulkanInterface;
 
@@ -84,6 +118,8 @@ struct vulkan_object
     // --- Private Members --- //
     VkInstance instance;
     Platform platform;
+    VulkanPhysicalDeviceInfo *devices;              // Snapshot taken once, at creation
+    TRUInt deviceCount;
     ATOMIC(TRLong) ref;
 };
 
@@ -119,12 +155,34 @@ namespace TR
                 return VulkanDeviceObject( vkdevobj );
             }
 
+            [[nodiscard]]
             VulkanDeviceObject CreateDevice( TRUInt index ) const
             {
                 _VulkanDeviceObject *vkdevobj;
                 check_tr_( get()->lpVtbl->CreateDeviceOverloadIndex( get(), index, &vkdevobj ) );
                 return VulkanDeviceObject( vkdevobj );
             }
+
+            [[nodiscard]]
+            VulkanDeviceObject CreateDevice() const
+            {
+                _VulkanDeviceObject *vkdevobj;
+                check_tr_( get()->lpVtbl->CreateDefaultDevice( get(), &vkdevobj ) );
+                return VulkanDeviceObject( vkdevobj );
+            }
+
+            [[nodiscard]]
+            VkSurfaceKHR CreateSurface( const WindowRepresentation &window ) const
+            {
+                VkSurfaceKHR surface;
+                check_tr_( get()->lpVtbl->CreateSurface( get(), &window, &surface ) );
+                return surface;
+            }
+
+            void DestroySurface( VkSurfaceKHR surface ) const noexcept
+            {
+                get()->lpVtbl->DestroySurface( get(), surface );
+            }
         };
     }
 }
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANACCELERATIONSTRUCTURE_H
+#define TRACERAYER_VULKANACCELERATIONSTRUCTURE_H
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Vulkan/VulkanAllocator.h>
+#include <Core/Vulkan/VulkanDevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _VulkanAccelerationStructureObject VulkanAccelerationStructureObject;
+
+/**
+ * The triangles of one bottom level structure, read by the build through buffer
+ * device addresses. The buffers need VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT and
+ * VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR.
+ */
+typedef struct _TR_VulkanAccelerationStructureGeometry
+{
+    VkDeviceAddress Vertices;                       // Three floats per position
+    VkDeviceSize VertexStride;
+    TRUInt VertexCount;
+    VkDeviceAddress Indices;                        // Three 32 bit indices per triangle, 0 for a plain triangle list
+    TRUInt TriangleCount;
+    TRBool Opaque;                                  // Never invokes any-hit shaders
+} VulkanAccelerationStructureGeometry;
+
+typedef struct _TR_VulkanAccelerationStructure
+{
+    VkAccelerationStructureKHR Handle;
+    VkDeviceAddress Address;
+    VkBuffer Buffer;
+    VulkanAllocation Memory;
+    VkDeviceSize Size;
+} VulkanAccelerationStructure;
+
+typedef struct _TR_VulkanAccelerationStructureStatistics
+{
+    TRUInt Structures;
+    TRUInt Batches;                                 // vkCmdBuildAccelerationStructuresKHR calls
+    VkDeviceSize ScratchBytes;                      // Of the one scratch buffer every batch shares
+    VkDeviceSize BuiltBytes;                        // Before compaction
+    VkDeviceSize CompactedBytes;
+    TRULong BuildNanoseconds;                       // Of the whole Build, waits included
+} VulkanAccelerationStructureStatistics;
+
+typedef struct _VulkanAccelerationStructureInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanAccelerationStructureObject )
+
+    /**
+     * @Method: void VulkanAccelerationStructureObject::Build( const VulkanAccelerationStructureGeometry *geometries, TRUInt count )
+     * @Description: Builds one bottom level structure per geometry, replacing the previous ones,
+     *               and waits for them. Builds are recorded in batches sharing a single scratch
+     *               buffer, every batch is compacted before the next one starts.
+     * @Status: Returns T_INVALIDARG for an empty geometry, T_OUTOFMEMORY if the structures
+     *          cannot be allocated and T_ERROR if the device fails.
+     */
+    TR_STATUS (*Build)(
+        IN VulkanAccelerationStructureObject            *This,
+        IN const VulkanAccelerationStructureGeometry    *geometries,
+        IN TRUInt                                        count );
+
+    /**
+     * @Method: TRUInt VulkanAccelerationStructureObject::Count()
+     * @Description: Gets the number of structures of the last successful Build.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Count)(
+        IN VulkanAccelerationStructureObject    *This,
+        OUT TRUInt                              *out );
+
+    /**
+     * @Method: VulkanAccelerationStructure VulkanAccelerationStructureObject::Structure( TRUInt index )
+     * @Description: Gets a structure in the order of the geometries it was built from. It
+     *               stays owned by the object and valid until the next Build.
+     * @Status: Returns T_INVALIDARG if index is out of range.
+     */
+    TR_STATUS (*GetStructure)(
+        IN VulkanAccelerationStructureObject    *This,
+        IN TRUInt                                index,
+        OUT VulkanAccelerationStructure         *out );
+
+    /**
+     * @Method: VulkanAccelerationStructureStatistics VulkanAccelerationStructureObject::Statistics()
+     * @Description: Gets the sizes, batches and duration of the last successful Build.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Statistics)(
+        IN VulkanAccelerationStructureObject        *This,
+        OUT VulkanAccelerationStructureStatistics   *out );
+
+    END_INTERFACE
+} VulkanAccelerationStructureInterface;
+
+com_interface _VulkanAccelerationStructureObject
+{
+    CONST_VTBL VulkanAccelerationStructureInterface *lpVtbl;
+};
+
+/**
+ * @Object: VulkanAccelerationStructureObject
+ * @Description: The bottom level acceleration structures of a scene. Structures are built
+ *               with compaction allowed and copied into storage of their compacted size,
+ *               usually about half of the built one, before the originals are freed. Built
+ *               on the graphics queue, where ray tracing pipelines read them.
+ */
+struct vulkan_acceleration_structure_object
+{
+    // --- Public Members --- //
+    VulkanAccelerationStructureObject VulkanAccelerationStructureObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;
+    VulkanAllocatorObject *allocator;
+    VulkanQueueObject *queue;
+    VkDevice handle;
+
+    VkCommandPool pool;
+    VkCommandBuffer commands;
+    VkFence fence;
+
+    VulkanAccelerationStructure *structures;
+    TRUInt count;
+    VulkanAccelerationStructureStatistics statistics;
+    VkDeviceSize scratchAlignment;
+    TRULong maxPrimitives;
+
+    PFN_vkCreateAccelerationStructureKHR createAccelerationStructure;
+    PFN_vkDestroyAccelerationStructureKHR destroyAccelerationStructure;
+    PFN_vkGetAccelerationStructureBuildSizesKHR getBuildSizes;
+    PFN_vkGetAccelerationStructureDeviceAddressKHR getDeviceAddress;
+    PFN_vkCmdBuildAccelerationStructuresKHR cmdBuild;
+    PFN_vkCmdWriteAccelerationStructuresPropertiesKHR cmdWriteProperties;
+    PFN_vkCmdCopyAccelerationStructureKHR cmdCopy;
+
+    pthread_mutex_t lock;
+    ATOMIC(TRLong) ref;
+};
+
+// e49c32d6-545d-4820-a8b8-1fd1f729c7d1
+DEFINE_GUID( VulkanAccelerationStructureObject, 0xe49c32d6, 0x545d, 0x4820, 0xa8, 0xb8, 0x1f, 0xd1, 0xf7, 0x29, 0xc7, 0xd1 );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_acceleration_structure_object_override_device_and_allocator( IN VulkanDeviceObject *device, IN VulkanAllocatorObject *allocator, OUT VulkanAccelerationStructureObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanAccelerationStructureObject : public UnknownObject<_VulkanAccelerationStructureObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanAccelerationStructureObject;
+
+            explicit VulkanAccelerationStructureObject( const VulkanDeviceObject &device, const VulkanAllocatorObject &allocator )
+            {
+                check_tr_( new_vulkan_acceleration_structure_object_override_device_and_allocator( device.get(), allocator.get(), put() ) );
+            }
+
+            void Build( const VulkanAccelerationStructureGeometry *geometries, TRUInt count ) const
+            {
+                check_tr_( get()->lpVtbl->Build( get(), geometries, count ) );
+            }
+
+            TRUInt Count() const noexcept
+            {
+                TRUInt out;
+                get()->lpVtbl->get_Count( get(), &out );
+                return out;
+            }
+
+            VulkanAccelerationStructure Structure( TRUInt index ) const
+            {
+                VulkanAccelerationStructure out;
+                check_tr_( get()->lpVtbl->GetStructure( get(), index, &out ) );
+                return out;
+            }
+
+            VulkanAccelerationStructureStatistics Statistics() const noexcept
+            {
+                VulkanAccelerationStructureStatistics out;
+                get()->lpVtbl->get_Statistics( get(), &out );
+                return out;
+            }
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANALLOCATOR_H
+#define TRACERAYER_VULKANALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Vulkan/VulkanDevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _VulkanAllocatorObject VulkanAllocatorObject;
+typedef struct _TR_VulkanMemoryBlock VulkanMemoryBlock;
+typedef struct _TR_VulkanMemoryNode VulkanMemoryNode;
+
+typedef enum _VulkanAllocationFlags
+{
+    VulkanAllocationFlags_None      = 0,
+    VulkanAllocationFlags_Optimal   = 1 << 0,       // Optimally tiled images, kept apart from buffers
+    VulkanAllocationFlags_Dedicated = 1 << 1,       // Always gets a VkDeviceMemory of its own
+    VulkanAllocationFlags_Mapped    = 1 << 2        // Requires host visible memory and maps it
+} VulkanAllocationFlags;
+
+/**
+ * A range of device memory handed out by a VulkanAllocatorObject. Filled in by
+ * Allocate and passed back as is to Free.
+ */
+typedef struct _TR_VulkanAllocation
+{
+    VkDeviceMemory Memory;
+    VkDeviceSize Offset;
+    VkDeviceSize Size;
+    void *Mapped;                                   // At Offset, nullptr unless host visible
+    TRUInt MemoryType;
+
+    // --- Private Members --- //
+    VulkanMemoryBlock *Block;                       // nullptr for dedicated allocations
+    VulkanMemoryNode *Node;
+} VulkanAllocation;
+
+typedef struct _TR_VulkanAllocatorStatistics
+{
+    TRUInt Blocks;
+    TRUInt DedicatedAllocations;
+    TRUInt Allocations;                             // Sub-allocations and dedicated ones
+    VkDeviceSize Reserved;                          // Every VkDeviceMemory, in bytes
+    VkDeviceSize Used;
+    VkDeviceSize LargestFree;                       // Largest single free range of any block
+    TRFloat Fragmentation;                          // 0 when the free space of every block is one range, towards 1 when scattered
+} VulkanAllocatorStatistics;
+
+typedef struct _VulkanAllocatorInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanAllocatorObject )
+
+    /**
+     * @Method: VulkanAllocation VulkanAllocatorObject::Allocate( const VkMemoryRequirements *requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, VulkanAllocationFlags flags )
+     * @Description: Sub-allocates memory from a block of a memory type matching the requirements,
+     *               creating a block when none has room. Requests larger than half a block
+     *               get a dedicated allocation.
+     * @Status: Returns T_INVALIDARG if no memory type matches, T_OUTOFMEMORY if the device is out of memory
+     *          or the driver's allocation count limit is reached.
+     */
+    TR_STATUS (*Allocate)(
+        IN VulkanAllocatorObject        *This,
+        IN const VkMemoryRequirements   *requirements,
+        IN VkMemoryPropertyFlags         required,
+        IN VkMemoryPropertyFlags         preferred,
+        IN VulkanAllocationFlags         flags,
+        OUT VulkanAllocation            *out );
+
+    /**
+     * @Method: VulkanAllocation VulkanAllocatorObject::AllocateForBuffer( VkBuffer buffer, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, VulkanAllocationFlags flags )
+     * @Description: Allocates memory for a buffer and binds it. The allocation is dedicated
+     *               when the driver prefers so.
+     * @Status: Same as Allocate, and T_ERROR if binding fails.
+     */
+    TR_STATUS (*AllocateForBuffer)(
+        IN VulkanAllocatorObject    *This,
+        IN VkBuffer                  buffer,
+        IN VkMemoryPropertyFlags     required,
+        IN VkMemoryPropertyFlags     preferred,
+        IN VulkanAllocationFlags     flags,
+        OUT VulkanAllocation        *out );
+
+    /**
+     * @Method: VulkanAllocation VulkanAllocatorObject::AllocateForImage( VkImage image, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, VulkanAllocationFlags flags )
+     * @Description: Allocates memory for an optimally tiled image and binds it. Render targets
+     *               and other images the driver prefers dedicated get their own memory.
+     * @Status: Same as Allocate, and T_ERROR if binding fails.
+     */
+    TR_STATUS (*AllocateForImage)(
+        IN VulkanAllocatorObject    *This,
+        IN VkImage                   image,
+        IN VkMemoryPropertyFlags     required,
+        IN VkMemoryPropertyFlags     preferred,
+        IN VulkanAllocationFlags     flags,
+        OUT VulkanAllocation        *out );
+
+    /**
+     * @Method: void VulkanAllocatorObject::Free( VulkanAllocation *allocation )
+     * @Description: Returns an allocation. Empty blocks are released, except the last one of
+     *               each memory type and tiling, which is kept for the next allocation.
+     */
+    void (*Free)(
+        IN VulkanAllocatorObject    *This,
+        IN VulkanAllocation         *allocation );
+
+    /**
+     * @Method: VulkanAllocatorStatistics VulkanAllocatorObject::Statistics()
+     * @Description: Gets the current block count, usage and fragmentation.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Statistics)(
+        IN VulkanAllocatorObject        *This,
+        OUT VulkanAllocatorStatistics   *out );
+
+    END_INTERFACE
+} VulkanAllocatorInterface;
+
+com_interface _VulkanAllocatorObject
+{
+    CONST_VTBL VulkanAllocatorInterface *lpVtbl;
+};
+
+/**
+ * @Object: VulkanAllocatorObject
+ * @Description: Sub-allocates device memory out of large blocks per memory type, with a
+ *               two level segregated fit (TLSF) free list per block.
+ */
+struct vulkan_allocator_object
+{
+    // --- Public Members --- //
+    VulkanAllocatorObject VulkanAllocatorObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;
+    VkDevice handle;
+    const VulkanPhysicalDeviceInfo *info;
+    pthread_mutex_t lock;
+    VulkanMemoryBlock *pools[VK_MAX_MEMORY_TYPES][2];   // Linear and optimal resources per memory type
+    TRBool separateOptimal;                             // bufferImageGranularity needs them apart
+    VkDeviceSize blockSizes[VK_MAX_MEMORY_HEAPS];
+    VulkanMemoryNode *spareNodes;
+    TRUInt memoryCount;                                 // Every live VkDeviceMemory
+    TRUInt dedicatedCount;
+    VkDeviceSize dedicatedBytes;
+    ATOMIC(TRLong) ref;
+};
+
+// a7815dca-c6e3-46c6-b617-21842a646f1b
+DEFINE_GUID( VulkanAllocatorObject, 0xa7815dca, 0xc6e3, 0x46c6, 0xb6, 0x17, 0x21, 0x84, 0x2a, 0x64, 0x6f, 0x1b );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_allocator_object_override_device( IN VulkanDeviceObject *device, OUT VulkanAllocatorObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanAllocatorObject : public UnknownObject<_VulkanAllocatorObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanAllocatorObject;
+
+            explicit VulkanAllocatorObject( const VulkanDeviceObject &device )
+            {
+                check_tr_( new_vulkan_allocator_object_override_device( device.get(), put() ) );
+            }
+
+            [[nodiscard]]
+            VulkanAllocation Allocate( const VkMemoryRequirements &requirements, VkMemoryPropertyFlags required,
+                                       VkMemoryPropertyFlags preferred = 0, VulkanAllocationFlags flags = VulkanAllocationFlags_None ) const
+            {
+                VulkanAllocation out;
+                check_tr_( get()->lpVtbl->Allocate( get(), &requirements, required, preferred, flags, &out ) );
+                return out;
+            }
+
+            [[nodiscard]]
+            VulkanAllocation AllocateForBuffer( VkBuffer buffer, VkMemoryPropertyFlags required,
+                                                VkMemoryPropertyFlags preferred = 0, VulkanAllocationFlags flags = VulkanAllocationFlags_None ) const
+            {
+                VulkanAllocation out;
+                check_tr_( get()->lpVtbl->AllocateForBuffer( get(), buffer, required, preferred, flags, &out ) );
+                return out;
+            }
+
+            [[nodiscard]]
+            VulkanAllocation AllocateForImage( VkImage image, VkMemoryPropertyFlags required,
+                                               VkMemoryPropertyFlags preferred = 0, VulkanAllocationFlags flags = VulkanAllocationFlags_None ) const
+            {
+                VulkanAllocation out;
+                check_tr_( get()->lpVtbl->AllocateForImage( get(), image, required, preferred, flags, &out ) );
+                return out;
+            }
+
+            void Free( VulkanAllocation &allocation ) const
+            {
+                get()->lpVtbl->Free( get(), &allocation );
+            }
+
+            VulkanAllocatorStatistics Statistics() const noexcept
+            {
+                VulkanAllocatorStatistics out;
+                get()->lpVtbl->get_Statistics( get(), &out );
+                return out;
+            }
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANCOMMANDRECORDER_H
+#define TRACERAYER_VULKANCOMMANDRECORDER_H
+
+#include <pthread.h>
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Vulkan/VulkanDevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VULKAN_RECORDER_MAX_THREADS 64
+#define VULKAN_RECORDER_DEFAULT_FRAMES 2            // As VULKAN_SWAPCHAIN_DEFAULT_FRAMES
+
+typedef struct _VulkanCommandRecorderObject VulkanCommandRecorderObject;
+
+/**
+ * Records item index of a Record into commands. Called concurrently for items of other
+ * ranges, every range of items is recorded in order by a single thread.
+ */
+typedef TR_STATUS (*VulkanRecordCallback)( IN void *context, IN TRUInt index, IN VkCommandBuffer commands );
+
+typedef struct _TR_VulkanCommandRecorderSettings
+{
+    VulkanQueueRole Role;                           // Of the queue the primary buffers are submitted to
+    TRUInt Threads;                                 // 0 for one per processor
+    TRUInt FramesInFlight;                          // 0 for VULKAN_RECORDER_DEFAULT_FRAMES
+} VulkanCommandRecorderSettings;
+
+typedef struct _TR_VulkanCommandRecorderStatistics
+{
+    TRULong Recorded;                               // Secondary command buffers
+    TRULong Items;
+    TRULong Resets;                                 // vkResetCommandPool calls
+    TRUInt Allocated;                               // Secondary command buffers across all pools, recycled by the resets
+    TRULong RecordNanoseconds;                      // Of the last Record, waits included
+} VulkanCommandRecorderStatistics;
+
+typedef struct _VulkanCommandRecorderInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanCommandRecorderObject )
+
+    /**
+     * @Method: void VulkanCommandRecorderObject::BeginFrame( TRUInt frame )
+     * @Description: Resets the command pools of a frame slot, recycling every command buffer
+     *               recorded in it. Everything submitted with them has to be finished, as
+     *               after waiting on the frame's fence.
+     * @Status: Returns T_INVALIDARG if frame is not below the frames in flight, T_ERROR if
+     *          a pool cannot be reset.
+     */
+    TR_STATUS (*BeginFrame)(
+        IN VulkanCommandRecorderObject *This,
+        IN TRUInt                       frame );
+
+    /**
+     * @Method: TRUInt VulkanCommandRecorderObject::Record( const VkCommandBufferInheritanceInfo *inheritance, TRUInt count, VulkanRecordCallback callback, void *context, VkCommandBuffer *commands )
+     * @Description: Records count items into secondary command buffers of the current frame,
+     *               splitting them into contiguous ranges across the threads. Helpers on the
+     *               async executor and the calling thread claim ranges in turn, the calling
+     *               thread records whatever no helper started yet, so a busy executor only
+     *               costs parallelism. commands gets one buffer per range in item order, at
+     *               most the thread count, to pass to vkCmdExecuteCommands. inheritance
+     *               defaults to recording outside of a render pass.
+     * @Status: Returns the first failure of callback, T_OUTOFMEMORY if command buffers cannot
+     *          be allocated and T_ERROR if recording fails.
+     */
+    TR_STATUS (*Record)(
+        IN VulkanCommandRecorderObject                      *This,
+        OPTIONAL IN const VkCommandBufferInheritanceInfo    *inheritance,
+        IN TRUInt                                            count,
+        IN VulkanRecordCallback                              callback,
+        IN void                                             *context,
+        OUT VkCommandBuffer                                 *commands,
+        OUT TRUInt                                          *recorded );
+
+    /**
+     * @Method: TRUInt VulkanCommandRecorderObject::ThreadCount()
+     * @Description: Gets the number of threads recording, the most buffers a Record returns.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_ThreadCount)(
+        IN VulkanCommandRecorderObject *This,
+        OUT TRUInt                     *out );
+
+    /**
+     * @Method: VulkanCommandRecorderStatistics VulkanCommandRecorderObject::Statistics()
+     * @Description: Gets the totals since creation and the duration of the last Record.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Statistics)(
+        IN VulkanCommandRecorderObject         *This,
+        OUT VulkanCommandRecorderStatistics    *out );
+
+    END_INTERFACE
+} VulkanCommandRecorderInterface;
+
+com_interface _VulkanCommandRecorderObject
+{
+    CONST_VTBL VulkanCommandRecorderInterface *lpVtbl;
+};
+
+/**
+ * The command pool of one range slot in one frame slot, used by one thread at a time.
+ * Buffers are allocated once and handed out again after every reset of the pool.
+ */
+typedef struct _TR_VulkanRecorderPool
+{
+    VkCommandPool Pool;
+    VkCommandBuffer *Buffers;
+    TRUInt Allocated;
+    TRUInt Used;                                    // Since the last reset
+} VulkanRecorderPool;
+
+/**
+ * @Object: VulkanCommandRecorderObject
+ * @Description: Parallel recording of secondary command buffers, for scenes with too many
+ *               instances and dispatches to record on one thread. Vulkan command pools are
+ *               externally synchronized, so each thread gets a pool of its own per frame in
+ *               flight and recording never takes a lock. Pools are reset whole instead of
+ *               buffer by buffer.
+ */
+struct vulkan_command_recorder_object
+{
+    // --- Public Members --- //
+    VulkanCommandRecorderObject VulkanCommandRecorderObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;
+    VkDevice handle;
+
+    VulkanRecorderPool *pools;                      // threads per frame, frame major
+    TRUInt threads;
+    TRUInt frames;
+    TRUInt frame;                                   // Of the last BeginFrame
+    VulkanCommandRecorderStatistics statistics;
+    pthread_mutex_t lock;                           // Guards the statistics, Record and BeginFrame come from one thread
+    ATOMIC(TRLong) ref;
+};
+
+// 53904495-45bc-41f6-b5e1-4a6076a56c30
+DEFINE_GUID( VulkanCommandRecorderObject, 0x53904495, 0x45bc, 0x41f6, 0xb5, 0xe1, 0x4a, 0x60, 0x76, 0xa5, 0x6c, 0x30 );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_command_recorder_object_override_device_and_settings( IN VulkanDeviceObject *device, IN const VulkanCommandRecorderSettings *settings, OUT VulkanCommandRecorderObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanCommandRecorderObject : public UnknownObject<_VulkanCommandRecorderObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanCommandRecorderObject;
+
+            explicit VulkanCommandRecorderObject( const VulkanDeviceObject &device, const VulkanCommandRecorderSettings &settings )
+            {
+                check_tr_( new_vulkan_command_recorder_object_override_device_and_settings( device.get(), &settings, put() ) );
+            }
+
+            void BeginFrame( TRUInt frame ) const
+            {
+                check_tr_( get()->lpVtbl->BeginFrame( get(), frame ) );
+            }
+
+            // commands needs room for ThreadCount() buffers.
+            TRUInt Record( const VkCommandBufferInheritanceInfo *inheritance, TRUInt count, VulkanRecordCallback callback,
+                           void *context, VkCommandBuffer *commands ) const
+            {
+                TRUInt recorded;
+                check_tr_( get()->lpVtbl->Record( get(), inheritance, count, callback, context, commands, &recorded ) );
+                return recorded;
+            }
+
+            TRUInt ThreadCount() const noexcept
+            {
+                TRUInt out;
+                get()->lpVtbl->get_ThreadCount( get(), &out );
+                return out;
+            }
+
+            VulkanCommandRecorderStatistics Statistics() const noexcept
+            {
+                VulkanCommandRecorderStatistics out;
+                get()->lpVtbl->get_Statistics( get(), &out );
+                return out;
+            }
+        };
+    }
+}
+#endif
+
+#endif
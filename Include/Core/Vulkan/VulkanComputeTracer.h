@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANCOMPUTETRACER_H
+#define TRACERAYER_VULKANCOMPUTETRACER_H
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Render/BVH.h>
+#include <Core/Render/Scene.h>
+#include <Core/Vulkan/VulkanAllocator.h>
+#include <Core/Vulkan/VulkanDevice.h>
+#include <Core/Vulkan/VulkanPipelineCache.h>
+#include <Core/Vulkan/VulkanProfiler.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _VulkanComputeTracerObject VulkanComputeTracerObject;
+
+typedef enum _VulkanComputeTracerKernel
+{
+    VulkanComputeTracerKernel_Generate,             // Camera paths, one per pixel
+    VulkanComputeTracerKernel_Extend,               // Closest hits of the queued paths
+    VulkanComputeTracerKernel_Shade,                // Light samples and the next bounce
+    VulkanComputeTracerKernel_Connect,              // Shadow rays
+    VulkanComputeTracerKernel_Count
+} VulkanComputeTracerKernel;
+
+typedef enum _VulkanComputeTracerBinding
+{
+    VulkanComputeTracerBinding_Nodes,
+    VulkanComputeTracerBinding_Triangles,
+    VulkanComputeTracerBinding_Materials,
+    VulkanComputeTracerBinding_Lights,
+    VulkanComputeTracerBinding_Paths,
+    VulkanComputeTracerBinding_Queues,
+    VulkanComputeTracerBinding_RayQueue,
+    VulkanComputeTracerBinding_ShadowRays,
+    VulkanComputeTracerBinding_Film,
+    VulkanComputeTracerBinding_Count
+} VulkanComputeTracerBinding;
+
+typedef struct _VulkanComputeTracerInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanComputeTracerObject )
+
+    /**
+     * @Method: void VulkanComputeTracerObject::LoadScene( const Scene *scene, const BVH *bvh )
+     * @Description: Uploads the triangles, materials, lights and BVH nodes, replacing the
+     *               previous scene. bvh has to be built over scene, which is not kept.
+     * @Status: Returns T_INVALIDARG for a scene without triangles, T_OUTOFMEMORY if the
+     *          buffers cannot be allocated and T_ERROR if the upload fails.
+     */
+    TR_STATUS (*LoadScene)(
+        IN VulkanComputeTracerObject *This,
+        IN const Scene               *scene,
+        IN const BVH                 *bvh );
+
+    /**
+     * @Method: void VulkanComputeTracerObject::Render( const RenderSettings *settings, float *out )
+     * @Description: Path traces the loaded scene into out, Width * Height RGB triples, and
+     *               waits for it. Computes the same estimator as RenderReference.
+     * @Status: Returns T_NOINIT before a scene is loaded, T_INVALIDARG for an empty image
+     *          and T_ERROR if the device fails.
+     */
+    TR_STATUS (*Render)(
+        IN VulkanComputeTracerObject *This,
+        IN const RenderSettings      *settings,
+        OUT float                    *out );
+
+    END_INTERFACE
+} VulkanComputeTracerInterface;
+
+com_interface _VulkanComputeTracerObject
+{
+    CONST_VTBL VulkanComputeTracerInterface *lpVtbl;
+};
+
+typedef struct _TR_VulkanComputeTracerBuffer
+{
+    VkBuffer Buffer;
+    VulkanAllocation Memory;
+    VkDeviceSize Size;
+} VulkanComputeTracerBuffer;
+
+/**
+ * @Object: VulkanComputeTracerObject
+ * @Description: A wavefront path tracer in plain compute shaders, for devices without
+ *               ray tracing pipelines. Every bounce runs as separate extend, shade and
+ *               connect kernels over queues of live paths, each dispatched indirectly for
+ *               exactly the paths the previous kernel queued, and traverses the BVH of
+ *               Core/Render/BVH.h from storage buffers. Each kernel dispatch is timed as
+ *               a scope on the "Compute Tracer" GPU track.
+ */
+struct vulkan_compute_tracer_object
+{
+    // --- Public Members --- //
+    VulkanComputeTracerObject VulkanComputeTracerObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;
+    VulkanAllocatorObject *allocator;
+    VulkanQueueObject *queue;
+    VulkanProfilerObject *profiler;
+    VkDevice handle;
+
+    VkDescriptorSetLayout setLayout;
+    VkPipelineLayout layout;
+    VkPipeline pipelines[VulkanComputeTracerKernel_Count];
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet set;
+    VkCommandPool pool;
+    VkCommandBuffer commands;
+    VkFence fence;
+
+    VulkanComputeTracerBuffer buffers[VulkanComputeTracerBinding_Count];
+    VulkanComputeTracerBuffer readback;             // Host visible copy of the film
+    TRUInt pixelCapacity;                           // Of the per pixel buffers
+    TRUInt lightCount;
+    SceneCamera camera;
+    TRBool loaded;
+    pthread_mutex_t lock;
+    ATOMIC(TRLong) ref;
+};
+
+// f315375d-8731-4c57-9928-90e94373a750
+DEFINE_GUID( VulkanComputeTracerObject, 0xf315375d, 0x8731, 0x4c57, 0x99, 0x28, 0x90, 0xe9, 0x43, 0x73, 0xa7, 0x50 );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_compute_tracer_object_override_device_and_allocator_and_cache( IN VulkanDeviceObject *device, IN VulkanAllocatorObject *allocator, OPTIONAL IN VulkanPipelineCacheObject *cache, OUT VulkanComputeTracerObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanComputeTracerObject : public UnknownObject<_VulkanComputeTracerObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanComputeTracerObject;
+
+            explicit VulkanComputeTracerObject( const VulkanDeviceObject &device, const VulkanAllocatorObject &allocator,
+                                                const VulkanPipelineCacheObject *cache = nullptr )
+            {
+                check_tr_( new_vulkan_compute_tracer_object_override_device_and_allocator_and_cache( device.get(), allocator.get(),
+                                                                                                     cache ? cache->get() : nullptr, put() ) );
+            }
+
+            void LoadScene( const Scene &scene, const BVH &bvh ) const
+            {
+                check_tr_( get()->lpVtbl->LoadScene( get(), &scene, &bvh ) );
+            }
+
+            void Render( const RenderSettings &settings, float *out ) const
+            {
+                check_tr_( get()->lpVtbl->Render( get(), &settings, out ) );
+            }
+        };
+    }
+}
+#endif
+
+#endif
@@ -28,11 +28,18 @@
 #include <Object.h>
 #include <Types.h>
 
+#include <Core/Vulkan/VulkanInventory.h>
+#include <Core/Vulkan/VulkanQueue.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef struct _VulkanDeviceObject VulkanDeviceObject;
+typedef struct _VulkanObject VulkanObject;
+
+// Host allocations made by the Vulkan implementation, charged to MEMORY_TAG_VULKAN.
+extern const VkAllocationCallbacks VulkanAllocationCallbacks;
 
 typedef struct _VulkanDeviceInterface
 {
@@ -41,15 +48,46 @@ typedef struct _VulkanDeviceInterface
     IMPLEMENTS_UNKNOWNOBJECT( VulkanDeviceObject )
 
     /**
-     * @Method: TRBool VulkanObject::SupportsExtension( TRCString extension )
+     * @Method: TRBool VulkanDeviceObject::SupportsExtension( TRCString extension )
      * @Description: Checks if a device supports an extension. Returns true if so.
-     * @Status: Returns T_ERROR if a vulkan call fails.
+     *               Looked up in the instance's snapshot, without asking the driver.
+     * @Status: Always returns T_SUCCESS.
      */
     TR_STATUS (*SupportsExtension)(
         VulkanDeviceObject *iface,
         TRCString           extension,
         TRBool             *out);
 
+    /**
+     * @Method: VulkanQueueObject VulkanDeviceObject::GetQueue( VulkanQueueRole role )
+     * @Description: Gets the queue for a role. Compute and transfer get queues of their own
+     *               when the device has families for them, and share another role's
+     *               queue otherwise.
+     * @Status: Returns T_INVALIDARG for an unknown role.
+     */
+    TR_STATUS (*GetQueue)(
+        VulkanDeviceObject  *iface,
+        VulkanQueueRole      role,
+        VulkanQueueObject  **out);
+
+    /**
+     * @Method: VkDevice VulkanDeviceObject::Handle()
+     * @Description: Gets the logical device created with this object.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Handle)(
+        VulkanDeviceObject *iface,
+        VkDevice           *out);
+
+    /**
+     * @Method: const VulkanPhysicalDeviceInfo* VulkanDeviceObject::Info()
+     * @Description: Gets the snapshot of the physical device, valid as long as this object is.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Info)(
+        VulkanDeviceObject               *iface,
+        const VulkanPhysicalDeviceInfo  **out);
+
     END_INTERFACE
 } VulkanDeviceInterface;
 
@@ -60,7 +98,7 @@ com_interface _VulkanDeviceObject
 
 /**
  * @Object: VulkanDeviceObject
- * @Description: A Vulkan device that represents a physical GPU device.
+ * @Description: A logical Vulkan device on a physical GPU device, with its queues.
  */
 struct vulkan_device_object
 {
@@ -68,7 +106,12 @@ struct vulkan_device_object
     VulkanDeviceObject VulkanDeviceObject_iface;
 
     // --- Private Members --- //
-    VkPhysicalDevice device;
+    VulkanObject *instance;                         // Keeps the snapshot alive
+    const VulkanPhysicalDeviceInfo *info;
+    VkDevice device;
+    VulkanQueueSlot slots[VulkanQueueRole_Count];   // One per distinct VkQueue
+    TRUInt slotCount;
+    VulkanQueueSlot *roles[VulkanQueueRole_Count];
     ATOMIC(TRLong) ref;
 };
 
@@ -77,7 +120,7 @@ DEFINE_GUID( VulkanDeviceObject, 0xb054c6a8, 0x90a0, 0x4383, 0xbc, 0x88, 0x42, 0
 
 // Constructors
 // NOTE: This should not be called outside of a VulkanObject.
-TR_STATUS TR_API new_vulkan_device_object_override_device( IN VkPhysicalDevice device, OUT VulkanDeviceObject **out );
+TR_STATUS TR_API new_vulkan_device_object_override_device( IN VulkanObject *instance, IN const VulkanPhysicalDeviceInfo *info, OUT VulkanDeviceObject **out );
 
 #ifdef __cplusplus
 } // extern "C"
@@ -92,17 +135,34 @@ namespace TR
             using UnknownObject::UnknownObject;
             static constexpr const TRUUID &classId = IID_VulkanDeviceObject;
 
-            explicit VulkanDeviceObject( VkPhysicalDevice device )
-            {
-                check_tr_( new_vulkan_device_object_override_device( device, put() ) );
-            }
-
             TRBool SupportsExtension( const std::string& extension ) const
             {
                 TRBool out;
                 check_tr_( get()->lpVtbl->SupportsExtension( get(), extension.c_str(), &out ) );
                 return out;
             }
+
+            [[nodiscard]]
+            VulkanQueueObject GetQueue( VulkanQueueRole role ) const
+            {
+                _VulkanQueueObject *queue;
+                check_tr_( get()->lpVtbl->GetQueue( get(), role, &queue ) );
+                return VulkanQueueObject( queue );
+            }
+
+            VkDevice Handle() const noexcept
+            {
+                VkDevice out;
+                get()->lpVtbl->get_Handle( get(), &out );
+                return out;
+            }
+
+            const VulkanPhysicalDeviceInfo *Info() const noexcept
+            {
+                const VulkanPhysicalDeviceInfo *out;
+                get()->lpVtbl->get_Info( get(), &out );
+                return out;
+            }
         };
     }
 }
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANINVENTORY_H
+#define TRACERAYER_VULKANINVENTORY_H
+
+#include <vulkan/vulkan.h>
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Everything about one physical device, queried once when the instance is created
+ * and immutable afterwards, so devices can read it from any thread without asking
+ * the driver again. Extensions are indexed by an open addressing hash set.
+ */
+typedef struct _TR_VulkanPhysicalDeviceInfo
+{
+    VkPhysicalDevice Device;
+    VkPhysicalDeviceProperties Properties;          // Limits included
+    VkPhysicalDeviceFeatures Features;
+    VkPhysicalDeviceVulkan12Features Features12;    // Zeroed before Vulkan 1.2, pNext is cleared
+    VkPhysicalDeviceMemoryProperties Memory;
+
+    // Zeroed without VK_KHR_acceleration_structure, pNext is cleared
+    VkPhysicalDeviceAccelerationStructureFeaturesKHR AccelerationStructureFeatures;
+    VkPhysicalDeviceAccelerationStructurePropertiesKHR AccelerationStructureProperties;
+
+    VkQueueFamilyProperties *QueueFamilies;
+    TRUInt QueueFamilyCount;
+
+    VkExtensionProperties *Extensions;
+    TRUInt ExtensionCount;
+    TRUInt *ExtensionSet;                           // Extension index + 1, 0 for an empty bucket
+    TRUInt ExtensionSetMask;                        // Bucket count - 1, a power of two
+
+    TRULong DeviceLocalBytes;
+    TRBool AccelerationStructures;                  // Acceleration structure builds, with device addresses
+    TRBool RayTracing;                              // Ray tracing pipelines on top of acceleration structures
+    TRBool CalibratedTimestamps;                    // Device timestamps can be mapped onto CLOCK_MONOTONIC
+    TRULong Score;                                  // 0 if the device can not be used at all
+} VulkanPhysicalDeviceInfo;
+
+TR_STATUS TR_API VulkanInventoryCreate( IN VkInstance instance, OUT VulkanPhysicalDeviceInfo **devices, OUT TRUInt *count );
+void TR_API VulkanInventoryFree( IN VulkanPhysicalDeviceInfo *devices, IN TRUInt count );
+
+TRBool TR_API VulkanInventoryHasExtension( IN const VulkanPhysicalDeviceInfo *info, IN TRCString extension );
+
+// The highest scoring usable device, or T_NOINIT if there is none.
+TR_STATUS TR_API VulkanInventoryBest( IN const VulkanPhysicalDeviceInfo *devices, IN TRUInt count, OUT const VulkanPhysicalDeviceInfo **out );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
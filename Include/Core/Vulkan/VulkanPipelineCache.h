@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANPIPELINECACHE_H
+#define TRACERAYER_VULKANPIPELINECACHE_H
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Vulkan/VulkanDevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _VulkanPipelineCacheObject VulkanPipelineCacheObject;
+
+typedef struct _VulkanPipelineCacheInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanPipelineCacheObject )
+
+    /**
+     * @Method: VkPipelineCache VulkanPipelineCacheObject::Handle()
+     * @Description: Gets the cache to pass to every pipeline creation.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Handle)(
+        IN VulkanPipelineCacheObject *This,
+        OUT VkPipelineCache          *out );
+
+    /**
+     * @Method: TRSize VulkanPipelineCacheObject::LoadedSize()
+     * @Description: Gets the size of the blob loaded from disk, 0 on a cold start.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_LoadedSize)(
+        IN VulkanPipelineCacheObject *This,
+        OUT TRSize                   *out );
+
+    /**
+     * @Method: void VulkanPipelineCacheObject::Save()
+     * @Description: Writes the cache to disk when it grew since it was loaded or last saved.
+     *               The file is replaced atomically, a crash leaves the previous one intact.
+     * @Status: Returns T_ERROR if the file cannot be written.
+     */
+    TR_STATUS (*Save)(
+        IN VulkanPipelineCacheObject *This );
+
+    END_INTERFACE
+} VulkanPipelineCacheInterface;
+
+com_interface _VulkanPipelineCacheObject
+{
+    CONST_VTBL VulkanPipelineCacheInterface *lpVtbl;
+};
+
+/**
+ * @Object: VulkanPipelineCacheObject
+ * @Description: A VkPipelineCache persisted under $XDG_CACHE_HOME, one file per vendor,
+ *               device, driver version and pipeline cache UUID. Blobs whose header does
+ *               not match the device are never handed to the driver. Saved on release.
+ */
+struct vulkan_pipeline_cache_object
+{
+    // --- Public Members --- //
+    VulkanPipelineCacheObject VulkanPipelineCacheObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;
+    VkDevice handle;
+    VkPipelineCache cache;
+    TRString path;
+    TRSize loadedSize;
+    TRSize savedSize;                               // Of the blob on disk, to skip saving an unchanged cache
+    pthread_mutex_t lock;
+    ATOMIC(TRLong) ref;
+};
+
+// 844e213f-3e02-443e-8eb3-e0bc05028b47
+DEFINE_GUID( VulkanPipelineCacheObject, 0x844e213f, 0x3e02, 0x443e, 0x8e, 0xb3, 0xe0, 0xbc, 0x05, 0x02, 0x8b, 0x47 );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_pipeline_cache_object_override_device( IN VulkanDeviceObject *device, OUT VulkanPipelineCacheObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanPipelineCacheObject : public UnknownObject<_VulkanPipelineCacheObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanPipelineCacheObject;
+
+            explicit VulkanPipelineCacheObject( const VulkanDeviceObject &device )
+            {
+                check_tr_( new_vulkan_pipeline_cache_object_override_device( device.get(), put() ) );
+            }
+
+            VkPipelineCache Handle() const noexcept
+            {
+                VkPipelineCache out;
+                get()->lpVtbl->get_Handle( get(), &out );
+                return out;
+            }
+
+            TRSize LoadedSize() const noexcept
+            {
+                TRSize out;
+                get()->lpVtbl->get_LoadedSize( get(), &out );
+                return out;
+            }
+
+            void Save() const
+            {
+                check_tr_( get()->lpVtbl->Save( get() ) );
+            }
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANPROFILER_H
+#define TRACERAYER_VULKANPROFILER_H
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Instrumentation/Zones.h>
+#include <Core/Vulkan/VulkanDevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frames between recording a scope and reading it back, at least the frames in flight.
+#define VULKAN_PROFILER_LATENCY 3
+#define VULKAN_PROFILER_MAX_SCOPES 256              // Per frame, later scopes are not timed
+#define VULKAN_PROFILER_NO_SCOPE 0xFFFFFFFFu
+
+typedef struct _VulkanProfilerObject VulkanProfilerObject;
+
+typedef struct _TR_VulkanProfilerResult
+{
+    TRCString Name;
+    TRULong Start;                                  // ns on CLOCK_MONOTONIC, like zones
+    TRULong Duration;                               // ns
+} VulkanProfilerResult;
+
+typedef struct _TR_VulkanProfilerFrame
+{
+    TRCString Names[VULKAN_PROFILER_MAX_SCOPES];
+    ATOMIC(TRUInt) Count;                           // Scopes handed out, may exceed the maximum
+    TRULong CpuStart;                               // When BeginFrame was called
+    TRBool Active;                                  // Its queries were reset, scopes can be written
+} VulkanProfilerFrame;
+
+typedef struct _VulkanProfilerInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanProfilerObject )
+
+    /**
+     * @Method: void VulkanProfilerObject::BeginFrame( VkCommandBuffer commands )
+     * @Description: Reads back the frame recorded VULKAN_PROFILER_LATENCY frames ago, without
+     *               waiting for queries that are not done yet, and resets its queries in
+     *               commands. commands has to run before any scope of the new frame and
+     *               outside of a render pass.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*BeginFrame)(
+        IN VulkanProfilerObject *This,
+        IN VkCommandBuffer       commands );
+
+    /**
+     * @Method: TRUInt VulkanProfilerObject::BeginScope( VkCommandBuffer commands, TRCString name )
+     * @Description: Writes the timestamp starting a scope. name has to be a string literal.
+     *               Safe to call from any thread recording for the queue.
+     * @Status: Always returns T_SUCCESS. The scope is VULKAN_PROFILER_NO_SCOPE when the queue has
+     *          no timestamps or the frame has too many scopes, EndScope ignores it.
+     */
+    TR_STATUS (*BeginScope)(
+        IN VulkanProfilerObject *This,
+        IN VkCommandBuffer       commands,
+        IN TRCString             name,
+        OUT TRUInt              *scope );
+
+    /**
+     * @Method: void VulkanProfilerObject::EndScope( VkCommandBuffer commands, TRUInt scope )
+     * @Description: Writes the timestamp ending a scope, after all previous commands are done.
+     */
+    void (*EndScope)(
+        IN VulkanProfilerObject *This,
+        IN VkCommandBuffer       commands,
+        IN TRUInt                scope );
+
+    /**
+     * @Method: TRUInt VulkanProfilerObject::Results( VulkanProfilerResult *out, TRUInt capacity )
+     * @Description: Copies the scopes of the last frame read back, in the order they began.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*GetResults)(
+        IN VulkanProfilerObject *This,
+        OUT VulkanProfilerResult *out,
+        IN TRUInt                capacity,
+        OUT TRUInt              *count );
+
+    END_INTERFACE
+} VulkanProfilerInterface;
+
+com_interface _VulkanProfilerObject
+{
+    CONST_VTBL VulkanProfilerInterface *lpVtbl;
+};
+
+/**
+ * @Object: VulkanProfilerObject
+ * @Description: Times named scopes on one queue with timestamp queries and records them
+ *               to the zone trace, on a track of their own. Without calibrated timestamps a
+ *               frame's scopes are lined up with the time BeginFrame was called, so their
+ *               lengths are exact but their position against CPU zones is not.
+ */
+struct vulkan_profiler_object
+{
+    // --- Public Members --- //
+    VulkanProfilerObject VulkanProfilerObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;
+    VkDevice handle;
+    VkQueryPool pool;
+    TRBool enabled;                                 // False when the queue family has no timestamps
+    TRULong validMask;                              // Of timestampValidBits, timestamps wrap past it
+    TRFloat period;                                 // ns per tick
+    PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps;
+
+    VulkanProfilerFrame frames[VULKAN_PROFILER_LATENCY];
+    TRUInt current;
+    VulkanProfilerResult results[VULKAN_PROFILER_MAX_SCOPES];
+    TRUInt resultCount;
+    ZoneTrack *track;
+    pthread_mutex_t lock;
+    ATOMIC(TRLong) ref;
+};
+
+// 53d1b355-3868-4744-a919-59d6447058ee
+DEFINE_GUID( VulkanProfilerObject, 0x53d1b355, 0x3868, 0x4744, 0xa9, 0x19, 0x59, 0xd6, 0x44, 0x70, 0x58, 0xee );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_profiler_object_override_device_and_queue( IN VulkanDeviceObject *device, IN VulkanQueueObject *queue, IN TRCString name, OUT VulkanProfilerObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanProfilerObject : public UnknownObject<_VulkanProfilerObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanProfilerObject;
+
+            explicit VulkanProfilerObject( const VulkanDeviceObject &device, const VulkanQueueObject &queue, TRCString name )
+            {
+                check_tr_( new_vulkan_profiler_object_override_device_and_queue( device.get(), queue.get(), name, put() ) );
+            }
+
+            void BeginFrame( VkCommandBuffer commands ) const noexcept
+            {
+                get()->lpVtbl->BeginFrame( get(), commands );
+            }
+
+            TRUInt BeginScope( VkCommandBuffer commands, TRCString name ) const noexcept
+            {
+                TRUInt out;
+                get()->lpVtbl->BeginScope( get(), commands, name, &out );
+                return out;
+            }
+
+            void EndScope( VkCommandBuffer commands, TRUInt scope ) const noexcept
+            {
+                get()->lpVtbl->EndScope( get(), commands, scope );
+            }
+
+            TRUInt Results( VulkanProfilerResult *out, TRUInt capacity ) const noexcept
+            {
+                TRUInt count;
+                get()->lpVtbl->GetResults( get(), out, capacity, &count );
+                return count;
+            }
+        };
+
+        // Times the commands recorded during its lifetime.
+        class ScopedGpuZone
+        {
+        public:
+            ScopedGpuZone( const VulkanProfilerObject &profiler, VkCommandBuffer commands, TRCString name ) noexcept
+                : profiler_( profiler ), commands_( commands ), scope_( profiler.BeginScope( commands, name ) )
+            {
+            }
+
+            ~ScopedGpuZone()
+            {
+                profiler_.EndScope( commands_, scope_ );
+            }
+
+            ScopedGpuZone( const ScopedGpuZone & ) = delete;
+            ScopedGpuZone &operator=( const ScopedGpuZone & ) = delete;
+
+        private:
+            const VulkanProfilerObject &profiler_;
+            VkCommandBuffer commands_;
+            TRUInt scope_;
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANQUEUE_H
+#define TRACERAYER_VULKANQUEUE_H
+
+#include <pthread.h>
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _VulkanQueueObject VulkanQueueObject;
+typedef struct _VulkanDeviceObject VulkanDeviceObject;
+
+typedef enum _VulkanQueueRole
+{
+    VulkanQueueRole_Graphics,
+    VulkanQueueRole_Compute,                        // Async compute, BVH builds and denoising
+    VulkanQueueRole_Transfer,                       // DMA uploads
+    VulkanQueueRole_Count
+} VulkanQueueRole;
+
+/**
+ * One VkQueue of a logical device. Vulkan requires external synchronization for
+ * every call on a queue, so all queue objects sharing a slot share its lock, which
+ * is the case when a role has to fall back to another role's queue.
+ */
+typedef struct _TR_VulkanQueueSlot
+{
+    VkQueue Queue;
+    TRUInt Family;
+    TRUInt Index;
+    pthread_mutex_t Lock;
+} VulkanQueueSlot;
+
+typedef struct _VulkanQueueInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanQueueObject )
+
+    /**
+     * @Method: void VulkanQueueObject::Submit( const VkSubmitInfo *submits, TRUInt count, VkFence fence )
+     * @Description: Submits command buffers to the queue. Safe to call from any thread.
+     * @Status: Returns T_ERROR if vkQueueSubmit fails.
+     */
+    TR_STATUS (*Submit)(
+        IN VulkanQueueObject   *This,
+        IN const VkSubmitInfo  *submits,
+        IN TRUInt               count,
+        IN VkFence              fence );
+
+    /**
+     * @Method: void VulkanQueueObject::WaitIdle()
+     * @Description: Blocks until everything submitted to the queue has finished.
+     * @Status: Returns T_ERROR if vkQueueWaitIdle fails.
+     */
+    TR_STATUS (*WaitIdle)(
+        IN VulkanQueueObject *This );
+
+    /**
+     * @Method: VkResult VulkanQueueObject::Present( const VkPresentInfoKHR *present )
+     * @Description: Queues swapchain images for presentation. Safe to call from any thread.
+     *               result gets the VkResult, VK_SUBOPTIMAL_KHR and VK_ERROR_OUT_OF_DATE_KHR
+     *               ask for the swapchain to be recreated.
+     * @Status: Returns T_ERROR if vkQueuePresentKHR fails for another reason.
+     */
+    TR_STATUS (*Present)(
+        IN VulkanQueueObject       *This,
+        IN const VkPresentInfoKHR  *present,
+        OPTIONAL OUT VkResult      *result );
+
+    /**
+     * @Method: TRUInt VulkanQueueObject::FamilyIndex()
+     * @Description: Gets the queue family, for ownership transfers and command pools.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_FamilyIndex)(
+        IN VulkanQueueObject *This,
+        OUT TRUInt           *out );
+
+    END_INTERFACE
+} VulkanQueueInterface;
+
+com_interface _VulkanQueueObject
+{
+    CONST_VTBL VulkanQueueInterface *lpVtbl;
+};
+
+/**
+ * @Object: VulkanQueueObject
+ * @Description: A thread-safe handle to one of the queues of a VulkanDeviceObject.
+ */
+struct vulkan_queue_object
+{
+    // --- Public Members --- //
+    VulkanQueueObject VulkanQueueObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;                     // Owns the slot
+    VulkanQueueSlot *slot;
+    ATOMIC(TRLong) ref;
+};
+
+// c53ca0c4-12a0-4836-81b4-e1567773a268
+DEFINE_GUID( VulkanQueueObject, 0xc53ca0c4, 0x12a0, 0x4836, 0x81, 0xb4, 0xe1, 0x56, 0x77, 0x73, 0xa2, 0x68 );
+
+// Constructors
+// NOTE: This should not be called outside of a VulkanDeviceObject.
+TR_STATUS TR_API new_vulkan_queue_object_override_device_and_slot( IN VulkanDeviceObject *device, IN VulkanQueueSlot *slot, OUT VulkanQueueObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanQueueObject : public UnknownObject<_VulkanQueueObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanQueueObject;
+
+            void Submit( const VkSubmitInfo *submits, TRUInt count, VkFence fence = VK_NULL_HANDLE ) const
+            {
+                check_tr_( get()->lpVtbl->Submit( get(), submits, count, fence ) );
+            }
+
+            void WaitIdle() const
+            {
+                check_tr_( get()->lpVtbl->WaitIdle( get() ) );
+            }
+
+            VkResult Present( const VkPresentInfoKHR &present ) const
+            {
+                VkResult result;
+                check_tr_( get()->lpVtbl->Present( get(), &present, &result ) );
+                return result;
+            }
+
+            TRUInt FamilyIndex() const noexcept
+            {
+                TRUInt out;
+                get()->lpVtbl->get_FamilyIndex( get(), &out );
+                return out;
+            }
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANSTAGING_H
+#define TRACERAYER_VULKANSTAGING_H
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Async/AsyncOperation.h>
+#include <Core/Vulkan/VulkanAllocator.h>
+#include <Core/Vulkan/VulkanDevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Copies recorded into one command buffer, up to this many of them in flight.
+#define VULKAN_STAGING_BATCH_COUNT 4
+#define VULKAN_STAGING_DEFAULT_SIZE (64ull * 1024ull * 1024ull)
+
+typedef struct _VulkanStagingObject VulkanStagingObject;
+
+typedef struct _TR_VulkanStagingBatch
+{
+    VkCommandBuffer Commands;
+    TRULong Value;                                  // Timeline value signalled once its copies are done
+    VkDeviceSize Start;                             // Ring offset of its first copy
+    TRUInt Copies;
+    TRBool Recording;
+} VulkanStagingBatch;
+
+typedef struct _TR_VulkanStagingStatistics
+{
+    TRULong Bytes;
+    TRULong Copies;
+    TRULong Submits;
+    TRULong Stalls;                                 // Writes that had to wait for the device to free ring space
+    TRFloat MegabytesPerSecond;                     // From the first copy to the last completion seen
+} VulkanStagingStatistics;
+
+typedef struct _VulkanStagingInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanStagingObject )
+
+    /**
+     * @Method: void VulkanStagingObject::UploadBuffer( VkBuffer destination, VkDeviceSize offset, const void *data, VkDeviceSize size )
+     * @Description: Copies data into the ring and records a copy into the current batch. Data larger
+     *               than half the ring is split. Blocks only when the ring is full of copies
+     *               the device has not finished yet. Safe to call from any thread.
+     * @Status: Returns T_ERROR if a vulkan call fails.
+     */
+    TR_STATUS (*UploadBuffer)(
+        IN VulkanStagingObject *This,
+        IN VkBuffer             destination,
+        IN VkDeviceSize         offset,
+        IN const void          *data,
+        IN VkDeviceSize         size );
+
+    /**
+     * @Method: void VulkanStagingObject::UploadImage( VkImage destination, const VkBufferImageCopy *region, const void *data, VkDeviceSize size )
+     * @Description: Like UploadBuffer, into an image already in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+     *               The region's bufferOffset is filled in.
+     * @Status: Returns T_INVALIDARG if the data is larger than half the ring.
+     */
+    TR_STATUS (*UploadImage)(
+        IN VulkanStagingObject      *This,
+        IN VkImage                   destination,
+        IN const VkBufferImageCopy  *region,
+        IN const void               *data,
+        IN VkDeviceSize              size );
+
+    /**
+     * @Method: AsyncOperationObject VulkanStagingObject::Flush()
+     * @Description: Submits the current batch on the transfer queue. The operation completes once
+     *               every copy recorded so far has landed, with the batch's timeline value as its
+     *               result. out may be nullptr when nobody waits for it.
+     * @Status: Returns T_ERROR if the submission fails.
+     */
+    TR_STATUS (*Flush)(
+        IN VulkanStagingObject      *This,
+        OUT AsyncOperationObject   **out );
+
+    /**
+     * @Method: VulkanStagingStatistics VulkanStagingObject::Statistics()
+     * @Description: Gets the bytes, copies, submits and stalls since creation or the last reset.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Statistics)(
+        IN VulkanStagingObject      *This,
+        OUT VulkanStagingStatistics *out );
+
+    /**
+     * @Method: void VulkanStagingObject::ResetStatistics()
+     * @Description: Starts counting again, e.g. at the start of a scene load.
+     */
+    void (*ResetStatistics)(
+        IN VulkanStagingObject *This );
+
+    END_INTERFACE
+} VulkanStagingInterface;
+
+com_interface _VulkanStagingObject
+{
+    CONST_VTBL VulkanStagingInterface *lpVtbl;
+};
+
+/**
+ * @Object: VulkanStagingObject
+ * @Description: A persistently mapped, host coherent ring buffer streaming uploads through
+ *               the transfer queue. A timeline semaphore tells which parts of the ring the
+ *               device is done with. Destinations are written from the transfer queue family
+ *               and no ownership transfer is recorded, so they must be created with
+ *               VK_SHARING_MODE_CONCURRENT across it and the families that use them, unless
+ *               the transfer queue shares their family.
+ */
+struct vulkan_staging_object
+{
+    // --- Public Members --- //
+    VulkanStagingObject VulkanStagingObject_iface;
+
+    // --- Private Members --- //
+    VulkanDeviceObject *device;
+    VulkanAllocatorObject *allocator;
+    VulkanQueueObject *queue;
+    VkDevice handle;
+
+    VkBuffer buffer;
+    VulkanAllocation memory;
+    VkDeviceSize size;
+    VkDeviceSize alignment;
+    VkDeviceSize head;                              // Where the next copy goes
+    VkDeviceSize tail;                              // Start of the oldest data the device may still read
+    TRBool empty;
+
+    VkCommandPool pool;
+    VkSemaphore timeline;
+    VulkanStagingBatch batches[VULKAN_STAGING_BATCH_COUNT];
+    TRUInt current;
+    TRULong submitted;
+    TRULong completed;
+
+    VulkanStagingStatistics statistics;
+    TRULong firstCopy;
+    TRULong lastCompletion;
+    pthread_mutex_t lock;
+    ATOMIC(TRLong) ref;
+};
+
+// f05f499a-baf6-4533-aaff-9d9ae5994796
+DEFINE_GUID( VulkanStagingObject, 0xf05f499a, 0xbaf6, 0x4533, 0xaa, 0xff, 0x9d, 0x9a, 0xe5, 0x99, 0x47, 0x96 );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_staging_object_override_device_and_allocator_and_size( IN VulkanDeviceObject *device, IN VulkanAllocatorObject *allocator, IN VkDeviceSize size, OUT VulkanStagingObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanStagingObject : public UnknownObject<_VulkanStagingObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanStagingObject;
+
+            explicit VulkanStagingObject( const VulkanDeviceObject &device, const VulkanAllocatorObject &allocator,
+                                          VkDeviceSize size = VULKAN_STAGING_DEFAULT_SIZE )
+            {
+                check_tr_( new_vulkan_staging_object_override_device_and_allocator_and_size( device.get(), allocator.get(), size, put() ) );
+            }
+
+            void UploadBuffer( VkBuffer destination, VkDeviceSize offset, const void *data, VkDeviceSize size ) const
+            {
+                check_tr_( get()->lpVtbl->UploadBuffer( get(), destination, offset, data, size ) );
+            }
+
+            void UploadImage( VkImage destination, const VkBufferImageCopy &region, const void *data, VkDeviceSize size ) const
+            {
+                check_tr_( get()->lpVtbl->UploadImage( get(), destination, &region, data, size ) );
+            }
+
+            [[nodiscard]]
+            Async::AsyncOperationObject Flush() const
+            {
+                _AsyncOperationObject *out;
+                check_tr_( get()->lpVtbl->Flush( get(), &out ) );
+                return Async::AsyncOperationObject( out );
+            }
+
+            VulkanStagingStatistics Statistics() const noexcept
+            {
+                VulkanStagingStatistics out;
+                get()->lpVtbl->get_Statistics( get(), &out );
+                return out;
+            }
+
+            void ResetStatistics() const noexcept
+            {
+                get()->lpVtbl->ResetStatistics( get() );
+            }
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_VULKANSWAPCHAIN_H
+#define TRACERAYER_VULKANSWAPCHAIN_H
+
+#include <pthread.h>
+
+#include <vulkan/vulkan.h>
+
+#include <Object.h>
+#include <Types.h>
+
+#include <Core/Vulkan/Vulkan.h>
+#include <Core/Vulkan/VulkanDevice.h>
+#include <UI/Representation.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VULKAN_SWAPCHAIN_DEFAULT_FRAMES 2
+#define VULKAN_SWAPCHAIN_MAX_FRAMES 3               // VULKAN_PROFILER_LATENCY covers this many
+
+typedef struct _VulkanSwapchainObject VulkanSwapchainObject;
+
+typedef enum _VulkanPresentMode
+{
+    VulkanPresentMode_Fifo,                         // Waits for vblank, always supported
+    VulkanPresentMode_Mailbox,                      // Replaces the queued image, no tearing
+    VulkanPresentMode_Immediate                     // Tears, lowest latency
+} VulkanPresentMode;
+
+typedef struct _TR_VulkanSwapchainSettings
+{
+    TRUInt Width;                                   // Used when the surface leaves the size to the swapchain, as on Wayland
+    TRUInt Height;
+    TRUInt FramesInFlight;                          // 0 for VULKAN_SWAPCHAIN_DEFAULT_FRAMES
+    VulkanPresentMode PresentMode;                  // Falls back to FIFO if unsupported
+} VulkanSwapchainSettings;
+
+/**
+ * One acquired image. Submissions writing Image wait on Acquired, the last one signals
+ * Rendered and Fence. Fence has to be signaled by a submission before the frame comes
+ * around again, otherwise the next acquire of its slot blocks forever.
+ */
+typedef struct _TR_VulkanSwapchainFrame
+{
+    TRUInt Frame;                                   // Slot, below the frames in flight
+    TRUInt ImageIndex;
+    VkImage Image;
+    VkImageView View;
+    VkFormat Format;
+    VkExtent2D Extent;
+    VkSemaphore Acquired;
+    VkSemaphore Rendered;
+    VkFence Fence;
+} VulkanSwapchainFrame;
+
+typedef struct _VulkanSwapchainInterface
+{
+    BEGIN_INTERFACE
+
+    IMPLEMENTS_UNKNOWNOBJECT( VulkanSwapchainObject )
+
+    /**
+     * @Method: VulkanSwapchainFrame VulkanSwapchainObject::AcquireFrame()
+     * @Description: Waits until the next frame slot is free and acquires an image for it,
+     *               recreating the swapchain first if the window was resized or the old one
+     *               went out of date. Acquire and Present from a single thread.
+     * @Status: Returns T_NOINIT while the window has no area, skip the frame then. Returns
+     *          T_ERROR if a vulkan call fails.
+     */
+    TR_STATUS (*AcquireFrame)(
+        IN VulkanSwapchainObject   *This,
+        OUT VulkanSwapchainFrame   *out );
+
+    /**
+     * @Method: void VulkanSwapchainObject::Present( const VulkanSwapchainFrame *frame )
+     * @Description: Presents an acquired frame once Rendered is signaled and moves on to
+     *               the next slot. A suboptimal or out of date swapchain is recreated by
+     *               the next AcquireFrame.
+     * @Status: Returns T_INVALIDARG for a frame that is not the acquired one and T_ERROR
+     *          if presentation fails.
+     */
+    TR_STATUS (*Present)(
+        IN VulkanSwapchainObject       *This,
+        IN const VulkanSwapchainFrame  *frame );
+
+    /**
+     * @Method: void VulkanSwapchainObject::Resize( TRUInt width, TRUInt height )
+     * @Description: Recreates the swapchain at the next AcquireFrame. Safe to call from any
+     *               thread, meant for the window's OnResize event.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*Resize)(
+        IN VulkanSwapchainObject   *This,
+        IN TRUInt                   width,
+        IN TRUInt                   height );
+
+    /**
+     * @Method: VkExtent2D VulkanSwapchainObject::Extent()
+     * @Description: Gets the size of the current images, which may differ from the last
+     *               Resize until the next AcquireFrame.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_Extent)(
+        IN VulkanSwapchainObject   *This,
+        OUT VkExtent2D             *out );
+
+    /**
+     * @Method: VulkanPresentMode VulkanSwapchainObject::PresentMode()
+     * @Description: Gets the present mode in use, FIFO if the requested one is unsupported.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*get_PresentMode)(
+        IN VulkanSwapchainObject   *This,
+        OUT VulkanPresentMode      *out );
+
+    END_INTERFACE
+} VulkanSwapchainInterface;
+
+com_interface _VulkanSwapchainObject
+{
+    CONST_VTBL VulkanSwapchainInterface *lpVtbl;
+};
+
+typedef struct _TR_VulkanSwapchainImage
+{
+    VkImage Image;
+    VkImageView View;
+    VkSemaphore Rendered;                           // Per image, presentation may still wait on it when the slot comes back
+    VkFence Fence;                                  // Of the slot that last acquired it, or VK_NULL_HANDLE
+} VulkanSwapchainImage;
+
+typedef struct _TR_VulkanSwapchainSlot
+{
+    VkSemaphore Acquired;
+    VkFence Fence;                                  // Created signaled
+} VulkanSwapchainSlot;
+
+/**
+ * @Object: VulkanSwapchainObject
+ * @Description: A swapchain on the surface of a UI window, presented from the graphics
+ *               queue so rendered images never leave the GPU. Keeps a fixed number of
+ *               frames in flight, each slot with its own fence.
+ */
+struct vulkan_swapchain_object
+{
+    // --- Public Members --- //
+    VulkanSwapchainObject VulkanSwapchainObject_iface;
+
+    // --- Private Members --- //
+    VulkanObject *instance;                         // Owns the surface
+    VulkanDeviceObject *device;
+    VulkanQueueObject *queue;
+    VkPhysicalDevice physical;
+    VkDevice handle;
+    VkSurfaceKHR surface;
+    VkSwapchainKHR swapchain;
+
+    VulkanSwapchainImage *images;
+    TRUInt imageCount;
+    VkFormat format;
+    VkExtent2D extent;
+    VulkanPresentMode mode;
+    VulkanPresentMode requestedMode;
+
+    VulkanSwapchainSlot slots[VULKAN_SWAPCHAIN_MAX_FRAMES];
+    TRUInt slotCount;
+    TRUInt slot;                                    // Of the next AcquireFrame
+    TRUInt acquired;                                // Image acquired for slot, UINT32_MAX if none
+    TRBool stale;                                   // Suboptimal or out of date
+
+    pthread_mutex_t lock;                           // Guards the size Resize asks for
+    VkExtent2D requested;
+    TRBool resized;
+    ATOMIC(TRLong) ref;
+};
+
+// 810aa8c8-1ad3-408f-9d27-8208532bd4b6
+DEFINE_GUID( VulkanSwapchainObject, 0x810aa8c8, 0x1ad3, 0x408f, 0x9d, 0x27, 0x82, 0x08, 0x53, 0x2b, 0xd4, 0xb6 );
+
+// Constructors
+TR_STATUS TR_API new_vulkan_swapchain_object_override_instance_and_device_and_window( IN VulkanObject *instance, IN VulkanDeviceObject *device, IN const WindowRepresentation *window, IN const VulkanSwapchainSettings *settings, OUT VulkanSwapchainObject **out );
+
+#ifdef __cplusplus
+} // extern "C"
+
+namespace TR
+{
+    namespace Core::Vulkan
+    {
+        class VulkanSwapchainObject : public UnknownObject<_VulkanSwapchainObject>
+        {
+        public:
+            using UnknownObject::UnknownObject;
+            static constexpr const TRUUID &classId = IID_VulkanSwapchainObject;
+
+            explicit VulkanSwapchainObject( const VulkanObject &instance, const VulkanDeviceObject &device,
+                                            const WindowRepresentation &window, const VulkanSwapchainSettings &settings )
+            {
+                check_tr_( new_vulkan_swapchain_object_override_instance_and_device_and_window( instance.get(), device.get(),
+                                                                                                 &window, &settings, put() ) );
+            }
+
+            // False while the window has no area.
+            bool AcquireFrame( VulkanSwapchainFrame &frame ) const
+            {
+                const TR_STATUS status = get()->lpVtbl->AcquireFrame( get(), &frame );
+                if ( status == T_NOINIT ) return false;
+                check_tr_( status );
+                return true;
+            }
+
+            void Present( const VulkanSwapchainFrame &frame ) const
+            {
+                check_tr_( get()->lpVtbl->Present( get(), &frame ) );
+            }
+
+            void Resize( TRUInt width, TRUInt height ) const noexcept
+            {
+                get()->lpVtbl->Resize( get(), width, height );
+            }
+
+            VkExtent2D Extent() const noexcept
+            {
+                VkExtent2D out;
+                get()->lpVtbl->get_Extent( get(), &out );
+                return out;
+            }
+
+            VulkanPresentMode PresentMode() const noexcept
+            {
+                VulkanPresentMode out;
+                get()->lpVtbl->get_PresentMode( get(), &out );
+                return out;
+            }
+        };
+    }
+}
+#endif
+
+#endif
@@ -32,6 +32,21 @@ typedef struct _TR_GlobalArguments
     TRLong LogLevel;
     TRPath *LogFile;
     TRBool ColoredTerminalOutput;
+    TRLong LogMaxSize;          // MiB per log segment, 0 disables size based rotation
+    TRLong LogMaxSegments;      // Closed segments to keep, 0 keeps all of them
+    TRLong LogRotateInterval;   // Seconds per log segment, 0 disables time based rotation
+    TRString LogFsync;          // never, interval or on-error
+    TRBool LogDirectIO;
+    TRBool LogCompress;
+    TRLong TraceRate;           // TRACE messages per second and call site, 0 disables rate limiting
+    TRLong TraceBurst;
+    TRLong TraceSample;         // Only let 1 in N TRACE messages per call site through
+    TRString TraceOut;          // Chrome trace JSON written at exit, nullptr disables zone recording
+    TRBool PerfCounters;        // Hardware counters per TR_PERF_PHASE, reported at exit
+    TRBool StartupProfile;      // Wall time of every startup phase, reported once startup finished
+    TRString BenchmarkStartup;  // Startup marks written here as JSON, then the application quits
+    TRString BenchmarkRender;   // Compute tracer against the CPU reference, written here as JSON before the UI starts
+    TRString BenchmarkRecording; // Parallel command recording per thread count, written here as JSON before the UI starts
 } GlobalArguments;
 
 extern GlobalArguments GlobalArgumentsDefault;
@@ -78,6 +93,66 @@ static Argument Available_Arguments[] =
     {
         .Name         = "colored-terminal-output",
         .ValueType   = TYPE_BOOL
+    },
+    {
+        .Name         = "log-max-size",
+        .ValueType    = TYPE_LONG
+    },
+    {
+        .Name         = "log-max-segments",
+        .ValueType    = TYPE_LONG
+    },
+    {
+        .Name         = "log-rotate-interval",
+        .ValueType    = TYPE_LONG
+    },
+    {
+        .Name         = "log-fsync",
+        .ValueType    = TYPE_STRING
+    },
+    {
+        .Name         = "log-direct-io",
+        .ValueType    = TYPE_BOOL
+    },
+    {
+        .Name         = "log-compress",
+        .ValueType    = TYPE_BOOL
+    },
+    {
+        .Name         = "trace-rate",
+        .ValueType    = TYPE_LONG
+    },
+    {
+        .Name         = "trace-burst",
+        .ValueType    = TYPE_LONG
+    },
+    {
+        .Name         = "trace-sample",
+        .ValueType    = TYPE_LONG
+    },
+    {
+        .Name         = "trace-out",
+        .ValueType    = TYPE_STRING
+    },
+    {
+        .Name         = "perf-counters",
+        .ValueType    = TYPE_BOOL
+    },
+    {
+        .Name         = "startup-profile",
+        .ValueType    = TYPE_BOOL
+    },
+    {
+        .Name         = "benchmark-startup",
+        .ValueType    = TYPE_STRING
+    },
+    {
+        .Name         = "benchmark-render",
+        .ValueType    = TYPE_STRING
+    },
+    {
+        .Name         = "benchmark-recording",
+        .ValueType    = TYPE_STRING
     }
 };
 
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_LOGSINK_H
+#define TRACERAYER_LOGSINK_H
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _TR_LogFsyncPolicy
+{
+    LOG_FSYNC_NEVER = 0,
+    LOG_FSYNC_INTERVAL = 1,
+    LOG_FSYNC_ON_ERROR = 2,
+} LogFsyncPolicy;
+
+typedef struct _TR_LogSinkOptions
+{
+    TRSize BufferSize;          // Size of each of the two write buffers, rounded up to the I/O alignment.
+    TRSize MaxSegmentSize;      // Rotate once the active segment grows past this. 0 disables size rotation.
+    TRLong RotateInterval;      // Rotate after this many seconds. 0 disables time rotation.
+    TRUInt MaxSegments;         // Closed segments kept next to the active one. 0 keeps everything.
+    LogFsyncPolicy FsyncPolicy;
+    TRLong FsyncInterval;       // Seconds between syncs for LOG_FSYNC_INTERVAL.
+    TRBool DirectIO;            // Bypass the page cache with O_DIRECT when the file system allows it.
+    TRBool Compress;            // gzip closed segments in the background.
+} LogSinkOptions;
+
+typedef struct _TR_LogSink LogSink;
+
+/**
+ * A log sink owns a background writer thread. Records are appended to an aligned
+ * in-memory buffer and never wait on disk I/O. When both buffers are in flight the
+ * record is dropped and counted, and a notice is written once the writer catches up.
+ */
+TR_STATUS OpenLogSink( IN TRCString location, IN const LogSinkOptions *options, OUT LogSink **out );
+TR_STATUS WriteLogSink( IN LogSink *sink, IN TRCString message, IN TRSize length, IN TRBool urgent );
+TR_STATUS FlushLogSink( IN LogSink *sink );
+void CloseLogSink( IN LogSink *sink );
+
+TR_STATUS ParseLogFsyncPolicy( IN TRCString name, OUT LogFsyncPolicy *out );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //TRACERAYER_LOGSINK_H
@@ -53,8 +53,27 @@ typedef struct _TR_Log_Token
     Log_Category Category;
 } Log_Token;
 
+/**
+ * Per call site state of a TRACE statement. Each site gets its own token
+ * bucket (GCRA, so a single atomic timestamp) and 1-in-N sampling counter.
+ * Messages that don't pass either are counted, and the count is summarised
+ * the next time the site is let through (or at exit).
+ */
+typedef struct _TR_Log_Site
+{
+    ATOMIC(TRULong) ArrivalTime;    // Theoretical arrival time of the next message, in ns
+    ATOMIC(TRULong) Counter;
+    ATOMIC(TRULong) Suppressed;
+    ATOMIC(TRULong) LastSummary;
+    ATOMIC(TRBool) Registered;
+    TRCString Module;
+    TRCString Function;
+    struct _TR_Log_Site *Next;
+} Log_Site;
+
 TR_STATUS TR_API InitializeLogging();
 void TR_API TraceRayer_DEBUG( IN Log_Category category, IN pid_t threadId, IN TRCString module, IN TRCString function, IN TRCString fmt, ... );
+TRBool TR_API AdmitLogSite( IN Log_Site *site, IN TRCString module, IN TRCString function );
 
 #define INFO(message, ...) \
     TraceRayer_DEBUG( LOG_CATEGORY_INFO, gettid(), __FILENAME__, __FUNCTION__, message, ##__VA_ARGS__)
@@ -65,8 +84,14 @@ void TR_API TraceRayer_DEBUG( IN Log_Category category, IN pid_t threadId, IN TR
 #define ERROR(message, ...) \
     TraceRayer_DEBUG( LOG_CATEGORY_ERROR, gettid(), __FILENAME__, __FUNCTION__, message, ##__VA_ARGS__)
 
+// The arguments are only evaluated for messages that get through the site's rate limit.
 #define TRACE(message, ...) \
-    TraceRayer_DEBUG( LOG_CATEGORY_TRACE, gettid(), __FILENAME__, __FUNCTION__, message, ##__VA_ARGS__)
+    do                                                                                                  \
+    {                                                                                                   \
+        static Log_Site _traceSite = {};                                                                \
+        if ( AdmitLogSite( &_traceSite, __FILENAME__, __FUNCTION__ ) )                                  \
+            TraceRayer_DEBUG( LOG_CATEGORY_TRACE, gettid(), __FILENAME__, __FUNCTION__, message, ##__VA_ARGS__); \
+    } while ( 0 )
 
 // Critical Exceptions
 // TODO: Implement unified throw routine
@@ -51,6 +51,7 @@ typedef struct _TR_Path
 
 TR_STATUS FetchPath( IN TRString path, IN TRBool create, IN AccessType accessType, OUT TRPath **pathObject );
 TR_STATUS FetchSubpath( IN TRPath *pathObject, IN TRString name, IN TRBool create, IN AccessType accessType, OUT TRPath **outPath );
+void FreePath( IN TRPath *pathObject );
 
 #ifdef __cplusplus
 } // extern "C"
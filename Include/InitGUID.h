@@ -44,5 +44,14 @@
 #include <Core/Async/AsyncState.h>      /** IID_AsyncStateObject **/
 #include <Core/Vulkan/Vulkan.h>         /** IID_VulkanObject **/
 #include <Core/Vulkan/VulkanDevice.h>   /** IID_VulkanDeviceObject **/
+#include <Core/Vulkan/VulkanQueue.h>    /** IID_VulkanQueueObject **/
+#include <Core/Vulkan/VulkanAllocator.h> /** IID_VulkanAllocatorObject **/
+#include <Core/Vulkan/VulkanStaging.h>  /** IID_VulkanStagingObject **/
+#include <Core/Vulkan/VulkanPipelineCache.h> /** IID_VulkanPipelineCacheObject **/
+#include <Core/Vulkan/VulkanProfiler.h> /** IID_VulkanProfilerObject **/
+#include <Core/Vulkan/VulkanComputeTracer.h> /** IID_VulkanComputeTracerObject **/
+#include <Core/Vulkan/VulkanAccelerationStructure.h> /** IID_VulkanAccelerationStructureObject **/
+#include <Core/Vulkan/VulkanSwapchain.h> /** IID_VulkanSwapchainObject **/
+#include <Core/Vulkan/VulkanCommandRecorder.h> /** IID_VulkanCommandRecorderObject **/
 
 #endif
\ No newline at end of file
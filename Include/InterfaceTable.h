@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_INTERFACETABLE_H
+#define TRACERAYER_INTERFACETABLE_H
+
+#include <stddef.h>
+
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Every DEFINE_GUID is interned into a small integer by a constructor emitted under
+ * INITGUID, so QueryInterface only hashes the uuid once and indexes the class table
+ * with the result instead of running a chain of uuid_compare() calls.
+ */
+#define INTERFACE_ID_INVALID 0
+#define INTERFACE_ID_MAX 64
+
+typedef enum _TR_InterfaceKind
+{
+    INTERFACE_KIND_SELF,        // The interface is embedded in the object at Offset
+    INTERFACE_KIND_MEMBER,      // Offset holds a pointer to an aggregated object implementing it
+    INTERFACE_KIND_FORWARD      // Offset holds a pointer to an aggregated object that is asked in turn
+} InterfaceKind;
+
+typedef struct _TR_InterfaceEntry
+{
+    const TRUInt *Id;
+    InterfaceKind Kind;
+    TRSize Offset;
+    TRCString Name;
+} InterfaceEntry;
+
+typedef struct _TR_InterfaceTable
+{
+    TRCString ClassName;
+    const InterfaceEntry *Entries;
+    TRUInt Count;
+    ATOMIC(TRInt) State;                    // Whether Slots has been built yet
+    unsigned char Slots[INTERFACE_ID_MAX];  // Interface id -> entry index + 1
+} InterfaceTable;
+
+TRUInt TR_API InternInterfaceId( IN const TRUUID uuid );
+TRUInt TR_API LookupInterfaceId( IN const TRUUID uuid );
+
+/**
+ * Resolves uuid against the table of the object whose implementation starts at impl.
+ * The returned interface is AddRef'd through its own vtable.
+ */
+TR_STATUS TR_API QueryInterfaceFromTable( IN InterfaceTable *table, IN void *impl, IN const TRUUID uuid, OUT void **out );
+
+#define INTERFACE_ENTRY( name, impl, field ) \
+    { &IID_INDEX_##name, INTERFACE_KIND_SELF, offsetof( struct impl, field ), #name }
+
+#define INTERFACE_ENTRY_MEMBER( name, impl, field ) \
+    { &IID_INDEX_##name, INTERFACE_KIND_MEMBER, offsetof( struct impl, field ), #name }
+
+#define INTERFACE_ENTRY_FORWARD( name, impl, field ) \
+    { &IID_INDEX_##name, INTERFACE_KIND_FORWARD, offsetof( struct impl, field ), #name }
+
+#define DEFINE_INTERFACE_TABLE( impl, ... ) \
+    static const InterfaceEntry impl##_interface_entries[] = { __VA_ARGS__ }; \
+    static InterfaceTable impl##_interfaces = \
+    { \
+        #impl, impl##_interface_entries, sizeof( impl##_interface_entries ) / sizeof( InterfaceEntry ) \
+    }
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -27,7 +27,10 @@
 #include <stdatomic.h>
 
 #include <Types.h>
+#include <InterfaceTable.h>
 #include <IO/Logging.h>
+#include <Core/Memory/Memory.h>
+#include <Core/Memory/Slab.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -67,18 +70,16 @@ com_interface _UnknownObject
 DEFINE_GUID( UnknownObject, 0x00000000, 0x0000, 0x0000, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46 );
 
 #define DEFINE_SHALLOW_UNKNOWNOBJECT( type_name, impl ) \
+    DEFINE_SLAB_CACHE( impl, MEMORY_TAG_OBJECT );                                                   \
+    \
+    DEFINE_INTERFACE_TABLE( impl,                                                                   \
+        INTERFACE_ENTRY( UnknownObject, impl, type_name##_iface ),                                  \
+        INTERFACE_ENTRY( type_name, impl, type_name##_iface ) );                                    \
+    \
     static TR_STATUS impl##_QueryInterface( type_name *iface, const TRUUID uuid, void **out )       \
     {                                                                                               \
-        TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );                  \
-        if ( !out ) throw_NullPtrException();                                                       \
-        if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_##type_name ) )   \
-        {                                                                                           \
-            iface->lpVtbl->AddRef( iface );                                                         \
-            *out = iface;                                                                           \
-            return T_SUCCESS;                                                                       \
-        }                                                                                           \
-        ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );        \
-        return T_NOTIMPL;                                                                           \
+        return QueryInterfaceFromTable( &impl##_interfaces, impl_from_##type_name( iface ),          \
+                                        uuid, out );                                                \
     }                                                                                               \
     \
     static TRLong impl##_AddRef( type_name *iface )                                                 \
@@ -95,7 +96,7 @@ DEFINE_GUID( UnknownObject, 0x00000000, 0x0000, 0x0000, 0xC0, 0x00, 0x00, 0x00,
         const ATOMIC(TRLong) removed = atomic_fetch_sub( &root->ref, 1 );                           \
         TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );                      \
         if ( !(removed - 1) )                                                                       \
-            free( root );                                                                           \
+            SlabFree( &impl##_cache, root );                                                        \
         return removed;                                                                             \
     }
 
@@ -104,15 +105,24 @@ DEFINE_GUID( UnknownObject, 0x00000000, 0x0000, 0x0000, 0xC0, 0x00, 0x00, 0x00,
 } // extern "C"
 
 #include <cstring>
+#include <type_traits>
 #include <COM/comptr.hpp>
 
 namespace TR
 {
+    /**
+     * Specialised through TR_STATIC_INTERFACE when every object exposing From aggregates
+     * To at a fixed member, so the wrappers resolve the cast without a QueryInterface.
+     */
+    template <typename From, typename To>
+    struct StaticInterface : std::false_type {};
+
     template <typename Inheritance>
     class UnknownObject : public ComRAII<Inheritance>
     {
     public:
         using ComRAII<Inheritance>::ComRAII;
+        using interface_type = Inheritance;
         static constexpr const TRUUID &classId = IID_UnknownObject;
 
         // Must only be used within QueryInterface.
@@ -130,11 +140,58 @@ namespace TR
         [[nodiscard]]
         To QueryInterface() const
         {
+            using Target = typename To::interface_type;
             _UnknownObject *out;
-            check_tr_( this->ptr_->lpVtbl->QueryInterface( this->ptr_, To::classId, reinterpret_cast<void **>(&out) ) );
+
+            if constexpr ( std::is_same_v<Target, Inheritance> || std::is_same_v<Target, _UnknownObject> )
+            {
+                out = reinterpret_cast<_UnknownObject *>( this->ptr_ );
+            }
+            else if constexpr ( StaticInterface<Inheritance, Target>::value )
+            {
+                out = reinterpret_cast<_UnknownObject *>( StaticInterface<Inheritance, Target>::Resolve( this->ptr_ ) );
+                if ( !out ) throw TRException( T_NOINIT );
+            }
+            else
+            {
+                check_tr_( this->ptr_->lpVtbl->QueryInterface( this->ptr_, To::classId, reinterpret_cast<void **>(&out) ) );
+                return To( out );
+            }
+
+            out->lpVtbl->AddRef( out );
             return To( out );
         }
 
+        /**
+         * Like QueryInterface, but returns a borrowed reference that is valid for as long as
+         * this object is, without touching the reference count for statically known interfaces.
+         */
+        template <typename To>
+        [[nodiscard]]
+        ComRef<To> Borrow() const &
+        {
+            using Target = typename To::interface_type;
+
+            if constexpr ( std::is_same_v<Target, Inheritance> || std::is_same_v<Target, _UnknownObject> )
+            {
+                return ComRef<To>( this->ptr_ );
+            }
+            else if constexpr ( StaticInterface<Inheritance, Target>::value )
+            {
+                Target *out = StaticInterface<Inheritance, Target>::Resolve( this->ptr_ );
+                if ( !out ) throw TRException( T_NOINIT );
+                return ComRef<To>( out );
+            }
+            else
+            {
+                // Every interface this object hands out is kept alive by the object itself.
+                return ComRef<To>( QueryInterface<To>().get() );
+            }
+        }
+
+        template <typename To>
+        ComRef<To> Borrow() const && = delete;
+
     // AddRef and Release are handled by RAII
     private:
         TRLong AddRef() const
@@ -149,6 +206,20 @@ namespace TR
     };
 }
 
+/**
+ * TR_STATIC_INTERFACE( GTKWindowObject, GTKWidgetObject, gtk_window_object, GTKWidgetObject_impl )
+ * Only valid for interfaces with a single implementation, since the cast assumes impl's layout.
+ */
+#define TR_STATIC_INTERFACE( from, to, impl, field )                                                \
+    template <>                                                                                     \
+    struct TR::StaticInterface<_##from, _##to> : std::true_type                                     \
+    {                                                                                               \
+        static _##to *Resolve( _##from *iface )                                                     \
+        {                                                                                           \
+            return CONTAINING_RECORD( iface, struct impl, from##_iface )->field;                    \
+        }                                                                                           \
+    };
+
 #endif
 
 #endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACERAYER_OBJECTREGISTRY_H
+#define TRACERAYER_OBJECTREGISTRY_H
+
+#include <Object.h>
+#include <Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A side control block for one interface of a slab allocated object. It outlives
+ * the object, so a cache can hold on to one without pinning what it points at,
+ * and upgrading it fails once the reference count has dropped to zero.
+ */
+typedef struct _TR_WeakReference WeakReference;
+
+// The caller has to hold a strong reference to object. out starts with one weak reference.
+TR_STATUS TR_API GetWeakReference( IN UnknownObject *object, OUT WeakReference **out );
+TRLong TR_API AddRefWeakReference( IN WeakReference *weak );
+TRLong TR_API ReleaseWeakReference( IN WeakReference *weak );
+
+// AddRefs the object into out, or returns T_HANDLE with out set to nullptr once it is gone.
+TR_STATUS TR_API ResolveWeakReference( IN WeakReference *weak, OUT UnknownObject **out );
+
+// Called by SlabFree() before the object's memory is reused.
+void TR_API DetachWeakReferences( IN void *object );
+
+/**
+ * Live object tracking, only compiled in with TR_OBJECT_REGISTRY (the TRACERAYER_OBJECT_REGISTRY
+ * CMake option, on by default in Debug builds). Every slab object is recorded with the backtrace
+ * it was created from, and whatever is still alive at exit is reported per class.
+ */
+TR_STATUS TR_API InitializeObjectRegistry();
+
+#ifdef TR_OBJECT_REGISTRY
+void TR_API ObjectRegistryTrack( IN SlabCache *cache, IN void *object );
+void TR_API ObjectRegistryUntrack( IN void *object );
+void TR_API ObjectRegistryReport();
+#endif
+
+#ifdef __cplusplus
+} // extern "C"
+
+#include <utility>
+
+namespace TR
+{
+    template <typename Wrapper>
+    class WeakRef
+    {
+    public:
+        WeakRef() = default;
+
+        explicit WeakRef( const Wrapper &object )
+        {
+            if ( object.get() )
+                check_tr_( GetWeakReference( reinterpret_cast<_UnknownObject *>( object.get() ), &weak_ ) );
+        }
+
+        WeakRef( const WeakRef &other ) : weak_( other.weak_ )
+        {
+            if ( weak_ ) AddRefWeakReference( weak_ );
+        }
+
+        WeakRef( WeakRef &&other ) noexcept : weak_( std::exchange( other.weak_, nullptr ) ) {}
+
+        WeakRef& operator = ( WeakRef other ) noexcept
+        {
+            std::swap( weak_, other.weak_ );
+            return *this;
+        }
+
+        ~WeakRef()
+        {
+            if ( weak_ ) ReleaseWeakReference( weak_ );
+        }
+
+        // An owning reference, or an empty wrapper once the object has been released.
+        [[nodiscard]]
+        Wrapper Lock() const
+        {
+            _UnknownObject *out = nullptr;
+
+            if ( weak_ )
+                ResolveWeakReference( weak_, &out );
+
+            return Wrapper( out );
+        }
+
+    private:
+        WeakReference *weak_ = nullptr;
+    };
+}
+
+#endif
+
+#endif
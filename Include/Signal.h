@@ -23,36 +23,92 @@
 #ifndef TRACERAYER_SIGNAL_H
 #define TRACERAYER_SIGNAL_H
 
+#include <pthread.h>
+
 #include <Object.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef void (*SignalCallback)( UnknownObject *invoker, void *user_data );
+typedef void (*SignalDestroyNotify)( void *user_data );
 
 typedef struct _SignalHandler
 {
     TRULong id;
     SignalCallback callback;
     void *user_data;
+    SignalDestroyNotify destroy; // Runs on user_data once no emission can reach the handler anymore
 } SignalHandler;
 
+typedef struct _SignalHandlerArray
+{
+    TRSize count;
+    SignalHandler handlers[];
+} SignalHandlerArray;
+
+/**
+ * Tokens are a slot index in the low and its generation in the high 32 bits. The
+ * slot maps to the handler's position in the current array, so removal finds it
+ * directly, and a stale token no longer matches the bumped generation.
+ */
+#define SIGNAL_TOKEN( slot, generation ) ( (TRULong)(generation) << 32 | (slot) )
+#define SIGNAL_TOKEN_SLOT( token ) ( (TRUInt)((token) & 0xFFFFFFFFu) )
+#define SIGNAL_TOKEN_GENERATION( token ) ( (TRUInt)((token) >> 32) )
+
+typedef struct _SignalSlot
+{
+    TRUInt generation;  // Never 0, so no token is 0
+    TRUInt position;    // Index in the handler array, or the next free slot
+} SignalSlot;
+
+/**
+ * The handlers of one event, as an immutable array that is replaced wholesale on
+ * every add or remove and reclaimed through the epoch. Emitting only loads the
+ * current array, so it takes no lock and allocates nothing.
+ */
+typedef struct _SignalEvent
+{
+    ATOMIC(SignalHandlerArray *) handlers;
+    pthread_mutex_t writeLock;
+    ATOMIC(TRUInt) posts;   // Coalesced raises since the last flush
+
+    // Guarded by writeLock
+    SignalSlot *slots;
+    TRUInt slotCount;
+    TRUInt slotCapacity;
+    TRUInt freeSlot;
+} SignalEvent;
+
+void TR_API SignalEventInit( IN SignalEvent *event );
+TR_STATUS TR_API SignalEventAdd( IN SignalEvent *event, IN SignalCallback callback, IN void *context, IN SignalDestroyNotify destroy, OUT TRULong *token );
+TR_STATUS TR_API SignalEventRemove( IN SignalEvent *event, IN TRULong token );
+void TR_API SignalEventEmit( IN SignalEvent *event, IN UnknownObject *invoker );
+
+/**
+ * Coalesced delivery, for sources that can fire far faster than handlers can usefully
+ * react (resize, motion, progress). SignalEventPost() only marks the event pending and
+ * returns true for the first post since the last flush, when the source has to schedule
+ * one, typically on the next frame clock tick. SignalEventFlush() then emits once for
+ * all of them. The source keeps the latest (or accumulated) state itself, for handlers
+ * to read back from the invoker.
+ */
+TRBool TR_API SignalEventPost( IN SignalEvent *event );
+void TR_API SignalEventFlush( IN SignalEvent *event, IN UnknownObject *invoker );
+
+// Drops every handler, for when the owning object is destroyed.
+void TR_API SignalEventClear( IN SignalEvent *event );
+
 #define IMPLEMENTS_EVENT( type_name, name ) \
-    TR_STATUS (*eventadd_##name)( IN type_name *This, IN SignalCallback callback, IN void *context, OUT TRULong *token ); \
+    TR_STATUS (*eventadd_##name)( IN type_name *This, IN SignalCallback callback, IN void *context, IN SignalDestroyNotify destroy, OUT TRULong *token ); \
     TR_STATUS (*eventremove_##name)( IN type_name *This, IN TRULong token );
 
-#ifdef  __cplusplus
-
-#include <unordered_map>
-#include <memory>
-#include <mutex>
+#define implements_event_list( name ) \
+    SignalEvent name##_event;
 
-namespace TR
-{
-    class Events
-    {
-    public:
-        inline static std::unordered_map<TRULong, std::unique_ptr<void, void(*)(void*)>> events_callback_store{};
-        inline static std::mutex events_callback_store_mutex{};
-    };
-}
+#ifdef __cplusplus
+} // extern "C"
 
 template <typename From>
 using SignalCallbackSafe = void (*)( const From &invoker, void *user_data );
@@ -71,39 +127,38 @@ SignalCallbackHandler(
 ) {
     const auto *safeCallback = static_cast<SignalCallbackSafeObj<TR::UnknownObject<UnknownObject>> *>( user_data );
 
-    safeCallback->callback( TR::UnknownObject<_UnknownObject>( invoker ), safeCallback->user_data );
+    // The invoker is only borrowed for the duration of the callback.
+    safeCallback->callback( *ComRef<TR::UnknownObject<_UnknownObject>>( invoker ), safeCallback->user_data );
 }
 
+template <typename From>
+inline void
+SignalCallbackDestroy(
+    IN void *user_data
+) {
+    delete static_cast<SignalCallbackSafeObj<From> *>( user_data );
+}
+
+// The callback object is owned by the handler and freed through its destroy notify.
 #define implements_event( name, from ) \
     TRULong name( SignalCallbackSafe<from> callback, void *context )                                                \
     {                                                                                                               \
         TRULong out;                                                                                                \
-        get()->lpVtbl->AddRef( get() );                                                                             \
         SignalCallbackSafeObj<from>* callbackObj = new SignalCallbackSafeObj<from>{ callback, context };            \
-        check_tr_( get()->lpVtbl->eventadd_##name( get(), SignalCallbackHandler, callbackObj, &out ) );             \
+        TR_STATUS status = get()->lpVtbl->eventadd_##name( get(), SignalCallbackHandler, callbackObj,               \
+                                                           SignalCallbackDestroy<from>, &out );                     \
+        if ( FAILED( status ) )                                                                                     \
         {                                                                                                           \
-            std::scoped_lock lock( Events::events_callback_store_mutex );                                           \
-            Events::events_callback_store.emplace(                                                                  \
-                    out,                                                                                            \
-                    std::unique_ptr<void, void(*)(void*)>( callbackObj, [](void *p)                                 \
-                        {                                                                                           \
-                            delete static_cast<SignalCallbackSafeObj<from>*>( p );                                  \
-                        } )                                                                                         \
-            );                                                                                                      \
+            delete callbackObj;                                                                                     \
+            throw TRException( status );                                                                            \
         }                                                                                                           \
         return out;                                                                                                 \
     }                                                                                                               \
     void name( TRULong token )                                                                                      \
     {                                                                                                               \
         check_tr_( get()->lpVtbl->eventremove_##name( get(), token ) );                                             \
-        std::scoped_lock lock( Events::events_callback_store_mutex );                                               \
-        Events::events_callback_store.erase( token );                                                               \
     }
 
 #endif
 
-#define implements_glib_eventlist( name ) \
-    GSList *name##_events;  \
-    GMutex name##_mutex;    \
-
 #endif
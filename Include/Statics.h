@@ -33,6 +33,9 @@
 
 #define LOGFILE_HEADER "// --- ($DATE) ($TIME) Trace Rayer ($VERSION), A Ray Tracing Demo Written in GTK and Vulkan --- //\n"
 #define LOG_FORMAT "[$THREAD] ($LOG_CATEGORY) $MODULE::$FUNCTION $MESSAGE"
+#define LOGFILE_BUFFER_SIZE (1024 * 1024) // Per half of the log sink's double buffer
+#define LOGFILE_FSYNC_INTERVAL 5 // Seconds, for --log-fsync=interval
+#define TRACE_SUMMARY_INTERVAL 5 // Seconds between "suppressed N messages" lines of a TRACE call site
 
 // Terminal Colors
 #define RESET_COLOR "\033[0m" // DO NOT CHANGE THIS!
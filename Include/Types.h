@@ -60,7 +60,7 @@ typedef uuid_t TRUUID;
 #define ATOMIC(type) std::atomic<type>
 #else
 #include <stdatomic.h>
-#define ATOMIC(type) _Atomic type
+#define ATOMIC(type) _Atomic(type)
 #endif
 
 #ifdef __unix__
@@ -165,10 +165,22 @@ typedef struct _FormattedVersion
         (unsigned char)(((w1) >> 8) & 0xff), (unsigned char)((w1) & 0xff), \
         (unsigned char)(((w2) >> 8) & 0xff), (unsigned char)((w2) & 0xff), \
         (unsigned char)(b1), (unsigned char)(b2), (unsigned char)(b3), (unsigned char)(b4), \
-        (unsigned char)(b5), (unsigned char)(b6), (unsigned char)(b7), (unsigned char)(b8) }
+        (unsigned char)(b5), (unsigned char)(b6), (unsigned char)(b7), (unsigned char)(b8) }; \
+    __attribute__((visibility("default"))) TRUInt IID_INDEX_##name = 0; \
+    __attribute__((constructor)) static void RegisterInterface_##name() \
+    { \
+        IID_INDEX_##name = InternInterfaceId( IID_##name ); \
+    } \
+    extern const uuid_t IID_##name
+
+TRUInt TR_API InternInterfaceId( IN const TRUUID uuid );
 #else
+/**
+ * IID_INDEX_ holds the interned id of the uuid, see InterfaceTable.h
+ */
 #define DEFINE_GUID(name, l, w1, w2, b1, b2, b3, b4, b5, b6, b7, b8) \
-    extern const TRUUID IID_##name
+    extern const TRUUID IID_##name; \
+    extern TRUInt IID_INDEX_##name
 #endif
 
 #endif //TRACERAYER_TYPES_H
@@ -71,6 +71,15 @@ typedef struct _GTKInterface
         IN GTKObject *This,
         OUT Platform *out);
 
+    /**
+     * @Method: void GTKObject::Quit()
+     * @Description: Makes RunApplication() return once the main loop is back in control.
+     *               Must be called from the main thread.
+     * @Status: Always returns T_SUCCESS.
+     */
+    TR_STATUS (*Quit)(
+        IN GTKObject *This);
+
     /**
      * @Event: GTKObject::OnActivation
      * @Description: Fired on GTKObject::RunApplication()
@@ -98,7 +107,7 @@ struct gtk_object
     // --- Private Members --- //
     GtkApplication *app;
     TRBool isInActivationThread;
-    implements_glib_eventlist( OnActivation )
+    implements_event_list( OnActivation )
     ATOMIC(TRLong) ref;
 };
 
@@ -146,6 +155,11 @@ namespace TR
                 return out;
             }
 
+            void Quit() const
+            {
+                check_tr_( get()->lpVtbl->Quit( get() ) );
+            }
+
             implements_event( OnActivation, GTKObject )
         };
     }
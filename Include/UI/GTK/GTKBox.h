@@ -87,6 +87,8 @@ TR_STATUS TR_API new_gtk_box_object_override_orientation_and_spacing( IN GtkOrie
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( GTKBoxObject, GTKWidgetObject, gtk_box_object, GTKWidgetObject_impl )
+
 namespace TR
 {
     namespace UI
@@ -108,7 +110,14 @@ namespace TR
                 return QueryInterface<GTKWidgetObject>();
             }
 
-            void AppendWidget( const GTKWidgetObject &widget ) const
+            operator ComRef<GTKWidgetObject>() const &
+            {
+                return Borrow<GTKWidgetObject>();
+            }
+
+            operator ComRef<GTKWidgetObject>() const && = delete;
+
+            void AppendWidget( ComRef<GTKWidgetObject> widget ) const
             {
                 check_tr_( get()->lpVtbl->AppendWidget( get(), widget.get() ) );
             }
@@ -78,6 +78,8 @@ TR_STATUS TR_API new_gtk_label_object_override_text( IN TRCString text, OUT GTKL
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( GTKLabelObject, GTKWidgetObject, gtk_label_object, GTKWidgetObject_impl )
+
 namespace TR
 {
     namespace UI
@@ -98,6 +100,13 @@ namespace TR
             {
                 return QueryInterface<GTKWidgetObject>();
             }
+
+            operator ComRef<GTKWidgetObject>() const &
+            {
+                return Borrow<GTKWidgetObject>();
+            }
+
+            operator ComRef<GTKWidgetObject>() const && = delete;
         };
     }
 }
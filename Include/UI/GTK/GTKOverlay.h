@@ -112,6 +112,8 @@ TR_STATUS TR_API new_gtk_overlay_object( OUT GTKOverlayObject **out );
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( GTKOverlayObject, GTKWidgetObject, gtk_overlay_object, GTKWidgetObject_impl )
+
 namespace TR
 {
     namespace UI
@@ -133,6 +135,13 @@ namespace TR
                 return QueryInterface<GTKWidgetObject>();
             }
 
+            operator ComRef<GTKWidgetObject>() const &
+            {
+                return Borrow<GTKWidgetObject>();
+            }
+
+            operator ComRef<GTKWidgetObject>() const && = delete;
+
             [[nodiscard]]
             GTKWidgetObject ChildWidget() const
             {
@@ -141,12 +150,12 @@ namespace TR
                 return GTKWidgetObject( ChildWidget );
             }
 
-            void ChildWidget( const GTKWidgetObject& widget ) const
+            void ChildWidget( ComRef<GTKWidgetObject> widget ) const
             {
                 check_tr_( get()->lpVtbl->set_ChildWidget( get(), widget.get() ) );
             }
 
-            void AddWidget( const GTKWidgetObject &widget ) const
+            void AddWidget( ComRef<GTKWidgetObject> widget ) const
             {
                 check_tr_( get()->lpVtbl->AddWidget( get(), widget.get() ) );
             }
@@ -76,6 +76,7 @@ struct gtk_picture_object
     implements( GTKWidgetObject );
 
     // --- Private Members --- //
+    GdkRectangle PictureRect;   // From the image header, known before the texture is decoded
     ATOMIC(TRLong) ref;
 };
 
@@ -88,6 +89,8 @@ TR_STATUS TR_API new_gtk_picture_object_override_path( IN TRPath *imagePath, OUT
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( GTKPictureObject, GTKWidgetObject, gtk_picture_object, GTKWidgetObject_impl )
+
 namespace TR
 {
     namespace UI
@@ -109,6 +112,13 @@ namespace TR
                 return QueryInterface<GTKWidgetObject>();
             }
 
+            operator ComRef<GTKWidgetObject>() const &
+            {
+                return Borrow<GTKWidgetObject>();
+            }
+
+            operator ComRef<GTKWidgetObject>() const && = delete;
+
             GdkRectangle GetPictureRect() const
             {
                 GdkRectangle rect;
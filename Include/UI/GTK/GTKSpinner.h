@@ -96,6 +96,8 @@ TR_STATUS TR_API new_gtk_spinner_object( OUT GTKSpinnerObject **out );
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( GTKSpinnerObject, GTKWidgetObject, gtk_spinner_object, GTKWidgetObject_impl )
+
 namespace TR
 {
     namespace UI
@@ -117,6 +119,13 @@ namespace TR
                 return QueryInterface<GTKWidgetObject>();
             }
 
+            operator ComRef<GTKWidgetObject>() const &
+            {
+                return Borrow<GTKWidgetObject>();
+            }
+
+            operator ComRef<GTKWidgetObject>() const && = delete;
+
             TRBool Spinning() const noexcept
             {
                 TRBool spinning;
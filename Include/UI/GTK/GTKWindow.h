@@ -134,6 +134,21 @@ typedef struct _GTKWindowInterface
      */
     IMPLEMENTS_EVENT( GTKWindowObject, OnDelete )
 
+    /**
+     * @Event: GTKWindowObject::OnResize
+     * @Description: Fired after the window size changed, at most once per frame
+     *               clock tick however many changes the tick covers. WindowRect
+     *               holds the latest size by then.
+     */
+    IMPLEMENTS_EVENT( GTKWindowObject, OnResize )
+
+    /**
+     * @Event: GTKWindowObject::OnFirstFrame
+     * @Description: Fired once, on the first frame clock tick after the window
+     *               was mapped, which is when its first frame is being drawn.
+     */
+    IMPLEMENTS_EVENT( GTKWindowObject, OnFirstFrame )
+
     END_INTERFACE
 } GTKWindowInterface;
 
@@ -162,7 +177,9 @@ struct gtk_window_object
 
     // --- Private Members --- //
     WindowLoopCallback callback;
-    implements_glib_eventlist( OnDelete )
+    implements_event_list( OnDelete )
+    implements_event_list( OnResize )
+    implements_event_list( OnFirstFrame )
     ATOMIC(TRLong) ref;
 };
 
@@ -179,6 +196,8 @@ TR_STATUS TR_API new_gtk_window_object( IN GtkApplication *app, OUT GTKWindowObj
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( GTKWindowObject, GTKWidgetObject, gtk_window_object, GTKWidgetObject_impl )
+
 namespace TR
 {
     namespace UI
@@ -200,6 +219,13 @@ namespace TR
                 return QueryInterface<GTKWidgetObject>();
             }
 
+            operator ComRef<GTKWidgetObject>() const &
+            {
+                return Borrow<GTKWidgetObject>();
+            }
+
+            operator ComRef<GTKWidgetObject>() const && = delete;
+
             [[nodiscard]]
             GdkRectangle WindowRect() const noexcept
             {
@@ -221,7 +247,7 @@ namespace TR
                 return GTKWidgetObject( ChildWidget );
             }
 
-            void ChildWidget( const GTKWidgetObject& widget ) const
+            void ChildWidget( ComRef<GTKWidgetObject> widget ) const
             {
                 check_tr_( get()->lpVtbl->set_ChildWidget( get(), widget.get() ) );
             }
@@ -250,6 +276,8 @@ namespace TR
             }
 
             implements_event( OnDelete, GTKWindowObject )
+            implements_event( OnResize, GTKWindowObject )
+            implements_event( OnFirstFrame, GTKWindowObject )
         };
     }
 }
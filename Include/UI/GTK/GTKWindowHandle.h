@@ -102,6 +102,8 @@ TR_STATUS TR_API new_gtk_window_handle_object( OUT GTKWindowHandleObject **out )
 #ifdef __cplusplus
 } // extern "C"
 
+TR_STATIC_INTERFACE( GTKWindowHandleObject, GTKWidgetObject, gtk_window_handle_object, GTKWidgetObject_impl )
+
 namespace TR
 {
     namespace UI
@@ -123,6 +125,13 @@ namespace TR
                 return QueryInterface<GTKWidgetObject>();
             }
 
+            operator ComRef<GTKWidgetObject>() const &
+            {
+                return Borrow<GTKWidgetObject>();
+            }
+
+            operator ComRef<GTKWidgetObject>() const && = delete;
+
             [[nodiscard]]
             GTKWidgetObject ChildWidget() const
             {
@@ -131,7 +140,7 @@ namespace TR
                 return GTKWidgetObject( ChildWidget );
             }
 
-            void ChildWidget( const GTKWidgetObject& widget ) const
+            void ChildWidget( ComRef<GTKWidgetObject> widget ) const
             {
                 check_tr_( get()->lpVtbl->set_ChildWidget( get(), widget.get() ) );
             }
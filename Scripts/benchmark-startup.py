@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Weather
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""
+Runs TraceRayer --benchmark-startup a number of times and reports percentiles
+for every startup mark, in ms since the process was launched.
+
+Warm runs start with one discarded run, so the shared libraries and resources
+are in the page cache. Cold runs drop the page cache before every run, which
+needs root. --no-pipeline-cache gives every run an empty cache directory, so
+compared with a default run it shows what the on-disk pipeline cache saves.
+Without a display, run it under a headless compositor or X server,
+e.g. xvfb-run.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+LAUNCH_ENV = "TRACERAYER_BENCHMARK_LAUNCH"
+
+
+def drop_caches():
+    os.sync()
+    with open("/proc/sys/vm/drop_caches", "w") as caches:
+        caches.write("3\n")
+
+
+def run_once(executable, extra, timeout, cache_home=None):
+    with tempfile.NamedTemporaryFile(suffix=".json") as output:
+        env = dict(os.environ)
+        if cache_home:
+            env["XDG_CACHE_HOME"] = cache_home
+        # Same clock as the marks, so the JSON can count from the launch.
+        env[LAUNCH_ENV] = str(time.monotonic_ns())
+        subprocess.run([executable, "--benchmark-startup", output.name] + extra, env=env,
+                       stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, timeout=timeout, check=True)
+        return {mark["name"]: mark["ms"] for mark in json.load(output)["marks"]}
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    position = (len(ordered) - 1) * fraction
+    lower = int(position)
+    upper = min(lower + 1, len(ordered) - 1)
+    return ordered[lower] + (ordered[upper] - ordered[lower]) * (position - lower)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("executable", help="the TraceRayer executable")
+    parser.add_argument("-n", "--runs", type=int, default=20, help="measured runs (default: 20)")
+    parser.add_argument("--cold", action="store_true", help="drop the page cache before every run, needs root")
+    parser.add_argument("--no-pipeline-cache", action="store_true", help="start every run without cached pipelines")
+    parser.add_argument("--timeout", type=float, default=60, help="seconds before a run counts as hung")
+    parser.add_argument("--json", help="also write the raw runs and percentiles here")
+    parser.add_argument("extra", nargs="*", help="passed on to TraceRayer, after --")
+    args = parser.parse_args()
+
+    if args.cold and os.geteuid() != 0:
+        sys.exit("--cold drops the page cache, which needs root")
+
+    if not args.cold:
+        run_once(args.executable, args.extra, args.timeout)
+
+    runs = []
+    for _ in range(args.runs):
+        if args.cold:
+            drop_caches()
+        if args.no_pipeline_cache:
+            with tempfile.TemporaryDirectory() as cache_home:
+                runs.append(run_once(args.executable, args.extra, args.timeout, cache_home))
+        else:
+            runs.append(run_once(args.executable, args.extra, args.timeout))
+
+    # Marks in the order the first run reached them.
+    names = sorted(runs[0], key=runs[0].get)
+    summary = {}
+
+    print(f"{'mark':<20} {'min':>9} {'p50':>9} {'p90':>9} {'p99':>9} {'max':>9}  ({len(runs)} {'cold' if args.cold else 'warm'} runs, ms)")
+    for name in names:
+        values = [run[name] for run in runs if name in run]
+        summary[name] = {
+            "min": min(values),
+            "p50": percentile(values, 0.50),
+            "p90": percentile(values, 0.90),
+            "p99": percentile(values, 0.99),
+            "max": max(values),
+        }
+        print(f"{name:<20} " + " ".join(f"{summary[name][key]:9.2f}" for key in ("min", "p50", "p90", "p99", "max")))
+
+    if args.json:
+        with open(args.json, "w") as output:
+            json.dump({"cold": args.cold, "pipeline_cache": not args.no_pipeline_cache, "runs": runs, "percentiles": summary}, output, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Common.glsl
+ *  Description: Bindings and helpers shared by the wavefront path tracing kernels.
+ *
+ *  The structs mirror Include/Core/Render/Scene.h and BVH.h, and the estimator
+ *  follows Source/Core/Render/Reference.c step by step, keep them in sync.
+ */
+
+#define WORKGROUP_SIZE 64
+#define BVH_STACK_SIZE 64
+#define NO_HIT 0xFFFFFFFFu
+#define FAR 3.402823466e+38
+#define PI 3.14159265358979
+#define RAY_OFFSET 1e-4
+#define SHADOW_EPSILON 1e-3
+#define ROULETTE_DEPTH 3
+#define RAY_EPSILON 1e-5
+#define SHADOW_QUEUE 2
+
+layout( local_size_x = WORKGROUP_SIZE ) in;
+
+struct Node
+{
+    vec3 Min;
+    uint LeftOrFirst;
+    vec3 Max;
+    uint Count;
+};
+
+struct Triangle
+{
+    vec3 V0;
+    uint Material;
+    vec3 Edge1;
+    float Reserved0;
+    vec3 Edge2;
+    float Reserved1;
+};
+
+struct Material
+{
+    vec3 Albedo;
+    float Reserved0;
+    vec3 Emission;
+    float Reserved1;
+};
+
+struct Path
+{
+    vec3 Origin;
+    float HitT;
+    vec3 Direction;
+    uint HitTriangle;
+    vec3 Throughput;
+    uint Depth;
+    uint Rng;
+    uint Reserved0;
+    uint Reserved1;
+    uint Reserved2;
+};
+
+struct ShadowRay
+{
+    vec3 Origin;
+    float TMax;
+    vec3 Direction;
+    uint Path;
+    vec3 Contribution;
+    float Reserved0;
+};
+
+// Doubles as the VkDispatchIndirectCommand of the kernel consuming the queue.
+struct QueueHeader
+{
+    uint GroupsX;
+    uint GroupsY;
+    uint GroupsZ;
+    uint Count;
+};
+
+layout( push_constant ) uniform Constants
+{
+    vec4 CameraOrigin;
+    vec4 CameraForward;
+    vec4 CameraRight;                               // To the right edge of the image plane
+    vec4 CameraUp;                                  // To its top edge
+    uint Width;
+    uint Height;
+    uint Sample;
+    uint Depth;
+    uint MaxDepth;
+    uint Seed;
+    uint LightCount;
+    uint InQueue;                                   // Ray queue read this bounce, the other one is written
+} Frame;
+
+layout( std430, binding = 0 ) readonly buffer NodeBuffer { Node Nodes[]; };
+layout( std430, binding = 1 ) readonly buffer TriangleBuffer { Triangle Triangles[]; };
+layout( std430, binding = 2 ) readonly buffer MaterialBuffer { Material Materials[]; };
+layout( std430, binding = 3 ) readonly buffer LightBuffer { uint Lights[]; };
+layout( std430, binding = 4 ) buffer PathBuffer { Path Paths[]; };
+layout( std430, binding = 5 ) buffer QueueBuffer { QueueHeader Queues[3]; };
+layout( std430, binding = 6 ) buffer RayQueueBuffer { uint RayQueue[]; };      // Two queues of a path per pixel each
+layout( std430, binding = 7 ) buffer ShadowRayBuffer { ShadowRay ShadowRays[]; };
+layout( std430, binding = 8 ) buffer FilmBuffer { vec4 Film[]; };              // Radiance summed over the samples
+
+uint PixelCount()
+{
+    return Frame.Width * Frame.Height;
+}
+
+// Counts the workgroups along, so the next kernel is dispatched for exactly the queued items.
+uint Enqueue( uint queue )
+{
+    uint slot = atomicAdd( Queues[queue].Count, 1u );
+    if ( slot % WORKGROUP_SIZE == 0u ) atomicAdd( Queues[queue].GroupsX, 1u );
+    return slot;
+}
+
+void PushRay( uint queue, uint path )
+{
+    RayQueue[queue * PixelCount() + Enqueue( queue )] = path;
+}
+
+// PCG, the same hash Reference.c uses.
+uint Hash( uint value )
+{
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float Random( inout uint state )
+{
+    state = Hash( state );
+    return float( state >> 8 ) * (1.0 / 16777216.0);
+}
+
+// Cosine weighted around normal, after Duff et al.'s orthonormal basis.
+vec3 SampleHemisphere( vec3 normal, inout uint rng )
+{
+    float side = normal.z >= 0.0 ? 1.0 : -1.0;
+    float a = -1.0 / (side + normal.z);
+    float b = normal.x * normal.y * a;
+    vec3 tangent = vec3( 1.0 + side * normal.x * normal.x * a, side * b, -side * normal.x );
+    vec3 bitangent = vec3( b, side + normal.y * normal.y * a, -normal.y );
+    float u = Random( rng );
+    float phi = 2.0 * PI * Random( rng );
+    float radius = sqrt( u );
+
+    return tangent * (radius * cos( phi )) + bitangent * (radius * sin( phi )) + normal * sqrt( 1.0 - u );
+}
+
+float IntersectBox( Node node, vec3 origin, vec3 reciprocal, float tMax )
+{
+    vec3 t0 = (node.Min - origin) * reciprocal;
+    vec3 t1 = (node.Max - origin) * reciprocal;
+    vec3 low = min( t0, t1 );
+    vec3 high = max( t0, t1 );
+    float enter = max( max( low.x, low.y ), max( low.z, 0.0 ) );
+    float exit = min( min( high.x, high.y ), min( high.z, tMax ) );
+
+    return enter <= exit ? enter : FAR;
+}
+
+// Möller-Trumbore, shortens t and returns true on a closer hit.
+bool IntersectTriangle( Triangle triangle, vec3 origin, vec3 direction, inout float t )
+{
+    vec3 p = cross( direction, triangle.Edge2 );
+    float determinant = dot( triangle.Edge1, p );
+    if ( abs( determinant ) < 1e-12 ) return false;
+
+    float reciprocal = 1.0 / determinant;
+    vec3 s = origin - triangle.V0;
+    float u = dot( s, p ) * reciprocal;
+    if ( u < 0.0 || u > 1.0 ) return false;
+
+    vec3 q = cross( s, triangle.Edge1 );
+    float v = dot( direction, q ) * reciprocal;
+    if ( v < 0.0 || u + v > 1.0 ) return false;
+
+    float hitDistance = dot( triangle.Edge2, q ) * reciprocal;
+    if ( hitDistance <= RAY_EPSILON || hitDistance >= t ) return false;
+
+    t = hitDistance;
+    return true;
+}
+
+// The closest triangle in (0, t), or any one when anyHit is set, NO_HIT on a miss.
+uint Trace( vec3 origin, vec3 direction, inout float t, bool anyHit )
+{
+    vec3 reciprocal = 1.0 / direction;
+    uint stack[BVH_STACK_SIZE];
+    uint depth = 0u;
+    uint hit = NO_HIT;
+    Node node = Nodes[0];
+
+    if ( IntersectBox( node, origin, reciprocal, t ) == FAR ) return NO_HIT;
+
+    for ( ;; )
+    {
+        if ( node.Count > 0u )
+        {
+            for ( uint i = node.LeftOrFirst; i < node.LeftOrFirst + node.Count; i++ )
+            {
+                if ( !IntersectTriangle( Triangles[i], origin, direction, t ) ) continue;
+
+                hit = i;
+                if ( anyHit ) return hit;
+            }
+        }
+        else
+        {
+            uint nearChild = node.LeftOrFirst;
+            uint farChild = nearChild + 1u;
+            float nearDistance = IntersectBox( Nodes[nearChild], origin, reciprocal, t );
+            float farDistance = IntersectBox( Nodes[farChild], origin, reciprocal, t );
+
+            if ( farDistance < nearDistance )
+            {
+                uint swap = nearChild;
+                nearChild = farChild;
+                farChild = swap;
+                float swapDistance = nearDistance;
+                nearDistance = farDistance;
+                farDistance = swapDistance;
+            }
+
+            if ( nearDistance != FAR )
+            {
+                if ( farDistance != FAR && depth < BVH_STACK_SIZE ) stack[depth++] = farChild;
+                node = Nodes[nearChild];
+                continue;
+            }
+        }
+
+        if ( depth == 0u ) return hit;
+        node = Nodes[stack[--depth]];
+    }
+}
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/RecordingBenchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <Core/Vulkan/Vulkan.h>
+#include <Core/Vulkan/VulkanAllocator.h>
+#include <Core/Vulkan/VulkanCommandRecorder.h>
+#include <Core/Instrumentation/Zones.h>
+
+#include <IO/Arguments.h>
+#include <IO/Logging.h>
+#include <Statics.h>
+
+using namespace TR;
+
+struct RecordingBenchmarkRun
+{
+    TRUInt threads = 0;
+    TRUInt buffers = 0;                             // Secondary command buffers of a frame
+    TRFloat ms = 0.0;                               // Median of the frames
+    TRFloat minMs = 0.0;
+    VulkanCommandRecorderStatistics statistics = {};
+};
+
+struct RecordingBenchmarkScene
+{
+    VkBuffer buffer;
+};
+
+// Owns the instance buffer, so every way out of RecordOnThreads frees it before its allocator and device.
+struct RecordingBenchmarkBuffer
+{
+    const Core::Vulkan::VulkanAllocatorObject &allocator;
+    VkDevice handle;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VulkanAllocation memory = {};
+
+    ~RecordingBenchmarkBuffer()
+    {
+        allocator.Free( memory );
+        if ( buffer ) vkDestroyBuffer( handle, buffer, &VulkanAllocationCallbacks );
+    }
+};
+
+// The constants a scene would compute for one instance, a transform and a color.
+struct RecordingBenchmarkInstance
+{
+    float transform[12];
+    float color[4];
+};
+
+static TR_STATUS
+RecordInstance(
+    IN void *context,
+    IN TRUInt index,
+    IN VkCommandBuffer commands
+) {
+    const auto *scene = (const RecordingBenchmarkScene *)context;
+    const VkDeviceSize offset = (VkDeviceSize)(index % RECORDING_BENCHMARK_SLOTS) * sizeof( RecordingBenchmarkInstance );
+    const float angle = (float)index * 0.001f;
+    RecordingBenchmarkInstance instance = {};
+
+    instance.transform[0] = instance.transform[5] = 1.0f - angle * angle * 0.5f;
+    instance.transform[1] = angle;
+    instance.transform[4] = -angle;
+    instance.transform[10] = 1.0f;
+    instance.transform[3] = (float)(index % 97);
+    instance.transform[7] = (float)(index / 97 % 89);
+    instance.transform[11] = (float)(index / 8633);
+    instance.color[0] = (float)(index & 0xff) / 255.0f;
+    instance.color[1] = (float)(index >> 8 & 0xff) / 255.0f;
+    instance.color[2] = (float)(index >> 16 & 0xff) / 255.0f;
+    instance.color[3] = 1.0f;
+
+    vkCmdUpdateBuffer( commands, scene->buffer, offset, sizeof( instance ), &instance );
+    vkCmdFillBuffer( commands, scene->buffer, offset + offsetof( RecordingBenchmarkInstance, color ), sizeof( float ), index );
+
+    return T_SUCCESS;
+}
+
+// Executes the buffers of the last Record once, so the driver sees every one of them.
+static void
+ExecuteRecorded(
+    const Core::Vulkan::VulkanDeviceObject &device,
+    const Core::Vulkan::VulkanQueueObject &queue,
+    const std::vector<VkCommandBuffer> &commands,
+    TRUInt count
+) {
+    const VkDevice handle = device.Handle();
+    const VkCommandPoolCreateInfo poolInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = queue.FamilyIndex()
+    };
+    const VkFenceCreateInfo fenceInfo = { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    const VkCommandBufferBeginInfo beginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    VkCommandBufferAllocateInfo allocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    VkSubmitInfo submit = { .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO, .commandBufferCount = 1 };
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VkCommandBuffer primary = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    TR_STATUS status = T_ERROR;
+
+    if ( vkCreateCommandPool( handle, &poolInfo, &VulkanAllocationCallbacks, &pool ) != VK_SUCCESS ) goto done;
+    if ( vkCreateFence( handle, &fenceInfo, &VulkanAllocationCallbacks, &fence ) != VK_SUCCESS ) goto done;
+
+    allocateInfo.commandPool = pool;
+    if ( vkAllocateCommandBuffers( handle, &allocateInfo, &primary ) != VK_SUCCESS ) goto done;
+    if ( vkBeginCommandBuffer( primary, &beginInfo ) != VK_SUCCESS ) goto done;
+    vkCmdExecuteCommands( primary, count, commands.data() );
+    if ( vkEndCommandBuffer( primary ) != VK_SUCCESS ) goto done;
+
+    submit.pCommandBuffers = &primary;
+    try
+    {
+        queue.Submit( &submit, 1, fence );
+    } catch ( const TRException &e )
+    {
+        status = e.status;
+        goto done;
+    }
+    if ( vkWaitForFences( handle, 1, &fence, VK_TRUE, UINT64_MAX ) != VK_SUCCESS ) goto done;
+    status = T_SUCCESS;
+
+done:
+    if ( fence ) vkDestroyFence( handle, fence, &VulkanAllocationCallbacks );
+    if ( pool ) vkDestroyCommandPool( handle, pool, &VulkanAllocationCallbacks );
+
+    check_tr_( status );
+}
+
+static TR_STATUS
+RecordOnThreads(
+    std::string &deviceName,
+    std::vector<RecordingBenchmarkRun> &runs
+) {
+    VkDevice handle = VK_NULL_HANDLE;
+    RecordingBenchmarkScene scene = {};
+
+    try
+    {
+        const Platform platform = getenv( "WAYLAND_DISPLAY" ) ? Platform_Wayland : Platform_X11;
+        Core::Vulkan::VulkanObject instance( APPNAME, {1, 0, 0}, platform );
+        Core::Vulkan::VulkanDeviceObject device = GlobalArgumentsDefault.GPUName ? instance.CreateDevice( GlobalArgumentsDefault.GPUName )
+                                                                                 : instance.CreateDevice();
+        Core::Vulkan::VulkanAllocatorObject allocator( device );
+        Core::Vulkan::VulkanQueueObject queue = device.GetQueue( VulkanQueueRole_Graphics );
+        const VkBufferCreateInfo bufferInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = RECORDING_BENCHMARK_SLOTS * sizeof( RecordingBenchmarkInstance ),
+            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+        };
+        RecordingBenchmarkBuffer instances = { allocator, device.Handle() };
+        std::vector<TRUInt> threadCounts;
+        TRUInt processors;
+
+        deviceName = device.Info()->Properties.deviceName;
+        handle = device.Handle();
+        if ( vkCreateBuffer( handle, &bufferInfo, &VulkanAllocationCallbacks, &instances.buffer ) != VK_SUCCESS )
+            return T_ERROR;
+        instances.memory = allocator.AllocateForBuffer( instances.buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
+        scene.buffer = instances.buffer;
+
+        // A recorder left to its defaults runs one thread per processor.
+        processors = Core::Vulkan::VulkanCommandRecorderObject( device, { VulkanQueueRole_Graphics, 0, 0 } ).ThreadCount();
+
+        for ( TRUInt threads = 1; threads < processors; threads *= 2 )
+            threadCounts.push_back( threads );
+        threadCounts.push_back( processors );
+
+        for ( TRUInt threads : threadCounts )
+        {
+            Core::Vulkan::VulkanCommandRecorderObject recorder( device, { VulkanQueueRole_Graphics, threads, 0 } );
+            std::vector<VkCommandBuffer> commands( recorder.ThreadCount() );
+            std::vector<TRFloat> times;
+            RecordingBenchmarkRun run;
+
+            TR_ZONE( "RecordingBenchmark" );
+
+            run.threads = threads;
+            for ( TRUInt frame = 0; frame < RECORDING_BENCHMARK_WARMUP + RECORDING_BENCHMARK_FRAMES; frame++ )
+            {
+                recorder.BeginFrame( frame % VULKAN_RECORDER_DEFAULT_FRAMES );
+                run.buffers = recorder.Record( nullptr, RECORDING_BENCHMARK_ITEMS, RecordInstance, &scene, commands.data() );
+                if ( frame >= RECORDING_BENCHMARK_WARMUP )
+                    times.push_back( (TRFloat)recorder.Statistics().RecordNanoseconds / 1e6 );
+            }
+            ExecuteRecorded( device, queue, commands, run.buffers );
+
+            std::sort( times.begin(), times.end() );
+            run.ms = times[times.size() / 2];
+            run.minMs = times.front();
+            run.statistics = recorder.Statistics();
+            runs.push_back( run );
+
+            INFO( "Recorded %u instances on %u threads in %.2f ms\n", RECORDING_BENCHMARK_ITEMS, threads, run.ms );
+        }
+    } catch ( const TRException &e )
+    {
+        ERROR( "Parallel recording failed with %d\n", e.status );
+        return e.status;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+WriteRecordingBenchmark(
+    TRCString outputPath,
+    const std::string &deviceName,
+    const std::vector<RecordingBenchmarkRun> &runs
+) {
+    FILE *file;
+
+    if (!(file = fopen( outputPath, "w" )))
+    {
+        ERROR( "Could not open %s for the recording benchmark\n", outputPath );
+        return T_ACCESSDENIED;
+    }
+
+    fprintf( file, "{\"device\":\"%s\",\"items\":%u,\"frames\":%u,\"runs\":[\n", deviceName.c_str(), RECORDING_BENCHMARK_ITEMS, RECORDING_BENCHMARK_FRAMES );
+    for ( size_t i = 0; i < runs.size(); i++ )
+    {
+        const RecordingBenchmarkRun &run = runs[i];
+
+        fprintf( file, "  {\"threads\":%u,\"buffers\":%u,\"ms\":%.3f,\"min_ms\":%.3f,\"mitems_per_second\":%.3f,\"speedup\":%.2f,\"allocated\":%u,\"resets\":%llu}%s\n",
+                 run.threads, run.buffers, run.ms, run.minMs, RECORDING_BENCHMARK_ITEMS / run.ms / 1e3, runs[0].ms / run.ms,
+                 run.statistics.Allocated, (unsigned long long)run.statistics.Resets, i + 1 < runs.size() ? "," : "" );
+    }
+    fprintf( file, "]}\n" );
+
+    if ( fclose( file ) )
+    {
+        ERROR( "Could not write the recording benchmark to %s\n", outputPath );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+TR_STATUS
+RunRecordingBenchmark(
+    IN TRCString outputPath
+) {
+    std::vector<RecordingBenchmarkRun> runs;
+    std::string deviceName;
+    TR_STATUS status;
+
+    status = RecordOnThreads( deviceName, runs );
+    if ( FAILED( status ) ) return status;
+
+    INFO( "Parallel recording on %s: %.2fx faster on %u threads than on one\n",
+          deviceName.c_str(), runs.front().ms / runs.back().ms, runs.back().threads );
+
+    return WriteRecordingBenchmark( outputPath, deviceName, runs );
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/RenderBenchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <Core/Render/BVH.h>
+#include <Core/Render/Reference.h>
+#include <Core/Render/Scene.h>
+#include <Core/Vulkan/Vulkan.h>
+#include <Core/Vulkan/VulkanAllocator.h>
+#include <Core/Vulkan/VulkanComputeTracer.h>
+#include <Core/Vulkan/VulkanPipelineCache.h>
+#include <Core/Instrumentation/Zones.h>
+
+#include <IO/Arguments.h>
+#include <IO/Logging.h>
+#include <Statics.h>
+
+using namespace TR;
+
+struct RenderBenchmarkResult
+{
+    std::string device;
+    TRFloat gpuMs = 0.0;
+    TRFloat cpuMs = 0.0;
+    TRFloat error = 0.0;                            // GPU against the reference
+    TRFloat noise = 0.0;                            // Reference against the reference, with another seed
+};
+
+static TR_STATUS
+RenderOnGpu(
+    const Scene &scene,
+    const BVH &bvh,
+    const RenderSettings &settings,
+    std::vector<float> &out,
+    RenderBenchmarkResult &result
+) {
+    try
+    {
+        const Platform platform = getenv( "WAYLAND_DISPLAY" ) ? Platform_Wayland : Platform_X11;
+        Core::Vulkan::VulkanObject instance( APPNAME, {1, 0, 0}, platform );
+        Core::Vulkan::VulkanDeviceObject device = GlobalArgumentsDefault.GPUName ? instance.CreateDevice( GlobalArgumentsDefault.GPUName )
+                                                                                 : instance.CreateDevice();
+        Core::Vulkan::VulkanAllocatorObject allocator( device );
+        Core::Vulkan::VulkanPipelineCacheObject cache( device );
+        Core::Vulkan::VulkanComputeTracerObject tracer( device, allocator, &cache );
+        RenderSettings warmup = settings;
+        TRULong start;
+
+        result.device = device.Info()->Properties.deviceName;
+        tracer.LoadScene( scene, bvh );
+
+        // Sizes the buffers and gets the first dispatch out of the way.
+        warmup.Samples = 1;
+        tracer.Render( warmup, out.data() );
+
+        start = ZoneTimestamp();
+        tracer.Render( settings, out.data() );
+        result.gpuMs = (TRFloat)(ZoneTimestamp() - start) / 1e6;
+    } catch ( const TRException &e )
+    {
+        ERROR( "The compute tracer failed with %d\n", e.status );
+        return e.status;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+WriteRenderBenchmark(
+    TRCString outputPath,
+    const RenderSettings &settings,
+    const RenderBenchmarkResult &result,
+    TRBool passed
+) {
+    const TRFloat paths = (TRFloat)settings.Width * settings.Height * settings.Samples;
+    FILE *file;
+
+    if (!(file = fopen( outputPath, "w" )))
+    {
+        ERROR( "Could not open %s for the render benchmark\n", outputPath );
+        return T_ACCESSDENIED;
+    }
+
+    fprintf( file, "{\"scene\":\"cornell-box\",\"device\":\"%s\",\"width\":%u,\"height\":%u,\"samples\":%u,\"max_depth\":%u,\n",
+             result.device.c_str(), settings.Width, settings.Height, settings.Samples, settings.MaxDepth );
+    fprintf( file, "\"gpu_ms\":%.3f,\"cpu_ms\":%.3f,\"gpu_mpaths_per_second\":%.3f,\"cpu_mpaths_per_second\":%.3f,\"speedup\":%.2f,\n",
+             result.gpuMs, result.cpuMs, paths / result.gpuMs / 1e3, paths / result.cpuMs / 1e3, result.cpuMs / result.gpuMs );
+    fprintf( file, "\"rmse\":%.6f,\"noise_rmse\":%.6f,\"tolerance\":%.2f,\"passed\":%s}\n",
+             result.error, result.noise, RENDER_BENCHMARK_TOLERANCE, passed ? "true" : "false" );
+
+    if ( fclose( file ) )
+    {
+        ERROR( "Could not write the render benchmark to %s\n", outputPath );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+TR_STATUS
+RunRenderBenchmark(
+    IN TRCString outputPath
+) {
+    const RenderSettings settings = { RENDER_BENCHMARK_SIZE, RENDER_BENCHMARK_SIZE, RENDER_BENCHMARK_SAMPLES, RENDER_BENCHMARK_DEPTH, 1 };
+    const TRSize count = (TRSize)settings.Width * settings.Height * 3;
+    std::vector<float> gpu( count ), reference( count ), second( count );
+    RenderBenchmarkResult result;
+    RenderSettings other;
+    Scene scene;
+    BVH bvh;
+    TR_STATUS status;
+    TRULong start;
+    TRBool passed;
+
+    TR_ZONE( "RenderBenchmark" );
+
+    status = SceneCreateCornellBox( &scene );
+    if ( FAILED( status ) ) return status;
+    status = BVHBuild( &scene, &bvh );
+    if ( FAILED( status ) )
+    {
+        SceneFree( &scene );
+        return status;
+    }
+
+    status = RenderOnGpu( scene, bvh, settings, gpu, result );
+    if ( FAILED( status ) ) goto done;
+
+    // The reference uses other seeds, the same one would follow the GPU's paths one by one.
+    other = settings;
+    other.Seed = settings.Seed + 1;
+    start = ZoneTimestamp();
+    status = RenderReference( &scene, &bvh, &other, reference.data() );
+    if ( FAILED( status ) ) goto done;
+    result.cpuMs = (TRFloat)(ZoneTimestamp() - start) / 1e6;
+
+    other.Seed = settings.Seed + 2;
+    status = RenderReference( &scene, &bvh, &other, second.data() );
+    if ( FAILED( status ) ) goto done;
+
+    result.error = RenderRootMeanSquareError( gpu.data(), reference.data(), count );
+    result.noise = RenderRootMeanSquareError( second.data(), reference.data(), count );
+    passed = result.error < RENDER_BENCHMARK_TOLERANCE * result.noise;
+
+    INFO( "Compute tracer on %s: %.1f ms, reference %.1f ms, RMSE %.4f against a noise floor of %.4f\n",
+          result.device.c_str(), result.gpuMs, result.cpuMs, result.error, result.noise );
+    if ( !passed )
+        ERROR( "The compute tracer does not converge to the reference\n" );
+
+    status = WriteRenderBenchmark( outputPath, settings, result, passed );
+    if ( FAILED( status ) ) goto done;
+    status = passed ? T_SUCCESS : T_ERROR;
+
+done:
+    BVHFree( &bvh );
+    SceneFree( &scene );
+
+    return status;
+}
@@ -21,9 +21,14 @@
  */
 
 #include <Application/Splash/SplashWindow.hpp>
+#include <Application/StartupGraph.hpp>
 
 #include <Core/Vulkan/Vulkan.h>
-#include <Core/Async/AsyncAwaiter.hpp>
+#include <Core/Vulkan/VulkanAllocator.h>
+#include <Core/Vulkan/VulkanComputeTracer.h>
+#include <Core/Vulkan/VulkanPipelineCache.h>
+#include <Core/Instrumentation/StartupBenchmark.h>
+#include <Core/Instrumentation/Zones.h>
 
 #include <UI/UI.h>
 #include <Statics.h>
@@ -33,14 +38,17 @@
 
 using namespace TR;
 
-void
-CustomAsync( UI::GTKWindowObject *window, void *param, PropVariant *result )
+// Kept until the first frame was drawn, which can come after every phase is done.
+static std::shared_ptr<Application::StartupGraph> SplashStartup;
+
+struct SplashProbe
 {
-    sleep(2);
-    window->SetResizable( true );
-    result->type = VT_STRING;
-    result->stringVal = "Hello, World!";
-}
+    Core::Vulkan::VulkanObject instance;
+    Core::Vulkan::VulkanDeviceObject device;
+    Core::Vulkan::VulkanPipelineCacheObject pipelines;
+    Core::Vulkan::VulkanAllocatorObject allocator;
+    Core::Vulkan::VulkanComputeTracerObject tracer;
+};
 
 void
 OnDelete( const UI::GTKWindowObject &window, void *param )
@@ -49,46 +57,37 @@ OnDelete( const UI::GTKWindowObject &window, void *param )
 }
 
 void
-SplashWindow(
-    const UI::GTKObject &inGtk
+OnFirstFrame( const UI::GTKWindowObject &window, void *param )
+{
+    if ( SplashStartup )
+        SplashStartup->Mark( "first-frame" );
+}
+
+static void
+BuildSplashWindow(
+    const std::shared_ptr<UI::GTKWindowObject> &windowPtr
 ) {
-    TRInt token;
     TRPath *splashPicturePath;
 
-    Core::Vulkan::VulkanObject vkInst;
-    Core::Vulkan::VulkanDeviceObject device;
     UI::GTKPictureObject picture;
     UI::GTKWindowHandleObject windowHandle{};
     UI::GTKSpinnerObject spinner{};
     UI::GTKOverlayObject overlay{};
-    UI::GTKWindowObject window = inGtk.CreateWindow();
     UI::GTKBoxObject box( GTK_ORIENTATION_HORIZONTAL, 5 );
     UI::GTKLabelObject label( "Loading..." );
 
-    auto windowPtr = std::make_shared<UI::GTKWindowObject>( std::move( window ) );
-
     FetchResource( "launch.png", &splashPicturePath );
 
+    // Sized from the image header, the pixels are decoded in the background.
     picture = UI::GTKPictureObject( splashPicturePath );
-    free( splashPicturePath );
-
-    Core::Async::AwaitableAsyncOperationObject asyncOperation( windowPtr.get(), nullptr, CustomAsync );
-
-    asyncOperation.await();
-
-    vkInst = Core::Vulkan::VulkanObject( "Test", {1, 0, 0}, inGtk.CurrentPlatform() );
-
-    device = vkInst.CreateDevice( GlobalArgumentsDefault.GPUName );
-
-    if ( !device.SupportsExtension( "VK_KHR_ray_tracing_pipeline" ) )
-        WARN( "This device does not support ray tracing!\n" );
+    FreePath( splashPicturePath );
 
     spinner.Spinning( true );
-    spinner.QueryInterface<UI::GTKWidgetObject>().Alignment( { .Horizontal = GTK_ALIGN_START, .Vertical = GTK_ALIGN_END } );
-    spinner.QueryInterface<UI::GTKWidgetObject>().SetSizeRequest( 48, 48 );
+    spinner.Borrow<UI::GTKWidgetObject>()->Alignment( { .Horizontal = GTK_ALIGN_START, .Vertical = GTK_ALIGN_END } );
+    spinner.Borrow<UI::GTKWidgetObject>()->SetSizeRequest( 48, 48 );
 
-    label.QueryInterface<UI::GTKWidgetObject>().Alignment( { .Horizontal = GTK_ALIGN_CENTER, .Vertical = GTK_ALIGN_END } );
-    label.QueryInterface<UI::GTKWidgetObject>().SetSizeRequest( 48, 48 );
+    label.Borrow<UI::GTKWidgetObject>()->Alignment( { .Horizontal = GTK_ALIGN_CENTER, .Vertical = GTK_ALIGN_END } );
+    label.Borrow<UI::GTKWidgetObject>()->SetSizeRequest( 48, 48 );
 
     overlay.ChildWidget( picture );
     overlay.AddWidget( spinner );
@@ -103,8 +102,75 @@ SplashWindow(
 
     windowPtr->OnDelete( OnDelete, nullptr );
     windowPtr->OnDelete( OnDelete, nullptr );
+    windowPtr->OnFirstFrame( OnFirstFrame, nullptr );
 
     windowHandle.ChildWidget( box );
 
     windowPtr->Show();
 }
+
+/**
+ * The window goes up first and Vulkan is probed on the worker threads meanwhile,
+ * nothing the splash draws depends on the device.
+ */
+void
+SplashWindow(
+    const UI::GTKObject &inGtk
+) {
+    TR_ZONE( "SplashWindow" );
+
+    auto graph = Application::StartupGraph::Create();
+    auto windowPtr = std::make_shared<UI::GTKWindowObject>( inGtk.CreateWindow() );
+    auto probe = std::make_shared<SplashProbe>();
+    const Platform platform = inGtk.CurrentPlatform();
+
+    graph->Add( "splash-window", Application::StartupThread::Main, {}, [windowPtr]
+    {
+        BuildSplashWindow( windowPtr );
+    } );
+
+    graph->Add( "vulkan-instance", Application::StartupThread::Worker, {}, [probe, platform]
+    {
+        probe->instance = Core::Vulkan::VulkanObject( "Test", {1, 0, 0}, platform );
+    } );
+
+    graph->Add( "vulkan-device", Application::StartupThread::Worker, { "vulkan-instance" }, [probe]
+    {
+        probe->device = GlobalArgumentsDefault.GPUName ? probe->instance.CreateDevice( GlobalArgumentsDefault.GPUName )
+                                                       : probe->instance.CreateDevice();
+
+        if ( !probe->device.SupportsExtension( "VK_KHR_ray_tracing_pipeline" ) )
+            INFO( "This device does not support ray tracing, rendering falls back to compute shaders\n" );
+    } );
+
+    // Reading the blob is the whole cost on a warm start, compiling only starts with the first pipeline.
+    graph->Add( "pipeline-cache", Application::StartupThread::Worker, { "vulkan-device" }, [probe]
+    {
+        probe->pipelines = Core::Vulkan::VulkanPipelineCacheObject( probe->device );
+    } );
+
+    // Compiles the path tracing kernels into the cache, a warm cache makes this cheap.
+    graph->Add( "compute-tracer", Application::StartupThread::Worker, { "pipeline-cache" }, [probe]
+    {
+        probe->allocator = Core::Vulkan::VulkanAllocatorObject( probe->device );
+        probe->tracer = Core::Vulkan::VulkanComputeTracerObject( probe->device, probe->allocator, &probe->pipelines );
+    } );
+
+    graph->Expect( "first-frame" );
+
+    // The graph finishes long after SplashWindow returned, it has to hold its own reference.
+    graph->OnFinished( [app = std::make_shared<UI::GTKObject>( inGtk.QueryInterface<UI::GTKObject>() )]
+    {
+        SplashStartup.reset();
+
+        // Headless runs for the benchmark script end here.
+        if ( StartupBenchmarkEnabled )
+        {
+            WriteStartupBenchmark();
+            app->Quit();
+        }
+    } );
+
+    SplashStartup = graph;
+    graph->Run();
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: StartupGraph.cpp
+ *  Description: Runs startup phases as a dependency graph.
+ */
+
+#include <cstring>
+
+#include <glib.h>
+
+#include <Application/StartupGraph.hpp>
+
+#include <Core/Async/AsyncOperation.h>
+#include <Core/Instrumentation/StartupBenchmark.h>
+#include <Core/Instrumentation/Zones.h>
+#include <IO/Arguments.h>
+
+using namespace TR;
+using namespace TR::Application;
+
+namespace
+{
+    struct Dispatched
+    {
+        std::shared_ptr<StartupGraph> graph;
+        TRSize index;
+    };
+
+    TRFloat
+    Milliseconds(
+        IN TRULong nanoseconds
+    ) {
+        return (TRFloat)nanoseconds / 1e6;
+    }
+}
+
+std::shared_ptr<StartupGraph>
+StartupGraph::Create()
+{
+    std::shared_ptr<StartupGraph> graph( new StartupGraph() );
+    graph->origin_ = ZoneTimestamp();
+    return graph;
+}
+
+StartupGraph &
+StartupGraph::Add(
+    IN TRCString name,
+    IN StartupThread thread,
+    IN std::initializer_list<TRCString> after,
+    IN Phase phase
+) {
+    auto node = std::make_unique<Node>();
+    const TRSize index = nodes_.size();
+
+    node->name = name;
+    node->thread = thread;
+    node->phase = std::move( phase );
+    node->waiting = after.size();
+    node->skipped = false;
+    node->failed = false;
+
+    for ( TRCString dependency : after )
+    {
+        TRSize found = 0;
+
+        while ( found < index && strcmp( nodes_[found]->name, dependency ) )
+            found++;
+
+        if ( found == index )
+        {
+            ERROR( "startup phase %s runs after %s, which has not been added\n", name, dependency );
+            throw TRException( T_INVALIDARG );
+        }
+
+        nodes_[found]->dependents.push_back( index );
+    }
+
+    nodes_.push_back( std::move( node ) );
+    remaining_++;
+    return *this;
+}
+
+StartupGraph &
+StartupGraph::Expect(
+    IN TRCString name
+) {
+    std::lock_guard lock( marksLock_ );
+
+    expected_.push_back( name );
+    remaining_++;
+    return *this;
+}
+
+StartupGraph &
+StartupGraph::OnFinished(
+    IN std::function<void()> finished
+) {
+    finished_.push_back( std::move( finished ) );
+    return *this;
+}
+
+void
+StartupGraph::Mark(
+    IN TRCString name
+) {
+    const TRULong at = ZoneTimestamp() - origin_;
+    TRBool expected = false;
+
+    StartupMark( name );
+
+    {
+        std::lock_guard lock( marksLock_ );
+
+        marks_.push_back( { name, at } );
+
+        for ( auto it = expected_.begin(); it != expected_.end(); ++it )
+            if ( !strcmp( *it, name ) )
+            {
+                expected_.erase( it );
+                expected = true;
+                break;
+            }
+
+        if ( reported_ && GlobalArgumentsDefault.StartupProfile )
+            INFO( "startup: %s reached at %.2f ms\n", name, Milliseconds( at ) );
+    }
+
+    if ( expected && remaining_.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+        Complete();
+}
+
+void
+StartupGraph::Run()
+{
+    // Workers first, so they are already busy while the main thread runs its share.
+    for ( StartupThread thread : { StartupThread::Worker, StartupThread::Main } )
+        for ( TRSize index = 0; index < nodes_.size(); index++ )
+            if ( nodes_[index]->thread == thread && !nodes_[index]->waiting )
+                Dispatch( index );
+}
+
+void
+StartupGraph::Dispatch(
+    IN TRSize index
+) {
+    // Deleted by whichever side ends up running the phase.
+    auto const dispatched = new Dispatched{ shared_from_this(), index };
+
+    if ( nodes_[index]->thread == StartupThread::Main )
+    {
+        // Runs right away when the caller already owns the main context.
+        g_main_context_invoke( nullptr, RunMainPhase, dispatched );
+        return;
+    }
+
+    _AsyncOperationObject *operation;
+    const TR_STATUS status = new_async_operation_object_override_callback( nullptr, dispatched, RunWorkerPhase, &operation );
+
+    if ( FAILED( status ) )
+    {
+        ERROR( "Could not queue startup phase %s, running it inline. Error was %d\n", nodes_[index]->name, status );
+        RunWorkerPhase( nullptr, dispatched, nullptr );
+        return;
+    }
+
+    // The pool holds its own reference until the phase has run.
+    operation->lpVtbl->Release( operation );
+}
+
+TR_STATUS
+StartupGraph::RunWorkerPhase(
+    IN _UnknownObject *invoker,
+    IN void *param,
+    OUT PropVariant *result
+) {
+    const std::unique_ptr<Dispatched> dispatched( static_cast<Dispatched *>( param ) );
+
+    dispatched->graph->Execute( dispatched->index );
+    return T_SUCCESS;
+}
+
+TRInt
+StartupGraph::RunMainPhase(
+    IN void *param
+) {
+    const std::unique_ptr<Dispatched> dispatched( static_cast<Dispatched *>( param ) );
+
+    dispatched->graph->Execute( dispatched->index );
+    return G_SOURCE_REMOVE;
+}
+
+void
+StartupGraph::Execute(
+    IN TRSize index
+) {
+    Node &node = *nodes_[index];
+
+    node.start = ZoneTimestamp();
+
+    if ( !node.skipped )
+    {
+        try
+        {
+            node.phase();
+        } catch ( const TRException &e )
+        {
+            ERROR( "startup phase %s failed with %d, skipping what depends on it\n", node.name, e.status );
+            node.failed = true;
+        }
+    }
+
+    node.end = ZoneTimestamp();
+
+    if ( !node.skipped && !node.failed )
+        StartupMark( node.name );
+
+    if ( ZonesEnabled && !node.skipped && !node.failed )
+        ZoneRecord( node.name, node.start, node.end - node.start );
+
+    Finish( index );
+}
+
+void
+StartupGraph::Finish(
+    IN TRSize index
+) {
+    for ( TRSize dependent : nodes_[index]->dependents )
+    {
+        if ( nodes_[index]->skipped || nodes_[index]->failed )
+            nodes_[dependent]->skipped = true;
+
+        if ( nodes_[dependent]->waiting.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+            Dispatch( dependent );
+    }
+
+    // The last phase to finish sees every other phase's timings.
+    if ( remaining_.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+        Complete();
+}
+
+void
+StartupGraph::Complete()
+{
+    Report();
+
+    if ( !finished_.empty() )
+        g_main_context_invoke( nullptr, RunFinished, new std::shared_ptr<StartupGraph>( shared_from_this() ) );
+}
+
+TRInt
+StartupGraph::RunFinished(
+    IN void *param
+) {
+    const std::unique_ptr<std::shared_ptr<StartupGraph>> graph( static_cast<std::shared_ptr<StartupGraph> *>( param ) );
+
+    for ( const auto &finished : (*graph)->finished_ )
+    {
+        try
+        {
+            finished();
+        } catch ( const TRException &e )
+        {
+            ERROR( "startup finished handler failed with %d\n", e.status );
+        }
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+void
+StartupGraph::Report()
+{
+    std::lock_guard lock( marksLock_ );
+
+    reported_ = true;
+
+    if ( !GlobalArgumentsDefault.StartupProfile )
+        return;
+
+    INFO( "startup: %zu phases finished after %.2f ms\n", nodes_.size(), Milliseconds( ZoneTimestamp() - origin_ ) );
+
+    for ( const auto &node : nodes_ )
+    {
+        if ( node->skipped || node->failed )
+            INFO( "startup:   %-24s %-6s %s\n", node->name, node->thread == StartupThread::Main ? "main" : "worker",
+                  node->failed ? "failed" : "skipped" );
+        else
+            INFO( "startup:   %-24s %-6s %8.2f ms -> %8.2f ms, took %8.2f ms\n", node->name,
+                  node->thread == StartupThread::Main ? "main" : "worker", Milliseconds( node->start - origin_ ),
+                  Milliseconds( node->end - origin_ ), Milliseconds( node->end - node->start ) );
+    }
+
+    for ( const auto &mark : marks_ )
+        INFO( "startup: %s reached at %.2f ms\n", mark.name, Milliseconds( mark.at ) );
+}
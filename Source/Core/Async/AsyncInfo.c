@@ -33,33 +33,22 @@ static struct async_info_object *impl_from_AsyncInfoObject( AsyncInfoObject *ifa
     return CONTAINING_RECORD( iface, struct async_info_object, AsyncInfoObject_iface );
 }
 
-static TR_STATUS async_info_object_QueryInterface( AsyncInfoObject *iface, const TRUUID uuid, void **out )
-{
-    const struct async_info_object *impl = impl_from_AsyncInfoObject( iface );
+DEFINE_SLAB_CACHE( async_info_object, MEMORY_TAG_ASYNC );
 
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+// The state lives as long as the info object, so it is borrowed instead of queried.
+static AsyncStateObject *state_from_AsyncInfoObject( AsyncInfoObject *iface )
+{
+    return impl_from_AsyncInfoObject( iface )->AsyncStateObject_impl;
+}
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_AsyncInfoObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( async_info_object,
+    INTERFACE_ENTRY( UnknownObject, async_info_object, AsyncInfoObject_iface ),
+    INTERFACE_ENTRY( AsyncInfoObject, async_info_object, AsyncInfoObject_iface ),
+    INTERFACE_ENTRY_MEMBER( AsyncStateObject, async_info_object, AsyncStateObject_impl ) );
 
-    if ( !uuid_compare( uuid, IID_AsyncStateObject ) )
-    {
-        if ( !impl->AsyncStateObject_impl )
-        {
-            ERROR( "Subclass AsyncStateObject for AsyncOperationObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->AsyncStateObject_impl->lpVtbl->AddRef( impl->AsyncStateObject_impl );
-        *out = impl->AsyncStateObject_impl;
-        return T_SUCCESS;
-    }
-
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS async_info_object_QueryInterface( AsyncInfoObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &async_info_object_interfaces, impl_from_AsyncInfoObject( iface ), uuid, out );
 }
 
 static TRLong async_info_object_AddRef( AsyncInfoObject *iface )
@@ -79,69 +68,49 @@ static TRLong async_info_object_Release( AsyncInfoObject *iface )
     {
         if ( impl->AsyncStateObject_impl )
             impl->AsyncStateObject_impl->lpVtbl->Release( impl->AsyncStateObject_impl );
-        free( impl );
+        SlabFree( &async_info_object_cache, impl );
     }
     return removed;
 }
 
 static TR_STATUS async_info_object_get_CurrentStatus( AsyncInfoObject *iface, AsyncStatus *out )
 {
-    TR_STATUS status;
-    AsyncStateObject *state;
+    AsyncStateObject *state = state_from_AsyncInfoObject( iface );
 
     TRACE( "iface %p, out %p\n", iface, out );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_AsyncStateObject, (void **)&state );
-    if ( FAILED( status ) ) return status;
-
-    status = state->lpVtbl->get_CurrentStatus( state, out );
-    state->lpVtbl->Release( state );
-    return status;
+    if ( !state ) return T_NOINIT;
+    return state->lpVtbl->get_CurrentStatus( state, out );
 }
 
 static TR_STATUS async_info_object_get_ErrorCode( AsyncInfoObject *iface, TR_STATUS *out )
 {
-    TR_STATUS status;
-    AsyncStateObject *state;
+    AsyncStateObject *state = state_from_AsyncInfoObject( iface );
 
     TRACE( "iface %p, out %p\n", iface, out );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_AsyncStateObject, (void **)&state );
-    if ( FAILED( status ) ) return status;
-
-    status = state->lpVtbl->get_ErrorCode( state, out );
-    state->lpVtbl->Release( state );
-    return status;
+    if ( !state ) return T_NOINIT;
+    return state->lpVtbl->get_ErrorCode( state, out );
 }
 
 static TR_STATUS async_info_object_Cancel( AsyncInfoObject *iface )
 {
-    TR_STATUS status;
-    AsyncStateObject *state;
+    AsyncStateObject *state = state_from_AsyncInfoObject( iface );
 
     TRACE( "iface %p\n", iface );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_AsyncStateObject, (void **)&state );
-    if ( FAILED( status ) ) return status;
-
-    status = state->lpVtbl->Cancel( state );
-    state->lpVtbl->Release( state );
-    return status;
+    if ( !state ) return T_NOINIT;
+    return state->lpVtbl->Cancel( state );
 }
 
 static TR_STATUS async_info_object_Close( AsyncInfoObject *iface )
 {
-    TR_STATUS status;
-    AsyncStateObject *state;
+    AsyncStateObject *state = state_from_AsyncInfoObject( iface );
 
     TRACE( "iface %p\n", iface );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_AsyncStateObject, (void **)&state );
-    if ( FAILED( status ) ) return status;
-
-    status = state->lpVtbl->Close( state );
-    state->lpVtbl->Release( state );
-    return status;
+    if ( !state ) return T_NOINIT;
+    return state->lpVtbl->Close( state );
 }
 
 static AsyncInfoInterface async_info_interface =
@@ -166,7 +135,7 @@ TR_STATUS TR_API new_async_info_object_override_callback_and_outer( IN UnknownOb
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &async_info_object_cache ))) return T_OUTOFMEMORY;
     impl->AsyncInfoObject_iface.lpVtbl = &async_info_interface;
     impl->ref = 1;
 
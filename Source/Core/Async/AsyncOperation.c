@@ -33,45 +33,27 @@ static struct async_operation_object *impl_from_AsyncOperationObject( AsyncOpera
     return CONTAINING_RECORD( iface, struct async_operation_object, AsyncOperationObject_iface );
 }
 
-static TR_STATUS async_operation_object_QueryInterface( AsyncOperationObject *iface, const TRUUID uuid, void **out )
+DEFINE_SLAB_CACHE( async_operation_object, MEMORY_TAG_ASYNC );
+
+// The nested state lives as long as the operation, so it is borrowed instead of queried twice.
+static AsyncStateObject *state_from_AsyncOperationObject( AsyncOperationObject *iface )
 {
     const struct async_operation_object *impl = impl_from_AsyncOperationObject( iface );
 
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
-
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_AsyncOperationObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
-
-    if ( !uuid_compare( uuid, IID_AsyncInfoObject ) )
-    {
-        if ( !impl->AsyncInfoObject_impl )
-        {
-            ERROR( "Subclass AsyncInfoObject for AsyncOperationObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->AsyncInfoObject_impl->lpVtbl->AddRef( impl->AsyncInfoObject_impl );
-        *out = impl->AsyncInfoObject_impl;
-        return T_SUCCESS;
-    }
+    if ( !impl->AsyncInfoObject_impl ) return nullptr;
+    return CONTAINING_RECORD( impl->AsyncInfoObject_impl, struct async_info_object, AsyncInfoObject_iface )->AsyncStateObject_impl;
+}
 
-    // Nested subclass AsyncStateObject:
-    if ( !uuid_compare( uuid, IID_AsyncStateObject ) )
-    {
-        if ( !impl->AsyncInfoObject_impl )
-        {
-            ERROR( "Subclass AsyncStateObject for AsyncOperationObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->AsyncInfoObject_impl->lpVtbl->QueryInterface( impl->AsyncInfoObject_impl, IID_AsyncStateObject, out );
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( async_operation_object,
+    INTERFACE_ENTRY( UnknownObject, async_operation_object, AsyncOperationObject_iface ),
+    INTERFACE_ENTRY( AsyncOperationObject, async_operation_object, AsyncOperationObject_iface ),
+    INTERFACE_ENTRY_MEMBER( AsyncInfoObject, async_operation_object, AsyncInfoObject_impl ),
+    // Nested subclass AsyncStateObject, resolved by the AsyncInfoObject
+    INTERFACE_ENTRY_FORWARD( AsyncStateObject, async_operation_object, AsyncInfoObject_impl ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS async_operation_object_QueryInterface( AsyncOperationObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &async_operation_object_interfaces, impl_from_AsyncOperationObject( iface ), uuid, out );
 }
 
 static TRLong async_operation_object_AddRef( AsyncOperationObject *iface )
@@ -91,54 +73,39 @@ static TRLong async_operation_object_Release( AsyncOperationObject *iface )
     {
         if ( impl->AsyncInfoObject_impl )
             impl->AsyncInfoObject_impl->lpVtbl->Release( impl->AsyncInfoObject_impl );
-        free( impl );
+        SlabFree( &async_operation_object_cache, impl );
     }
     return removed;
 }
 
 static TR_STATUS async_operation_object_get_Completed( AsyncOperationObject *iface, AsyncOperationCompletedHandlerObject **out )
 {
-    TR_STATUS status;
-    AsyncStateObject *state;
+    AsyncStateObject *state = state_from_AsyncOperationObject( iface );
 
     TRACE( "iface %p, out %p\n", iface, out );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_AsyncStateObject, (void **)&state );
-    if ( FAILED( status ) ) return status;
-
-    status = state->lpVtbl->get_Completed( state, (AsyncStateCompletedHandlerObject **)out );
-    state->lpVtbl->Release( state );
-    return status;
+    if ( !state ) return T_NOINIT;
+    return state->lpVtbl->get_Completed( state, (AsyncStateCompletedHandlerObject **)out );
 }
 
 static TR_STATUS async_operation_object_set_Completed( AsyncOperationObject *iface, AsyncOperationCompletedHandlerObject *completed )
 {
-    TR_STATUS status;
-    AsyncStateObject *state;
+    AsyncStateObject *state = state_from_AsyncOperationObject( iface );
 
     TRACE( "iface %p, completed %p\n", iface, completed );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_AsyncStateObject, (void **)&state );
-    if ( FAILED( status ) ) return status;
-
-    status = state->lpVtbl->set_Completed( state, (AsyncStateCompletedHandlerObject *)completed );
-    state->lpVtbl->Release( state );
-    return status;
+    if ( !state ) return T_NOINIT;
+    return state->lpVtbl->set_Completed( state, (AsyncStateCompletedHandlerObject *)completed );
 }
 
 static TR_STATUS async_operation_object_GetResults( AsyncOperationObject *iface, PropVariant **out )
 {
-    TR_STATUS status;
-    AsyncStateObject *state;
+    AsyncStateObject *state = state_from_AsyncOperationObject( iface );
 
     TRACE( "iface %p, out %p\n", iface, out );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_AsyncStateObject, (void **)&state );
-    if ( FAILED( status ) ) return status;
-
-    status = state->lpVtbl->Result( state, out );
-    state->lpVtbl->Release( state );
-    return status;
+    if ( !state ) return T_NOINIT;
+    return state->lpVtbl->Result( state, out );
 }
 
 static AsyncOperationInterface async_operation_interface =
@@ -165,14 +132,14 @@ TR_STATUS TR_API new_async_operation_object_override_callback( IN UnknownObject
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &async_operation_object_cache ))) return T_OUTOFMEMORY;
     impl->AsyncOperationObject_iface.lpVtbl = &async_operation_interface;
     impl->ref = 1;
 
     status = new_async_info_object_override_callback_and_outer( invoker, param, callback, (UnknownObject *)&impl->AsyncOperationObject_iface, &impl->AsyncInfoObject_impl );
     if ( FAILED( status ) )
     {
-        free( impl );
+        SlabFree( &async_operation_object_cache, impl );
         return status;
     }
 
@@ -180,7 +147,7 @@ TR_STATUS TR_API new_async_operation_object_override_callback( IN UnknownObject
     if ( FAILED( status ) )
     {
         impl->AsyncInfoObject_impl->lpVtbl->Release( impl->AsyncInfoObject_impl );
-        free( impl );
+        SlabFree( &async_operation_object_cache, impl );
         return status;
     }
 
@@ -189,7 +156,7 @@ TR_STATUS TR_API new_async_operation_object_override_callback( IN UnknownObject
     {
         impl->AsyncInfoObject_impl->lpVtbl->Release( impl->AsyncInfoObject_impl );
         state->lpVtbl->Release( state );
-        free( impl );
+        SlabFree( &async_operation_object_cache, impl );
         return status;
     }
 
@@ -34,19 +34,15 @@ static struct async_operation_completed_handler_default_object *impl_from_AsyncO
     return CONTAINING_RECORD( iface, struct async_operation_completed_handler_default_object, AsyncOperationCompletedHandlerObject_iface );
 }
 
-static TR_STATUS async_operation_completed_handler_default_object_QueryInterface( AsyncOperationCompletedHandlerObject *iface, const TRUUID uuid, void **out )
-{
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+DEFINE_SLAB_CACHE( async_operation_completed_handler_default_object, MEMORY_TAG_ASYNC );
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_AsyncOperationCompletedHandlerObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( async_operation_completed_handler_default_object,
+    INTERFACE_ENTRY( UnknownObject, async_operation_completed_handler_default_object, AsyncOperationCompletedHandlerObject_iface ),
+    INTERFACE_ENTRY( AsyncOperationCompletedHandlerObject, async_operation_completed_handler_default_object, AsyncOperationCompletedHandlerObject_iface ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS async_operation_completed_handler_default_object_QueryInterface( AsyncOperationCompletedHandlerObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &async_operation_completed_handler_default_object_interfaces, impl_from_AsyncOperationCompletedHandlerObject( iface ), uuid, out );
 }
 
 static TRLong async_operation_completed_handler_default_object_AddRef( AsyncOperationCompletedHandlerObject *iface )
@@ -64,7 +60,7 @@ static TRLong async_operation_completed_handler_default_object_Release( AsyncOpe
     TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
     if ( !(removed - 1) )
     {
-        free( impl );
+        SlabFree( &async_operation_completed_handler_default_object_cache, impl );
     }
     return removed;
 }
@@ -73,7 +69,7 @@ static TR_STATUS async_operation_completed_handler_default_object_Invoke( AsyncO
 {
     const struct async_operation_completed_handler_default_object *impl = impl_from_AsyncOperationCompletedHandlerObject( iface );
     TRACE( "iface %p, info %p, status %d\n", iface, info, status );
-    info->lpVtbl->AddRef( info ); // Ownership is handed to invoker.
+    // info is borrowed, the caller keeps it alive until the callback returns.
     return impl->callback( info, impl->param, status );
 }
 
@@ -96,7 +92,7 @@ TR_STATUS TR_API async_operation_completed_handler_default_object_override_callb
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &async_operation_completed_handler_default_object_cache ))) return T_OUTOFMEMORY;
     impl->AsyncOperationCompletedHandlerObject_iface.lpVtbl = &async_operation_completed_handler_default_interface;
     impl->callback = callback;
     impl->param = param;
@@ -29,27 +29,29 @@
 #include <glib.h>
 
 #include <Core/Async/AsyncState.h>
+#include <Core/Instrumentation/Zones.h>
 
 #define HANDLER_NOT_SET (AsyncStateCompletedHandlerObject *)((void *)~(TRULong)0)
 
+static void async_state_object_callback( void *iface, void *user_data );
+
+// One pool for every async state. Creating one per operation spawned a thread per core each time.
+static GThreadPool *SharedPool;
+
 static struct async_state_object *impl_from_AsyncStateObject( AsyncStateObject *iface )
 {
     return CONTAINING_RECORD( iface, struct async_state_object, AsyncStateObject_iface );
 }
 
-static TR_STATUS async_state_object_QueryInterface( AsyncStateObject *iface, const TRUUID uuid, void **out )
-{
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+DEFINE_SLAB_CACHE( async_state_object, MEMORY_TAG_ASYNC );
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_AsyncStateObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( async_state_object,
+    INTERFACE_ENTRY( UnknownObject, async_state_object, AsyncStateObject_iface ),
+    INTERFACE_ENTRY( AsyncStateObject, async_state_object, AsyncStateObject_iface ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS async_state_object_QueryInterface( AsyncStateObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &async_state_object_interfaces, impl_from_AsyncStateObject( iface ), uuid, out );
 }
 
 static TRLong async_state_object_AddRef( AsyncStateObject *iface )
@@ -73,7 +75,7 @@ static TRLong async_state_object_Release( AsyncStateObject *iface )
         if ( impl->invoker )
             impl->invoker->lpVtbl->Release( impl->invoker );
         pthread_mutex_destroy( &impl->lock );
-        free( impl );
+        SlabFree( &async_state_object_cache, impl );
     }
     return removed;
 }
@@ -202,10 +204,13 @@ static TR_STATUS async_state_object_Start( AsyncStateObject *iface )
 {
     struct async_state_object *impl = impl_from_AsyncStateObject( iface );
 
+    TR_ZONE( "AsyncState::Start" );
+
     TRACE( "iface %p\n", iface );
 
+    impl->flowId = ZoneFlowBegin( "AsyncOperation" );
     impl->outer->lpVtbl->AddRef( impl->outer ); // keep the async alive in the callback
-    g_thread_pool_push( impl->pool, (void *)&impl->AsyncStateObject_iface, nullptr );
+    g_thread_pool_push( SharedPool, (void *)&impl->AsyncStateObject_iface, nullptr );
 
     return T_SUCCESS;
 }
@@ -240,11 +245,7 @@ static TR_STATUS async_state_object_Close( AsyncStateObject *iface )
     if ( impl->CurrentStatus == AsyncStatus_Started )
         status = T_ILLEGAL_STATE_CHANGE;
     else if ( impl->CurrentStatus != AsyncStatus_Closed )
-    {
-        g_thread_pool_free( impl->pool, false, false );
-        impl->pool = nullptr;
         impl->CurrentStatus = AsyncStatus_Closed;
-    }
     pthread_mutex_unlock( &impl->lock );
 
     return status;
@@ -274,8 +275,11 @@ static void async_state_object_callback( void *iface, void *user_data )
 
     struct async_state_object *impl = impl_from_AsyncStateObject( (AsyncStateObject *)iface );
 
+    TR_ZONE( "AsyncState::Callback" );
+
     TRACE( "iface %p, user_data %p\n", iface, user_data );
 
+    ZoneFlowStep( "AsyncOperation", impl->flowId );
     PropVariantInit( &result );
 
     status = impl->callback( impl->invoker, impl->param, &result );
@@ -285,6 +289,7 @@ static void async_state_object_callback( void *iface, void *user_data )
         impl->CurrentStatus = FAILED( status ) ? AsyncStatus_Error : AsyncStatus_Completed;
     impl->result = &result;
     impl->ErrorCode = status;
+    ZoneFlowEnd( "AsyncOperation", impl->flowId );
 
     if ( impl->Completed && impl->Completed != HANDLER_NOT_SET )
     {
@@ -301,18 +306,40 @@ static void async_state_object_callback( void *iface, void *user_data )
     impl->outer->lpVtbl->Release( impl->outer );
 }
 
-TR_STATUS TR_API new_async_state_object_override_callback_and_outer( IN UnknownObject *invoker, IN void *param, IN async_operation_callback callback, IN UnknownObject *outer, OUT AsyncStateObject **out )
+static TR_STATUS async_state_shared_pool()
 {
+    static gsize initialized = 0;
+    static TR_STATUS status = T_SUCCESS;
     GError *error = nullptr;
 
+    if ( g_once_init_enter( &initialized ) )
+    {
+        // Not exclusive, so idle threads are shared with the rest of GLib instead of being spawned up front.
+        if (!(SharedPool = g_thread_pool_new( async_state_object_callback, nullptr, (gint)g_get_num_processors(), false, &error )))
+        {
+            ERROR( "Error while creating the async thread pool. Error was %s\n", error->message );
+            status = error->code;
+            g_error_free( error );
+        }
+        g_once_init_leave( &initialized, 1 );
+    }
+
+    return status;
+}
+
+TR_STATUS TR_API new_async_state_object_override_callback_and_outer( IN UnknownObject *invoker, IN void *param, IN async_operation_callback callback, IN UnknownObject *outer, OUT AsyncStateObject **out )
+{
+    TR_STATUS status;
     struct async_state_object *impl;
 
     TRACE( "invoker %p, param %p, callback %p, outer %p, out %p\n", invoker, param, callback, outer, out );
 
     if ( !out || !callback ) throw_NullPtrException();
 
+    if ( FAILED( status = async_state_shared_pool() ) ) return status;
+
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &async_state_object_cache ))) return T_OUTOFMEMORY;
     impl->AsyncStateObject_iface.lpVtbl = &async_state_interface;
     impl->ref = 1;
 
@@ -321,15 +348,6 @@ TR_STATUS TR_API new_async_state_object_override_callback_and_outer( IN UnknownO
     impl->CurrentStatus = AsyncStatus_Started;
     impl->outer = outer;
 
-    impl->pool = g_thread_pool_new( async_state_object_callback, nullptr, (gint)g_get_num_processors(), true, &error );
-
-    if ( !impl->pool )
-    {
-        ERROR( "Error while creating thread pool for object %p. Error was %s\n", impl, error->message );
-        free( impl );
-        return error->code;
-    }
-
     impl->invoker = invoker;
     if ( invoker )
         invoker->lpVtbl->AddRef( invoker );
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: PerfCounters.c
+ *  Description: Per-thread perf_event hardware counters attributed to named phases.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <Core/Instrumentation/PerfCounters.h>
+#include <IO/Logging.h>
+#include <Core/Memory/Memory.h>
+
+#define PERF_MAX_PHASES 64
+
+#define PERF_CACHE_CONFIG( cache ) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct
+{
+    TRUInt Type;
+    TRULong Config;
+    TRCString Name;
+} PerfCounterEvents[PERF_COUNTER_COUNT] =
+{
+    [PERF_COUNTER_CYCLES]        = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+    [PERF_COUNTER_INSTRUCTIONS]  = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+    [PERF_COUNTER_L1D_MISSES]    = { PERF_TYPE_HW_CACHE, PERF_CACHE_CONFIG( PERF_COUNT_HW_CACHE_L1D ), "L1D read misses" },
+    [PERF_COUNTER_LLC_MISSES]    = { PERF_TYPE_HW_CACHE, PERF_CACHE_CONFIG( PERF_COUNT_HW_CACHE_LL ), "LLC read misses" },
+    [PERF_COUNTER_BRANCH_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch misses" },
+};
+
+/**
+ * One counter group per thread, with cycles as the leader so every member is
+ * scheduled (and multiplexed) together. Members the PMU doesn't have are skipped.
+ */
+typedef struct _TR_PerfThread
+{
+    TRInt GroupFd;
+    TRInt Fds[PERF_COUNTER_COUNT];
+    TRULong Ids[PERF_COUNTER_COUNT];
+    TRBool Available[PERF_COUNTER_COUNT];
+    TRSize MemberCount;
+} PerfThread;
+
+// Layout of read() on the leader with PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_*.
+typedef struct _TR_PerfGroupRead
+{
+    TRULong Count;
+    TRULong TimeEnabled;
+    TRULong TimeRunning;
+    struct
+    {
+        TRULong Value;
+        TRULong Id;
+    } Values[PERF_COUNTER_COUNT];
+} PerfGroupRead;
+
+TRBool TR_API PerfCountersEnabled = false;
+
+static thread_local PerfThread *CurrentPerfThread = nullptr;
+static thread_local TRBool PerfThreadFailed = false;
+static pthread_key_t PerfThreadKey;
+static ATOMIC(TRBool) PerfWarned = false;
+
+static pthread_mutex_t PerfPhasesLock = PTHREAD_MUTEX_INITIALIZER;
+static PerfPhaseTotals PerfPhases[PERF_MAX_PHASES];
+static TRSize PerfPhaseCount = 0;
+
+static TRInt
+OpenPerfEvent(
+    IN PerfCounter counter,
+    IN TRInt groupFd
+) {
+    struct perf_event_attr attributes = {};
+
+    attributes.size = sizeof( attributes );
+    attributes.type = PerfCounterEvents[counter].Type;
+    attributes.config = PerfCounterEvents[counter].Config;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    return (TRInt)syscall( SYS_perf_event_open, &attributes, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC );
+}
+
+static void
+ClosePerfThread(
+    IN void *param
+) {
+    PerfThread *thread = param;
+    TRSize iterator;
+
+    for ( iterator = 0; iterator < PERF_COUNTER_COUNT; iterator++ )
+        if ( thread->Available[iterator] )
+            close( thread->Fds[iterator] );
+
+    TRFree( thread );
+}
+
+static PerfThread *
+GetPerfThread()
+{
+    PerfThread *thread = CurrentPerfThread;
+    TRSize iterator;
+    TRInt fd;
+
+    if ( thread || PerfThreadFailed )
+        return thread;
+
+    // Freed by the thread key's destructor when the thread exits.
+    if (!(thread = TRCalloc( 1, sizeof(*thread), MEMORY_TAG_INSTRUMENTATION ))) return nullptr;
+
+    thread->GroupFd = OpenPerfEvent( PERF_COUNTER_CYCLES, -1 );
+    if ( thread->GroupFd < 0 )
+    {
+        TRBool warned = false;
+
+        if ( atomic_compare_exchange_strong( &PerfWarned, &warned, true ) )
+            WARN( "perf_event_open failed (%s), hardware counters are disabled. "
+                  "Check /proc/sys/kernel/perf_event_paranoid.\n", strerror( errno ) );
+
+        // Nothing will work on other threads either.
+        if ( errno == EACCES || errno == EPERM || errno == ENOSYS || errno == ENOENT )
+            PerfCountersEnabled = false;
+
+        PerfThreadFailed = true;
+        TRFree( thread );
+        return nullptr;
+    }
+
+    thread->Fds[PERF_COUNTER_CYCLES] = thread->GroupFd;
+    thread->Available[PERF_COUNTER_CYCLES] = true;
+    thread->MemberCount = 1;
+
+    for ( iterator = PERF_COUNTER_CYCLES + 1; iterator < PERF_COUNTER_COUNT; iterator++ )
+    {
+        if ( (fd = OpenPerfEvent( iterator, thread->GroupFd )) < 0 )
+        {
+            TRACE( "%s counter is unavailable (%s)\n", PerfCounterEvents[iterator].Name, strerror( errno ) );
+            continue;
+        }
+        thread->Fds[iterator] = fd;
+        thread->Available[iterator] = true;
+        thread->MemberCount++;
+    }
+
+    for ( iterator = 0; iterator < PERF_COUNTER_COUNT; iterator++ )
+        if ( thread->Available[iterator] )
+            ioctl( thread->Fds[iterator], PERF_EVENT_IOC_ID, &thread->Ids[iterator] );
+
+    pthread_setspecific( PerfThreadKey, thread );
+    CurrentPerfThread = thread;
+    return thread;
+}
+
+static TRBool
+ReadPerfThread(
+    IN PerfThread *thread,
+    OUT TRULong *values,
+    OUT TRULong *timeEnabled,
+    OUT TRULong *timeRunning
+) {
+    PerfGroupRead group;
+    TRSize iterator;
+    TRSize counter;
+
+    if ( read( thread->GroupFd, &group, sizeof( group ) ) < (ssize_t)( 3 * sizeof( TRULong ) ) )
+        return false;
+
+    memset( values, 0, sizeof( TRULong ) * PERF_COUNTER_COUNT );
+    for ( iterator = 0; iterator < group.Count && iterator < PERF_COUNTER_COUNT; iterator++ )
+        for ( counter = 0; counter < PERF_COUNTER_COUNT; counter++ )
+            if ( thread->Available[counter] && thread->Ids[counter] == group.Values[iterator].Id )
+                values[counter] = group.Values[iterator].Value;
+
+    *timeEnabled = group.TimeEnabled;
+    *timeRunning = group.TimeRunning;
+    return true;
+}
+
+void TR_API
+PerfPhaseBegin(
+    IN PerfPhase *phase,
+    IN TRCString name
+) {
+    PerfThread *thread = GetPerfThread();
+
+    phase->Name = nullptr;
+    if ( !thread || !ReadPerfThread( thread, phase->Start, &phase->StartEnabled, &phase->StartRunning ) )
+        return;
+
+    phase->Name = name;
+}
+
+void TR_API
+PerfPhaseEnd(
+    IN PerfPhase *phase
+) {
+    TRULong values[PERF_COUNTER_COUNT];
+    TRULong timeEnabled;
+    TRULong timeRunning;
+    TRFloat scale = 1.0;
+    TRSize iterator;
+    TRSize counter;
+    PerfThread *thread = CurrentPerfThread;
+    PerfPhaseTotals *totals = nullptr;
+
+    if ( !phase->Name || !thread || !ReadPerfThread( thread, values, &timeEnabled, &timeRunning ) )
+        return;
+
+    // The group was multiplexed with other users of the PMU for part of the phase, extrapolate.
+    if ( timeRunning > phase->StartRunning && timeEnabled - phase->StartEnabled != timeRunning - phase->StartRunning )
+        scale = (TRFloat)( timeEnabled - phase->StartEnabled ) / (TRFloat)( timeRunning - phase->StartRunning );
+
+    pthread_mutex_lock( &PerfPhasesLock );
+    for ( iterator = 0; iterator < PerfPhaseCount; iterator++ )
+    {
+        if ( PerfPhases[iterator].Name == phase->Name || !strcmp( PerfPhases[iterator].Name, phase->Name ) )
+        {
+            totals = &PerfPhases[iterator];
+            break;
+        }
+    }
+
+    if ( !totals && PerfPhaseCount < PERF_MAX_PHASES )
+    {
+        totals = &PerfPhases[PerfPhaseCount++];
+        totals->Name = phase->Name;
+    }
+
+    if ( totals )
+    {
+        totals->Calls++;
+        for ( counter = 0; counter < PERF_COUNTER_COUNT; counter++ )
+        {
+            if ( !thread->Available[counter] )
+                continue;
+            totals->Available[counter] = true;
+            totals->Counters[counter] += (TRULong)( (TRFloat)( values[counter] - phase->Start[counter] ) * scale );
+        }
+    }
+    pthread_mutex_unlock( &PerfPhasesLock );
+
+    phase->Name = nullptr;
+}
+
+// Misses per thousand instructions, or -1 if either counter is missing.
+static TRFloat
+PerfPerKiloInstruction(
+    IN const PerfPhaseTotals *totals,
+    IN PerfCounter counter
+) {
+    if ( !totals->Available[counter] || !totals->Available[PERF_COUNTER_INSTRUCTIONS] || !totals->Counters[PERF_COUNTER_INSTRUCTIONS] )
+        return -1.0;
+
+    return (TRFloat)totals->Counters[counter] * 1000.0 / (TRFloat)totals->Counters[PERF_COUNTER_INSTRUCTIONS];
+}
+
+void TR_API
+PerfCountersReport(
+    IN TRBool reset
+) {
+    PerfPhaseTotals *totals;
+    TRFloat instructionsPerCycle;
+    TRSize iterator;
+
+    pthread_mutex_lock( &PerfPhasesLock );
+    for ( iterator = 0; iterator < PerfPhaseCount; iterator++ )
+    {
+        totals = &PerfPhases[iterator];
+        if ( !totals->Calls )
+            continue;
+
+        instructionsPerCycle = totals->Counters[PERF_COUNTER_CYCLES] && totals->Available[PERF_COUNTER_INSTRUCTIONS]
+            ? (TRFloat)totals->Counters[PERF_COUNTER_INSTRUCTIONS] / (TRFloat)totals->Counters[PERF_COUNTER_CYCLES]
+            : -1.0;
+
+        // Negative values mean the counter isn't available on this machine.
+        INFO( "perf phase %s: %lu calls, %lu cycles, %lu instructions, IPC %.2f, "
+              "L1D MPKI %.2f, LLC MPKI %.2f, branch MPKI %.2f\n",
+              totals->Name, totals->Calls, totals->Counters[PERF_COUNTER_CYCLES], totals->Counters[PERF_COUNTER_INSTRUCTIONS],
+              instructionsPerCycle,
+              PerfPerKiloInstruction( totals, PERF_COUNTER_L1D_MISSES ),
+              PerfPerKiloInstruction( totals, PERF_COUNTER_LLC_MISSES ),
+              PerfPerKiloInstruction( totals, PERF_COUNTER_BRANCH_MISSES ) );
+
+        if ( reset )
+        {
+            totals->Calls = 0;
+            memset( totals->Counters, 0, sizeof( totals->Counters ) );
+        }
+    }
+    pthread_mutex_unlock( &PerfPhasesLock );
+}
+
+static void
+ReportPerfCountersAtExit()
+{
+    PerfCountersReport( false );
+}
+
+TR_STATUS TR_API
+InitializePerfCounters(
+    IN TRBool enable
+) {
+    if ( !enable )
+        return T_SUCCESS;
+
+    if ( pthread_key_create( &PerfThreadKey, ClosePerfThread ) )
+    {
+        WARN( "No thread key left for the perf counters, --perf-counters is ignored\n" );
+        return T_SUCCESS;
+    }
+
+    PerfCountersEnabled = true;
+
+    atexit( ReportPerfCountersAtExit );
+
+    return T_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: StartupBenchmark.c
+ *  Description: Startup phase marks, written as JSON for the benchmark runner.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <Core/Instrumentation/StartupBenchmark.h>
+#include <Core/Instrumentation/Zones.h>
+#include <Core/Memory/Memory.h>
+#include <IO/Logging.h>
+
+#define STARTUP_MAX_MARKS 64
+
+typedef struct _TR_StartupMarkRecord
+{
+    TRCString Name;
+    TRULong Timestamp;
+} StartupMarkRecord;
+
+TRBool TR_API StartupBenchmarkEnabled = false;
+
+static StartupMarkRecord Marks[STARTUP_MAX_MARKS];
+static TRSize MarkCount = 0;
+static pthread_mutex_t MarksMutex = PTHREAD_MUTEX_INITIALIZER;
+static TRString OutputPath = nullptr;
+
+// Runs after the dynamic loader mapped every shared library and ran their constructors.
+__attribute__((constructor))
+static void
+MarkLoaded()
+{
+    StartupMark( "loaded" );
+}
+
+void TR_API
+StartupMark(
+    IN TRCString name
+) {
+    const TRULong timestamp = ZoneTimestamp();
+
+    pthread_mutex_lock( &MarksMutex );
+    if ( MarkCount < STARTUP_MAX_MARKS )
+    {
+        Marks[MarkCount].Name = name;
+        Marks[MarkCount].Timestamp = timestamp;
+        MarkCount++;
+    }
+    pthread_mutex_unlock( &MarksMutex );
+}
+
+TR_STATUS TR_API
+InitializeStartupBenchmark(
+    IN TRCString outputPath
+) {
+    if ( !outputPath )
+        return T_SUCCESS;
+
+    if (!(OutputPath = TRStrdup( outputPath, MEMORY_TAG_INSTRUMENTATION ))) return T_OUTOFMEMORY;
+
+    StartupBenchmarkEnabled = true;
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API
+WriteStartupBenchmark()
+{
+    FILE *file;
+    TRCString launchEnv;
+    TRULong origin, launch = 0;
+    TRSize count, iterator;
+
+    if ( !OutputPath )
+        return T_NOINIT;
+
+    pthread_mutex_lock( &MarksMutex );
+    count = MarkCount;
+    pthread_mutex_unlock( &MarksMutex );
+
+    // The first mark is "loaded", from the constructor.
+    origin = Marks[0].Timestamp;
+
+    if ( (launchEnv = getenv( STARTUP_BENCHMARK_LAUNCH_ENV )) && (launch = strtoull( launchEnv, nullptr, 10 )) && launch <= origin )
+        origin = launch;
+    else
+        launch = 0;
+
+    if (!(file = fopen( OutputPath, "w" )))
+    {
+        ERROR( "Could not open %s for the startup benchmark\n", OutputPath );
+        return T_ACCESSDENIED;
+    }
+
+    fprintf( file, "{\"clock\":\"CLOCK_MONOTONIC\",\"origin\":\"%s\",\"marks\":[\n", launch ? "launch" : "loaded" );
+
+    if ( launch )
+        fprintf( file, "{\"name\":\"launch\",\"ms\":0.000},\n" );
+
+    for ( iterator = 0; iterator < count; iterator++ )
+        fprintf( file, "{\"name\":\"%s\",\"ms\":%.3f}%s\n", Marks[iterator].Name,
+                 (TRFloat)(Marks[iterator].Timestamp - origin) / 1e6, iterator + 1 < count ? "," : "" );
+
+    fprintf( file, "]}\n" );
+
+    if ( fclose( file ) )
+    {
+        ERROR( "Could not write the startup benchmark to %s\n", OutputPath );
+        return T_ERROR;
+    }
+
+    INFO( "Wrote %zu startup marks to %s\n", count, OutputPath );
+    return T_SUCCESS;
+}
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Zones.c
+ *  Description: Per-thread zone recording and Chrome trace JSON export.
+ */
+
+#define _GNU_SOURCE // pthread_getname_np
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Core/Instrumentation/Zones.h>
+#include <IO/Logging.h>
+#include <Core/Memory/Memory.h>
+
+#define ZONE_CHUNK_EVENTS 4096
+#define ZONE_MAX_CHUNKS 256 // ~1M events per thread, anything past that is counted and dropped.
+#define ZONE_TRACK_ID_BASE (1 << 30) // Above any pid_max, tracks never collide with a thread id
+
+typedef enum _TR_ZoneEventType
+{
+    ZONE_EVENT_COMPLETE,
+    ZONE_EVENT_FLOW_BEGIN,
+    ZONE_EVENT_FLOW_STEP,
+    ZONE_EVENT_FLOW_END
+} ZoneEventType;
+
+typedef struct _TR_ZoneEvent
+{
+    TRCString Name;
+    TRULong Timestamp;
+    TRULong Value; // Duration for complete events, the flow id otherwise
+    ZoneEventType Type;
+} ZoneEvent;
+
+typedef struct _TR_ZoneChunk
+{
+    _Atomic(struct _TR_ZoneChunk *) Next;
+    ATOMIC(TRSize) Count;
+    ZoneEvent Events[ZONE_CHUNK_EVENTS];
+} ZoneChunk;
+
+/**
+ * Only the owning thread ever appends to its chunks. Counts and chunk links are
+ * published with release stores so the exporter can walk them without locking.
+ */
+typedef struct _TR_ZoneThread
+{
+    struct _TR_ZoneThread *Next;
+    pid_t ThreadId;
+    TRChar ThreadName[16];
+    _Atomic(ZoneChunk *) First;
+    ZoneChunk *Last;
+    TRSize ChunkCount;
+    ATOMIC(TRULong) Dropped;
+} ZoneThread;
+
+TRBool TR_API ZonesEnabled = false;
+
+static _Atomic(ZoneThread *) ZoneThreads = nullptr;
+static ATOMIC(TRULong) NextFlowId = 1;
+static ATOMIC(TRUInt) NextTrackId = 0;
+static thread_local ZoneThread *CurrentZoneThread = nullptr;
+static TRULong ZonesEpoch = 0;
+static TRString ZonesOutputPath = nullptr;
+
+static void
+LinkZoneThread(
+    IN ZoneThread *thread
+) {
+    thread->Next = atomic_load( &ZoneThreads );
+    while ( !atomic_compare_exchange_weak( &ZoneThreads, &thread->Next, thread ) );
+}
+
+static ZoneThread *
+GetZoneThread()
+{
+    ZoneThread *thread = CurrentZoneThread;
+
+    if ( thread )
+        return thread;
+
+    // Never freed, the events have to survive their thread until they are exported.
+    if (!(thread = TRCalloc( 1, sizeof(*thread), MEMORY_TAG_INSTRUMENTATION ))) return nullptr;
+
+    thread->ThreadId = (pid_t)gettid();
+    pthread_getname_np( pthread_self(), thread->ThreadName, sizeof( thread->ThreadName ) );
+    LinkZoneThread( thread );
+
+    CurrentZoneThread = thread;
+    return thread;
+}
+
+static void
+AppendZoneEvent(
+    IN ZoneThread *thread,
+    IN TRCString name,
+    IN TRULong timestamp,
+    IN TRULong value,
+    IN ZoneEventType type
+) {
+    TRSize count = 0;
+    ZoneChunk *chunk;
+
+    chunk = thread->Last;
+    if ( !chunk || (count = atomic_load_explicit( &chunk->Count, memory_order_relaxed )) == ZONE_CHUNK_EVENTS )
+    {
+        if ( thread->ChunkCount == ZONE_MAX_CHUNKS || !(chunk = TRCalloc( 1, sizeof(*chunk), MEMORY_TAG_INSTRUMENTATION )) )
+        {
+            atomic_fetch_add_explicit( &thread->Dropped, 1, memory_order_relaxed );
+            return;
+        }
+
+        if ( thread->Last )
+            atomic_store_explicit( &thread->Last->Next, chunk, memory_order_release );
+        else
+            atomic_store_explicit( &thread->First, chunk, memory_order_release );
+
+        thread->Last = chunk;
+        thread->ChunkCount++;
+        count = 0;
+    }
+
+    chunk->Events[count].Name = name;
+    chunk->Events[count].Timestamp = timestamp;
+    chunk->Events[count].Value = value;
+    chunk->Events[count].Type = type;
+    atomic_store_explicit( &chunk->Count, count + 1, memory_order_release );
+}
+
+static void
+PushZoneEvent(
+    IN TRCString name,
+    IN TRULong timestamp,
+    IN TRULong value,
+    IN ZoneEventType type
+) {
+    ZoneThread *thread;
+
+    if ( !ZonesEnabled || !(thread = GetZoneThread()) )
+        return;
+
+    AppendZoneEvent( thread, name, timestamp, value, type );
+}
+
+void TR_API
+ZoneRecord(
+    IN TRCString name,
+    IN TRULong start,
+    IN TRULong duration
+) {
+    PushZoneEvent( name, start, duration, ZONE_EVENT_COMPLETE );
+}
+
+TRULong TR_API
+ZoneFlowBegin(
+    IN TRCString name
+) {
+    TRULong id;
+
+    if ( !ZonesEnabled )
+        return 0;
+
+    id = atomic_fetch_add_explicit( &NextFlowId, 1, memory_order_relaxed );
+    PushZoneEvent( name, ZoneTimestamp(), id, ZONE_EVENT_FLOW_BEGIN );
+    return id;
+}
+
+void TR_API
+ZoneFlowStep(
+    IN TRCString name,
+    IN TRULong id
+) {
+    if ( id )
+        PushZoneEvent( name, ZoneTimestamp(), id, ZONE_EVENT_FLOW_STEP );
+}
+
+void TR_API
+ZoneFlowEnd(
+    IN TRCString name,
+    IN TRULong id
+) {
+    if ( id )
+        PushZoneEvent( name, ZoneTimestamp(), id, ZONE_EVENT_FLOW_END );
+}
+
+ZoneTrack TR_API *
+ZoneTrackCreate(
+    IN TRCString name
+) {
+    ZoneThread *track;
+
+    if ( !ZonesEnabled )
+        return nullptr;
+
+    // Never freed, like the threads.
+    if (!(track = TRCalloc( 1, sizeof(*track), MEMORY_TAG_INSTRUMENTATION ))) return nullptr;
+
+    track->ThreadId = ZONE_TRACK_ID_BASE + (pid_t)atomic_fetch_add( &NextTrackId, 1 );
+    strncpy( track->ThreadName, name, sizeof( track->ThreadName ) - 1 );
+    LinkZoneThread( track );
+
+    return track;
+}
+
+void TR_API
+ZoneTrackRecord(
+    IN ZoneTrack *track,
+    IN TRCString name,
+    IN TRULong start,
+    IN TRULong duration
+) {
+    if ( track )
+        AppendZoneEvent( track, name, start, duration, ZONE_EVENT_COMPLETE );
+}
+
+static void
+WriteJSONString(
+    IN FILE *file,
+    IN TRCString string
+) {
+    fputc( '"', file );
+    for ( ; string && *string; string++ )
+    {
+        if ( *string == '"' || *string == '\\' )
+            fprintf( file, "\\%c", *string );
+        else if ( (unsigned char)*string < 0x20 )
+            fprintf( file, "\\u%04x", *string );
+        else
+            fputc( *string, file );
+    }
+    fputc( '"', file );
+}
+
+// Chrome trace timestamps are in microseconds.
+static void
+WriteJSONTimestamp(
+    IN FILE *file,
+    IN TRCString key,
+    IN TRULong nanoseconds
+) {
+    fprintf( file, ",\"%s\":%lu.%03lu", key, nanoseconds / 1000, nanoseconds % 1000 );
+}
+
+TR_STATUS TR_API
+ExportZones(
+    IN TRCString outputPath
+) {
+    static const TRChar phases[] = { 'X', 's', 't', 'f' };
+
+    FILE *file;
+    ZoneThread *thread;
+    ZoneChunk *chunk;
+    ZoneEvent *event;
+    TRSize count;
+    TRSize iterator;
+    TRULong eventCount = 0;
+    TRULong dropped = 0;
+    TRBool first = true;
+    pid_t processId = getpid();
+
+    if ( !outputPath )
+        return T_INVALIDARG;
+
+    if (!(file = fopen( outputPath, "w" )))
+    {
+        ERROR( "Could not open %s for the trace export\n", outputPath );
+        return T_ACCESSDENIED;
+    }
+
+    fprintf( file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+
+    for ( thread = atomic_load( &ZoneThreads ); thread; thread = thread->Next )
+    {
+        fprintf( file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                 first ? "" : ",\n", processId, thread->ThreadId );
+        WriteJSONString( file, thread->ThreadName[0] ? thread->ThreadName : "thread" );
+        fprintf( file, "}}" );
+        first = false;
+
+        for ( chunk = atomic_load_explicit( &thread->First, memory_order_acquire ); chunk;
+              chunk = atomic_load_explicit( &chunk->Next, memory_order_acquire ) )
+        {
+            count = atomic_load_explicit( &chunk->Count, memory_order_acquire );
+            for ( iterator = 0; iterator < count; iterator++ )
+            {
+                event = &chunk->Events[iterator];
+
+                fprintf( file, ",\n{\"name\":" );
+                WriteJSONString( file, event->Name );
+                fprintf( file, ",\"ph\":\"%c\",\"pid\":%d,\"tid\":%d", phases[event->Type], processId, thread->ThreadId );
+                WriteJSONTimestamp( file, "ts", event->Timestamp > ZonesEpoch ? event->Timestamp - ZonesEpoch : 0 );
+
+                if ( event->Type == ZONE_EVENT_COMPLETE )
+                    WriteJSONTimestamp( file, "dur", event->Value );
+                else
+                {
+                    fprintf( file, ",\"cat\":\"flow\",\"id\":%lu", event->Value );
+                    // Bind the flow end to the enclosing zone rather than the next one.
+                    if ( event->Type == ZONE_EVENT_FLOW_END )
+                        fprintf( file, ",\"bp\":\"e\"" );
+                }
+                fprintf( file, "}" );
+                eventCount++;
+            }
+        }
+
+        dropped += atomic_load( &thread->Dropped );
+    }
+
+    fprintf( file, "\n]}\n" );
+
+    if ( fclose( file ) )
+    {
+        ERROR( "Could not write the trace to %s\n", outputPath );
+        return T_ERROR;
+    }
+
+    if ( dropped )
+        WARN( "%lu zone events were dropped, the per-thread buffers were full\n", dropped );
+
+    INFO( "Wrote %lu zone events to %s\n", eventCount, outputPath );
+    return T_SUCCESS;
+}
+
+static void
+ExportZonesAtExit()
+{
+    ZonesEnabled = false;
+    ExportZones( ZonesOutputPath );
+    TRFree( ZonesOutputPath );
+    ZonesOutputPath = nullptr;
+}
+
+TR_STATUS TR_API
+InitializeZones(
+    IN TRCString outputPath
+) {
+    if ( !outputPath )
+        return T_SUCCESS;
+
+    if (!(ZonesOutputPath = TRStrdup( outputPath, MEMORY_TAG_INSTRUMENTATION ))) return T_OUTOFMEMORY;
+
+    ZonesEpoch = ZoneTimestamp();
+    ZonesEnabled = true;
+
+    atexit( ExportZonesAtExit );
+
+    return T_SUCCESS;
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Memory.c
+ *  Description: Tagged allocator with per-subsystem accounting.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <Core/Memory/Memory.h>
+#include <IO/Logging.h>
+
+typedef struct _TR_MemoryHeader
+{
+    TRSize Size;
+    TRUInt Offset;          // From the start of the underlying malloc() block to the user pointer
+    TRUShort Tag;
+    TRUShort AlignmentShift;
+} MemoryHeader;
+
+static_assert( sizeof( MemoryHeader ) == 16, "The header has to keep malloc()'s 16 byte alignment" );
+
+#define MEMORY_HEADER_SIZE sizeof( MemoryHeader )
+#define MEMORY_DEFAULT_SHIFT 4  // Of TRAlloc() blocks, aligned to the header size
+#define HEADER_FROM_BLOCK( block ) ((MemoryHeader *)(block) - 1)
+
+typedef struct _TR_MemoryCounters
+{
+    ATOMIC(TRSize) LiveBytes;
+    ATOMIC(TRSize) LiveCount;
+    ATOMIC(TRSize) PeakBytes;
+    ATOMIC(TRULong) TotalCount;
+} MemoryCounters;
+
+static MemoryCounters Counters[MEMORY_TAG_COUNT];
+
+static const TRCString MemoryTagNames[MEMORY_TAG_COUNT] =
+{
+    [MEMORY_TAG_OBJECT]          = "Object",
+    [MEMORY_TAG_ASYNC]           = "Async",
+    [MEMORY_TAG_LOGGING]         = "Logging",
+    [MEMORY_TAG_PATH]            = "Path",
+    [MEMORY_TAG_GEOMETRY]        = "Geometry",
+    [MEMORY_TAG_TEXTURE]         = "Texture",
+    [MEMORY_TAG_VULKAN]          = "Vulkan",
+    [MEMORY_TAG_INSTRUMENTATION] = "Instrumentation",
+};
+
+static void
+ChargeMemory(
+    IN MemoryTag tag,
+    IN TRSize size
+) {
+    MemoryCounters *counters = &Counters[tag];
+    TRSize live = atomic_fetch_add_explicit( &counters->LiveBytes, size, memory_order_relaxed ) + size;
+    TRSize peak = atomic_load_explicit( &counters->PeakBytes, memory_order_relaxed );
+
+    atomic_fetch_add_explicit( &counters->LiveCount, 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &counters->TotalCount, 1, memory_order_relaxed );
+
+    while ( live > peak && !atomic_compare_exchange_weak_explicit( &counters->PeakBytes, &peak, live, memory_order_relaxed, memory_order_relaxed ) );
+}
+
+static void
+CreditMemory(
+    IN MemoryTag tag,
+    IN TRSize size
+) {
+    atomic_fetch_sub_explicit( &Counters[tag].LiveBytes, size, memory_order_relaxed );
+    atomic_fetch_sub_explicit( &Counters[tag].LiveCount, 1, memory_order_relaxed );
+}
+
+static void *
+FinishBlock(
+    IN void *base,
+    IN TRSize offset,
+    IN TRSize alignment,
+    IN TRSize size,
+    IN MemoryTag tag
+) {
+    void *block = (TRChar *)base + offset;
+    MemoryHeader *header = HEADER_FROM_BLOCK( block );
+
+    header->Size = size;
+    header->Offset = (TRUInt)offset;
+    header->Tag = (TRUShort)tag;
+    header->AlignmentShift = (TRUShort)__builtin_ctzl( alignment );
+
+    ChargeMemory( tag, size );
+    return block;
+}
+
+void TR_API *
+TRAlloc(
+    IN TRSize size,
+    IN MemoryTag tag
+) {
+    void *base;
+
+    if ( tag >= MEMORY_TAG_COUNT || size > SIZE_MAX - MEMORY_HEADER_SIZE )
+        return nullptr;
+
+    if (!(base = malloc( size + MEMORY_HEADER_SIZE ))) return nullptr;
+
+    return FinishBlock( base, MEMORY_HEADER_SIZE, MEMORY_HEADER_SIZE, size, tag );
+}
+
+void TR_API *
+TRCalloc(
+    IN TRSize count,
+    IN TRSize size,
+    IN MemoryTag tag
+) {
+    void *base;
+    TRSize total;
+
+    if ( tag >= MEMORY_TAG_COUNT || __builtin_mul_overflow( count, size, &total ) || total > SIZE_MAX - MEMORY_HEADER_SIZE )
+        return nullptr;
+
+    if (!(base = calloc( 1, total + MEMORY_HEADER_SIZE ))) return nullptr;
+
+    return FinishBlock( base, MEMORY_HEADER_SIZE, MEMORY_HEADER_SIZE, total, tag );
+}
+
+void TR_API *
+TRAlignedAlloc(
+    IN TRSize alignment,
+    IN TRSize size,
+    IN MemoryTag tag
+) {
+    void *base;
+    uintptr_t block;
+
+    if ( alignment <= MEMORY_HEADER_SIZE )
+        return TRAlloc( size, tag );
+
+    if ( tag >= MEMORY_TAG_COUNT || alignment & (alignment - 1) || size > SIZE_MAX - alignment )
+        return nullptr;
+
+    // malloc() already gives 16 byte alignment, so the header plus padding never takes more than alignment bytes.
+    if (!(base = malloc( size + alignment ))) return nullptr;
+
+    block = ((uintptr_t)base + MEMORY_HEADER_SIZE + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+    return FinishBlock( base, block - (uintptr_t)base, alignment, size, tag );
+}
+
+void TR_API *
+TRRealloc(
+    IN void *block,
+    IN TRSize size,
+    IN MemoryTag tag
+) {
+    void *base;
+    MemoryHeader *header;
+    MemoryHeader previous;
+
+    if ( !block )
+        return TRAlloc( size, tag );
+
+    // Aligned blocks may sit right behind the header too, only the recorded alignment tells them apart.
+    header = HEADER_FROM_BLOCK( block );
+    if ( header->AlignmentShift != MEMORY_DEFAULT_SHIFT )
+        return TRAlignedRealloc( block, (TRSize)1 << header->AlignmentShift, size, tag );
+
+    if ( size > SIZE_MAX - MEMORY_HEADER_SIZE )
+        return nullptr;
+
+    // The block keeps the tag it was allocated with.
+    previous = *header;
+    if (!(base = realloc( header, size + MEMORY_HEADER_SIZE ))) return nullptr;
+
+    CreditMemory( previous.Tag, previous.Size );
+    return FinishBlock( base, MEMORY_HEADER_SIZE, MEMORY_HEADER_SIZE, size, previous.Tag );
+}
+
+void TR_API *
+TRAlignedRealloc(
+    IN void *block,
+    IN TRSize alignment,
+    IN TRSize size,
+    IN MemoryTag tag
+) {
+    void *newBlock;
+    MemoryHeader *header;
+
+    if ( !block )
+        return TRAlignedAlloc( alignment, size, tag );
+
+    header = HEADER_FROM_BLOCK( block );
+    if ( alignment <= MEMORY_HEADER_SIZE && header->AlignmentShift == MEMORY_DEFAULT_SHIFT )
+        return TRRealloc( block, size, tag );
+
+    if (!(newBlock = TRAlignedAlloc( alignment, size, header->Tag ))) return nullptr;
+
+    memcpy( newBlock, block, header->Size < size ? header->Size : size );
+    TRFree( block );
+
+    return newBlock;
+}
+
+TRString TR_API
+TRStrdup(
+    IN TRCString string,
+    IN MemoryTag tag
+) {
+    TRString copy;
+    TRSize length;
+
+    if ( !string )
+        return nullptr;
+
+    length = strlen( string ) + 1;
+    if (!(copy = TRAlloc( length, tag ))) return nullptr;
+
+    memcpy( copy, string, length );
+    return copy;
+}
+
+void TR_API
+TRFree(
+    IN void *block
+) {
+    MemoryHeader *header;
+
+    if ( !block )
+        return;
+
+    header = HEADER_FROM_BLOCK( block );
+    CreditMemory( header->Tag, header->Size );
+    free( (TRChar *)block - header->Offset );
+}
+
+void TR_API
+MemoryCharge(
+    IN MemoryTag tag,
+    IN TRSize size
+) {
+    if ( tag < MEMORY_TAG_COUNT )
+        ChargeMemory( tag, size );
+}
+
+void TR_API
+MemoryCredit(
+    IN MemoryTag tag,
+    IN TRSize size
+) {
+    if ( tag < MEMORY_TAG_COUNT )
+        CreditMemory( tag, size );
+}
+
+TR_STATUS TR_API
+MemoryQueryStatistics(
+    IN MemoryTag tag,
+    OUT MemoryStatistics *out
+) {
+    if ( tag >= MEMORY_TAG_COUNT || !out )
+        return T_INVALIDARG;
+
+    out->Name = MemoryTagNames[tag];
+    out->LiveBytes = atomic_load( &Counters[tag].LiveBytes );
+    out->LiveCount = atomic_load( &Counters[tag].LiveCount );
+    out->PeakBytes = atomic_load( &Counters[tag].PeakBytes );
+    out->TotalCount = atomic_load( &Counters[tag].TotalCount );
+
+    return T_SUCCESS;
+}
+
+void TR_API
+MemoryDumpStatistics()
+{
+    MemoryStatistics statistics;
+    TRUInt tag;
+
+    for ( tag = 0; tag < MEMORY_TAG_COUNT; tag++ )
+    {
+        MemoryQueryStatistics( tag, &statistics );
+        if ( !statistics.TotalCount )
+            continue;
+
+        INFO( "memory %s: %zu bytes live in %zu blocks, peak %zu bytes, %lu allocations\n",
+              statistics.Name, statistics.LiveBytes, statistics.LiveCount, statistics.PeakBytes, statistics.TotalCount );
+    }
+}
+
+static TRSize
+FormatUnsigned(
+    OUT TRChar *buffer,
+    IN TRULong value
+) {
+    TRChar digits[20];
+    TRSize length = 0;
+    TRSize iterator;
+
+    do
+    {
+        digits[length++] = (TRChar)( '0' + value % 10 );
+        value /= 10;
+    } while ( value );
+
+    for ( iterator = 0; iterator < length; iterator++ )
+        buffer[iterator] = digits[length - iterator - 1];
+
+    return length;
+}
+
+static TRSize
+FormatString(
+    OUT TRChar *buffer,
+    IN TRCString string
+) {
+    TRSize length = strlen( string );
+    memcpy( buffer, string, length );
+    return length;
+}
+
+// Only async-signal-safe calls in here, no stdio and no logging.
+static void
+MemorySignalHandler(
+    IN TRInt signal
+) {
+    TRChar line[256];
+    TRSize length;
+    TRUInt tag;
+    TRInt savedErrno = errno;
+
+    for ( tag = 0; tag < MEMORY_TAG_COUNT; tag++ )
+    {
+        length = FormatString( line, "memory " );
+        length += FormatString( line + length, MemoryTagNames[tag] );
+        length += FormatString( line + length, ": live " );
+        length += FormatUnsigned( line + length, atomic_load( &Counters[tag].LiveBytes ) );
+        length += FormatString( line + length, " bytes in " );
+        length += FormatUnsigned( line + length, atomic_load( &Counters[tag].LiveCount ) );
+        length += FormatString( line + length, " blocks, peak " );
+        length += FormatUnsigned( line + length, atomic_load( &Counters[tag].PeakBytes ) );
+        length += FormatString( line + length, " bytes\n" );
+
+        if ( write( STDERR_FILENO, line, length ) < 0 )
+            break;
+    }
+
+    errno = savedErrno;
+}
+
+TR_STATUS TR_API
+InitializeMemoryAccounting()
+{
+    struct sigaction action = {};
+
+    action.sa_handler = MemorySignalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset( &action.sa_mask );
+
+    if ( sigaction( SIGUSR1, &action, nullptr ) )
+        return T_ERROR;
+
+    atexit( MemoryDumpStatistics );
+
+    return T_SUCCESS;
+}
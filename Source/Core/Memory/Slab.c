@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Slab.c
+ *  Description: Per-type slab caches with thread-local magazines.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Core/Memory/Slab.h>
+#include <IO/Logging.h>
+#include <ObjectRegistry.h>
+
+#define SLAB_SIZE (64 * 1024)
+#define SLAB_CACHE_LINE 64
+#define SLAB_MAGAZINE_SIZE 32
+#define SLAB_MAX_CACHES 64
+#define SLAB_MAX_OBJECT (SLAB_SIZE / 8) // Anything larger gets its own aligned block
+#define SLAB_INDEX_NONE ((TRUInt)~0u)
+
+struct _TR_SlabMagazine
+{
+    SlabMagazine *Next;
+    TRUInt Count;
+    void *Objects[SLAB_MAGAZINE_SIZE];
+};
+
+static SlabCache *Caches[SLAB_MAX_CACHES];
+static TRUInt CacheCount = 0;
+static pthread_mutex_t CachesMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t MagazineKey;
+static pthread_once_t MagazineKeyOnce = PTHREAD_ONCE_INIT;
+
+static thread_local SlabMagazine *LoadedMagazines[SLAB_MAX_CACHES];
+
+typedef struct _TR_SlabRange
+{
+    TRChar *Start;
+    SlabCache *Cache;
+} SlabRange;
+
+// Every slab ever carved, sorted by address, so SlabLookup() can binary search it.
+static SlabRange *Ranges = nullptr;
+static TRSize RangeCount = 0;
+static TRSize RangeCapacity = 0;
+static pthread_rwlock_t RangesLock = PTHREAD_RWLOCK_INITIALIZER;
+
+static void
+PushMagazine(
+    IN SlabCache *cache,
+    IN SlabMagazine *magazine
+) {
+    SlabMagazine **list = magazine->Count ? &cache->Depot : &cache->EmptyMagazines;
+
+    magazine->Next = *list;
+    *list = magazine;
+}
+
+// Hands the magazines of an exiting thread back to the depots, so its free objects are not lost.
+static void
+FlushThreadMagazines(
+    IN void *unused
+) {
+    SlabMagazine *magazine;
+    TRUInt index;
+
+    for ( index = 0; index < SLAB_MAX_CACHES; index++ )
+    {
+        if (!(magazine = LoadedMagazines[index])) continue;
+
+        pthread_mutex_lock( &Caches[index]->Lock );
+        PushMagazine( Caches[index], magazine );
+        pthread_mutex_unlock( &Caches[index]->Lock );
+
+        LoadedMagazines[index] = nullptr;
+    }
+}
+
+static void
+CreateMagazineKey()
+{
+    pthread_key_create( &MagazineKey, FlushThreadMagazines );
+}
+
+static TRUInt
+GetCacheIndex(
+    IN SlabCache *cache
+) {
+    TRUInt index = atomic_load_explicit( &cache->Index, memory_order_acquire );
+
+    if ( index )
+        goto _DONE;
+
+    // Before the index is published, threads taking the fast path above rely on the key.
+    pthread_once( &MagazineKeyOnce, CreateMagazineKey );
+
+    pthread_mutex_lock( &CachesMutex );
+    if ( !(index = atomic_load_explicit( &cache->Index, memory_order_relaxed )) )
+    {
+        cache->Stride = (cache->Size + SLAB_CACHE_LINE - 1) & ~(TRSize)(SLAB_CACHE_LINE - 1);
+
+        if ( CacheCount == SLAB_MAX_CACHES || cache->Stride > SLAB_MAX_OBJECT )
+            index = SLAB_INDEX_NONE;
+        else
+        {
+            Caches[CacheCount] = cache;
+            index = ++CacheCount;
+        }
+
+        atomic_store_explicit( &cache->Index, index, memory_order_release );
+    }
+    pthread_mutex_unlock( &CachesMutex );
+
+_DONE:
+    // Index is stored off by one, so zero can mean unassigned.
+    return index == SLAB_INDEX_NONE ? index : index - 1;
+}
+
+static TRBool
+RecordSlab(
+    IN SlabCache *cache,
+    IN TRChar *start
+) {
+    SlabRange *ranges;
+    TRSize index;
+    TRBool recorded = false;
+
+    pthread_rwlock_wrlock( &RangesLock );
+
+    if ( RangeCount == RangeCapacity )
+    {
+        if (!(ranges = TRRealloc( Ranges, (RangeCapacity ? RangeCapacity * 2 : 16) * sizeof( SlabRange ), MEMORY_TAG_OBJECT )))
+            goto _CLEANUP;
+
+        Ranges = ranges;
+        RangeCapacity = RangeCapacity ? RangeCapacity * 2 : 16;
+    }
+
+    for ( index = RangeCount; index && Ranges[index - 1].Start > start; index-- )
+        Ranges[index] = Ranges[index - 1];
+
+    Ranges[index] = (SlabRange){ start, cache };
+    RangeCount++;
+    recorded = true;
+
+_CLEANUP:
+    pthread_rwlock_unlock( &RangesLock );
+    return recorded;
+}
+
+// Called with the cache lock held.
+static void *
+TakeObject(
+    IN SlabCache *cache
+) {
+    void *object;
+
+    if ( (object = cache->FreeObjects) )
+    {
+        memcpy( &cache->FreeObjects, object, sizeof( void * ) );
+        return object;
+    }
+
+    if ( cache->Cursor + cache->Stride > cache->Limit )
+    {
+        // Not charged, the tag pays for every object when it is handed out instead.
+        if ( !(cache->Cursor = aligned_alloc( SLAB_CACHE_LINE, SLAB_SIZE )) ||
+             !RecordSlab( cache, cache->Cursor ) )
+        {
+            free( cache->Cursor );
+            cache->Cursor = cache->Limit = nullptr;
+            return nullptr;
+        }
+
+        cache->Limit = cache->Cursor + SLAB_SIZE;
+        cache->SlabCount++;
+        TRACE( "slab cache %s grew to %zu slabs\n", cache->Name, cache->SlabCount );
+    }
+
+    object = cache->Cursor;
+    cache->Cursor += cache->Stride;
+    return object;
+}
+
+/**
+ * Swaps an empty (or missing) magazine for one from the depot, or fills one from
+ * the loose objects and slabs. Half full, so a thread alternating between Alloc and
+ * Free does not bounce off the depot on every call.
+ */
+static SlabMagazine *
+ReloadMagazine(
+    IN SlabCache *cache,
+    IN SlabMagazine *magazine
+) {
+    SlabMagazine *full;
+    void *object;
+
+    pthread_mutex_lock( &cache->Lock );
+
+    if ( (full = cache->Depot) )
+    {
+        cache->Depot = full->Next;
+        if ( magazine )
+            PushMagazine( cache, magazine );
+        magazine = full;
+        goto _CLEANUP;
+    }
+
+    if ( !magazine && (magazine = cache->EmptyMagazines) )
+        cache->EmptyMagazines = magazine->Next;
+
+    if ( !magazine && !(magazine = calloc( 1, sizeof(*magazine) )) )
+        goto _CLEANUP;
+
+    while ( magazine->Count < SLAB_MAGAZINE_SIZE / 2 && (object = TakeObject( cache )) )
+        magazine->Objects[magazine->Count++] = object;
+
+_CLEANUP:
+    pthread_mutex_unlock( &cache->Lock );
+    return magazine;
+}
+
+// Swaps a full magazine for an empty one, nullptr if none could be allocated.
+static SlabMagazine *
+ExchangeMagazine(
+    IN SlabCache *cache,
+    IN SlabMagazine *magazine
+) {
+    SlabMagazine *empty;
+
+    pthread_mutex_lock( &cache->Lock );
+
+    if ( (empty = cache->EmptyMagazines) )
+        cache->EmptyMagazines = empty->Next;
+
+    if ( magazine && (empty || (empty = calloc( 1, sizeof(*empty) ))) )
+        PushMagazine( cache, magazine );
+    else if ( magazine )
+        empty = magazine; // Keep the full one, the caller falls back to the loose list
+
+    pthread_mutex_unlock( &cache->Lock );
+
+    return empty;
+}
+
+void TR_API *
+SlabAlloc(
+    IN SlabCache *cache
+) {
+    SlabMagazine *magazine;
+    void *object;
+    TRUInt index = GetCacheIndex( cache );
+
+    if ( index == SLAB_INDEX_NONE )
+    {
+        if ( cache->Stride > SLAB_MAX_OBJECT )
+            object = TRAlignedAlloc( SLAB_CACHE_LINE, cache->Stride, cache->Tag );
+        else
+        {
+            pthread_mutex_lock( &cache->Lock );
+            object = TakeObject( cache );
+            pthread_mutex_unlock( &cache->Lock );
+        }
+    }
+    else
+    {
+        magazine = LoadedMagazines[index];
+        if ( !magazine || !magazine->Count )
+        {
+            if ( !magazine )
+                pthread_setspecific( MagazineKey, LoadedMagazines );
+
+            magazine = ReloadMagazine( cache, magazine );
+            LoadedMagazines[index] = magazine;
+
+            if ( !magazine || !magazine->Count )
+                return nullptr;
+        }
+
+        object = magazine->Objects[--magazine->Count];
+    }
+
+    if ( !object )
+        return nullptr;
+
+    memset( object, 0, cache->Size );
+    atomic_fetch_add_explicit( &cache->LiveCount, 1, memory_order_relaxed );
+    if ( cache->Stride <= SLAB_MAX_OBJECT )
+        MemoryCharge( cache->Tag, cache->Size );
+
+#ifdef TR_OBJECT_REGISTRY
+    ObjectRegistryTrack( cache, object );
+#endif
+
+    return object;
+}
+
+void TR_API
+SlabFree(
+    IN SlabCache *cache,
+    IN void *object
+) {
+    SlabMagazine *magazine;
+    TRUInt index;
+
+    if ( !object )
+        return;
+
+    DetachWeakReferences( object );
+#ifdef TR_OBJECT_REGISTRY
+    ObjectRegistryUntrack( object );
+#endif
+
+    index = GetCacheIndex( cache );
+    atomic_fetch_sub_explicit( &cache->LiveCount, 1, memory_order_relaxed );
+
+    if ( index == SLAB_INDEX_NONE && cache->Stride > SLAB_MAX_OBJECT )
+    {
+        TRFree( object );
+        return;
+    }
+    MemoryCredit( cache->Tag, cache->Size );
+
+    if ( index != SLAB_INDEX_NONE )
+    {
+        magazine = LoadedMagazines[index];
+        if ( !magazine || magazine->Count == SLAB_MAGAZINE_SIZE )
+        {
+            if ( !magazine )
+                pthread_setspecific( MagazineKey, LoadedMagazines );
+
+            LoadedMagazines[index] = magazine = ExchangeMagazine( cache, magazine );
+        }
+
+        if ( magazine && magazine->Count < SLAB_MAGAZINE_SIZE )
+        {
+            magazine->Objects[magazine->Count++] = object;
+            return;
+        }
+    }
+
+    pthread_mutex_lock( &cache->Lock );
+    memcpy( object, &cache->FreeObjects, sizeof( void * ) );
+    cache->FreeObjects = object;
+    pthread_mutex_unlock( &cache->Lock );
+}
+
+TR_STATUS TR_API
+SlabLookup(
+    IN const void *address,
+    OUT SlabCache **cache,
+    OUT void **object
+) {
+    const TRChar *target = address;
+    TRSize low = 0, high, middle;
+    SlabRange *range = nullptr;
+
+    if ( !cache || !object ) throw_NullPtrException();
+
+    pthread_rwlock_rdlock( &RangesLock );
+
+    // The last slab starting at or below address.
+    high = RangeCount;
+    while ( low < high )
+    {
+        middle = low + (high - low) / 2;
+        if ( Ranges[middle].Start <= target )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if ( low && target < Ranges[low - 1].Start + SLAB_SIZE )
+        range = &Ranges[low - 1];
+
+    if ( range )
+    {
+        *cache = range->Cache;
+        *object = range->Start + (TRSize)(target - range->Start) / range->Cache->Stride * range->Cache->Stride;
+    }
+
+    pthread_rwlock_unlock( &RangesLock );
+
+    return range ? T_SUCCESS : T_NOTIMPL;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: InterfaceTable.c
+ *  Description: Interned interface ids and table driven QueryInterface.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <InterfaceTable.h>
+#include <Object.h>
+
+#define INTERFACE_HASH_SIZE 128 // Twice INTERFACE_ID_MAX, so probes stay short
+
+enum
+{
+    TABLE_UNBUILT = 0,
+    TABLE_BUILDING = 1,
+    TABLE_READY = 2
+};
+
+typedef struct _TR_InterfaceSlot
+{
+    TRUUID Uuid;
+    ATOMIC(TRUInt) Id; // Published last, INTERFACE_ID_INVALID marks an empty slot
+} InterfaceSlot;
+
+static InterfaceSlot InterfaceHash[INTERFACE_HASH_SIZE];
+static TRUInt InterfaceCount = 0;
+static pthread_mutex_t InterfaceMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static TRSize
+HashInterface(
+    IN const TRUUID uuid
+) {
+    uint64_t low, high, hash;
+
+    memcpy( &low, uuid, sizeof( low ) );
+    memcpy( &high, uuid + sizeof( low ), sizeof( high ) );
+
+    hash = (low ^ high) * 0x9E3779B97F4A7C15ull;
+    return (TRSize)(hash >> 32) & (INTERFACE_HASH_SIZE - 1);
+}
+
+TRUInt TR_API
+LookupInterfaceId(
+    IN const TRUUID uuid
+) {
+    TRSize index = HashInterface( uuid );
+    TRUInt id;
+    TRUInt probes;
+
+    for ( probes = 0; probes < INTERFACE_HASH_SIZE; probes++ )
+    {
+        id = atomic_load_explicit( &InterfaceHash[index].Id, memory_order_acquire );
+        if ( id == INTERFACE_ID_INVALID )
+            break;
+
+        if ( !memcmp( InterfaceHash[index].Uuid, uuid, sizeof( TRUUID ) ) )
+            return id;
+
+        index = (index + 1) & (INTERFACE_HASH_SIZE - 1);
+    }
+
+    return INTERFACE_ID_INVALID;
+}
+
+// Called from the constructors DEFINE_GUID emits under INITGUID, before main() runs.
+TRUInt TR_API
+InternInterfaceId(
+    IN const TRUUID uuid
+) {
+    TRSize index;
+    TRUInt id;
+
+    pthread_mutex_lock( &InterfaceMutex );
+
+    // Different names sharing a uuid share the id, just like they compared equal before.
+    if ( (id = LookupInterfaceId( uuid )) != INTERFACE_ID_INVALID )
+        goto _CLEANUP;
+
+    if ( InterfaceCount + 1 >= INTERFACE_ID_MAX )
+    {
+        // Logging is not up this early.
+        fprintf( stderr, "Too many interfaces, raise INTERFACE_ID_MAX to register %s\n", debugstr_uuid( uuid ) );
+        goto _CLEANUP;
+    }
+
+    index = HashInterface( uuid );
+    while ( atomic_load_explicit( &InterfaceHash[index].Id, memory_order_relaxed ) != INTERFACE_ID_INVALID )
+        index = (index + 1) & (INTERFACE_HASH_SIZE - 1);
+
+    id = ++InterfaceCount;
+    memcpy( InterfaceHash[index].Uuid, uuid, sizeof( TRUUID ) );
+    atomic_store_explicit( &InterfaceHash[index].Id, id, memory_order_release );
+
+_CLEANUP:
+    pthread_mutex_unlock( &InterfaceMutex );
+    return id;
+}
+
+static const InterfaceEntry *
+FindInterfaceEntry(
+    IN InterfaceTable *table,
+    IN TRUInt id
+) {
+    TRInt state = atomic_load_explicit( &table->State, memory_order_acquire );
+    TRUInt iterator;
+    TRUInt entryId;
+
+    if ( state == TABLE_READY )
+        return table->Slots[id] ? &table->Entries[table->Slots[id] - 1] : nullptr;
+
+    // The first caller builds the slots, anyone racing it scans the entries meanwhile.
+    if ( state == TABLE_UNBUILT && atomic_compare_exchange_strong( &table->State, &state, TABLE_BUILDING ) )
+    {
+        for ( iterator = 0; iterator < table->Count; iterator++ )
+        {
+            entryId = *table->Entries[iterator].Id;
+            if ( entryId != INTERFACE_ID_INVALID && !table->Slots[entryId] )
+                table->Slots[entryId] = (unsigned char)(iterator + 1);
+        }
+
+        atomic_store_explicit( &table->State, TABLE_READY, memory_order_release );
+        return table->Slots[id] ? &table->Entries[table->Slots[id] - 1] : nullptr;
+    }
+
+    for ( iterator = 0; iterator < table->Count; iterator++ )
+        if ( *table->Entries[iterator].Id == id )
+            return &table->Entries[iterator];
+
+    return nullptr;
+}
+
+TR_STATUS TR_API
+QueryInterfaceFromTable(
+    IN InterfaceTable *table,
+    IN void *impl,
+    IN const TRUUID uuid,
+    OUT void **out
+) {
+    const InterfaceEntry *entry;
+    UnknownObject *object;
+    TRUInt id;
+
+    if ( !out ) throw_NullPtrException();
+
+    if ( (id = LookupInterfaceId( uuid )) == INTERFACE_ID_INVALID || !(entry = FindInterfaceEntry( table, id )) )
+    {
+        ERROR( "uuid %s is not implemented by %s! returning T_NOTIMPL\n", debugstr_uuid( uuid ), table->ClassName );
+        return T_NOTIMPL;
+    }
+
+    if ( entry->Kind == INTERFACE_KIND_SELF )
+        object = (UnknownObject *)((TRChar *)impl + entry->Offset);
+    else
+        object = *(UnknownObject **)((TRChar *)impl + entry->Offset);
+
+    TRACE( "impl %p, interface %s, object %p\n", impl, entry->Name, object );
+
+    if ( !object )
+    {
+        ERROR( "Subclass %s for %s %p is not initialized yet!\n", entry->Name, table->ClassName, impl );
+        return T_NOINIT;
+    }
+
+    if ( entry->Kind == INTERFACE_KIND_FORWARD )
+        return object->lpVtbl->QueryInterface( object, uuid, out );
+
+    object->lpVtbl->AddRef( object );
+    *out = object;
+    return T_SUCCESS;
+}
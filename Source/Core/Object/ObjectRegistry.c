@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: ObjectRegistry.c
+ *  Description: Weak reference control blocks and the live object registry.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef TR_OBJECT_REGISTRY
+#include <execinfo.h>
+#endif
+
+#include <Core/Memory/Slab.h>
+#include <ObjectRegistry.h>
+
+#define WEAK_BUCKETS 256
+
+struct _TR_WeakReference
+{
+    WeakReference *Next;        // Bucket chain, only while Base is set
+    void *Base;                 // The slab object, nullptr once it has been freed
+    UnknownObject *Interface;
+    ATOMIC(TRLong) *Ref;
+    TRLong WeakCount;           // Guarded by WeakMutex
+};
+
+static WeakReference *WeakBuckets[WEAK_BUCKETS];
+static pthread_mutex_t WeakMutex = PTHREAD_MUTEX_INITIALIZER;
+static ATOMIC(TRSize) WeakTargets = 0; // Control blocks still attached to an object
+
+static TRSize
+HashObject(
+    IN const void *object,
+    IN TRSize buckets
+) {
+    // Slab objects start on a cache line, the low bits carry nothing.
+    return (TRSize)((((uintptr_t)object >> 6) * 0x9E3779B97F4A7C15ull) >> 32) & (buckets - 1);
+}
+
+static void
+UnlinkWeakReference(
+    IN WeakReference *weak
+) {
+    WeakReference **link = &WeakBuckets[HashObject( weak->Base, WEAK_BUCKETS )];
+
+    while ( *link != weak )
+        link = &(*link)->Next;
+
+    *link = weak->Next;
+    weak->Base = nullptr;
+    atomic_fetch_sub_explicit( &WeakTargets, 1, memory_order_relaxed );
+}
+
+TR_STATUS TR_API
+GetWeakReference(
+    IN UnknownObject *object,
+    OUT WeakReference **out
+) {
+    WeakReference *weak;
+    SlabCache *cache;
+    void *base;
+    TRSize bucket;
+    TR_STATUS status = T_SUCCESS;
+
+    if ( !object || !out ) throw_NullPtrException();
+
+    if ( FAILED( status = SlabLookup( object, &cache, &base ) ) )
+    {
+        ERROR( "object %p is not slab allocated, it can not be weakly referenced\n", object );
+        return status;
+    }
+
+    bucket = HashObject( base, WEAK_BUCKETS );
+
+    pthread_mutex_lock( &WeakMutex );
+
+    for ( weak = WeakBuckets[bucket]; weak; weak = weak->Next )
+        if ( weak->Interface == object )
+        {
+            weak->WeakCount++;
+            goto _CLEANUP;
+        }
+
+    if (!(weak = TRAlloc( sizeof( *weak ), MEMORY_TAG_OBJECT )))
+    {
+        status = T_OUTOFMEMORY;
+        goto _CLEANUP;
+    }
+
+    weak->Base = base;
+    weak->Interface = object;
+    weak->Ref = (ATOMIC(TRLong) *)((TRChar *)base + cache->RefOffset);
+    weak->WeakCount = 1;
+    weak->Next = WeakBuckets[bucket];
+    WeakBuckets[bucket] = weak;
+    atomic_fetch_add_explicit( &WeakTargets, 1, memory_order_relaxed );
+
+    TRACE( "%s %p has a weak reference %p now\n", cache->Name, base, weak );
+
+_CLEANUP:
+    pthread_mutex_unlock( &WeakMutex );
+
+    *out = FAILED( status ) ? nullptr : weak;
+    return status;
+}
+
+TRLong TR_API
+AddRefWeakReference(
+    IN WeakReference *weak
+) {
+    TRLong count;
+
+    pthread_mutex_lock( &WeakMutex );
+    count = ++weak->WeakCount;
+    pthread_mutex_unlock( &WeakMutex );
+
+    return count;
+}
+
+TRLong TR_API
+ReleaseWeakReference(
+    IN WeakReference *weak
+) {
+    TRLong count;
+
+    pthread_mutex_lock( &WeakMutex );
+
+    if ( !(count = --weak->WeakCount) )
+    {
+        if ( weak->Base )
+            UnlinkWeakReference( weak );
+        TRFree( weak );
+    }
+
+    pthread_mutex_unlock( &WeakMutex );
+
+    return count;
+}
+
+TR_STATUS TR_API
+ResolveWeakReference(
+    IN WeakReference *weak,
+    OUT UnknownObject **out
+) {
+    TRLong count = 0;
+
+    if ( !weak || !out ) throw_NullPtrException();
+
+    pthread_mutex_lock( &WeakMutex );
+
+    /**
+     * Only ever step up from a count above zero. A Release that hit zero is already
+     * tearing the object down and blocks in DetachWeakReferences() on this mutex
+     * before the memory can be reused, so a dying object is never handed out again.
+     */
+    if ( weak->Base )
+    {
+        count = atomic_load_explicit( weak->Ref, memory_order_relaxed );
+        while ( count > 0 && !atomic_compare_exchange_weak_explicit( weak->Ref, &count, count + 1,
+                                                                     memory_order_acq_rel, memory_order_relaxed ) );
+    }
+
+    pthread_mutex_unlock( &WeakMutex );
+
+    *out = count > 0 ? weak->Interface : nullptr;
+    return count > 0 ? T_SUCCESS : T_HANDLE;
+}
+
+void TR_API
+DetachWeakReferences(
+    IN void *object
+) {
+    WeakReference *weak, *next;
+
+    // Nothing has ever been weakly referenced, which is the common case.
+    if ( !atomic_load_explicit( &WeakTargets, memory_order_relaxed ) )
+        return;
+
+    pthread_mutex_lock( &WeakMutex );
+
+    for ( weak = WeakBuckets[HashObject( object, WEAK_BUCKETS )]; weak; weak = next )
+    {
+        next = weak->Next;
+        if ( weak->Base == object )
+            UnlinkWeakReference( weak );
+    }
+
+    pthread_mutex_unlock( &WeakMutex );
+}
+
+#ifdef TR_OBJECT_REGISTRY
+
+#define REGISTRY_BUCKETS 4096
+#define REGISTRY_FRAMES 16
+#define REGISTRY_SKIP_FRAMES 2 // ObjectRegistryTrack() and SlabAlloc()
+#define REGISTRY_MAX_CLASSES 128
+
+typedef struct _TR_ObjectRecord
+{
+    struct _TR_ObjectRecord *Next;
+    void *Object;
+    SlabCache *Cache;
+    TRInt FrameCount;
+    void *Frames[REGISTRY_FRAMES];
+} ObjectRecord;
+
+typedef struct _TR_ClassLeaks
+{
+    SlabCache *Cache;
+    TRSize Count;
+    ObjectRecord *Sample;       // The backtrace printed for the class
+} ClassLeaks;
+
+static ObjectRecord *RecordBuckets[REGISTRY_BUCKETS];
+static pthread_mutex_t RecordMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void TR_API
+ObjectRegistryTrack(
+    IN SlabCache *cache,
+    IN void *object
+) {
+    ObjectRecord *record;
+    TRSize bucket = HashObject( object, REGISTRY_BUCKETS );
+
+    if (!(record = TRAlloc( sizeof( *record ), MEMORY_TAG_INSTRUMENTATION ))) return;
+
+    record->Object = object;
+    record->Cache = cache;
+    record->FrameCount = backtrace( record->Frames, REGISTRY_FRAMES );
+
+    pthread_mutex_lock( &RecordMutex );
+    record->Next = RecordBuckets[bucket];
+    RecordBuckets[bucket] = record;
+    pthread_mutex_unlock( &RecordMutex );
+}
+
+void TR_API
+ObjectRegistryUntrack(
+    IN void *object
+) {
+    ObjectRecord **link, *record = nullptr;
+
+    pthread_mutex_lock( &RecordMutex );
+
+    for ( link = &RecordBuckets[HashObject( object, REGISTRY_BUCKETS )]; *link; link = &(*link)->Next )
+        if ( (*link)->Object == object )
+        {
+            record = *link;
+            *link = record->Next;
+            break;
+        }
+
+    pthread_mutex_unlock( &RecordMutex );
+
+    TRFree( record );
+}
+
+void TR_API
+ObjectRegistryReport()
+{
+    ClassLeaks classes[REGISTRY_MAX_CLASSES] = {};
+    TRSize classCount = 0;
+    TRSize bucket, index, total = 0;
+    ObjectRecord *record;
+    TRString *symbols;
+    TRInt frame;
+
+    pthread_mutex_lock( &RecordMutex );
+
+    for ( bucket = 0; bucket < REGISTRY_BUCKETS; bucket++ )
+        for ( record = RecordBuckets[bucket]; record; record = record->Next )
+        {
+            for ( index = 0; index < classCount && classes[index].Cache != record->Cache; index++ );
+
+            if ( index == classCount )
+            {
+                if ( classCount == REGISTRY_MAX_CLASSES ) continue;
+                classes[classCount++].Cache = record->Cache;
+            }
+
+            classes[index].Count++;
+            classes[index].Sample = record;
+            total++;
+        }
+
+    if ( !total )
+        INFO( "object registry: no live objects at exit\n" );
+
+    for ( index = 0; index < classCount; index++ )
+    {
+        WARN( "object registry: %zu %s still alive at exit, %zu bytes\n", classes[index].Count,
+              classes[index].Cache->Name, classes[index].Count * classes[index].Cache->Size );
+
+        record = classes[index].Sample;
+        if (!(symbols = backtrace_symbols( record->Frames, record->FrameCount ))) continue;
+
+        for ( frame = REGISTRY_SKIP_FRAMES; frame < record->FrameCount; frame++ )
+            WARN( "    #%d %s\n", frame - REGISTRY_SKIP_FRAMES, symbols[frame] );
+
+        free( symbols );
+    }
+
+    pthread_mutex_unlock( &RecordMutex );
+}
+
+#endif
+
+TR_STATUS TR_API
+InitializeObjectRegistry()
+{
+#ifdef TR_OBJECT_REGISTRY
+    atexit( ObjectRegistryReport );
+#endif
+
+    return T_SUCCESS;
+}
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: BVH.c
+ *  Description: Binned SAH bounding volume hierarchy over scene triangles.
+ */
+
+#include <float.h>
+#include <string.h>
+
+#include <Core/Render/BVH.h>
+#include <Core/Memory/Memory.h>
+#include <Core/Instrumentation/PerfCounters.h>
+#include <Core/Instrumentation/Zones.h>
+#include <IO/Logging.h>
+
+#define BVH_FAR FLT_MAX
+#define BVH_RAY_EPSILON 1e-5f
+
+typedef struct _TR_BVHBin
+{
+    Vector3 Min;
+    Vector3 Max;
+    TRUInt Count;
+} BVHBin;
+
+typedef struct _TR_BVHBuilder
+{
+    const Scene *Source;
+    BVH *Tree;
+    TRUInt *Indices;                                // Triangle order, leaves cover ranges of it
+    Vector3 *Centroids;
+} BVHBuilder;
+
+static inline float
+HalfArea(
+    IN Vector3 min,
+    IN Vector3 max
+) {
+    const Vector3 extent = Vector3Sub( max, min );
+    return extent.X * extent.Y + extent.Y * extent.Z + extent.Z * extent.X;
+}
+
+static void
+GrowBounds(
+    INOUT Vector3 *min,
+    INOUT Vector3 *max,
+    IN const SceneTriangle *triangle
+) {
+    const Vector3 v1 = Vector3Add( triangle->V0, triangle->Edge1 );
+    const Vector3 v2 = Vector3Add( triangle->V0, triangle->Edge2 );
+
+    *min = Vector3Min( *min, Vector3Min( triangle->V0, Vector3Min( v1, v2 ) ) );
+    *max = Vector3Max( *max, Vector3Max( triangle->V0, Vector3Max( v1, v2 ) ) );
+}
+
+static void
+UpdateBounds(
+    IN const BVHBuilder *builder,
+    INOUT BVHNode *node
+) {
+    TRUInt iterator;
+
+    node->Min = Vector3Make( BVH_FAR, BVH_FAR, BVH_FAR );
+    node->Max = Vector3Make( -BVH_FAR, -BVH_FAR, -BVH_FAR );
+
+    for ( iterator = 0; iterator < node->Count; iterator++ )
+        GrowBounds( &node->Min, &node->Max, &builder->Source->Triangles[builder->Indices[node->LeftOrFirst + iterator]] );
+}
+
+/**
+ * Sorts the node's triangles into bins along every axis of their centroids' bounds
+ * and returns the cheapest split, FLT_MAX when all centroids coincide.
+ */
+static float
+FindSplit(
+    IN const BVHBuilder *builder,
+    IN const BVHNode *node,
+    OUT TRUInt *axis,
+    OUT float *position
+) {
+    float best = BVH_FAR;
+    TRUInt candidate, iterator;
+
+    for ( candidate = 0; candidate < 3; candidate++ )
+    {
+        BVHBin bins[BVH_SAH_BINS];
+        float leftArea[BVH_SAH_BINS - 1], rightArea[BVH_SAH_BINS - 1];
+        TRUInt leftCount[BVH_SAH_BINS - 1], rightCount[BVH_SAH_BINS - 1];
+        Vector3 leftMin, leftMax, rightMin, rightMax;
+        TRUInt leftSum = 0, rightSum = 0;
+        float low = BVH_FAR, high = -BVH_FAR, scale;
+
+        for ( iterator = 0; iterator < node->Count; iterator++ )
+        {
+            const float centroid = Vector3Axis( builder->Centroids[builder->Indices[node->LeftOrFirst + iterator]], candidate );
+            low = fminf( low, centroid );
+            high = fmaxf( high, centroid );
+        }
+        if ( low == high ) continue;
+
+        for ( iterator = 0; iterator < BVH_SAH_BINS; iterator++ )
+        {
+            bins[iterator].Min = Vector3Make( BVH_FAR, BVH_FAR, BVH_FAR );
+            bins[iterator].Max = Vector3Make( -BVH_FAR, -BVH_FAR, -BVH_FAR );
+            bins[iterator].Count = 0;
+        }
+
+        scale = BVH_SAH_BINS / (high - low);
+        for ( iterator = 0; iterator < node->Count; iterator++ )
+        {
+            const TRUInt triangle = builder->Indices[node->LeftOrFirst + iterator];
+            TRUInt bin = (TRUInt)((Vector3Axis( builder->Centroids[triangle], candidate ) - low) * scale);
+
+            if ( bin > BVH_SAH_BINS - 1 ) bin = BVH_SAH_BINS - 1;
+            GrowBounds( &bins[bin].Min, &bins[bin].Max, &builder->Source->Triangles[triangle] );
+            bins[bin].Count++;
+        }
+
+        // Sweep from both ends, plane i lies between bins i and i + 1.
+        leftMin = rightMin = Vector3Make( BVH_FAR, BVH_FAR, BVH_FAR );
+        leftMax = rightMax = Vector3Make( -BVH_FAR, -BVH_FAR, -BVH_FAR );
+        for ( iterator = 0; iterator < BVH_SAH_BINS - 1; iterator++ )
+        {
+            const BVHBin *left = &bins[iterator], *right = &bins[BVH_SAH_BINS - 1 - iterator];
+
+            leftSum += left->Count;
+            leftMin = Vector3Min( leftMin, left->Min );
+            leftMax = Vector3Max( leftMax, left->Max );
+            leftCount[iterator] = leftSum;
+            leftArea[iterator] = leftSum ? HalfArea( leftMin, leftMax ) : 0.0f;
+
+            rightSum += right->Count;
+            rightMin = Vector3Min( rightMin, right->Min );
+            rightMax = Vector3Max( rightMax, right->Max );
+            rightCount[BVH_SAH_BINS - 2 - iterator] = rightSum;
+            rightArea[BVH_SAH_BINS - 2 - iterator] = rightSum ? HalfArea( rightMin, rightMax ) : 0.0f;
+        }
+
+        for ( iterator = 0; iterator < BVH_SAH_BINS - 1; iterator++ )
+        {
+            const float cost = leftCount[iterator] * leftArea[iterator] + rightCount[iterator] * rightArea[iterator];
+
+            if ( !leftCount[iterator] || !rightCount[iterator] || cost >= best ) continue;
+
+            best = cost;
+            *axis = candidate;
+            *position = low + (iterator + 1) / scale;
+        }
+    }
+
+    return best;
+}
+
+static void
+Subdivide(
+    INOUT BVHBuilder *builder,
+    IN TRUInt *stack
+) {
+    TRUInt depth = 0;
+
+    // Pairs of node and its depth in the tree.
+    stack[depth++] = 0;
+    stack[depth++] = 0;
+
+    while ( depth )
+    {
+        const TRUInt level = stack[--depth];
+        BVHNode *node = &builder->Tree->Nodes[stack[--depth]];
+        const TRUInt first = node->LeftOrFirst, count = node->Count;
+        TRUInt axis = 0, children;
+        TRLong left, right;
+        float position = 0.0f;
+
+        // Traversal pushes at most one node per level, deeper children would not fit its stack.
+        if ( level + 1 >= BVH_STACK_SIZE ) continue;
+
+        // Splitting only pays off when traversing two children is cheaper than testing every triangle.
+        if ( FindSplit( builder, node, &axis, &position ) >= count * HalfArea( node->Min, node->Max ) ) continue;
+
+        left = first;
+        right = (TRLong)first + count - 1;
+        while ( left <= right )
+        {
+            if ( Vector3Axis( builder->Centroids[builder->Indices[left]], axis ) < position )
+                left++;
+            else
+            {
+                const TRUInt swap = builder->Indices[left];
+                builder->Indices[left] = builder->Indices[right];
+                builder->Indices[right--] = swap;
+            }
+        }
+
+        // Rounding can put a centroid on the other side of the plane than its bin.
+        if ( left == first || left == (TRLong)(first + count) ) continue;
+
+        children = builder->Tree->NodeCount;
+        builder->Tree->NodeCount += 2;
+
+        builder->Tree->Nodes[children] = (BVHNode){ .LeftOrFirst = first, .Count = (TRUInt)left - first };
+        builder->Tree->Nodes[children + 1] = (BVHNode){ .LeftOrFirst = (TRUInt)left, .Count = count - ((TRUInt)left - first) };
+        UpdateBounds( builder, &builder->Tree->Nodes[children] );
+        UpdateBounds( builder, &builder->Tree->Nodes[children + 1] );
+
+        node->LeftOrFirst = children;
+        node->Count = 0;
+
+        stack[depth++] = children;
+        stack[depth++] = level + 1;
+        stack[depth++] = children + 1;
+        stack[depth++] = level + 1;
+    }
+}
+
+TR_STATUS TR_API
+BVHBuild(
+    INOUT Scene *scene,
+    OUT BVH *bvh
+) {
+    BVHBuilder builder = { .Source = scene, .Tree = bvh };
+    SceneTriangle *sorted = nullptr;
+    TRUInt *stack = nullptr;
+    TR_STATUS status = T_OUTOFMEMORY;
+    TRUInt iterator;
+
+    TR_ZONE( "BVH::Build" );
+    TR_PERF_PHASE( "BVH::Build" );
+
+    if ( !scene || !bvh ) return T_INVALIDARG;
+
+    *bvh = (BVH){};
+    if ( !scene->TriangleCount ) return T_INVALIDARG;
+
+    // A full binary tree over n leaves has 2n - 1 nodes, and there are at most n leaves.
+    if (!(bvh->Nodes = TRAlloc( sizeof(BVHNode) * (2 * scene->TriangleCount - 1), MEMORY_TAG_GEOMETRY )) ||
+        !(builder.Indices = TRAlloc( sizeof(TRUInt) * scene->TriangleCount, MEMORY_TAG_GEOMETRY )) ||
+        !(builder.Centroids = TRAlloc( sizeof(Vector3) * scene->TriangleCount, MEMORY_TAG_GEOMETRY )) ||
+        !(stack = TRAlloc( sizeof(TRUInt) * 2 * (BVH_STACK_SIZE + 1), MEMORY_TAG_GEOMETRY )) ||
+        !(sorted = TRAlloc( sizeof(SceneTriangle) * scene->TriangleCount, MEMORY_TAG_GEOMETRY )))
+        goto _CLEANUP;
+
+    for ( iterator = 0; iterator < scene->TriangleCount; iterator++ )
+    {
+        const SceneTriangle *triangle = &scene->Triangles[iterator];
+
+        builder.Indices[iterator] = iterator;
+        builder.Centroids[iterator] = Vector3Add( triangle->V0, Vector3Scale( Vector3Add( triangle->Edge1, triangle->Edge2 ), 1.0f / 3.0f ) );
+    }
+
+    bvh->NodeCount = 1;
+    bvh->Nodes[0] = (BVHNode){ .LeftOrFirst = 0, .Count = scene->TriangleCount };
+    UpdateBounds( &builder, &bvh->Nodes[0] );
+
+    Subdivide( &builder, stack );
+
+    // Leaves index the triangle array directly from now on.
+    for ( iterator = 0; iterator < scene->TriangleCount; iterator++ )
+        sorted[iterator] = scene->Triangles[builder.Indices[iterator]];
+    memcpy( scene->Triangles, sorted, sizeof(SceneTriangle) * scene->TriangleCount );
+
+    INFO( "Built a BVH of %u nodes over %u triangles\n", bvh->NodeCount, scene->TriangleCount );
+
+    status = SceneIndexLights( scene );
+
+_CLEANUP:
+    TRFree( sorted );
+    TRFree( stack );
+    TRFree( builder.Centroids );
+    TRFree( builder.Indices );
+    if ( FAILED( status ) ) BVHFree( bvh );
+    return status;
+}
+
+void TR_API
+BVHFree(
+    IN BVH *bvh
+) {
+    TRFree( bvh->Nodes );
+    *bvh = (BVH){};
+}
+
+// Entry distance of the ray into the box, BVH_FAR when it misses or enters past tMax.
+static inline float
+IntersectBox(
+    IN const BVHNode *node,
+    IN Vector3 origin,
+    IN Vector3 inverse,
+    IN float tMax
+) {
+    const float x0 = (node->Min.X - origin.X) * inverse.X, x1 = (node->Max.X - origin.X) * inverse.X;
+    const float y0 = (node->Min.Y - origin.Y) * inverse.Y, y1 = (node->Max.Y - origin.Y) * inverse.Y;
+    const float z0 = (node->Min.Z - origin.Z) * inverse.Z, z1 = (node->Max.Z - origin.Z) * inverse.Z;
+    const float enter = fmaxf( fmaxf( fminf( x0, x1 ), fminf( y0, y1 ) ), fmaxf( fminf( z0, z1 ), 0.0f ) );
+    const float exit = fminf( fminf( fmaxf( x0, x1 ), fmaxf( y0, y1 ) ), fminf( fmaxf( z0, z1 ), tMax ) );
+
+    return enter <= exit ? enter : BVH_FAR;
+}
+
+// Möller-Trumbore, shortens *t and returns true on a closer hit.
+static inline TRBool
+IntersectTriangle(
+    IN const SceneTriangle *triangle,
+    IN Vector3 origin,
+    IN Vector3 direction,
+    INOUT float *t
+) {
+    const Vector3 p = Vector3Cross( direction, triangle->Edge2 );
+    const float determinant = Vector3Dot( triangle->Edge1, p );
+    Vector3 s, q;
+    float inverse, u, v, distance;
+
+    if ( fabsf( determinant ) < 1e-12f ) return false;
+
+    inverse = 1.0f / determinant;
+    s = Vector3Sub( origin, triangle->V0 );
+    u = Vector3Dot( s, p ) * inverse;
+    if ( u < 0.0f || u > 1.0f ) return false;
+
+    q = Vector3Cross( s, triangle->Edge1 );
+    v = Vector3Dot( direction, q ) * inverse;
+    if ( v < 0.0f || u + v > 1.0f ) return false;
+
+    distance = Vector3Dot( triangle->Edge2, q ) * inverse;
+    if ( distance <= BVH_RAY_EPSILON || distance >= *t ) return false;
+
+    *t = distance;
+    return true;
+}
+
+void TR_API
+BVHIntersect(
+    IN const BVH *bvh,
+    IN const Scene *scene,
+    IN const Vector3 origin,
+    IN const Vector3 direction,
+    IN const float tMax,
+    IN const TRBool anyHit,
+    OUT BVHHit *hit
+) {
+    const Vector3 inverse = Vector3Make( 1.0f / direction.X, 1.0f / direction.Y, 1.0f / direction.Z );
+    TRUInt stack[BVH_STACK_SIZE];
+    TRUInt depth = 0, iterator;
+    const BVHNode *node = &bvh->Nodes[0];
+
+    hit->T = tMax;
+    hit->Triangle = BVH_NO_HIT;
+
+    if ( IntersectBox( node, origin, inverse, hit->T ) == BVH_FAR ) return;
+
+    for ( ;; )
+    {
+        if ( node->Count )
+        {
+            for ( iterator = node->LeftOrFirst; iterator < node->LeftOrFirst + node->Count; iterator++ )
+            {
+                if ( !IntersectTriangle( &scene->Triangles[iterator], origin, direction, &hit->T ) ) continue;
+
+                hit->Triangle = iterator;
+                if ( anyHit ) return;
+            }
+        } else
+        {
+            const BVHNode *near = &bvh->Nodes[node->LeftOrFirst], *far = near + 1;
+            float nearDistance = IntersectBox( near, origin, inverse, hit->T );
+            float farDistance = IntersectBox( far, origin, inverse, hit->T );
+
+            if ( farDistance < nearDistance )
+            {
+                const BVHNode *swap = near;
+                const float swapDistance = nearDistance;
+
+                near = far;
+                far = swap;
+                nearDistance = farDistance;
+                farDistance = swapDistance;
+            }
+
+            if ( nearDistance != BVH_FAR )
+            {
+                if ( farDistance != BVH_FAR && depth < BVH_STACK_SIZE ) stack[depth++] = (TRUInt)(far - bvh->Nodes);
+                node = near;
+                continue;
+            }
+        }
+
+        if ( !depth ) return;
+        node = &bvh->Nodes[stack[--depth]];
+    }
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Reference.c
+ *  Description: A plain CPU path tracer, the ground truth for the GPU renderers.
+ */
+
+#include <float.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <Core/Render/Reference.h>
+#include <Core/Memory/Memory.h>
+#include <Core/Instrumentation/PerfCounters.h>
+#include <Core/Instrumentation/Zones.h>
+#include <IO/Logging.h>
+
+#define REFERENCE_MAX_THREADS 64
+
+typedef struct _TR_ReferenceJob
+{
+    const Scene *Source;
+    const BVH *Tree;
+    const RenderSettings *Settings;
+    Vector3 Forward;
+    Vector3 Right;
+    Vector3 Up;
+    float *Out;
+    ATOMIC(TRUInt) NextRow;
+} ReferenceJob;
+
+// PCG, the same hash the shaders use.
+static inline TRUInt
+Hash(
+    IN TRUInt value
+) {
+    const TRUInt state = value * 747796405u + 2891336453u;
+    const TRUInt word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+static inline float
+Random(
+    INOUT TRUInt *state
+) {
+    *state = Hash( *state );
+    return (float)(*state >> 8) * (1.0f / 16777216.0f);
+}
+
+// Cosine weighted around normal, after Duff et al.'s orthonormal basis.
+static Vector3
+SampleHemisphere(
+    IN Vector3 normal,
+    INOUT TRUInt *rng
+) {
+    const float sign = normal.Z >= 0.0f ? 1.0f : -1.0f;
+    const float a = -1.0f / (sign + normal.Z);
+    const float b = normal.X * normal.Y * a;
+    const Vector3 tangent = Vector3Make( 1.0f + sign * normal.X * normal.X * a, sign * b, -sign * normal.X );
+    const Vector3 bitangent = Vector3Make( b, sign + normal.Y * normal.Y * a, -normal.Y );
+    const float u = Random( rng ), phi = 2.0f * (float)M_PI * Random( rng );
+    const float radius = sqrtf( u );
+
+    return Vector3Add( Vector3Add( Vector3Scale( tangent, radius * cosf( phi ) ), Vector3Scale( bitangent, radius * sinf( phi ) ) ),
+                       Vector3Scale( normal, sqrtf( 1.0f - u ) ) );
+}
+
+// Next event estimation towards one uniformly picked light triangle.
+static Vector3
+SampleLight(
+    IN const ReferenceJob *job,
+    IN Vector3 position,
+    IN Vector3 normal,
+    IN Vector3 weight,
+    INOUT TRUInt *rng
+) {
+    const Scene *scene = job->Source;
+    TRUInt index = (TRUInt)(Random( rng ) * (float)scene->LightCount);
+    const SceneTriangle *light;
+    Vector3 lightNormal, point, toLight, direction;
+    float root, r, area, distance, cosSurface, cosLight;
+    BVHHit hit;
+
+    if ( index > scene->LightCount - 1 ) index = scene->LightCount - 1;
+    light = &scene->Triangles[scene->Lights[index]];
+
+    root = sqrtf( Random( rng ) );
+    r = Random( rng );
+    point = Vector3Add( light->V0, Vector3Add( Vector3Scale( light->Edge1, root * (1.0f - r) ), Vector3Scale( light->Edge2, root * r ) ) );
+
+    lightNormal = Vector3Cross( light->Edge1, light->Edge2 );
+    area = 0.5f * Vector3Length( lightNormal );
+    lightNormal = Vector3Normalize( lightNormal );
+
+    toLight = Vector3Sub( point, position );
+    distance = Vector3Length( toLight );
+    direction = Vector3Scale( toLight, 1.0f / distance );
+    cosSurface = Vector3Dot( normal, direction );
+    cosLight = -Vector3Dot( lightNormal, direction );
+    if ( cosSurface <= 0.0f || cosLight <= 0.0f ) return Vector3Make( 0, 0, 0 );
+
+    BVHIntersect( job->Tree, scene, position, direction, distance * (1.0f - RENDER_SHADOW_EPSILON), true, &hit );
+    if ( hit.Triangle != BVH_NO_HIT ) return Vector3Make( 0, 0, 0 );
+
+    return Vector3Scale( Vector3Mul( weight, scene->Materials[light->Material].Emission ),
+                         cosSurface * cosLight * area * (float)scene->LightCount / (distance * distance) );
+}
+
+static Vector3
+TracePath(
+    IN const ReferenceJob *job,
+    IN TRUInt pixel,
+    IN TRUInt sample
+) {
+    const Scene *scene = job->Source;
+    const RenderSettings *settings = job->Settings;
+    TRUInt rng = Hash( pixel ^ Hash( sample ^ Hash( settings->Seed ) ) );
+    const float x = 2.0f * ((float)(pixel % settings->Width) + Random( &rng )) / (float)settings->Width - 1.0f;
+    const float y = 1.0f - 2.0f * ((float)(pixel / settings->Width) + Random( &rng )) / (float)settings->Height;
+    Vector3 origin = scene->Camera.Origin;
+    Vector3 direction = Vector3Normalize( Vector3Add( job->Forward, Vector3Add( Vector3Scale( job->Right, x ), Vector3Scale( job->Up, y ) ) ) );
+    Vector3 throughput = Vector3Make( 1, 1, 1 ), radiance = Vector3Make( 0, 0, 0 );
+    TRUInt depth;
+
+    for ( depth = 0; ; depth++ )
+    {
+        const SceneTriangle *triangle;
+        const SceneMaterial *material;
+        Vector3 normal, position;
+        TRBool front;
+        BVHHit hit;
+
+        BVHIntersect( job->Tree, scene, origin, direction, FLT_MAX, false, &hit );
+        if ( hit.Triangle == BVH_NO_HIT ) break;
+
+        triangle = &scene->Triangles[hit.Triangle];
+        material = &scene->Materials[triangle->Material];
+        normal = Vector3Normalize( Vector3Cross( triangle->Edge1, triangle->Edge2 ) );
+        front = Vector3Dot( normal, direction ) < 0.0f;
+
+        // Hitting a light after a bounce was already counted by the light sample at the previous vertex.
+        if ( Vector3MaxComponent( material->Emission ) > 0.0f )
+        {
+            if ( !depth && front ) radiance = Vector3Add( radiance, Vector3Mul( throughput, material->Emission ) );
+            break;
+        }
+
+        if ( !front ) normal = Vector3Scale( normal, -1.0f );
+        position = Vector3Add( Vector3Add( origin, Vector3Scale( direction, hit.T ) ), Vector3Scale( normal, RENDER_RAY_OFFSET ) );
+
+        if ( scene->LightCount )
+            radiance = Vector3Add( radiance, SampleLight( job, position, normal, Vector3Scale( Vector3Mul( throughput, material->Albedo ), (float)M_1_PI ), &rng ) );
+
+        if ( depth + 1 >= settings->MaxDepth ) break;
+
+        throughput = Vector3Mul( throughput, material->Albedo );
+        if ( depth + 1 >= RENDER_ROULETTE_DEPTH )
+        {
+            const float survival = fminf( fmaxf( Vector3MaxComponent( throughput ), 0.05f ), 0.95f );
+            if ( Random( &rng ) >= survival ) break;
+            throughput = Vector3Scale( throughput, 1.0f / survival );
+        }
+
+        origin = position;
+        direction = SampleHemisphere( normal, &rng );
+    }
+
+    return radiance;
+}
+
+static void *
+RenderRows(
+    IN void *param
+) {
+    ReferenceJob *job = param;
+    const RenderSettings *settings = job->Settings;
+    TRUInt row, column, sample;
+
+    TR_ZONE( "Reference::Rows" );
+    TR_PERF_PHASE( "Reference::TracePath" );
+
+    while ( (row = atomic_fetch_add( &job->NextRow, 1 )) < settings->Height )
+    {
+        for ( column = 0; column < settings->Width; column++ )
+        {
+            const TRUInt pixel = row * settings->Width + column;
+            Vector3 sum = Vector3Make( 0, 0, 0 );
+
+            for ( sample = 0; sample < settings->Samples; sample++ )
+                sum = Vector3Add( sum, TracePath( job, pixel, sample ) );
+
+            job->Out[pixel * 3 + 0] = sum.X / (float)settings->Samples;
+            job->Out[pixel * 3 + 1] = sum.Y / (float)settings->Samples;
+            job->Out[pixel * 3 + 2] = sum.Z / (float)settings->Samples;
+        }
+    }
+
+    return nullptr;
+}
+
+TR_STATUS TR_API
+RenderReference(
+    IN const Scene *scene,
+    IN const BVH *bvh,
+    IN const RenderSettings *settings,
+    OUT float *out
+) {
+    ReferenceJob job = { .Source = scene, .Tree = bvh, .Settings = settings, .Out = out };
+    pthread_t threads[REFERENCE_MAX_THREADS];
+    TRLong count = sysconf( _SC_NPROCESSORS_ONLN );
+    TRLong started, iterator;
+
+    TR_ZONE( "Reference::Render" );
+
+    if ( !scene || !bvh || !settings || !out ) return T_INVALIDARG;
+    if ( !settings->Width || !settings->Height || !settings->Samples || !settings->MaxDepth ) return T_INVALIDARG;
+
+    SceneCameraBasis( &scene->Camera, settings->Width, settings->Height, &job.Forward, &job.Right, &job.Up );
+    atomic_init( &job.NextRow, 0 );
+
+    if ( count < 1 ) count = 1;
+    if ( count > REFERENCE_MAX_THREADS ) count = REFERENCE_MAX_THREADS;
+
+    // The calling thread works too, it is also the fallback when no thread can be started.
+    for ( started = 0; started < count - 1; started++ )
+        if ( pthread_create( &threads[started], nullptr, RenderRows, &job ) ) break;
+
+    RenderRows( &job );
+
+    for ( iterator = 0; iterator < started; iterator++ )
+        pthread_join( threads[iterator], nullptr );
+
+    return T_SUCCESS;
+}
+
+TRFloat TR_API
+RenderRootMeanSquareError(
+    IN const float *a,
+    IN const float *b,
+    IN const TRSize count
+) {
+    TRFloat sum = 0.0;
+    TRSize iterator;
+
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        const TRFloat difference = (TRFloat)a[iterator] - (TRFloat)b[iterator];
+        sum += difference * difference;
+    }
+
+    return count ? sqrt( sum / (TRFloat)count ) : 0.0;
+}
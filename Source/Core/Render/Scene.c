@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Scene.c
+ *  Description: Triangle scenes shared by the CPU reference and the compute tracer.
+ */
+
+#include <math.h>
+
+#include <Core/Render/Scene.h>
+#include <Core/Memory/Memory.h>
+#include <IO/Logging.h>
+
+#define CORNELL_BOX_TRIANGLES 32
+
+enum
+{
+    CORNELL_WHITE,
+    CORNELL_RED,
+    CORNELL_GREEN,
+    CORNELL_LIGHT,
+    CORNELL_MATERIALS
+};
+
+static void
+AddTriangle(
+    INOUT Scene *scene,
+    IN Vector3 v0,
+    IN Vector3 v1,
+    IN Vector3 v2,
+    IN TRUInt material
+) {
+    SceneTriangle *triangle = &scene->Triangles[scene->TriangleCount++];
+
+    triangle->V0 = v0;
+    triangle->Edge1 = Vector3Sub( v1, v0 );
+    triangle->Edge2 = Vector3Sub( v2, v0 );
+    triangle->Material = material;
+}
+
+// Faces where (b - a) x (c - a) points.
+static void
+AddQuad(
+    INOUT Scene *scene,
+    IN Vector3 a,
+    IN Vector3 b,
+    IN Vector3 c,
+    IN Vector3 d,
+    IN TRUInt material
+) {
+    AddTriangle( scene, a, b, c, material );
+    AddTriangle( scene, a, c, d, material );
+}
+
+// Without its bottom, which would lie in the floor.
+static void
+AddBlock(
+    INOUT Scene *scene,
+    IN Vector3 centre,
+    IN Vector3 size,
+    IN float angle,
+    IN TRUInt material
+) {
+    const float c = cosf( angle ), s = sinf( angle );
+    Vector3 corners[8];
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < 8; iterator++ )
+    {
+        const float x = (iterator & 1 ? 0.5f : -0.5f) * size.X;
+        const float z = (iterator & 4 ? 0.5f : -0.5f) * size.Z;
+
+        corners[iterator] = Vector3Make( centre.X + c * x + s * z, iterator & 2 ? size.Y : 0.0f, centre.Z - s * x + c * z );
+    }
+
+    AddQuad( scene, corners[2], corners[6], corners[7], corners[3], material );     // Top
+    AddQuad( scene, corners[0], corners[2], corners[3], corners[1], material );     // Front
+    AddQuad( scene, corners[5], corners[7], corners[6], corners[4], material );     // Back
+    AddQuad( scene, corners[4], corners[6], corners[2], corners[0], material );     // Left
+    AddQuad( scene, corners[1], corners[3], corners[7], corners[5], material );     // Right
+}
+
+TR_STATUS TR_API
+SceneCreateCornellBox(
+    OUT Scene *scene
+) {
+    const Vector3 white = { 0.73f, 0.73f, 0.73f };
+
+    if ( !scene ) return T_INVALIDARG;
+
+    *scene = (Scene){};
+
+    if (!(scene->Triangles = TRCalloc( CORNELL_BOX_TRIANGLES, sizeof(SceneTriangle), MEMORY_TAG_GEOMETRY )) ||
+        !(scene->Materials = TRCalloc( CORNELL_MATERIALS, sizeof(SceneMaterial), MEMORY_TAG_GEOMETRY )))
+    {
+        SceneFree( scene );
+        return T_OUTOFMEMORY;
+    }
+
+    scene->MaterialCount = CORNELL_MATERIALS;
+    scene->Materials[CORNELL_WHITE].Albedo = white;
+    scene->Materials[CORNELL_RED].Albedo = Vector3Make( 0.65f, 0.05f, 0.05f );
+    scene->Materials[CORNELL_GREEN].Albedo = Vector3Make( 0.12f, 0.45f, 0.15f );
+    scene->Materials[CORNELL_LIGHT].Emission = Vector3Make( 17.0f, 12.0f, 4.0f );
+
+    // The open side faces the camera, which looks down +Z with +X to its left.
+    AddQuad( scene, Vector3Make( 0, 0, 0 ), Vector3Make( 0, 0, 1 ), Vector3Make( 1, 0, 1 ), Vector3Make( 1, 0, 0 ), CORNELL_WHITE );   // Floor
+    AddQuad( scene, Vector3Make( 0, 1, 0 ), Vector3Make( 1, 1, 0 ), Vector3Make( 1, 1, 1 ), Vector3Make( 0, 1, 1 ), CORNELL_WHITE );   // Ceiling
+    AddQuad( scene, Vector3Make( 0, 0, 1 ), Vector3Make( 0, 1, 1 ), Vector3Make( 1, 1, 1 ), Vector3Make( 1, 0, 1 ), CORNELL_WHITE );   // Back
+    AddQuad( scene, Vector3Make( 1, 0, 0 ), Vector3Make( 1, 0, 1 ), Vector3Make( 1, 1, 1 ), Vector3Make( 1, 1, 0 ), CORNELL_RED );     // Left
+    AddQuad( scene, Vector3Make( 0, 0, 0 ), Vector3Make( 0, 1, 0 ), Vector3Make( 0, 1, 1 ), Vector3Make( 0, 0, 1 ), CORNELL_GREEN );   // Right
+
+    // Facing down, just below the ceiling so it is not hidden by it.
+    AddQuad( scene, Vector3Make( 0.38f, 0.999f, 0.40f ), Vector3Make( 0.62f, 0.999f, 0.40f ),
+                    Vector3Make( 0.62f, 0.999f, 0.60f ), Vector3Make( 0.38f, 0.999f, 0.60f ), CORNELL_LIGHT );
+
+    AddBlock( scene, Vector3Make( 0.35f, 0, 0.35f ), Vector3Make( 0.30f, 0.30f, 0.30f ), -0.30f, CORNELL_WHITE );
+    AddBlock( scene, Vector3Make( 0.65f, 0, 0.65f ), Vector3Make( 0.30f, 0.60f, 0.30f ), 0.30f, CORNELL_WHITE );
+
+    scene->Camera = (SceneCamera){
+        .Origin = { 0.5f, 0.5f, -1.4f },
+        .Target = { 0.5f, 0.5f, 0.5f },
+        .Up = { 0, 1, 0 },
+        .FovY = 39.3f
+    };
+
+    return SceneIndexLights( scene );
+}
+
+TR_STATUS TR_API
+SceneIndexLights(
+    INOUT Scene *scene
+) {
+    TRUInt iterator;
+
+    TRFree( scene->Lights );
+    scene->Lights = nullptr;
+    scene->LightCount = 0;
+
+    for ( iterator = 0; iterator < scene->TriangleCount; iterator++ )
+    {
+        if ( Vector3MaxComponent( scene->Materials[scene->Triangles[iterator].Material].Emission ) <= 0.0f ) continue;
+
+        if ( !scene->Lights && !(scene->Lights = TRAlloc( sizeof(TRUInt) * scene->TriangleCount, MEMORY_TAG_GEOMETRY )) )
+            return T_OUTOFMEMORY;
+
+        scene->Lights[scene->LightCount++] = iterator;
+    }
+
+    if ( !scene->LightCount )
+        WARN( "Scene has no emissive triangles, it renders black\n" );
+
+    return T_SUCCESS;
+}
+
+void TR_API
+SceneFree(
+    IN Scene *scene
+) {
+    TRFree( scene->Triangles );
+    TRFree( scene->Materials );
+    TRFree( scene->Lights );
+    *scene = (Scene){};
+}
+
+void TR_API
+SceneCameraBasis(
+    IN const SceneCamera *camera,
+    IN const TRUInt width,
+    IN const TRUInt height,
+    OUT Vector3 *forward,
+    OUT Vector3 *right,
+    OUT Vector3 *up
+) {
+    const float halfHeight = tanf( camera->FovY * (float)M_PI / 360.0f );
+    const float halfWidth = halfHeight * (float)width / (float)height;
+
+    *forward = Vector3Normalize( Vector3Sub( camera->Target, camera->Origin ) );
+    *right = Vector3Normalize( Vector3Cross( *forward, camera->Up ) );
+    *up = Vector3Cross( *right, *forward );
+
+    *right = Vector3Scale( *right, halfWidth );
+    *up = Vector3Scale( *up, halfHeight );
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Epoch.c
+ *  Description: Epoch based reclamation for copy-on-write data.
+ */
+
+#include <pthread.h>
+
+#include <Core/Sync/Epoch.h>
+#include <Core/Memory/Memory.h>
+#include <IO/Logging.h>
+
+#define EPOCH_QUIESCENT 0
+
+typedef struct _TR_EpochThread
+{
+    struct _TR_EpochThread *Next;
+    ATOMIC(TRULong) Epoch;          // The epoch the thread entered in, EPOCH_QUIESCENT outside
+    ATOMIC(TRBool) InUse;
+} EpochThread;
+
+typedef struct _TR_EpochRetired
+{
+    struct _TR_EpochRetired *Next;
+    void *Object;
+    EpochDestroy Destroy;
+    TRULong Epoch;
+} EpochRetired;
+
+static ATOMIC(TRULong) GlobalEpoch = 1;
+static ATOMIC(EpochThread *) Threads = nullptr;   // Only ever grows, records are recycled
+static ATOMIC(TRSize) RetiredCount = 0;
+
+static EpochRetired *Retired = nullptr;
+static pthread_mutex_t RetiredMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t ThreadKey;
+static pthread_once_t ThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+static thread_local EpochThread *CurrentThread = nullptr;
+static thread_local TRUInt Depth = 0;
+
+static void
+ReleaseThread(
+    IN void *record
+) {
+    EpochThread *thread = record;
+
+    atomic_store_explicit( &thread->Epoch, EPOCH_QUIESCENT, memory_order_release );
+    atomic_store_explicit( &thread->InUse, false, memory_order_release );
+}
+
+static void
+CreateThreadKey()
+{
+    pthread_key_create( &ThreadKey, ReleaseThread );
+}
+
+static EpochThread *
+AcquireThread()
+{
+    EpochThread *thread;
+    TRBool inUse;
+
+    pthread_once( &ThreadKeyOnce, CreateThreadKey );
+
+    for ( thread = atomic_load( &Threads ); thread; thread = thread->Next )
+    {
+        inUse = false;
+        if ( atomic_compare_exchange_strong( &thread->InUse, &inUse, true ) )
+            goto _DONE;
+    }
+
+    // Never freed, a thread that exits hands its record to the next one.
+    if (!(thread = TRCalloc( 1, sizeof( *thread ), MEMORY_TAG_OBJECT ))) return nullptr;
+
+    atomic_init( &thread->InUse, true );
+    thread->Next = atomic_load( &Threads );
+    while ( !atomic_compare_exchange_weak( &Threads, &thread->Next, thread ) );
+
+_DONE:
+    pthread_setspecific( ThreadKey, thread );
+    return thread;
+}
+
+void TR_API
+EpochEnter()
+{
+    if ( Depth++ )
+        return;
+
+    if ( !CurrentThread && !(CurrentThread = AcquireThread()) )
+    {
+        ERROR( "Could not register thread for epoch tracking!\n" );
+        abort();
+    }
+
+    atomic_store( &CurrentThread->Epoch, atomic_load( &GlobalEpoch ) );
+
+    /**
+     * The store has to be visible before any pointer the caller loads next: a writer
+     * that retires data after that load scans this epoch, and one that retired it
+     * before tagged it with an epoch no lower than this one.
+     */
+    atomic_thread_fence( memory_order_seq_cst );
+}
+
+void TR_API
+EpochExit()
+{
+    if ( --Depth )
+        return;
+
+    atomic_store_explicit( &CurrentThread->Epoch, EPOCH_QUIESCENT, memory_order_release );
+
+    if ( atomic_load_explicit( &RetiredCount, memory_order_relaxed ) )
+        EpochCollect();
+}
+
+TR_STATUS TR_API
+EpochRetire(
+    IN void *object,
+    IN EpochDestroy destroy
+) {
+    EpochRetired *retired;
+
+    if ( !object || !destroy ) throw_NullPtrException();
+
+    if (!(retired = TRAlloc( sizeof( *retired ), MEMORY_TAG_OBJECT ))) return T_OUTOFMEMORY;
+
+    retired->Object = object;
+    retired->Destroy = destroy;
+    // Readers entering from here on can not see object anymore.
+    retired->Epoch = atomic_fetch_add( &GlobalEpoch, 1 );
+
+    pthread_mutex_lock( &RetiredMutex );
+    retired->Next = Retired;
+    Retired = retired;
+    atomic_fetch_add_explicit( &RetiredCount, 1, memory_order_relaxed );
+    pthread_mutex_unlock( &RetiredMutex );
+
+    EpochCollect();
+
+    return T_SUCCESS;
+}
+
+void TR_API
+EpochCollect()
+{
+    EpochThread *thread;
+    EpochRetired **link, *retired, *expired = nullptr;
+    TRULong epoch;
+
+    // Anything retired while scanning may still be held by a reader the scan already passed.
+    TRULong oldest = atomic_load( &GlobalEpoch );
+
+    // A reader that is still inside protects everything retired in or after its epoch.
+    for ( thread = atomic_load( &Threads ); thread; thread = thread->Next )
+        if ( (epoch = atomic_load( &thread->Epoch )) != EPOCH_QUIESCENT && epoch < oldest )
+            oldest = epoch;
+
+    pthread_mutex_lock( &RetiredMutex );
+
+    for ( link = &Retired; (retired = *link); )
+    {
+        if ( retired->Epoch >= oldest )
+        {
+            link = &retired->Next;
+            continue;
+        }
+
+        *link = retired->Next;
+        retired->Next = expired;
+        expired = retired;
+        atomic_fetch_sub_explicit( &RetiredCount, 1, memory_order_relaxed );
+    }
+
+    pthread_mutex_unlock( &RetiredMutex );
+
+    // Outside the lock, since destroying may retire more.
+    while ( (retired = expired) )
+    {
+        expired = retired->Next;
+        retired->Destroy( retired->Object );
+        TRFree( retired );
+    }
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: Signal.c
+ *  Description: Copy-on-write signal handler arrays.
+ */
+
+#include <string.h>
+
+#include <Signal.h>
+#include <Core/Sync/Epoch.h>
+
+#define SIGNAL_SLOT_NONE ((TRUInt)~0u)
+
+static SignalHandlerArray *
+AllocateHandlerArray(
+    IN TRSize count
+) {
+    SignalHandlerArray *array;
+
+    if (!(array = TRAlloc( sizeof( SignalHandlerArray ) + count * sizeof( SignalHandler ), MEMORY_TAG_OBJECT )))
+        return nullptr;
+
+    array->count = count;
+    return array;
+}
+
+static void
+FreeHandlerArray(
+    IN void *array
+) {
+    TRFree( array );
+}
+
+static void
+DestroyHandlerArray(
+    IN void *object
+) {
+    SignalHandlerArray *array = object;
+    TRSize index;
+
+    for ( index = 0; index < array->count; index++ )
+        if ( array->handlers[index].destroy )
+            array->handlers[index].destroy( array->handlers[index].user_data );
+
+    TRFree( array );
+}
+
+// The removed handler is retired on its own, so its destroy notify runs after the grace period too.
+static void
+DestroyRemovedHandler(
+    IN void *object
+) {
+    SignalHandlerArray *removed = object;
+
+    removed->handlers[0].destroy( removed->handlers[0].user_data );
+    TRFree( removed );
+}
+
+static TRBool
+AcquireSlot(
+    IN SignalEvent *event,
+    IN TRUInt position,
+    OUT TRULong *token
+) {
+    SignalSlot *slots;
+    TRUInt slot, capacity;
+
+    if ( (slot = event->freeSlot) != SIGNAL_SLOT_NONE )
+        event->freeSlot = event->slots[slot].position;
+    else
+    {
+        if ( event->slotCount == event->slotCapacity )
+        {
+            capacity = event->slotCapacity ? event->slotCapacity * 2 : 4;
+            if ( capacity >= SIGNAL_SLOT_NONE || !(slots = TRRealloc( event->slots, capacity * sizeof( SignalSlot ), MEMORY_TAG_OBJECT )) )
+                return false;
+
+            event->slots = slots;
+            event->slotCapacity = capacity;
+        }
+
+        slot = event->slotCount++;
+        event->slots[slot].generation = 1;
+    }
+
+    event->slots[slot].position = position;
+    *token = SIGNAL_TOKEN( slot, event->slots[slot].generation );
+    return true;
+}
+
+static void
+ReleaseSlot(
+    IN SignalEvent *event,
+    IN TRUInt slot
+) {
+    // Outstanding tokens for the slot go stale here.
+    if ( !++event->slots[slot].generation )
+        event->slots[slot].generation = 1;
+
+    event->slots[slot].position = event->freeSlot;
+    event->freeSlot = slot;
+}
+
+void TR_API
+SignalEventInit(
+    IN SignalEvent *event
+) {
+    atomic_init( &event->handlers, nullptr );
+    pthread_mutex_init( &event->writeLock, nullptr );
+    atomic_init( &event->posts, 0 );
+    event->slots = nullptr;
+    event->slotCount = event->slotCapacity = 0;
+    event->freeSlot = SIGNAL_SLOT_NONE;
+}
+
+TR_STATUS TR_API
+SignalEventAdd(
+    IN SignalEvent *event,
+    IN SignalCallback callback,
+    IN void *context,
+    IN SignalDestroyNotify destroy,
+    OUT TRULong *token
+) {
+    SignalHandlerArray *current, *next;
+    SignalHandler *handler;
+    TRSize count;
+
+    if ( !event || !callback || !token ) throw_NullPtrException();
+
+    pthread_mutex_lock( &event->writeLock );
+
+    current = atomic_load_explicit( &event->handlers, memory_order_relaxed );
+    count = current ? current->count : 0;
+
+    if ( !(next = AllocateHandlerArray( count + 1 )) || !AcquireSlot( event, (TRUInt)count, token ) )
+    {
+        pthread_mutex_unlock( &event->writeLock );
+        TRFree( next );
+        return T_OUTOFMEMORY;
+    }
+
+    if ( count )
+        memcpy( next->handlers, current->handlers, count * sizeof( SignalHandler ) );
+
+    handler = &next->handlers[count];
+    handler->id = *token;
+    handler->callback = callback;
+    handler->user_data = context;
+    handler->destroy = destroy;
+
+    atomic_store_explicit( &event->handlers, next, memory_order_release );
+    pthread_mutex_unlock( &event->writeLock );
+
+    if ( current )
+        EpochRetire( current, FreeHandlerArray );
+
+    TRACE( "added event with token id %llu\n", *token );
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API
+SignalEventRemove(
+    IN SignalEvent *event,
+    IN TRULong token
+) {
+    SignalHandlerArray *current, *next = nullptr, *removed;
+    TRUInt slot = SIGNAL_TOKEN_SLOT( token );
+    TRSize found, last;
+
+    if ( !event ) throw_NullPtrException();
+
+    pthread_mutex_lock( &event->writeLock );
+
+    current = atomic_load_explicit( &event->handlers, memory_order_relaxed );
+
+    if ( !current || slot >= event->slotCount || event->slots[slot].generation != SIGNAL_TOKEN_GENERATION( token ) ||
+         (found = event->slots[slot].position) >= current->count || current->handlers[found].id != token )
+    {
+        pthread_mutex_unlock( &event->writeLock );
+        WARN( "token %llu is stale or was never handed out\n", token );
+        return T_NOINIT;
+    }
+
+    last = current->count - 1;
+
+    if (!(removed = AllocateHandlerArray( 1 )) || (last && !(next = AllocateHandlerArray( last ))))
+    {
+        pthread_mutex_unlock( &event->writeLock );
+        TRFree( removed );
+        return T_OUTOFMEMORY;
+    }
+
+    // The last handler takes the removed one's place, so only its slot has to move.
+    if ( next )
+    {
+        memcpy( next->handlers, current->handlers, last * sizeof( SignalHandler ) );
+        if ( found != last )
+        {
+            next->handlers[found] = current->handlers[last];
+            event->slots[SIGNAL_TOKEN_SLOT( current->handlers[last].id )].position = (TRUInt)found;
+        }
+    }
+
+    removed->handlers[0] = current->handlers[found];
+    ReleaseSlot( event, slot );
+
+    atomic_store_explicit( &event->handlers, next, memory_order_release );
+    pthread_mutex_unlock( &event->writeLock );
+
+    EpochRetire( current, FreeHandlerArray );
+
+    if ( removed->handlers[0].destroy )
+        EpochRetire( removed, DestroyRemovedHandler );
+    else
+        TRFree( removed );
+
+    return T_SUCCESS;
+}
+
+void TR_API
+SignalEventEmit(
+    IN SignalEvent *event,
+    IN UnknownObject *invoker
+) {
+    SignalHandlerArray *handlers;
+    TRSize index;
+
+    EpochEnter();
+
+    // Handlers added or removed by a callback take effect from the next emission.
+    if ( (handlers = atomic_load_explicit( &event->handlers, memory_order_acquire )) )
+        for ( index = 0; index < handlers->count; index++ )
+            handlers->handlers[index].callback( invoker, handlers->handlers[index].user_data );
+
+    EpochExit();
+}
+
+TRBool TR_API
+SignalEventPost(
+    IN SignalEvent *event
+) {
+    return !atomic_fetch_add_explicit( &event->posts, 1, memory_order_acq_rel );
+}
+
+void TR_API
+SignalEventFlush(
+    IN SignalEvent *event,
+    IN UnknownObject *invoker
+) {
+    TRUInt posts;
+
+    // Reset first, so a post racing the handlers schedules another flush rather than being lost.
+    if ( !(posts = atomic_exchange_explicit( &event->posts, 0, memory_order_acq_rel )) )
+        return;
+
+    TRACE( "delivering %u coalesced posts\n", posts );
+
+    SignalEventEmit( event, invoker );
+}
+
+void TR_API
+SignalEventClear(
+    IN SignalEvent *event
+) {
+    SignalHandlerArray *current;
+
+    pthread_mutex_lock( &event->writeLock );
+    current = atomic_exchange_explicit( &event->handlers, nullptr, memory_order_acq_rel );
+    TRFree( event->slots );
+    event->slots = nullptr;
+    event->slotCount = event->slotCapacity = 0;
+    event->freeSlot = SIGNAL_SLOT_NONE;
+    pthread_mutex_unlock( &event->writeLock );
+
+    pthread_mutex_destroy( &event->writeLock );
+
+    if ( current )
+        EpochRetire( current, DestroyHandlerArray );
+}
@@ -26,12 +26,12 @@
  */
 
 #include <Core/Vulkan/Vulkan.h>
+#include <Core/Instrumentation/Zones.h>
 
 #include <UI/Representation.h>
 
 #ifdef PLATFORM_SUPPORTS_X11
-#include <xcb/xcb.h>
-#include <vulkan/vulkan_xcb.h>
+#include <vulkan/vulkan_xlib.h>
 #endif
 #ifdef PLATFORM_SUPPORTS_WAYLAND
 #include <vulkan/vulkan_wayland.h>
@@ -46,24 +46,62 @@
 
 #include <Statics.h>
 
+static void *VKAPI_PTR
+VulkanAllocation(
+    IN void *userData,
+    IN size_t size,
+    IN size_t alignment,
+    IN VkSystemAllocationScope scope
+) {
+    return TRAlignedAlloc( alignment, size, MEMORY_TAG_VULKAN );
+}
+
+static void *VKAPI_PTR
+VulkanReallocation(
+    IN void *userData,
+    IN void *original,
+    IN size_t size,
+    IN size_t alignment,
+    IN VkSystemAllocationScope scope
+) {
+    if ( !size )
+    {
+        TRFree( original );
+        return nullptr;
+    }
+
+    return TRAlignedRealloc( original, alignment, size, MEMORY_TAG_VULKAN );
+}
+
+static void VKAPI_PTR
+VulkanFree(
+    IN void *userData,
+    IN void *memory
+) {
+    TRFree( memory );
+}
+
+const VkAllocationCallbacks VulkanAllocationCallbacks =
+{
+    .pfnAllocation = VulkanAllocation,
+    .pfnReallocation = VulkanReallocation,
+    .pfnFree = VulkanFree,
+};
+
 static struct vulkan_object *impl_from_VulkanObject( VulkanObject *iface )
 {
     return CONTAINING_RECORD( iface, struct vulkan_object, VulkanObject_iface );
 }
 
-static TR_STATUS vulkan_object_QueryInterface( VulkanObject *iface, const TRUUID uuid, void **out )
-{
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+DEFINE_SLAB_CACHE( vulkan_object, MEMORY_TAG_VULKAN );
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_VulkanObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( vulkan_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_object, VulkanObject_iface ),
+    INTERFACE_ENTRY( VulkanObject, vulkan_object, VulkanObject_iface ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS vulkan_object_QueryInterface( VulkanObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_object_interfaces, impl_from_VulkanObject( iface ), uuid, out );
 }
 
 static TRLong vulkan_object_AddRef( VulkanObject *iface )
@@ -81,67 +119,146 @@ static TRLong vulkan_object_Release( VulkanObject *iface )
     TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
     if ( !(removed - 1) )
     {
-        vkDestroyInstance( impl->instance, nullptr );
-        free( impl );
+        VulkanInventoryFree( impl->devices, impl->deviceCount );
+        vkDestroyInstance( impl->instance, &VulkanAllocationCallbacks );
+        SlabFree( &vulkan_object_cache, impl );
     }
     return removed;
 }
 
 static TR_STATUS vulkan_object_CreateDeviceOverloadDeviceName( VulkanObject *iface, TRCString deviceName, VulkanDeviceObject **out )
 {
-    TR_STATUS status;
-    VkResult result = VK_SUCCESS;
-    VkPhysicalDevice *vkDevices = nullptr;
-    VkPhysicalDevice vkDevice = VK_NULL_HANDLE;
-    TRUInt deviceCount = 0;
     TRUInt iterator;
 
     struct vulkan_object *impl = impl_from_VulkanObject( iface );
 
+    TR_ZONE( "Vulkan::CreateDevice" );
+
     TRACE( "iface %p, deviceName %s, out %p\n", iface, deviceName, out );
 
-    result = vkEnumeratePhysicalDevices( impl->instance, &deviceCount, nullptr );
-    if ( result != VK_SUCCESS || !deviceCount )
+    for ( iterator = 0; iterator < impl->deviceCount; iterator++ )
     {
-        ERROR( "Vulkan device enumeration failed with %d\n", result );
-        return T_ERROR;
+        if ( !strcmp( deviceName, impl->devices[iterator].Properties.deviceName ) )
+            return new_vulkan_device_object_override_device( iface, &impl->devices[iterator], out );
     }
 
-    if (!(vkDevices = malloc( sizeof(VkPhysicalDevice) * deviceCount ))) return T_OUTOFMEMORY;
+    ERROR( "Could not find a vulkan device with name %s\n", deviceName );
+    return T_NOINIT;
+}
 
-    result = vkEnumeratePhysicalDevices( impl->instance, &deviceCount, vkDevices );
-    if ( result != VK_SUCCESS )
+static TR_STATUS vulkan_object_CreateDeviceOverloadIndex( VulkanObject *iface, TRUInt index, VulkanDeviceObject **out )
+{
+    struct vulkan_object *impl = impl_from_VulkanObject( iface );
+
+    TR_ZONE( "Vulkan::CreateDevice" );
+
+    TRACE( "iface %p, index %u, out %p\n", iface, index, out );
+
+    if ( index >= impl->deviceCount )
     {
-        ERROR( "Vulkan device enumeration failed with %d\n", result );
-        free( vkDevices );
-        return T_ERROR;
+        ERROR( "Vulkan device index %u is out of range, there are %u devices\n", index, impl->deviceCount );
+        return T_NOINIT;
     }
 
-    for ( iterator = 0; iterator < deviceCount; iterator++ )
+    return new_vulkan_device_object_override_device( iface, &impl->devices[index], out );
+}
+
+static TR_STATUS vulkan_object_CreateDefaultDevice( VulkanObject *iface, VulkanDeviceObject **out )
+{
+    TR_STATUS status;
+    const VulkanPhysicalDeviceInfo *best;
+
+    struct vulkan_object *impl = impl_from_VulkanObject( iface );
+
+    TR_ZONE( "Vulkan::CreateDevice" );
+
+    TRACE( "iface %p, out %p\n", iface, out );
+
+    if ( FAILED( status = VulkanInventoryBest( impl->devices, impl->deviceCount, &best ) ) )
     {
-        VkPhysicalDeviceProperties deviceProperties;
+        ERROR( "None of the %u vulkan devices can be used\n", impl->deviceCount );
+        return status;
+    }
+
+    INFO( "Vulkan: picked %s\n", best->Properties.deviceName );
 
-        vkGetPhysicalDeviceProperties( vkDevices[iterator], &deviceProperties );
-        if ( !strcmp( deviceName, deviceProperties.deviceName ) )
+    return new_vulkan_device_object_override_device( iface, best, out );
+}
+
+static TR_STATUS vulkan_object_CreateSurface( VulkanObject *iface, const WindowRepresentation *window, VkSurfaceKHR *out )
+{
+    VkResult result = VK_ERROR_EXTENSION_NOT_PRESENT;
+
+    struct vulkan_object *impl = impl_from_VulkanObject( iface );
+
+    TR_ZONE( "Vulkan::CreateSurface" );
+
+    TRACE( "iface %p, window %p, out %p\n", iface, window, out );
+
+    if ( !window || !out ) throw_NullPtrException();
+
+    switch ( window->surfaceType )
+    {
+        case SurfaceType_X11:
         {
-            vkDevice = vkDevices[iterator];
+#ifdef PLATFORM_SUPPORTS_X11
+            VkXlibSurfaceCreateInfoKHR createInfo = { VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR };
+            if ( impl->platform != Platform_X11 ) break;
+            createInfo.dpy = window->x11_display;
+            createInfo.window = window->x11_window;
+            result = vkCreateXlibSurfaceKHR( impl->instance, &createInfo, &VulkanAllocationCallbacks, out );
+#endif
+            break;
+        }
+        case SurfaceType_Wayland:
+        {
+#ifdef PLATFORM_SUPPORTS_WAYLAND
+            VkWaylandSurfaceCreateInfoKHR createInfo = { VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR };
+            if ( impl->platform != Platform_Wayland ) break;
+            createInfo.display = window->wayland_display;
+            createInfo.surface = window->wayland_surface;
+            result = vkCreateWaylandSurfaceKHR( impl->instance, &createInfo, &VulkanAllocationCallbacks, out );
+#endif
             break;
         }
-        WARN( "device %s did not match\n", deviceProperties.deviceName );
+        case SurfaceType_Win32:
+        {
+#ifdef PLATFORM_SUPPORTS_WIN32
+            VkWin32SurfaceCreateInfoKHR createInfo = { VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR };
+            if ( impl->platform != Platform_win32 ) break;
+            createInfo.hinstance = GetModuleHandle( nullptr );
+            createInfo.hwnd = window->win32_window;
+            result = vkCreateWin32SurfaceKHR( impl->instance, &createInfo, &VulkanAllocationCallbacks, out );
+#endif
+            break;
+        }
+        case SurfaceType_macOS:
+            break;
     }
 
-    if ( vkDevice == VK_NULL_HANDLE )
+    if ( result == VK_ERROR_EXTENSION_NOT_PRESENT )
     {
-        ERROR( "Could not find a vulkan device with name %s\n", deviceName );
-        free( vkDevices );
-        return T_NOINIT;
+        ERROR( "Vulkan: The instance cannot present to a surface of type %d\n", window->surfaceType );
+        return T_NOTIMPL;
+    }
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Vulkan surface creation failed with %d\n", result );
+        return T_ERROR;
     }
 
-    status = new_vulkan_device_object_override_device( vkDevice, out );
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_object_DestroySurface( VulkanObject *iface, VkSurfaceKHR surface )
+{
+    struct vulkan_object *impl = impl_from_VulkanObject( iface );
 
-    free( vkDevices );
+    TRACE( "iface %p, surface %p\n", iface, (void *)surface );
 
-    return status;
+    vkDestroySurfaceKHR( impl->instance, surface, &VulkanAllocationCallbacks );
+
+    return T_SUCCESS;
 }
 
 static VulkanInterface vulkan_interface =
@@ -151,11 +268,16 @@ static VulkanInterface vulkan_interface =
     vulkan_object_AddRef,
     vulkan_object_Release,
     /* VulkanObject Methods */
-    vulkan_object_CreateDeviceOverloadDeviceName
+    vulkan_object_CreateDeviceOverloadDeviceName,
+    vulkan_object_CreateDeviceOverloadIndex,
+    vulkan_object_CreateDefaultDevice,
+    vulkan_object_CreateSurface,
+    vulkan_object_DestroySurface
 };
 
 TR_STATUS TR_API new_vulkan_object_override_app_name_and_version_and_platform( IN TRCString appName, IN FormattedVersion version, IN Platform platform, OUT VulkanObject **out )
 {
+    TR_STATUS status;
     VkResult result = VK_SUCCESS;
     VkApplicationInfo appInfo = {0};
     VkInstanceCreateInfo createInfo = {0};
@@ -163,14 +285,18 @@ TR_STATUS TR_API new_vulkan_object_override_app_name_and_version_and_platform( I
     TRCString extensions[2] = { VK_KHR_SURFACE_EXTENSION_NAME, nullptr };
     struct vulkan_object *impl;
 
+    TR_ZONE( "Vulkan::CreateInstance" );
+
     TRACE( "appName %s, version %p, out %p\n", appName, &version, out );
 
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &vulkan_object_cache ))) return T_OUTOFMEMORY;
     impl->VulkanObject_iface.lpVtbl = &vulkan_interface;
     impl->platform = platform;
+    impl->devices = nullptr;
+    impl->deviceCount = 0;
     impl->ref = 1;
 
     appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -197,7 +323,8 @@ TR_STATUS TR_API new_vulkan_object_override_app_name_and_version_and_platform( I
         {
 #ifdef PLATFORM_SUPPORTS_X11
             INFO( "Vulkan: Creating an Instance for an X11 surface...\n" );
-            extensions[1] = VK_KHR_XCB_SURFACE_EXTENSION_NAME;
+            // GDK hands out Xlib handles, see WindowRepresentation.
+            extensions[1] = VK_KHR_XLIB_SURFACE_EXTENSION_NAME;
 #endif
             break;
         }
@@ -222,21 +349,29 @@ TR_STATUS TR_API new_vulkan_object_override_app_name_and_version_and_platform( I
     if ( !extensions[1] )
     {
         ERROR( "Vulkan: Unsupported platform!\n" );
-        free( impl );
+        SlabFree( &vulkan_object_cache, impl );
         return T_NOTIMPL;
     }
 
     createInfo.enabledExtensionCount = 2;
     createInfo.ppEnabledExtensionNames = extensions;
 
-    result = vkCreateInstance( &createInfo, nullptr, &impl->instance );
+    result = vkCreateInstance( &createInfo, &VulkanAllocationCallbacks, &impl->instance );
     if ( result != VK_SUCCESS )
     {
         ERROR( "Vulkan Instance creation failed with %d\n", result );
-        free( impl );
+        SlabFree( &vulkan_object_cache, impl );
         return T_ERROR;
     }
 
+    // Devices never change for the lifetime of an instance, so ask the driver once.
+    if ( FAILED( status = VulkanInventoryCreate( impl->instance, &impl->devices, &impl->deviceCount ) ) )
+    {
+        vkDestroyInstance( impl->instance, &VulkanAllocationCallbacks );
+        SlabFree( &vulkan_object_cache, impl );
+        return status;
+    }
+
     *out = &impl->VulkanObject_iface;
 
     TRACE( "created VulkanObject %p\n", *out );
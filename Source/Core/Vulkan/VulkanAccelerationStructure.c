@@ -0,0 +1,682 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanAccelerationStructure.c
+ *  Description: Batched, compacted builds of bottom level acceleration structures.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <Core/Vulkan/VulkanAccelerationStructure.h>
+#include <Core/Instrumentation/Zones.h>
+
+// A batch takes structures until their scratch memory reaches this, a larger structure gets a batch of its own.
+#define ACCELERATION_BATCH_SCRATCH (64ull * 1024ull * 1024ull)
+
+// Vulkan requires structures to start 256 byte aligned within their buffer.
+#define ACCELERATION_STRUCTURE_ALIGNMENT 256
+
+typedef struct _TR_AccelerationBuild
+{
+    VkAccelerationStructureGeometryKHR Geometry;
+    VkAccelerationStructureBuildRangeInfoKHR Range;
+    VkAccelerationStructureBuildSizesInfoKHR Sizes;
+    VulkanAccelerationStructure Built;              // Freed once copied into its compacted storage
+    VkDeviceSize CompactedSize;                     // Written by vkGetQueryPoolResults with a stride of this struct
+} AccelerationBuild;
+
+static struct vulkan_acceleration_structure_object *impl_from_VulkanAccelerationStructureObject( VulkanAccelerationStructureObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_acceleration_structure_object, VulkanAccelerationStructureObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_acceleration_structure_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_acceleration_structure_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_acceleration_structure_object, VulkanAccelerationStructureObject_iface ),
+    INTERFACE_ENTRY( VulkanAccelerationStructureObject, vulkan_acceleration_structure_object, VulkanAccelerationStructureObject_iface ) );
+
+static VkDeviceSize
+AlignUp(
+    IN VkDeviceSize value,
+    IN VkDeviceSize alignment
+) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static VkDeviceAddress
+BufferAddress(
+    IN struct vulkan_acceleration_structure_object *impl,
+    IN VkBuffer buffer
+) {
+    const VkBufferDeviceAddressInfo addressInfo = { VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, buffer };
+    return vkGetBufferDeviceAddress( impl->handle, &addressInfo );
+}
+
+static void
+DestroyBuffer(
+    IN struct vulkan_acceleration_structure_object *impl,
+    INOUT VkBuffer *buffer,
+    INOUT VulkanAllocation *memory
+) {
+    if ( *buffer ) vkDestroyBuffer( impl->handle, *buffer, &VulkanAllocationCallbacks );
+    if ( memory->Memory ) impl->allocator->lpVtbl->Free( impl->allocator, memory );
+    *buffer = VK_NULL_HANDLE;
+    *memory = (VulkanAllocation){};
+}
+
+static TR_STATUS
+CreateBuffer(
+    IN struct vulkan_acceleration_structure_object *impl,
+    IN VkDeviceSize size,
+    IN VkBufferUsageFlags usage,
+    OUT VkBuffer *buffer,
+    OUT VulkanAllocation *memory
+) {
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    TR_STATUS status;
+
+    *memory = (VulkanAllocation){};
+
+    bufferInfo.size = size;
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if ( vkCreateBuffer( impl->handle, &bufferInfo, &VulkanAllocationCallbacks, buffer ) != VK_SUCCESS )
+    {
+        *buffer = VK_NULL_HANDLE;
+        return T_OUTOFMEMORY;
+    }
+
+    if ( FAILED( status = impl->allocator->lpVtbl->AllocateForBuffer( impl->allocator, *buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0,
+                                                                      VulkanAllocationFlags_None, memory ) ) )
+    {
+        DestroyBuffer( impl, buffer, memory );
+        return status;
+    }
+
+    return T_SUCCESS;
+}
+
+static void
+DestroyStructure(
+    IN struct vulkan_acceleration_structure_object *impl,
+    INOUT VulkanAccelerationStructure *structure
+) {
+    if ( structure->Handle ) impl->destroyAccelerationStructure( impl->handle, structure->Handle, &VulkanAllocationCallbacks );
+    DestroyBuffer( impl, &structure->Buffer, &structure->Memory );
+    *structure = (VulkanAccelerationStructure){};
+}
+
+static TR_STATUS
+CreateStructure(
+    IN struct vulkan_acceleration_structure_object *impl,
+    IN VkDeviceSize size,
+    OUT VulkanAccelerationStructure *out
+) {
+    VkAccelerationStructureCreateInfoKHR createInfo = { VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR };
+    VkAccelerationStructureDeviceAddressInfoKHR addressInfo = { VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR };
+    TR_STATUS status;
+
+    *out = (VulkanAccelerationStructure){ .Size = size };
+
+    if ( FAILED( status = CreateBuffer( impl, size, VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR, &out->Buffer, &out->Memory ) ) )
+        return status;
+
+    createInfo.buffer = out->Buffer;
+    createInfo.size = size;
+    createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+    if ( impl->createAccelerationStructure( impl->handle, &createInfo, &VulkanAllocationCallbacks, &out->Handle ) != VK_SUCCESS )
+    {
+        out->Handle = VK_NULL_HANDLE;
+        DestroyStructure( impl, out );
+        return T_OUTOFMEMORY;
+    }
+
+    addressInfo.accelerationStructure = out->Handle;
+    out->Address = impl->getDeviceAddress( impl->handle, &addressInfo );
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+BeginCommands(
+    IN struct vulkan_acceleration_structure_object *impl
+) {
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if ( vkBeginCommandBuffer( impl->commands, &beginInfo ) != VK_SUCCESS )
+    {
+        ERROR( "Failed to begin the acceleration structure commands\n" );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+// Submits the recorded commands and waits for them, nothing is in flight between calls.
+static TR_STATUS
+ExecuteCommands(
+    IN struct vulkan_acceleration_structure_object *impl
+) {
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    TR_STATUS status;
+    VkResult result;
+
+    TR_ZONE( "VulkanAccelerationStructure::Execute" );
+
+    if ( vkEndCommandBuffer( impl->commands ) != VK_SUCCESS )
+    {
+        ERROR( "Failed to record the acceleration structure commands\n" );
+        return T_ERROR;
+    }
+
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &impl->commands;
+    if ( FAILED( status = impl->queue->lpVtbl->Submit( impl->queue, &submitInfo, 1, impl->fence ) ) ) return status;
+
+    result = vkWaitForFences( impl->handle, 1, &impl->fence, VK_TRUE, UINT64_MAX );
+    vkResetFences( impl->handle, 1, &impl->fence );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Waiting for the acceleration structure builds failed with %d\n", result );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+// Builds have to finish before their results are read or their scratch memory is reused.
+static void
+Barrier(
+    IN VkCommandBuffer commands
+) {
+    VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+
+    barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+    vkCmdPipelineBarrier( commands, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                          0, 1, &barrier, 0, nullptr, 0, nullptr );
+}
+
+// The end of the batch starting at first, and the scratch memory it needs.
+static TRUInt
+NextBatch(
+    IN const AccelerationBuild *builds,
+    IN TRUInt first,
+    IN TRUInt count,
+    IN VkDeviceSize alignment,
+    OUT VkDeviceSize *scratch
+) {
+    TRUInt end = first;
+
+    *scratch = 0;
+    while ( end < count )
+    {
+        const VkDeviceSize size = AlignUp( builds[end].Sizes.buildScratchSize, alignment );
+
+        if ( end > first && *scratch + size > ACCELERATION_BATCH_SCRATCH )
+            break;
+
+        *scratch += size;
+        end++;
+    }
+
+    return end;
+}
+
+static void
+DestroyStructures(
+    IN struct vulkan_acceleration_structure_object *impl
+) {
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < impl->count; iterator++ )
+        DestroyStructure( impl, &impl->structures[iterator] );
+
+    TRFree( impl->structures );
+    impl->structures = nullptr;
+    impl->count = 0;
+}
+
+// Builds builds[first, end) into new structures, reads back their compacted sizes and copies them into out.
+static TR_STATUS
+BuildBatch(
+    IN struct vulkan_acceleration_structure_object *impl,
+    IN AccelerationBuild *builds,
+    IN TRUInt first,
+    IN TRUInt end,
+    IN VkDeviceAddress scratch,
+    IN VkQueryPool queries,
+    INOUT VkAccelerationStructureBuildGeometryInfoKHR *infos,
+    INOUT const VkAccelerationStructureBuildRangeInfoKHR **ranges,
+    OUT VulkanAccelerationStructure *out
+) {
+    const TRUInt count = end - first;
+    VkDeviceSize offset = 0;
+    TR_STATUS status;
+    VkResult result;
+    TRUInt iterator;
+
+    TR_ZONE( "VulkanAccelerationStructure::BuildBatch" );
+
+    for ( iterator = first; iterator < end; iterator++ )
+    {
+        if ( FAILED( status = CreateStructure( impl, builds[iterator].Sizes.accelerationStructureSize, &builds[iterator].Built ) ) )
+            return status;
+
+        infos[iterator].dstAccelerationStructure = builds[iterator].Built.Handle;
+        infos[iterator].scratchData.deviceAddress = scratch + offset;
+        ranges[iterator] = &builds[iterator].Range;
+        offset += AlignUp( builds[iterator].Sizes.buildScratchSize, impl->scratchAlignment );
+    }
+
+    if ( FAILED( status = BeginCommands( impl ) ) ) return status;
+
+    vkCmdResetQueryPool( impl->commands, queries, 0, count );
+    impl->cmdBuild( impl->commands, count, &infos[first], &ranges[first] );
+    Barrier( impl->commands );
+
+    for ( iterator = first; iterator < end; iterator++ )
+        impl->cmdWriteProperties( impl->commands, 1, &builds[iterator].Built.Handle, VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+                                  queries, iterator - first );
+
+    if ( FAILED( status = ExecuteCommands( impl ) ) ) return status;
+
+    result = vkGetQueryPoolResults( impl->handle, queries, 0, count, count * sizeof(AccelerationBuild), &builds[first].CompactedSize,
+                                    sizeof(AccelerationBuild), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Reading the compacted acceleration structure sizes failed with %d\n", result );
+        return T_ERROR;
+    }
+
+    for ( iterator = first; iterator < end; iterator++ )
+        if ( FAILED( status = CreateStructure( impl, AlignUp( builds[iterator].CompactedSize, ACCELERATION_STRUCTURE_ALIGNMENT ), &out[iterator] ) ) )
+            return status;
+
+    if ( FAILED( status = BeginCommands( impl ) ) ) return status;
+
+    for ( iterator = first; iterator < end; iterator++ )
+    {
+        VkCopyAccelerationStructureInfoKHR copyInfo = { VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR };
+
+        copyInfo.src = builds[iterator].Built.Handle;
+        copyInfo.dst = out[iterator].Handle;
+        copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+        impl->cmdCopy( impl->commands, &copyInfo );
+    }
+
+    if ( FAILED( status = ExecuteCommands( impl ) ) ) return status;
+
+    for ( iterator = first; iterator < end; iterator++ )
+    {
+        impl->statistics.BuiltBytes += builds[iterator].Built.Size;
+        impl->statistics.CompactedBytes += out[iterator].Size;
+        DestroyStructure( impl, &builds[iterator].Built );
+    }
+
+    impl->statistics.Batches++;
+
+    return T_SUCCESS;
+}
+
+static void
+DestroyAccelerationStructure(
+    IN struct vulkan_acceleration_structure_object *impl
+) {
+    DestroyStructures( impl );
+
+    if ( impl->fence ) vkDestroyFence( impl->handle, impl->fence, &VulkanAllocationCallbacks );
+    if ( impl->pool ) vkDestroyCommandPool( impl->handle, impl->pool, &VulkanAllocationCallbacks );
+
+    if ( impl->queue ) impl->queue->lpVtbl->Release( impl->queue );
+    impl->allocator->lpVtbl->Release( impl->allocator );
+    impl->device->lpVtbl->Release( impl->device );
+
+    pthread_mutex_destroy( &impl->lock );
+    SlabFree( &vulkan_acceleration_structure_object_cache, impl );
+}
+
+static TR_STATUS vulkan_acceleration_structure_object_QueryInterface( VulkanAccelerationStructureObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_acceleration_structure_object_interfaces, impl_from_VulkanAccelerationStructureObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_acceleration_structure_object_AddRef( VulkanAccelerationStructureObject *iface )
+{
+    struct vulkan_acceleration_structure_object *impl = impl_from_VulkanAccelerationStructureObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_acceleration_structure_object_Release( VulkanAccelerationStructureObject *iface )
+{
+    struct vulkan_acceleration_structure_object *impl = impl_from_VulkanAccelerationStructureObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) ) DestroyAccelerationStructure( impl );
+    return removed;
+}
+
+static TR_STATUS vulkan_acceleration_structure_object_Build( VulkanAccelerationStructureObject *iface, const VulkanAccelerationStructureGeometry *geometries, TRUInt count )
+{
+    struct vulkan_acceleration_structure_object *impl = impl_from_VulkanAccelerationStructureObject( iface );
+    const TRULong start = ZoneTimestamp();
+    AccelerationBuild *builds = nullptr;
+    VkAccelerationStructureBuildGeometryInfoKHR *infos = nullptr;
+    const VkAccelerationStructureBuildRangeInfoKHR **ranges = nullptr;
+    VulkanAccelerationStructure *structures = nullptr;
+    VkQueryPoolCreateInfo queryInfo = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    VkQueryPool queries = VK_NULL_HANDLE;
+    VkBuffer scratch = VK_NULL_HANDLE;
+    VulkanAllocation scratchMemory = {};
+    VkDeviceSize scratchSize = 0, batchScratch;
+    VkDeviceAddress scratchAddress;
+    TR_STATUS status = T_OUTOFMEMORY;
+    TRUInt iterator, end, batchSize = 0;
+
+    TR_ZONE( "VulkanAccelerationStructure::Build" );
+
+    TRACE( "iface %p, geometries %p, count %u\n", iface, geometries, count );
+
+    if ( !geometries && count ) throw_NullPtrException();
+
+    for ( iterator = 0; iterator < count; iterator++ )
+        if ( !geometries[iterator].Vertices || !geometries[iterator].VertexCount || !geometries[iterator].TriangleCount ||
+             geometries[iterator].TriangleCount > impl->maxPrimitives )
+            return T_INVALIDARG;
+
+    pthread_mutex_lock( &impl->lock );
+
+    DestroyStructures( impl );
+    impl->statistics = (VulkanAccelerationStructureStatistics){};
+
+    if ( !count )
+    {
+        status = T_SUCCESS;
+        goto done;
+    }
+
+    if (!(builds = TRCalloc( count, sizeof(AccelerationBuild), MEMORY_TAG_VULKAN ))) goto done;
+    if (!(infos = TRCalloc( count, sizeof(VkAccelerationStructureBuildGeometryInfoKHR), MEMORY_TAG_VULKAN ))) goto done;
+    if (!(ranges = TRCalloc( count, sizeof(*ranges), MEMORY_TAG_VULKAN ))) goto done;
+    if (!(structures = TRCalloc( count, sizeof(VulkanAccelerationStructure), MEMORY_TAG_VULKAN ))) goto done;
+
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        const VulkanAccelerationStructureGeometry *geometry = &geometries[iterator];
+        AccelerationBuild *build = &builds[iterator];
+        VkAccelerationStructureGeometryTrianglesDataKHR *triangles = &build->Geometry.geometry.triangles;
+
+        build->Geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+        build->Geometry.geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR;
+        build->Geometry.flags = geometry->Opaque ? VK_GEOMETRY_OPAQUE_BIT_KHR : 0;
+        triangles->sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
+        triangles->vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
+        triangles->vertexData.deviceAddress = geometry->Vertices;
+        triangles->vertexStride = geometry->VertexStride;
+        triangles->maxVertex = geometry->VertexCount - 1;
+        triangles->indexType = geometry->Indices ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_NONE_KHR;
+        triangles->indexData.deviceAddress = geometry->Indices;
+
+        build->Range.primitiveCount = geometry->TriangleCount;
+        build->Sizes.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+
+        // Compaction needs the flag at build time, fast traces pay for the slower build.
+        infos[iterator].sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+        infos[iterator].type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+        infos[iterator].flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
+        infos[iterator].mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+        infos[iterator].geometryCount = 1;
+        infos[iterator].pGeometries = &build->Geometry;
+
+        impl->getBuildSizes( impl->handle, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &infos[iterator], &build->Range.primitiveCount, &build->Sizes );
+    }
+
+    // One scratch buffer and query pool, sized for the largest batch, serve every batch.
+    for ( iterator = 0; iterator < count; iterator = end )
+    {
+        end = NextBatch( builds, iterator, count, impl->scratchAlignment, &batchScratch );
+        if ( batchScratch > scratchSize ) scratchSize = batchScratch;
+        if ( end - iterator > batchSize ) batchSize = end - iterator;
+    }
+
+    // Buffers are not necessarily aligned as strictly as scratch memory has to be.
+    if ( FAILED( status = CreateBuffer( impl, scratchSize + impl->scratchAlignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, &scratch, &scratchMemory ) ) )
+        goto done;
+    scratchAddress = AlignUp( BufferAddress( impl, scratch ), impl->scratchAlignment );
+
+    queryInfo.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+    queryInfo.queryCount = batchSize;
+    if ( vkCreateQueryPool( impl->handle, &queryInfo, &VulkanAllocationCallbacks, &queries ) != VK_SUCCESS )
+    {
+        queries = VK_NULL_HANDLE;
+        status = T_OUTOFMEMORY;
+        goto done;
+    }
+
+    for ( iterator = 0; iterator < count; iterator = end )
+    {
+        end = NextBatch( builds, iterator, count, impl->scratchAlignment, &batchScratch );
+        if ( FAILED( status = BuildBatch( impl, builds, iterator, end, scratchAddress, queries, infos, ranges, structures ) ) )
+            goto done;
+    }
+
+    impl->structures = structures;
+    impl->count = count;
+    impl->statistics.Structures = count;
+    impl->statistics.ScratchBytes = scratchSize + impl->scratchAlignment;
+    impl->statistics.BuildNanoseconds = ZoneTimestamp() - start;
+    structures = nullptr;
+
+    INFO( "Vulkan: built %u acceleration structures in %u batches, %llu KiB compacted to %llu KiB in %.2f ms\n",
+          count, impl->statistics.Batches, (unsigned long long)(impl->statistics.BuiltBytes / 1024),
+          (unsigned long long)(impl->statistics.CompactedBytes / 1024), (double)impl->statistics.BuildNanoseconds / 1e6 );
+
+done:
+    if ( FAILED( status ) )
+        ERROR( "Failed to build %u acceleration structures, status was %d\n", count, status );
+
+    if ( builds )
+        for ( iterator = 0; iterator < count; iterator++ )
+            DestroyStructure( impl, &builds[iterator].Built );
+
+    if ( structures )
+    {
+        impl->statistics = (VulkanAccelerationStructureStatistics){};
+        for ( iterator = 0; iterator < count; iterator++ )
+            DestroyStructure( impl, &structures[iterator] );
+    }
+
+    if ( queries ) vkDestroyQueryPool( impl->handle, queries, &VulkanAllocationCallbacks );
+    DestroyBuffer( impl, &scratch, &scratchMemory );
+
+    TRFree( structures );
+    TRFree( ranges );
+    TRFree( infos );
+    TRFree( builds );
+
+    pthread_mutex_unlock( &impl->lock );
+
+    return status;
+}
+
+static TR_STATUS vulkan_acceleration_structure_object_get_Count( VulkanAccelerationStructureObject *iface, TRUInt *out )
+{
+    struct vulkan_acceleration_structure_object *impl = impl_from_VulkanAccelerationStructureObject( iface );
+
+    TRACE( "iface %p, out %p\n", iface, out );
+
+    if ( !out ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->lock );
+    *out = impl->count;
+    pthread_mutex_unlock( &impl->lock );
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_acceleration_structure_object_GetStructure( VulkanAccelerationStructureObject *iface, TRUInt index, VulkanAccelerationStructure *out )
+{
+    struct vulkan_acceleration_structure_object *impl = impl_from_VulkanAccelerationStructureObject( iface );
+    TR_STATUS status = T_INVALIDARG;
+
+    TRACE( "iface %p, index %u, out %p\n", iface, index, out );
+
+    if ( !out ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->lock );
+    if ( index < impl->count )
+    {
+        *out = impl->structures[index];
+        status = T_SUCCESS;
+    }
+    pthread_mutex_unlock( &impl->lock );
+
+    return status;
+}
+
+static TR_STATUS vulkan_acceleration_structure_object_get_Statistics( VulkanAccelerationStructureObject *iface, VulkanAccelerationStructureStatistics *out )
+{
+    struct vulkan_acceleration_structure_object *impl = impl_from_VulkanAccelerationStructureObject( iface );
+
+    TRACE( "iface %p, out %p\n", iface, out );
+
+    if ( !out ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->lock );
+    *out = impl->statistics;
+    pthread_mutex_unlock( &impl->lock );
+
+    return T_SUCCESS;
+}
+
+static VulkanAccelerationStructureInterface vulkan_acceleration_structure_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_acceleration_structure_object_QueryInterface,
+    vulkan_acceleration_structure_object_AddRef,
+    vulkan_acceleration_structure_object_Release,
+    /* VulkanAccelerationStructureObject Methods */
+    vulkan_acceleration_structure_object_Build,
+    vulkan_acceleration_structure_object_get_Count,
+    vulkan_acceleration_structure_object_GetStructure,
+    vulkan_acceleration_structure_object_get_Statistics
+};
+
+static TR_STATUS
+LoadFunctions(
+    IN struct vulkan_acceleration_structure_object *impl
+) {
+    impl->createAccelerationStructure = (PFN_vkCreateAccelerationStructureKHR)vkGetDeviceProcAddr( impl->handle, "vkCreateAccelerationStructureKHR" );
+    impl->destroyAccelerationStructure = (PFN_vkDestroyAccelerationStructureKHR)vkGetDeviceProcAddr( impl->handle, "vkDestroyAccelerationStructureKHR" );
+    impl->getBuildSizes = (PFN_vkGetAccelerationStructureBuildSizesKHR)vkGetDeviceProcAddr( impl->handle, "vkGetAccelerationStructureBuildSizesKHR" );
+    impl->getDeviceAddress = (PFN_vkGetAccelerationStructureDeviceAddressKHR)vkGetDeviceProcAddr( impl->handle, "vkGetAccelerationStructureDeviceAddressKHR" );
+    impl->cmdBuild = (PFN_vkCmdBuildAccelerationStructuresKHR)vkGetDeviceProcAddr( impl->handle, "vkCmdBuildAccelerationStructuresKHR" );
+    impl->cmdWriteProperties = (PFN_vkCmdWriteAccelerationStructuresPropertiesKHR)vkGetDeviceProcAddr( impl->handle, "vkCmdWriteAccelerationStructuresPropertiesKHR" );
+    impl->cmdCopy = (PFN_vkCmdCopyAccelerationStructureKHR)vkGetDeviceProcAddr( impl->handle, "vkCmdCopyAccelerationStructureKHR" );
+
+    if ( !impl->createAccelerationStructure || !impl->destroyAccelerationStructure || !impl->getBuildSizes ||
+         !impl->getDeviceAddress || !impl->cmdBuild || !impl->cmdWriteProperties || !impl->cmdCopy )
+    {
+        ERROR( "The driver does not export the acceleration structure functions\n" );
+        return T_NOTIMPL;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+CreateCommands(
+    IN struct vulkan_acceleration_structure_object *impl
+) {
+    VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    VkCommandBufferAllocateInfo commandsInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    impl->queue->lpVtbl->get_FamilyIndex( impl->queue, &poolInfo.queueFamilyIndex );
+    if ( vkCreateCommandPool( impl->handle, &poolInfo, &VulkanAllocationCallbacks, &impl->pool ) != VK_SUCCESS ) return T_ERROR;
+
+    commandsInfo.commandPool = impl->pool;
+    commandsInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandsInfo.commandBufferCount = 1;
+    if ( vkAllocateCommandBuffers( impl->handle, &commandsInfo, &impl->commands ) != VK_SUCCESS ) return T_ERROR;
+
+    if ( vkCreateFence( impl->handle, &fenceInfo, &VulkanAllocationCallbacks, &impl->fence ) != VK_SUCCESS ) return T_ERROR;
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API new_vulkan_acceleration_structure_object_override_device_and_allocator( IN VulkanDeviceObject *device, IN VulkanAllocatorObject *allocator, OUT VulkanAccelerationStructureObject **out )
+{
+    struct vulkan_acceleration_structure_object *impl;
+    const VulkanPhysicalDeviceInfo *info;
+    TR_STATUS status;
+
+    TRACE( "device %p, allocator %p, out %p\n", device, allocator, out );
+
+    if ( !device || !allocator || !out ) throw_NullPtrException();
+
+    device->lpVtbl->get_Info( device, &info );
+    if ( !info->AccelerationStructures )
+    {
+        WARN( "%s has no acceleration structures\n", info->Properties.deviceName );
+        return T_NOTIMPL;
+    }
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_acceleration_structure_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanAccelerationStructureObject_iface.lpVtbl = &vulkan_acceleration_structure_interface;
+    impl->device = device;
+    impl->allocator = allocator;
+    impl->scratchAlignment = info->AccelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment;
+    impl->maxPrimitives = info->AccelerationStructureProperties.maxPrimitiveCount;
+    impl->ref = 1;
+
+    if ( !impl->scratchAlignment ) impl->scratchAlignment = 1;
+
+    device->lpVtbl->AddRef( device );
+    allocator->lpVtbl->AddRef( allocator );
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    if ( FAILED( status = LoadFunctions( impl ) ) ||
+         FAILED( status = device->lpVtbl->GetQueue( device, VulkanQueueRole_Graphics, &impl->queue ) ) ||
+         FAILED( status = CreateCommands( impl ) ) )
+    {
+        ERROR( "Failed to create the acceleration structure builder on %s\n", info->Properties.deviceName );
+        DestroyAccelerationStructure( impl );
+        return status;
+    }
+
+    *out = &impl->VulkanAccelerationStructureObject_iface;
+
+    TRACE( "created VulkanAccelerationStructureObject %p\n", *out );
+
+    return T_SUCCESS;
+}
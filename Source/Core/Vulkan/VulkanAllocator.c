@@ -0,0 +1,894 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanAllocator.c
+ *  Description: Device memory sub-allocation with a TLSF free list per block.
+ */
+
+#include <string.h>
+
+#include <Core/Vulkan/VulkanAllocator.h>
+#include <Core/Instrumentation/Zones.h>
+
+// 32 second level lists per power of two, worst case waste below 1/32 of a request.
+#define TLSF_SL_LOG2 5
+#define TLSF_SL_COUNT (1u << TLSF_SL_LOG2)
+#define TLSF_FL_COUNT 64
+#define TLSF_MIN_ALIGNMENT 16
+
+#define ALLOCATOR_LARGE_HEAP (1024ull * 1024ull * 1024ull)
+#define ALLOCATOR_BLOCK_SIZE (256ull * 1024ull * 1024ull)
+
+struct _TR_VulkanMemoryNode
+{
+    VkDeviceSize Offset;
+    VkDeviceSize Size;
+    VulkanMemoryNode *PrevPhysical;
+    VulkanMemoryNode *NextPhysical;
+    VulkanMemoryNode *PrevFree;
+    VulkanMemoryNode *NextFree;                     // Also links the allocator's spare nodes
+    TRBool Free;
+};
+
+struct _TR_VulkanMemoryBlock
+{
+    VkDeviceMemory Memory;
+    VkDeviceSize Size;
+    VkDeviceSize Used;
+    TRUInt MemoryType;
+    TRUInt Allocations;
+    TRChar *Mapped;
+    VulkanMemoryBlock **Pool;
+    VulkanMemoryBlock *Prev;
+    VulkanMemoryBlock *Next;
+
+    TRULong FirstLevel;                             // Bit per first level with any free node
+    TRUInt SecondLevel[TLSF_FL_COUNT];
+    VulkanMemoryNode *FreeLists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+};
+
+static inline VkDeviceSize
+AlignUp(
+    IN VkDeviceSize value,
+    IN VkDeviceSize alignment
+) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline void
+MappingInsert(
+    IN VkDeviceSize size,
+    OUT TRUInt *fl,
+    OUT TRUInt *sl
+) {
+    TRUInt bit;
+
+    if ( size < TLSF_SL_COUNT )
+    {
+        *fl = 0;
+        *sl = (TRUInt)size;
+        return;
+    }
+
+    bit = 63 - __builtin_clzll( size );
+    *sl = (TRUInt)(size >> (bit - TLSF_SL_LOG2)) & (TLSF_SL_COUNT - 1);
+    *fl = bit - TLSF_SL_LOG2 + 1;
+}
+
+// Rounds up to the next list, so every node found there is large enough.
+static inline void
+MappingSearch(
+    IN VkDeviceSize size,
+    OUT TRUInt *fl,
+    OUT TRUInt *sl
+) {
+    if ( size >= TLSF_SL_COUNT )
+        size += (1ull << ((63 - __builtin_clzll( size )) - TLSF_SL_LOG2)) - 1;
+
+    MappingInsert( size, fl, sl );
+}
+
+static void
+InsertFree(
+    IN VulkanMemoryBlock *block,
+    IN VulkanMemoryNode *node
+) {
+    TRUInt fl, sl;
+
+    MappingInsert( node->Size, &fl, &sl );
+
+    node->Free = true;
+    node->PrevFree = nullptr;
+    node->NextFree = block->FreeLists[fl][sl];
+    if ( node->NextFree )
+        node->NextFree->PrevFree = node;
+
+    block->FreeLists[fl][sl] = node;
+    block->FirstLevel |= 1ull << fl;
+    block->SecondLevel[fl] |= 1u << sl;
+}
+
+static void
+RemoveFree(
+    IN VulkanMemoryBlock *block,
+    IN VulkanMemoryNode *node
+) {
+    TRUInt fl, sl;
+
+    MappingInsert( node->Size, &fl, &sl );
+
+    if ( node->PrevFree )
+        node->PrevFree->NextFree = node->NextFree;
+    else
+        block->FreeLists[fl][sl] = node->NextFree;
+
+    if ( node->NextFree )
+        node->NextFree->PrevFree = node->PrevFree;
+
+    if ( !block->FreeLists[fl][sl] )
+    {
+        block->SecondLevel[fl] &= ~(1u << sl);
+        if ( !block->SecondLevel[fl] )
+            block->FirstLevel &= ~(1ull << fl);
+    }
+
+    node->Free = false;
+}
+
+static VulkanMemoryNode *
+FindFree(
+    IN const VulkanMemoryBlock *block,
+    IN VkDeviceSize size
+) {
+    TRUInt fl, sl, slMap;
+    TRULong flMap;
+
+    MappingSearch( size, &fl, &sl );
+    if ( fl >= TLSF_FL_COUNT )
+        return nullptr;
+
+    if (!(slMap = block->SecondLevel[fl] & (~0u << sl)))
+    {
+        flMap = fl + 1 < TLSF_FL_COUNT ? block->FirstLevel & (~0ull << (fl + 1)) : 0;
+        if ( !flMap )
+            return nullptr;
+
+        fl = __builtin_ctzll( flMap );
+        slMap = block->SecondLevel[fl];
+    }
+
+    return block->FreeLists[fl][__builtin_ctz( slMap )];
+}
+
+static VkDeviceSize
+LargestFree(
+    IN const VulkanMemoryBlock *block
+) {
+    const VulkanMemoryNode *node;
+    VkDeviceSize largest = 0;
+    TRUInt fl, sl;
+
+    if ( !block->FirstLevel )
+        return 0;
+
+    fl = 63 - __builtin_clzll( block->FirstLevel );
+    sl = 31 - __builtin_clz( block->SecondLevel[fl] );
+
+    // Sizes within the top list differ by less than its granularity.
+    for ( node = block->FreeLists[fl][sl]; node; node = node->NextFree )
+        if ( node->Size > largest )
+            largest = node->Size;
+
+    return largest;
+}
+
+static TRBool
+ReserveNodes(
+    IN struct vulkan_allocator_object *impl,
+    IN TRUInt count
+) {
+    VulkanMemoryNode *node = impl->spareNodes;
+    TRUInt available = 0;
+
+    while ( node && available < count )
+    {
+        node = node->NextFree;
+        available++;
+    }
+
+    for ( ; available < count; available++ )
+    {
+        if (!(node = TRAlloc( sizeof(VulkanMemoryNode), MEMORY_TAG_VULKAN ))) return false;
+        node->NextFree = impl->spareNodes;
+        impl->spareNodes = node;
+    }
+
+    return true;
+}
+
+static VulkanMemoryNode *
+TakeNode(
+    IN struct vulkan_allocator_object *impl
+) {
+    VulkanMemoryNode *node = impl->spareNodes;
+
+    impl->spareNodes = node->NextFree;
+    memset( node, 0, sizeof(VulkanMemoryNode) );
+    return node;
+}
+
+static void
+RecycleNode(
+    IN struct vulkan_allocator_object *impl,
+    IN VulkanMemoryNode *node
+) {
+    node->NextFree = impl->spareNodes;
+    impl->spareNodes = node;
+}
+
+static TR_STATUS
+AllocateMemory(
+    IN struct vulkan_allocator_object *impl,
+    IN TRUInt memoryType,
+    IN VkDeviceSize size,
+    IN const void *next,
+    OUT VkDeviceMemory *memory,
+    OUT TRChar **mapped
+) {
+    VkMemoryAllocateInfo allocateInfo = {0};
+    VkMemoryAllocateFlagsInfo flagsInfo = {0};
+    VkResult result;
+
+    if ( impl->memoryCount >= impl->info->Properties.limits.maxMemoryAllocationCount )
+    {
+        ERROR( "Reached the driver's limit of %u device memory allocations\n", impl->info->Properties.limits.maxMemoryAllocationCount );
+        return T_OUTOFMEMORY;
+    }
+
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.pNext = next;
+
+    // Any buffer may ask for its device address, acceleration structure builds read everything through them.
+    if ( impl->info->Features12.bufferDeviceAddress )
+    {
+        flagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+        flagsInfo.pNext = next;
+        flagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+        allocateInfo.pNext = &flagsInfo;
+    }
+    allocateInfo.allocationSize = size;
+    allocateInfo.memoryTypeIndex = memoryType;
+
+    result = vkAllocateMemory( impl->handle, &allocateInfo, &VulkanAllocationCallbacks, memory );
+    if ( result == VK_ERROR_OUT_OF_DEVICE_MEMORY || result == VK_ERROR_OUT_OF_HOST_MEMORY )
+        return T_OUTOFMEMORY;
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Allocating %llu bytes of memory type %u failed with %d\n", (unsigned long long)size, memoryType, result );
+        return T_ERROR;
+    }
+
+    *mapped = nullptr;
+
+    // Persistently mapped, mapping on every access costs a syscall on most drivers.
+    if ( impl->info->Memory.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT )
+    {
+        result = vkMapMemory( impl->handle, *memory, 0, VK_WHOLE_SIZE, 0, (void **)mapped );
+        if ( result != VK_SUCCESS )
+        {
+            ERROR( "Mapping memory type %u failed with %d\n", memoryType, result );
+            vkFreeMemory( impl->handle, *memory, &VulkanAllocationCallbacks );
+            return T_ERROR;
+        }
+    }
+
+    impl->memoryCount++;
+    return T_SUCCESS;
+}
+
+static void
+DestroyBlock(
+    IN struct vulkan_allocator_object *impl,
+    IN VulkanMemoryBlock *block
+) {
+    TRUInt fl, sl;
+
+    if ( block->Prev )
+        block->Prev->Next = block->Next;
+    else
+        *block->Pool = block->Next;
+    if ( block->Next )
+        block->Next->Prev = block->Prev;
+
+    for ( fl = 0; fl < TLSF_FL_COUNT; fl++ )
+        for ( sl = 0; sl < TLSF_SL_COUNT; sl++ )
+            while ( block->FreeLists[fl][sl] )
+            {
+                VulkanMemoryNode *node = block->FreeLists[fl][sl];
+
+                block->FreeLists[fl][sl] = node->NextFree;
+                RecycleNode( impl, node );
+            }
+
+    vkFreeMemory( impl->handle, block->Memory, &VulkanAllocationCallbacks );
+    impl->memoryCount--;
+    TRFree( block );
+}
+
+static TR_STATUS
+CreateBlock(
+    IN struct vulkan_allocator_object *impl,
+    IN VulkanMemoryBlock **pool,
+    IN TRUInt memoryType,
+    IN VkDeviceSize minimum,
+    OUT VulkanMemoryBlock **out
+) {
+    const TRUInt heap = impl->info->Memory.memoryTypes[memoryType].heapIndex;
+    VulkanMemoryBlock *block;
+    VulkanMemoryNode *node;
+    TR_STATUS status = T_OUTOFMEMORY;
+    TRUInt shift;
+
+    if ( !ReserveNodes( impl, 1 ) ) return T_OUTOFMEMORY;
+    if (!(block = TRCalloc( 1, sizeof(VulkanMemoryBlock), MEMORY_TAG_VULKAN ))) return T_OUTOFMEMORY;
+
+    // Smaller blocks when the device is nearly full, as long as the request still fits.
+    for ( shift = 0; shift < 4 && (impl->blockSizes[heap] >> shift) >= minimum; shift++ )
+    {
+        block->Size = impl->blockSizes[heap] >> shift;
+
+        status = AllocateMemory( impl, memoryType, block->Size, nullptr, &block->Memory, &block->Mapped );
+        if ( status != T_OUTOFMEMORY )
+            break;
+    }
+
+    if ( FAILED( status ) )
+    {
+        TRFree( block );
+        return status;
+    }
+
+    block->MemoryType = memoryType;
+    block->Pool = pool;
+
+    node = TakeNode( impl );
+    node->Offset = 0;
+    node->Size = block->Size;
+    InsertFree( block, node );
+
+    block->Next = *pool;
+    if ( block->Next )
+        block->Next->Prev = block;
+    *pool = block;
+
+    TRACE( "created a %llu byte block of memory type %u\n", (unsigned long long)block->Size, memoryType );
+
+    *out = block;
+    return T_SUCCESS;
+}
+
+static TRBool
+BlockAllocate(
+    IN struct vulkan_allocator_object *impl,
+    IN VulkanMemoryBlock *block,
+    IN VkDeviceSize size,
+    IN VkDeviceSize alignment,
+    OUT VulkanAllocation *out
+) {
+    VulkanMemoryNode *node, *split;
+    VkDeviceSize padding;
+
+    // Worst case padding is counted in the search, so the first fit always fits.
+    if (!(node = FindFree( block, size + alignment - TLSF_MIN_ALIGNMENT ))) return false;
+    if ( !ReserveNodes( impl, 2 ) ) return false;
+
+    RemoveFree( block, node );
+
+    if ( (padding = AlignUp( node->Offset, alignment ) - node->Offset) )
+    {
+        split = TakeNode( impl );
+        split->Offset = node->Offset;
+        split->Size = padding;
+        split->PrevPhysical = node->PrevPhysical;
+        split->NextPhysical = node;
+        if ( split->PrevPhysical )
+            split->PrevPhysical->NextPhysical = split;
+
+        node->PrevPhysical = split;
+        node->Offset += padding;
+        node->Size -= padding;
+        InsertFree( block, split );
+    }
+
+    if ( node->Size - size >= TLSF_MIN_ALIGNMENT )
+    {
+        split = TakeNode( impl );
+        split->Offset = node->Offset + size;
+        split->Size = node->Size - size;
+        split->PrevPhysical = node;
+        split->NextPhysical = node->NextPhysical;
+        if ( split->NextPhysical )
+            split->NextPhysical->PrevPhysical = split;
+
+        node->NextPhysical = split;
+        node->Size = size;
+        InsertFree( block, split );
+    }
+
+    block->Used += node->Size;
+    block->Allocations++;
+
+    out->Memory = block->Memory;
+    out->Offset = node->Offset;
+    out->Size = node->Size;
+    out->Mapped = block->Mapped ? block->Mapped + node->Offset : nullptr;
+    out->MemoryType = block->MemoryType;
+    out->Block = block;
+    out->Node = node;
+
+    return true;
+}
+
+static void
+BlockFree(
+    IN struct vulkan_allocator_object *impl,
+    IN VulkanMemoryBlock *block,
+    IN VulkanMemoryNode *node
+) {
+    VulkanMemoryNode *neighbour;
+
+    block->Used -= node->Size;
+    block->Allocations--;
+
+    if ( (neighbour = node->PrevPhysical) && neighbour->Free )
+    {
+        RemoveFree( block, neighbour );
+        neighbour->Size += node->Size;
+        neighbour->NextPhysical = node->NextPhysical;
+        if ( neighbour->NextPhysical )
+            neighbour->NextPhysical->PrevPhysical = neighbour;
+
+        RecycleNode( impl, node );
+        node = neighbour;
+    }
+
+    if ( (neighbour = node->NextPhysical) && neighbour->Free )
+    {
+        RemoveFree( block, neighbour );
+        node->Size += neighbour->Size;
+        node->NextPhysical = neighbour->NextPhysical;
+        if ( node->NextPhysical )
+            node->NextPhysical->PrevPhysical = node;
+
+        RecycleNode( impl, neighbour );
+    }
+
+    InsertFree( block, node );
+}
+
+static TR_STATUS
+AllocateFromPool(
+    IN struct vulkan_allocator_object *impl,
+    IN TRUInt memoryType,
+    IN const VkMemoryRequirements *requirements,
+    IN VulkanAllocationFlags flags,
+    OUT VulkanAllocation *out
+) {
+    const VkMemoryPropertyFlags properties = impl->info->Memory.memoryTypes[memoryType].propertyFlags;
+    VulkanMemoryBlock **pool = &impl->pools[memoryType][(flags & VulkanAllocationFlags_Optimal) && impl->separateOptimal];
+    VulkanMemoryBlock *block;
+    VkDeviceSize alignment = requirements->alignment > TLSF_MIN_ALIGNMENT ? requirements->alignment : TLSF_MIN_ALIGNMENT;
+    VkDeviceSize size;
+    TR_STATUS status;
+
+    // Flushes and invalidations of non coherent memory work in whole atoms.
+    if ( (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) &&
+         impl->info->Properties.limits.nonCoherentAtomSize > alignment )
+        alignment = impl->info->Properties.limits.nonCoherentAtomSize;
+
+    size = AlignUp( requirements->size, alignment );
+
+    for ( block = *pool; block; block = block->Next )
+        if ( block->Size - block->Used >= size && BlockAllocate( impl, block, size, alignment, out ) )
+            return T_SUCCESS;
+
+    if ( FAILED( status = CreateBlock( impl, pool, memoryType, size + alignment, &block ) ) )
+        return status;
+
+    return BlockAllocate( impl, block, size, alignment, out ) ? T_SUCCESS : T_OUTOFMEMORY;
+}
+
+static TR_STATUS
+AllocateDedicated(
+    IN struct vulkan_allocator_object *impl,
+    IN TRUInt memoryType,
+    IN const VkMemoryRequirements *requirements,
+    IN const void *next,
+    OUT VulkanAllocation *out
+) {
+    TR_STATUS status;
+    TRChar *mapped;
+
+    if ( FAILED( status = AllocateMemory( impl, memoryType, requirements->size, next, &out->Memory, &mapped ) ) )
+        return status;
+
+    out->Offset = 0;
+    out->Size = requirements->size;
+    out->Mapped = mapped;
+    out->MemoryType = memoryType;
+    out->Block = nullptr;
+    out->Node = nullptr;
+
+    impl->dedicatedCount++;
+    impl->dedicatedBytes += requirements->size;
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+AllocateInternal(
+    IN struct vulkan_allocator_object *impl,
+    IN const VkMemoryRequirements *requirements,
+    IN VkMemoryPropertyFlags required,
+    IN VkMemoryPropertyFlags preferred,
+    IN VulkanAllocationFlags flags,
+    IN const void *dedicatedInfo,
+    OUT VulkanAllocation *out
+) {
+    const VkPhysicalDeviceMemoryProperties *memory = &impl->info->Memory;
+    TR_STATUS status = T_INVALIDARG;
+    TRUInt pass, type;
+
+    TR_ZONE( "VulkanAllocator::Allocate" );
+
+    if ( !requirements || !out ) throw_NullPtrException();
+
+    memset( out, 0, sizeof(VulkanAllocation) );
+
+    if ( flags & VulkanAllocationFlags_Mapped )
+        required |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    pthread_mutex_lock( &impl->lock );
+
+    // Types with every preferred flag first, then any type with the required ones.
+    for ( pass = 0; pass < 2; pass++ )
+    {
+        const VkMemoryPropertyFlags wanted = pass ? required : required | preferred;
+
+        if ( pass && !preferred )
+            break;
+
+        for ( type = 0; type < memory->memoryTypeCount; type++ )
+        {
+            const TRUInt heap = memory->memoryTypes[type].heapIndex;
+
+            if ( !(requirements->memoryTypeBits & (1u << type)) || (memory->memoryTypes[type].propertyFlags & wanted) != wanted )
+                continue;
+
+            if ( (flags & VulkanAllocationFlags_Dedicated) || requirements->size > impl->blockSizes[heap] / 2 )
+                status = AllocateDedicated( impl, type, requirements, dedicatedInfo, out );
+            else
+                status = AllocateFromPool( impl, type, requirements, flags, out );
+
+            // Out of memory in one heap can still leave room in another.
+            if ( status != T_OUTOFMEMORY )
+                goto done;
+        }
+    }
+
+done:
+    pthread_mutex_unlock( &impl->lock );
+
+    if ( status == T_INVALIDARG )
+        ERROR( "No memory type matches the bits %#x with the flags %#x\n", requirements->memoryTypeBits, required );
+    else if ( status == T_OUTOFMEMORY )
+        ERROR( "Out of device memory allocating %llu bytes\n", (unsigned long long)requirements->size );
+
+    return status;
+}
+
+static struct vulkan_allocator_object *impl_from_VulkanAllocatorObject( VulkanAllocatorObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_allocator_object, VulkanAllocatorObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_allocator_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_allocator_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_allocator_object, VulkanAllocatorObject_iface ),
+    INTERFACE_ENTRY( VulkanAllocatorObject, vulkan_allocator_object, VulkanAllocatorObject_iface ) );
+
+static TR_STATUS vulkan_allocator_object_QueryInterface( VulkanAllocatorObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_allocator_object_interfaces, impl_from_VulkanAllocatorObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_allocator_object_AddRef( VulkanAllocatorObject *iface )
+{
+    struct vulkan_allocator_object *impl = impl_from_VulkanAllocatorObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_allocator_object_Release( VulkanAllocatorObject *iface )
+{
+    struct vulkan_allocator_object *impl = impl_from_VulkanAllocatorObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) )
+    {
+        TRUInt type, kind;
+
+        if ( impl->dedicatedCount )
+            WARN( "%u dedicated allocations were never freed\n", impl->dedicatedCount );
+
+        for ( type = 0; type < VK_MAX_MEMORY_TYPES; type++ )
+            for ( kind = 0; kind < 2; kind++ )
+                while ( impl->pools[type][kind] )
+                {
+                    if ( impl->pools[type][kind]->Allocations )
+                        WARN( "%u allocations of memory type %u were never freed\n", impl->pools[type][kind]->Allocations, type );
+
+                    DestroyBlock( impl, impl->pools[type][kind] );
+                }
+
+        while ( impl->spareNodes )
+        {
+            VulkanMemoryNode *node = impl->spareNodes;
+
+            impl->spareNodes = node->NextFree;
+            TRFree( node );
+        }
+
+        pthread_mutex_destroy( &impl->lock );
+        impl->device->lpVtbl->Release( impl->device );
+        SlabFree( &vulkan_allocator_object_cache, impl );
+    }
+    return removed;
+}
+
+static TR_STATUS vulkan_allocator_object_Allocate( VulkanAllocatorObject *iface, const VkMemoryRequirements *requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, VulkanAllocationFlags flags, VulkanAllocation *out )
+{
+    struct vulkan_allocator_object *impl = impl_from_VulkanAllocatorObject( iface );
+
+    TRACE( "iface %p, requirements %p, required %#x, preferred %#x, flags %#x, out %p\n", iface, requirements, required, preferred, flags, out );
+
+    return AllocateInternal( impl, requirements, required, preferred, flags, nullptr, out );
+}
+
+static TR_STATUS vulkan_allocator_object_AllocateForBuffer( VulkanAllocatorObject *iface, VkBuffer buffer, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, VulkanAllocationFlags flags, VulkanAllocation *out )
+{
+    VkBufferMemoryRequirementsInfo2 requirementsInfo = {0};
+    VkMemoryDedicatedRequirements dedicatedRequirements = {0};
+    VkMemoryRequirements2 requirements = {0};
+    VkMemoryDedicatedAllocateInfo dedicatedInfo = {0};
+    TR_STATUS status;
+    VkResult result;
+
+    struct vulkan_allocator_object *impl = impl_from_VulkanAllocatorObject( iface );
+
+    TRACE( "iface %p, buffer %p, required %#x, preferred %#x, flags %#x, out %p\n", iface, (void *)buffer, required, preferred, flags, out );
+
+    requirementsInfo.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+    requirementsInfo.buffer = buffer;
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+
+    vkGetBufferMemoryRequirements2( impl->handle, &requirementsInfo, &requirements );
+
+    if ( dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation )
+        flags |= VulkanAllocationFlags_Dedicated;
+
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedInfo.buffer = buffer;
+
+    if ( FAILED( status = AllocateInternal( impl, &requirements.memoryRequirements, required, preferred, flags & ~VulkanAllocationFlags_Optimal,
+                                            &dedicatedInfo, out ) ) )
+        return status;
+
+    result = vkBindBufferMemory( impl->handle, buffer, out->Memory, out->Offset );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Binding buffer memory failed with %d\n", result );
+        iface->lpVtbl->Free( iface, out );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_allocator_object_AllocateForImage( VulkanAllocatorObject *iface, VkImage image, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, VulkanAllocationFlags flags, VulkanAllocation *out )
+{
+    VkImageMemoryRequirementsInfo2 requirementsInfo = {0};
+    VkMemoryDedicatedRequirements dedicatedRequirements = {0};
+    VkMemoryRequirements2 requirements = {0};
+    VkMemoryDedicatedAllocateInfo dedicatedInfo = {0};
+    TR_STATUS status;
+    VkResult result;
+
+    struct vulkan_allocator_object *impl = impl_from_VulkanAllocatorObject( iface );
+
+    TRACE( "iface %p, image %p, required %#x, preferred %#x, flags %#x, out %p\n", iface, (void *)image, required, preferred, flags, out );
+
+    requirementsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+    requirementsInfo.image = image;
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+
+    vkGetImageMemoryRequirements2( impl->handle, &requirementsInfo, &requirements );
+
+    // Drivers ask for this on render targets, where it enables compression.
+    if ( dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation )
+        flags |= VulkanAllocationFlags_Dedicated;
+
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedInfo.image = image;
+
+    if ( FAILED( status = AllocateInternal( impl, &requirements.memoryRequirements, required, preferred, flags | VulkanAllocationFlags_Optimal,
+                                            &dedicatedInfo, out ) ) )
+        return status;
+
+    result = vkBindImageMemory( impl->handle, image, out->Memory, out->Offset );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Binding image memory failed with %d\n", result );
+        iface->lpVtbl->Free( iface, out );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+static void vulkan_allocator_object_Free( VulkanAllocatorObject *iface, VulkanAllocation *allocation )
+{
+    struct vulkan_allocator_object *impl = impl_from_VulkanAllocatorObject( iface );
+
+    TRACE( "iface %p, allocation %p\n", iface, allocation );
+
+    if ( !allocation || !allocation->Memory )
+        return;
+
+    pthread_mutex_lock( &impl->lock );
+
+    if ( !allocation->Block )
+    {
+        vkFreeMemory( impl->handle, allocation->Memory, &VulkanAllocationCallbacks );
+        impl->memoryCount--;
+        impl->dedicatedCount--;
+        impl->dedicatedBytes -= allocation->Size;
+    }
+    else
+    {
+        VulkanMemoryBlock *block = allocation->Block;
+
+        BlockFree( impl, block, allocation->Node );
+
+        // Keeping one empty block per pool avoids a vkAllocateMemory round trip per frame.
+        if ( !block->Allocations && (*block->Pool != block || block->Next) )
+            DestroyBlock( impl, block );
+    }
+
+    pthread_mutex_unlock( &impl->lock );
+
+    memset( allocation, 0, sizeof(VulkanAllocation) );
+}
+
+static TR_STATUS vulkan_allocator_object_get_Statistics( VulkanAllocatorObject *iface, VulkanAllocatorStatistics *out )
+{
+    struct vulkan_allocator_object *impl = impl_from_VulkanAllocatorObject( iface );
+    const VulkanMemoryBlock *block;
+    VkDeviceSize free = 0, contiguous = 0, largest;
+    TRUInt type, kind;
+
+    TRACE( "iface %p, out %p\n", iface, out );
+
+    if ( !out ) throw_NullPtrException();
+
+    memset( out, 0, sizeof(VulkanAllocatorStatistics) );
+
+    pthread_mutex_lock( &impl->lock );
+
+    for ( type = 0; type < VK_MAX_MEMORY_TYPES; type++ )
+        for ( kind = 0; kind < 2; kind++ )
+            for ( block = impl->pools[type][kind]; block; block = block->Next )
+            {
+                out->Blocks++;
+                out->Allocations += block->Allocations;
+                out->Reserved += block->Size;
+                out->Used += block->Used;
+                free += block->Size - block->Used;
+
+                largest = LargestFree( block );
+                contiguous += largest;
+                if ( largest > out->LargestFree )
+                    out->LargestFree = largest;
+            }
+
+    out->DedicatedAllocations = impl->dedicatedCount;
+    out->Allocations += impl->dedicatedCount;
+    out->Reserved += impl->dedicatedBytes;
+    out->Used += impl->dedicatedBytes;
+
+    pthread_mutex_unlock( &impl->lock );
+
+    out->Fragmentation = free ? 1.0 - (TRFloat)contiguous / (TRFloat)free : 0.0;
+
+    return T_SUCCESS;
+}
+
+static VulkanAllocatorInterface vulkan_allocator_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_allocator_object_QueryInterface,
+    vulkan_allocator_object_AddRef,
+    vulkan_allocator_object_Release,
+    /* VulkanAllocatorObject Methods */
+    vulkan_allocator_object_Allocate,
+    vulkan_allocator_object_AllocateForBuffer,
+    vulkan_allocator_object_AllocateForImage,
+    vulkan_allocator_object_Free,
+    vulkan_allocator_object_get_Statistics
+};
+
+TR_STATUS TR_API new_vulkan_allocator_object_override_device( IN VulkanDeviceObject *device, OUT VulkanAllocatorObject **out )
+{
+    struct vulkan_allocator_object *impl;
+    TRUInt heap;
+
+    TRACE( "device %p, out %p\n", device, out );
+
+    if ( !device || !out ) throw_NullPtrException();
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_allocator_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanAllocatorObject_iface.lpVtbl = &vulkan_allocator_interface;
+    impl->device = device;
+    impl->ref = 1;
+
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    device->lpVtbl->get_Info( device, &impl->info );
+
+    // Linear and optimal resources closer than the granularity would alias each other's pages.
+    impl->separateOptimal = impl->info->Properties.limits.bufferImageGranularity > 1;
+
+    // An eighth of small heaps, so a few blocks never exhaust integrated GPUs or BAR memory.
+    for ( heap = 0; heap < impl->info->Memory.memoryHeapCount; heap++ )
+    {
+        const VkDeviceSize heapSize = impl->info->Memory.memoryHeaps[heap].size;
+
+        impl->blockSizes[heap] = heapSize > ALLOCATOR_LARGE_HEAP ? ALLOCATOR_BLOCK_SIZE : AlignUp( heapSize / 8, 1 << 20 );
+    }
+
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    device->lpVtbl->AddRef( device );
+
+    *out = &impl->VulkanAllocatorObject_iface;
+
+    TRACE( "created VulkanAllocatorObject %p\n", *out );
+
+    return T_SUCCESS;
+}
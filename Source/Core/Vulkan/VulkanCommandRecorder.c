@@ -0,0 +1,468 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanCommandRecorder.c
+ *  Description: Secondary command buffers recorded in parallel, from per-thread command pools.
+ */
+
+#include <glib.h>
+
+#include <Core/Vulkan/VulkanCommandRecorder.h>
+#include <Core/Async/AsyncOperation.h>
+#include <Core/Instrumentation/Zones.h>
+
+// Buffers a pool allocates the first time it runs out, doubled every time after.
+#define RECORDER_POOL_GROWTH 4
+
+typedef struct _TR_RecordRange
+{
+    struct vulkan_command_recorder_object *Recorder;
+    VulkanRecorderPool *Pool;
+    const VkCommandBufferInheritanceInfo *Inheritance;
+    VulkanRecordCallback Callback;
+    void *Context;
+    TRUInt Begin;
+    TRUInt End;
+    VkCommandBuffer Commands;
+    TR_STATUS Status;
+} RecordRange;
+
+/**
+ * The ranges of one Record, claimed in order by whichever thread gets to them first. Helpers
+ * queued on the async executor may only start after Record returned, so they hold a reference.
+ */
+typedef struct _TR_RecordBatch
+{
+    RecordRange Ranges[VULKAN_RECORDER_MAX_THREADS];
+    TRUInt Count;
+    ATOMIC(TRUInt) Next;                            // First range nobody claimed yet
+    pthread_mutex_t Lock;
+    pthread_cond_t Done;
+    TRUInt Remaining;                               // Ranges not recorded yet
+    ATOMIC(TRLong) Ref;
+} RecordBatch;
+
+static struct vulkan_command_recorder_object *impl_from_VulkanCommandRecorderObject( VulkanCommandRecorderObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_command_recorder_object, VulkanCommandRecorderObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_command_recorder_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_command_recorder_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_command_recorder_object, VulkanCommandRecorderObject_iface ),
+    INTERFACE_ENTRY( VulkanCommandRecorderObject, vulkan_command_recorder_object, VulkanCommandRecorderObject_iface ) );
+
+static TR_STATUS
+NextBuffer(
+    IN struct vulkan_command_recorder_object *impl,
+    IN VulkanRecorderPool *pool,
+    OUT VkCommandBuffer *out
+) {
+    VkCommandBufferAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    VkCommandBuffer *buffers;
+    TRUInt count;
+
+    if ( pool->Used == pool->Allocated )
+    {
+        count = pool->Allocated ? pool->Allocated * 2 : RECORDER_POOL_GROWTH;
+        if (!(buffers = TRRealloc( pool->Buffers, count * sizeof(VkCommandBuffer), MEMORY_TAG_VULKAN ))) return T_OUTOFMEMORY;
+        pool->Buffers = buffers;
+
+        allocateInfo.commandPool = pool->Pool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = count - pool->Allocated;
+        if ( vkAllocateCommandBuffers( impl->handle, &allocateInfo, &pool->Buffers[pool->Allocated] ) != VK_SUCCESS ) return T_OUTOFMEMORY;
+        pool->Allocated = count;
+    }
+
+    *out = pool->Buffers[pool->Used++];
+
+    return T_SUCCESS;
+}
+
+static void
+RecordItems(
+    IN RecordRange *range
+) {
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    TRUInt index;
+
+    TR_ZONE( "VulkanCommandRecorder::RecordItems" );
+
+    if ( FAILED(( range->Status = NextBuffer( range->Recorder, range->Pool, &range->Commands ) )) ) return;
+
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if ( range->Inheritance->renderPass ) beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = range->Inheritance;
+
+    if ( vkBeginCommandBuffer( range->Commands, &beginInfo ) != VK_SUCCESS )
+    {
+        range->Status = T_ERROR;
+        return;
+    }
+
+    for ( index = range->Begin; index < range->End; index++ )
+    {
+        if ( FAILED(( range->Status = range->Callback( range->Context, index, range->Commands ) )) ) break;
+    }
+
+    // Ended even after a failure, so the buffer goes back to the pool in a sane state.
+    if ( vkEndCommandBuffer( range->Commands ) != VK_SUCCESS && !FAILED( range->Status ) )
+        range->Status = T_ERROR;
+}
+
+static void
+ReleaseRecordBatch(
+    IN RecordBatch *batch
+) {
+    if ( atomic_fetch_sub( &batch->Ref, 1 ) != 1 ) return;
+
+    pthread_cond_destroy( &batch->Done );
+    pthread_mutex_destroy( &batch->Lock );
+    TRFree( batch );
+}
+
+// Records ranges until none is left to claim, returns how many this thread recorded.
+static TRUInt
+RecordRanges(
+    IN RecordBatch *batch
+) {
+    TRUInt index, recorded = 0;
+
+    while ( (index = atomic_fetch_add( &batch->Next, 1 )) < batch->Count )
+    {
+        RecordItems( &batch->Ranges[index] );
+        recorded++;
+
+        pthread_mutex_lock( &batch->Lock );
+        if ( !--batch->Remaining ) pthread_cond_signal( &batch->Done );
+        pthread_mutex_unlock( &batch->Lock );
+    }
+
+    return recorded;
+}
+
+static TR_STATUS
+RecordCallback(
+    IN UnknownObject *invoker,
+    IN void *param,
+    OUT PropVariant *result
+) {
+    RecordBatch *batch = param;
+
+    result->type = VT_UI32;
+    result->uintVal = RecordRanges( batch );
+    ReleaseRecordBatch( batch );
+
+    return T_SUCCESS;
+}
+
+static void
+DestroyCommandRecorder(
+    IN struct vulkan_command_recorder_object *impl
+) {
+    TRUInt iterator;
+
+    if ( impl->pools )
+    {
+        // Destroying a pool frees its buffers.
+        for ( iterator = 0; iterator < impl->threads * impl->frames; iterator++ )
+        {
+            if ( impl->pools[iterator].Pool ) vkDestroyCommandPool( impl->handle, impl->pools[iterator].Pool, &VulkanAllocationCallbacks );
+            TRFree( impl->pools[iterator].Buffers );
+        }
+        TRFree( impl->pools );
+    }
+
+    impl->device->lpVtbl->Release( impl->device );
+
+    pthread_mutex_destroy( &impl->lock );
+    SlabFree( &vulkan_command_recorder_object_cache, impl );
+}
+
+static TR_STATUS vulkan_command_recorder_object_QueryInterface( VulkanCommandRecorderObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_command_recorder_object_interfaces, impl_from_VulkanCommandRecorderObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_command_recorder_object_AddRef( VulkanCommandRecorderObject *iface )
+{
+    struct vulkan_command_recorder_object *impl = impl_from_VulkanCommandRecorderObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_command_recorder_object_Release( VulkanCommandRecorderObject *iface )
+{
+    struct vulkan_command_recorder_object *impl = impl_from_VulkanCommandRecorderObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) ) DestroyCommandRecorder( impl );
+    return removed;
+}
+
+static TR_STATUS vulkan_command_recorder_object_BeginFrame( VulkanCommandRecorderObject *iface, TRUInt frame )
+{
+    VulkanRecorderPool *pools;
+    TRUInt iterator;
+
+    struct vulkan_command_recorder_object *impl = impl_from_VulkanCommandRecorderObject( iface );
+
+    TR_ZONE( "VulkanCommandRecorder::BeginFrame" );
+
+    TRACE( "iface %p, frame %u\n", iface, frame );
+
+    if ( frame >= impl->frames ) return T_INVALIDARG;
+
+    pools = &impl->pools[frame * impl->threads];
+
+    for ( iterator = 0; iterator < impl->threads; iterator++ )
+    {
+        // Pools never recorded into since their last reset are already clean.
+        if ( !pools[iterator].Used ) continue;
+
+        if ( vkResetCommandPool( impl->handle, pools[iterator].Pool, 0 ) != VK_SUCCESS )
+        {
+            ERROR( "Failed to reset the command pool of thread %u in frame %u\n", iterator, frame );
+            return T_ERROR;
+        }
+        pools[iterator].Used = 0;
+
+        pthread_mutex_lock( &impl->lock );
+        impl->statistics.Resets++;
+        pthread_mutex_unlock( &impl->lock );
+    }
+
+    impl->frame = frame;
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_command_recorder_object_Record( VulkanCommandRecorderObject *iface, const VkCommandBufferInheritanceInfo *inheritance,
+                                                        TRUInt count, VulkanRecordCallback callback, void *context, VkCommandBuffer *commands, TRUInt *recorded )
+{
+    const VkCommandBufferInheritanceInfo outside = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    RecordBatch *batch;
+    AsyncOperationObject *operation;
+    TR_STATUS status = T_SUCCESS;
+    TRUInt iterator, rangeCount, size, allocated = 0;
+    TRULong start;
+
+    struct vulkan_command_recorder_object *impl = impl_from_VulkanCommandRecorderObject( iface );
+
+    TR_ZONE( "VulkanCommandRecorder::Record" );
+
+    TRACE( "iface %p, inheritance %p, count %u, callback %p, context %p, commands %p, recorded %p\n", iface, inheritance, count, callback, context, commands, recorded );
+
+    if ( !callback || !commands || !recorded ) throw_NullPtrException();
+
+    *recorded = 0;
+    if ( !count ) return T_SUCCESS;
+
+    start = ZoneTimestamp();
+
+    // Ranges of at least one item each, in item order so executing them in order keeps it.
+    rangeCount = count < impl->threads ? count : impl->threads;
+    size = (count + rangeCount - 1) / rangeCount;
+    rangeCount = (count + size - 1) / size;
+
+    if (!(batch = TRAlloc( sizeof(*batch), MEMORY_TAG_VULKAN ))) return T_OUTOFMEMORY;
+
+    pthread_mutex_init( &batch->Lock, nullptr );
+    pthread_cond_init( &batch->Done, nullptr );
+    batch->Count = rangeCount;
+    batch->Remaining = rangeCount;
+    atomic_init( &batch->Next, 0 );
+    atomic_init( &batch->Ref, 1 );
+
+    // Each range keeps the pool of its slot, whichever thread records it, so no pool is shared.
+    for ( iterator = 0; iterator < rangeCount; iterator++ )
+    {
+        batch->Ranges[iterator] = (RecordRange){
+            .Recorder = impl,
+            .Pool = &impl->pools[impl->frame * impl->threads + iterator],
+            .Inheritance = inheritance ? inheritance : &outside,
+            .Callback = callback,
+            .Context = context,
+            .Begin = iterator * size,
+            .End = (iterator + 1) * size < count ? (iterator + 1) * size : count,
+        };
+    }
+
+    for ( iterator = 1; iterator < rangeCount; iterator++ )
+    {
+        atomic_fetch_add( &batch->Ref, 1 );
+
+        // The operation keeps itself alive until its callback returned.
+        if ( FAILED( new_async_operation_object_override_callback( (UnknownObject *)iface, batch, RecordCallback, &operation ) ) )
+        {
+            WARN( "Could not start recording helper %u on the async executor\n", iterator );
+            ReleaseRecordBatch( batch );
+            break;
+        }
+        operation->lpVtbl->Release( operation );
+    }
+
+    // Helpers that are slow to start, or never do while the executor is busy, leave their ranges to this thread.
+    RecordRanges( batch );
+
+    pthread_mutex_lock( &batch->Lock );
+    while ( batch->Remaining ) pthread_cond_wait( &batch->Done, &batch->Lock );
+    pthread_mutex_unlock( &batch->Lock );
+
+    for ( iterator = 0; iterator < rangeCount; iterator++ )
+    {
+        if ( FAILED( batch->Ranges[iterator].Status ) && !FAILED( status ) ) status = batch->Ranges[iterator].Status;
+        commands[iterator] = batch->Ranges[iterator].Commands;
+    }
+
+    ReleaseRecordBatch( batch );
+
+    for ( iterator = 0; iterator < impl->threads * impl->frames; iterator++ )
+        allocated += impl->pools[iterator].Allocated;
+
+    pthread_mutex_lock( &impl->lock );
+    impl->statistics.Recorded += rangeCount;
+    impl->statistics.Items += count;
+    impl->statistics.Allocated = allocated;
+    impl->statistics.RecordNanoseconds = ZoneTimestamp() - start;
+    pthread_mutex_unlock( &impl->lock );
+
+    if ( FAILED( status ) )
+    {
+        ERROR( "Recording %u items on %u threads failed with %d\n", count, rangeCount, status );
+        return status;
+    }
+
+    *recorded = rangeCount;
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_command_recorder_object_get_ThreadCount( VulkanCommandRecorderObject *iface, TRUInt *out )
+{
+    const struct vulkan_command_recorder_object *impl = impl_from_VulkanCommandRecorderObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->threads;
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_command_recorder_object_get_Statistics( VulkanCommandRecorderObject *iface, VulkanCommandRecorderStatistics *out )
+{
+    struct vulkan_command_recorder_object *impl = impl_from_VulkanCommandRecorderObject( iface );
+
+    TRACE( "iface %p, out %p\n", iface, out );
+
+    if ( !out ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->lock );
+    *out = impl->statistics;
+    pthread_mutex_unlock( &impl->lock );
+
+    return T_SUCCESS;
+}
+
+static VulkanCommandRecorderInterface vulkan_command_recorder_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_command_recorder_object_QueryInterface,
+    vulkan_command_recorder_object_AddRef,
+    vulkan_command_recorder_object_Release,
+    /* VulkanCommandRecorderObject Methods */
+    vulkan_command_recorder_object_BeginFrame,
+    vulkan_command_recorder_object_Record,
+    vulkan_command_recorder_object_get_ThreadCount,
+    vulkan_command_recorder_object_get_Statistics
+};
+
+static TR_STATUS
+CreatePools(
+    IN struct vulkan_command_recorder_object *impl,
+    IN VulkanQueueRole role
+) {
+    VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    VulkanQueueObject *queue;
+    TR_STATUS status;
+    TRUInt iterator;
+
+    if ( FAILED(( status = impl->device->lpVtbl->GetQueue( impl->device, role, &queue ) )) ) return status;
+    queue->lpVtbl->get_FamilyIndex( queue, &poolInfo.queueFamilyIndex );
+    queue->lpVtbl->Release( queue );
+
+    // Buffers only live until the pool's next reset.
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    if (!(impl->pools = TRCalloc( impl->threads * impl->frames, sizeof(VulkanRecorderPool), MEMORY_TAG_VULKAN ))) return T_OUTOFMEMORY;
+
+    for ( iterator = 0; iterator < impl->threads * impl->frames; iterator++ )
+    {
+        if ( vkCreateCommandPool( impl->handle, &poolInfo, &VulkanAllocationCallbacks, &impl->pools[iterator].Pool ) != VK_SUCCESS )
+            return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API new_vulkan_command_recorder_object_override_device_and_settings( IN VulkanDeviceObject *device, IN const VulkanCommandRecorderSettings *settings, OUT VulkanCommandRecorderObject **out )
+{
+    struct vulkan_command_recorder_object *impl;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanCommandRecorder::Create" );
+
+    TRACE( "device %p, settings %p, out %p\n", device, settings, out );
+
+    if ( !device || !settings || !out ) throw_NullPtrException();
+
+    if ( settings->Role >= VulkanQueueRole_Count ) return T_INVALIDARG;
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_command_recorder_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanCommandRecorderObject_iface.lpVtbl = &vulkan_command_recorder_interface;
+    impl->device = device;
+    impl->threads = settings->Threads ? settings->Threads : (TRUInt)g_get_num_processors();
+    impl->frames = settings->FramesInFlight ? settings->FramesInFlight : VULKAN_RECORDER_DEFAULT_FRAMES;
+    impl->ref = 1;
+
+    if ( impl->threads > VULKAN_RECORDER_MAX_THREADS ) impl->threads = VULKAN_RECORDER_MAX_THREADS;
+
+    device->lpVtbl->AddRef( device );
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    if ( FAILED(( status = CreatePools( impl, settings->Role ) )) )
+    {
+        ERROR( "Failed to create %u command pools for %u threads\n", impl->threads * impl->frames, impl->threads );
+        DestroyCommandRecorder( impl );
+        return status;
+    }
+
+    *out = &impl->VulkanCommandRecorderObject_iface;
+
+    TRACE( "created VulkanCommandRecorderObject %p\n", *out );
+
+    return T_SUCCESS;
+}
@@ -0,0 +1,752 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanComputeTracer.c
+ *  Description: Wavefront path tracing in compute shaders, for devices without ray tracing pipelines.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <Core/Vulkan/VulkanComputeTracer.h>
+#include <Core/Instrumentation/PerfCounters.h>
+#include <Core/Instrumentation/Zones.h>
+
+// SPIR-V words, compiled from Shaders/ at build time.
+static const TRUInt GenerateCode[] = {
+#include "Shaders/Generate.comp.inc"
+};
+
+static const TRUInt ExtendCode[] = {
+#include "Shaders/Extend.comp.inc"
+};
+
+static const TRUInt ShadeCode[] = {
+#include "Shaders/Shade.comp.inc"
+};
+
+static const TRUInt ConnectCode[] = {
+#include "Shaders/Connect.comp.inc"
+};
+
+static const struct
+{
+    TRCString Name;                                 // Of its profiler scopes
+    const TRUInt *Code;
+    TRSize Size;
+} KernelCode[VulkanComputeTracerKernel_Count] =
+{
+    [VulkanComputeTracerKernel_Generate] = { "Generate", GenerateCode, sizeof(GenerateCode) },
+    [VulkanComputeTracerKernel_Extend] = { "Extend", ExtendCode, sizeof(ExtendCode) },
+    [VulkanComputeTracerKernel_Shade] = { "Shade", ShadeCode, sizeof(ShadeCode) },
+    [VulkanComputeTracerKernel_Connect] = { "Connect", ConnectCode, sizeof(ConnectCode) }
+};
+
+// Shaders/Common.glsl has to agree on all of these.
+#define TRACER_WORKGROUP_SIZE 64
+#define TRACER_QUEUE_COUNT 3                        // Two ray queues taking turns and the shadow ray queue
+#define TRACER_SHADOW_QUEUE 2
+#define TRACER_PATH_SIZE 64
+#define TRACER_SHADOW_RAY_SIZE 48
+
+// Dispatch() with it runs a kernel over a fixed grid instead of a queue.
+#define TRACER_NO_QUEUE 0xFFFFFFFFu
+
+typedef struct _TR_TracerQueueHeader
+{
+    TRUInt GroupsX;                                 // VkDispatchIndirectCommand of the consuming kernel
+    TRUInt GroupsY;
+    TRUInt GroupsZ;
+    TRUInt Count;
+} TracerQueueHeader;
+
+typedef struct _TR_TracerConstants
+{
+    float CameraOrigin[4];
+    float CameraForward[4];
+    float CameraRight[4];
+    float CameraUp[4];
+    TRUInt Width;
+    TRUInt Height;
+    TRUInt Sample;
+    TRUInt Depth;
+    TRUInt MaxDepth;
+    TRUInt Seed;
+    TRUInt LightCount;
+    TRUInt InQueue;
+} TracerConstants;
+
+static const TracerQueueHeader EmptyQueue = { 0, 1, 1, 0 };
+
+static struct vulkan_compute_tracer_object *impl_from_VulkanComputeTracerObject( VulkanComputeTracerObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_compute_tracer_object, VulkanComputeTracerObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_compute_tracer_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_compute_tracer_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_compute_tracer_object, VulkanComputeTracerObject_iface ),
+    INTERFACE_ENTRY( VulkanComputeTracerObject, vulkan_compute_tracer_object, VulkanComputeTracerObject_iface ) );
+
+static void
+DestroyBuffer(
+    IN struct vulkan_compute_tracer_object *impl,
+    INOUT VulkanComputeTracerBuffer *buffer
+) {
+    if ( buffer->Buffer ) vkDestroyBuffer( impl->handle, buffer->Buffer, &VulkanAllocationCallbacks );
+    if ( buffer->Memory.Memory ) impl->allocator->lpVtbl->Free( impl->allocator, &buffer->Memory );
+    *buffer = (VulkanComputeTracerBuffer){};
+}
+
+static TR_STATUS
+CreateBuffer(
+    IN struct vulkan_compute_tracer_object *impl,
+    IN VkDeviceSize size,
+    IN VkBufferUsageFlags usage,
+    IN VkMemoryPropertyFlags required,
+    IN VkMemoryPropertyFlags preferred,
+    IN VulkanAllocationFlags flags,
+    OUT VulkanComputeTracerBuffer *out
+) {
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    TR_STATUS status;
+
+    *out = (VulkanComputeTracerBuffer){ .Size = size };
+
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if ( vkCreateBuffer( impl->handle, &bufferInfo, &VulkanAllocationCallbacks, &out->Buffer ) != VK_SUCCESS )
+    {
+        out->Buffer = VK_NULL_HANDLE;
+        return T_OUTOFMEMORY;
+    }
+
+    if ( FAILED( status = impl->allocator->lpVtbl->AllocateForBuffer( impl->allocator, out->Buffer, required, preferred, flags, &out->Memory ) ) )
+    {
+        DestroyBuffer( impl, out );
+        return status;
+    }
+
+    return T_SUCCESS;
+}
+
+static void
+WriteDescriptors(
+    IN struct vulkan_compute_tracer_object *impl,
+    IN TRUInt first,
+    IN TRUInt count
+) {
+    VkDescriptorBufferInfo buffers[VulkanComputeTracerBinding_Count];
+    VkWriteDescriptorSet writes[VulkanComputeTracerBinding_Count];
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        buffers[iterator] = (VkDescriptorBufferInfo){ impl->buffers[first + iterator].Buffer, 0, VK_WHOLE_SIZE };
+        writes[iterator] = (VkWriteDescriptorSet){ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        writes[iterator].dstSet = impl->set;
+        writes[iterator].dstBinding = first + iterator;
+        writes[iterator].descriptorCount = 1;
+        writes[iterator].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[iterator].pBufferInfo = &buffers[iterator];
+    }
+
+    vkUpdateDescriptorSets( impl->handle, count, writes, 0, nullptr );
+}
+
+static TR_STATUS
+BeginCommands(
+    IN struct vulkan_compute_tracer_object *impl
+) {
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if ( vkBeginCommandBuffer( impl->commands, &beginInfo ) != VK_SUCCESS )
+    {
+        ERROR( "Failed to begin the compute tracer's commands\n" );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+// Submits the recorded commands and waits for them, nothing is in flight between calls.
+static TR_STATUS
+ExecuteCommands(
+    IN struct vulkan_compute_tracer_object *impl
+) {
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    TR_STATUS status;
+    VkResult result;
+
+    TR_ZONE( "VulkanComputeTracer::Execute" );
+    TR_PERF_PHASE( "VulkanComputeTracer::Submit" );
+
+    if ( vkEndCommandBuffer( impl->commands ) != VK_SUCCESS )
+    {
+        ERROR( "Failed to record the compute tracer's commands\n" );
+        return T_ERROR;
+    }
+
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &impl->commands;
+    if ( FAILED( status = impl->queue->lpVtbl->Submit( impl->queue, &submitInfo, 1, impl->fence ) ) ) return status;
+
+    result = vkWaitForFences( impl->handle, 1, &impl->fence, VK_TRUE, UINT64_MAX );
+    vkResetFences( impl->handle, 1, &impl->fence );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Waiting for the compute tracer failed with %d\n", result );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+// Makes every compute and transfer write visible to the following commands, indirect arguments included.
+static void
+Barrier(
+    IN VkCommandBuffer commands
+) {
+    VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+                            VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    vkCmdPipelineBarrier( commands, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                          0, 1, &barrier, 0, nullptr, 0, nullptr );
+}
+
+static void
+ResetQueue(
+    IN struct vulkan_compute_tracer_object *impl,
+    IN TRUInt queue
+) {
+    vkCmdUpdateBuffer( impl->commands, impl->buffers[VulkanComputeTracerBinding_Queues].Buffer,
+                       queue * sizeof(TracerQueueHeader), sizeof(EmptyQueue), &EmptyQueue );
+}
+
+// Records a kernel into its own profiler scope.
+static void
+Dispatch(
+    IN struct vulkan_compute_tracer_object *impl,
+    IN VulkanComputeTracerKernel kernel,
+    IN TRUInt queue,
+    IN TRUInt groups
+) {
+    TRUInt scope;
+
+    impl->profiler->lpVtbl->BeginScope( impl->profiler, impl->commands, KernelCode[kernel].Name, &scope );
+
+    vkCmdBindPipeline( impl->commands, VK_PIPELINE_BIND_POINT_COMPUTE, impl->pipelines[kernel] );
+    if ( queue == TRACER_NO_QUEUE )
+        vkCmdDispatch( impl->commands, groups, 1, 1 );
+    else
+        vkCmdDispatchIndirect( impl->commands, impl->buffers[VulkanComputeTracerBinding_Queues].Buffer, queue * sizeof(TracerQueueHeader) );
+
+    impl->profiler->lpVtbl->EndScope( impl->profiler, impl->commands, scope );
+}
+
+// Grows the buffers holding a path, queue entry, shadow ray and film texel per pixel. Must be called with the lock held.
+static TR_STATUS
+ReservePixels(
+    IN struct vulkan_compute_tracer_object *impl,
+    IN TRUInt pixels
+) {
+    static const struct
+    {
+        VulkanComputeTracerBinding Binding;
+        VkDeviceSize PixelSize;
+        VkBufferUsageFlags Usage;
+    } layouts[] =
+    {
+        { VulkanComputeTracerBinding_Paths, TRACER_PATH_SIZE, 0 },
+        { VulkanComputeTracerBinding_RayQueue, 2 * sizeof(TRUInt), 0 },
+        { VulkanComputeTracerBinding_ShadowRays, TRACER_SHADOW_RAY_SIZE, 0 },
+        { VulkanComputeTracerBinding_Film, 4 * sizeof(float), VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT }
+    };
+    TR_STATUS status;
+    TRUInt iterator;
+
+    if ( pixels <= impl->pixelCapacity ) return T_SUCCESS;
+
+    impl->pixelCapacity = 0;
+    for ( iterator = 0; iterator < sizeof(layouts) / sizeof(*layouts); iterator++ )
+        DestroyBuffer( impl, &impl->buffers[layouts[iterator].Binding] );
+    DestroyBuffer( impl, &impl->readback );
+
+    for ( iterator = 0; iterator < sizeof(layouts) / sizeof(*layouts); iterator++ )
+    {
+        if ( FAILED( status = CreateBuffer( impl, layouts[iterator].PixelSize * pixels,
+                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | layouts[iterator].Usage,
+                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, VulkanAllocationFlags_None,
+                                            &impl->buffers[layouts[iterator].Binding] ) ) )
+            return status;
+    }
+
+    // Read once by the host, cached memory is much faster to read than write-combined.
+    if ( FAILED( status = CreateBuffer( impl, 4 * sizeof(float) * pixels, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                        VK_MEMORY_PROPERTY_HOST_CACHED_BIT, VulkanAllocationFlags_Mapped, &impl->readback ) ) )
+        return status;
+
+    WriteDescriptors( impl, VulkanComputeTracerBinding_Paths, VulkanComputeTracerBinding_Count - VulkanComputeTracerBinding_Paths );
+    impl->pixelCapacity = pixels;
+
+    return T_SUCCESS;
+}
+
+static void
+DestroyTracer(
+    IN struct vulkan_compute_tracer_object *impl
+) {
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < VulkanComputeTracerBinding_Count; iterator++ )
+        DestroyBuffer( impl, &impl->buffers[iterator] );
+    DestroyBuffer( impl, &impl->readback );
+
+    for ( iterator = 0; iterator < VulkanComputeTracerKernel_Count; iterator++ )
+        if ( impl->pipelines[iterator] ) vkDestroyPipeline( impl->handle, impl->pipelines[iterator], &VulkanAllocationCallbacks );
+
+    if ( impl->fence ) vkDestroyFence( impl->handle, impl->fence, &VulkanAllocationCallbacks );
+    if ( impl->pool ) vkDestroyCommandPool( impl->handle, impl->pool, &VulkanAllocationCallbacks );
+    if ( impl->descriptorPool ) vkDestroyDescriptorPool( impl->handle, impl->descriptorPool, &VulkanAllocationCallbacks );
+    if ( impl->layout ) vkDestroyPipelineLayout( impl->handle, impl->layout, &VulkanAllocationCallbacks );
+    if ( impl->setLayout ) vkDestroyDescriptorSetLayout( impl->handle, impl->setLayout, &VulkanAllocationCallbacks );
+
+    if ( impl->profiler ) impl->profiler->lpVtbl->Release( impl->profiler );
+    if ( impl->queue ) impl->queue->lpVtbl->Release( impl->queue );
+    impl->allocator->lpVtbl->Release( impl->allocator );
+    impl->device->lpVtbl->Release( impl->device );
+
+    pthread_mutex_destroy( &impl->lock );
+    SlabFree( &vulkan_compute_tracer_object_cache, impl );
+}
+
+static TR_STATUS vulkan_compute_tracer_object_QueryInterface( VulkanComputeTracerObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_compute_tracer_object_interfaces, impl_from_VulkanComputeTracerObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_compute_tracer_object_AddRef( VulkanComputeTracerObject *iface )
+{
+    struct vulkan_compute_tracer_object *impl = impl_from_VulkanComputeTracerObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_compute_tracer_object_Release( VulkanComputeTracerObject *iface )
+{
+    struct vulkan_compute_tracer_object *impl = impl_from_VulkanComputeTracerObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) ) DestroyTracer( impl );
+    return removed;
+}
+
+static TR_STATUS vulkan_compute_tracer_object_LoadScene( VulkanComputeTracerObject *iface, const Scene *scene, const BVH *bvh )
+{
+    struct vulkan_compute_tracer_object *impl = impl_from_VulkanComputeTracerObject( iface );
+    const struct
+    {
+        const void *Data;
+        VkDeviceSize Size;
+    } sources[VulkanComputeTracerBinding_Paths] =
+    {
+        [VulkanComputeTracerBinding_Nodes] = { bvh ? bvh->Nodes : nullptr, bvh ? bvh->NodeCount * sizeof(BVHNode) : 0 },
+        [VulkanComputeTracerBinding_Triangles] = { scene ? scene->Triangles : nullptr, scene ? scene->TriangleCount * sizeof(SceneTriangle) : 0 },
+        [VulkanComputeTracerBinding_Materials] = { scene ? scene->Materials : nullptr, scene ? scene->MaterialCount * sizeof(SceneMaterial) : 0 },
+        [VulkanComputeTracerBinding_Lights] = { scene ? scene->Lights : nullptr, scene ? scene->LightCount * sizeof(TRUInt) : 0 }
+    };
+    VulkanComputeTracerBuffer staging = {};
+    VkDeviceSize offsets[VulkanComputeTracerBinding_Paths], total = 0;
+    TR_STATUS status;
+    TRUInt iterator;
+
+    TR_ZONE( "VulkanComputeTracer::LoadScene" );
+
+    TRACE( "iface %p, scene %p, bvh %p\n", iface, scene, bvh );
+
+    if ( !scene || !bvh ) throw_NullPtrException();
+    if ( !scene->TriangleCount || !scene->MaterialCount || !bvh->NodeCount ) return T_INVALIDARG;
+
+    for ( iterator = 0; iterator < VulkanComputeTracerBinding_Paths; iterator++ )
+    {
+        offsets[iterator] = total;
+        total += (sources[iterator].Size + 15) & ~(VkDeviceSize)15;
+    }
+
+    pthread_mutex_lock( &impl->lock );
+
+    impl->loaded = false;
+    for ( iterator = 0; iterator < VulkanComputeTracerBinding_Paths; iterator++ )
+        DestroyBuffer( impl, &impl->buffers[iterator] );
+
+    // A one-off copy on the tracer's own queue, so the buffers never change queue family.
+    if ( FAILED( status = CreateBuffer( impl, total, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0,
+                                        VulkanAllocationFlags_Mapped, &staging ) ) )
+        goto done;
+
+    for ( iterator = 0; iterator < VulkanComputeTracerBinding_Paths; iterator++ )
+    {
+        // Storage buffers cannot be empty, a scene without lights still gets one.
+        const VkDeviceSize size = sources[iterator].Size ? sources[iterator].Size : sizeof(TRUInt);
+
+        if ( FAILED( status = CreateBuffer( impl, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, VulkanAllocationFlags_None,
+                                            &impl->buffers[iterator] ) ) )
+            goto done;
+
+        if ( sources[iterator].Size )
+            memcpy( (TRChar *)staging.Memory.Mapped + offsets[iterator], sources[iterator].Data, sources[iterator].Size );
+    }
+
+    if ( FAILED( status = BeginCommands( impl ) ) ) goto done;
+
+    for ( iterator = 0; iterator < VulkanComputeTracerBinding_Paths; iterator++ )
+    {
+        const VkBufferCopy region = { offsets[iterator], 0, sources[iterator].Size };
+
+        if ( region.size ) vkCmdCopyBuffer( impl->commands, staging.Buffer, impl->buffers[iterator].Buffer, 1, &region );
+    }
+
+    if ( FAILED( status = ExecuteCommands( impl ) ) ) goto done;
+
+    WriteDescriptors( impl, VulkanComputeTracerBinding_Nodes, VulkanComputeTracerBinding_Paths );
+    impl->lightCount = scene->LightCount;
+    impl->camera = scene->Camera;
+    impl->loaded = true;
+
+    INFO( "Loaded %u triangles and %u BVH nodes into the compute tracer\n", scene->TriangleCount, bvh->NodeCount );
+
+done:
+    DestroyBuffer( impl, &staging );
+    pthread_mutex_unlock( &impl->lock );
+
+    return status;
+}
+
+static TR_STATUS vulkan_compute_tracer_object_Render( VulkanComputeTracerObject *iface, const RenderSettings *settings, float *out )
+{
+    struct vulkan_compute_tracer_object *impl = impl_from_VulkanComputeTracerObject( iface );
+    const VulkanPhysicalDeviceInfo *info;
+    TracerConstants constants = {};
+    Vector3 forward, right, up;
+    const float *film;
+    TRUInt pixels, groups, sample, depth, iterator;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanComputeTracer::Render" );
+
+    TRACE( "iface %p, settings %p, out %p\n", iface, settings, out );
+
+    if ( !settings || !out ) throw_NullPtrException();
+    if ( !settings->Width || !settings->Height || !settings->Samples || !settings->MaxDepth ) return T_INVALIDARG;
+
+    pixels = settings->Width * settings->Height;
+    groups = (pixels + TRACER_WORKGROUP_SIZE - 1) / TRACER_WORKGROUP_SIZE;
+
+    impl->device->lpVtbl->get_Info( impl->device, &info );
+    if ( groups > info->Properties.limits.maxComputeWorkGroupCount[0] )
+    {
+        WARN( "%ux%u pixels need more workgroups than %s can dispatch\n", settings->Width, settings->Height, info->Properties.deviceName );
+        return T_INVALIDARG;
+    }
+
+    pthread_mutex_lock( &impl->lock );
+
+    if ( !impl->loaded )
+    {
+        status = T_NOINIT;
+        goto done;
+    }
+
+    if ( FAILED( status = ReservePixels( impl, pixels ) ) || FAILED( status = BeginCommands( impl ) ) ) goto done;
+
+    // Every render is a profiler frame, read back once VULKAN_PROFILER_LATENCY more have been recorded.
+    impl->profiler->lpVtbl->BeginFrame( impl->profiler, impl->commands );
+
+    SceneCameraBasis( &impl->camera, settings->Width, settings->Height, &forward, &right, &up );
+    memcpy( constants.CameraOrigin, &impl->camera.Origin, sizeof(Vector3) );
+    memcpy( constants.CameraForward, &forward, sizeof(Vector3) );
+    memcpy( constants.CameraRight, &right, sizeof(Vector3) );
+    memcpy( constants.CameraUp, &up, sizeof(Vector3) );
+    constants.Width = settings->Width;
+    constants.Height = settings->Height;
+    constants.MaxDepth = settings->MaxDepth;
+    constants.Seed = settings->Seed;
+    constants.LightCount = impl->lightCount;
+
+    vkCmdBindDescriptorSets( impl->commands, VK_PIPELINE_BIND_POINT_COMPUTE, impl->layout, 0, 1, &impl->set, 0, nullptr );
+    vkCmdFillBuffer( impl->commands, impl->buffers[VulkanComputeTracerBinding_Film].Buffer, 0, 4 * sizeof(float) * pixels, 0 );
+
+    for ( sample = 0; sample < settings->Samples; sample++ )
+    {
+        Barrier( impl->commands );
+        for ( iterator = 0; iterator < TRACER_QUEUE_COUNT; iterator++ )
+            ResetQueue( impl, iterator );
+        Barrier( impl->commands );
+
+        constants.Sample = sample;
+        constants.Depth = 0;
+        constants.InQueue = 0;
+        vkCmdPushConstants( impl->commands, impl->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants );
+        Dispatch( impl, VulkanComputeTracerKernel_Generate, TRACER_NO_QUEUE, groups );
+
+        // Paths finishing early leave the queues short, the indirect dispatches shrink with them.
+        for ( depth = 0; depth < settings->MaxDepth; depth++ )
+        {
+            const TRUInt in = depth & 1;
+
+            Barrier( impl->commands );
+            constants.Depth = depth;
+            constants.InQueue = in;
+            vkCmdPushConstants( impl->commands, impl->layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants );
+            Dispatch( impl, VulkanComputeTracerKernel_Extend, in, 0 );
+
+            ResetQueue( impl, in ^ 1 );
+            ResetQueue( impl, TRACER_SHADOW_QUEUE );
+            Barrier( impl->commands );
+            Dispatch( impl, VulkanComputeTracerKernel_Shade, in, 0 );
+
+            Barrier( impl->commands );
+            Dispatch( impl, VulkanComputeTracerKernel_Connect, TRACER_SHADOW_QUEUE, 0 );
+        }
+    }
+
+    {
+        const VkBufferCopy region = { 0, 0, 4 * sizeof(float) * pixels };
+        VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+
+        Barrier( impl->commands );
+        vkCmdCopyBuffer( impl->commands, impl->buffers[VulkanComputeTracerBinding_Film].Buffer, impl->readback.Buffer, 1, &region );
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier( impl->commands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                              0, 1, &barrier, 0, nullptr, 0, nullptr );
+    }
+
+    if ( FAILED( status = ExecuteCommands( impl ) ) ) goto done;
+
+    {
+        TR_PERF_PHASE( "VulkanComputeTracer::Readback" );
+
+        film = impl->readback.Memory.Mapped;
+        for ( iterator = 0; iterator < pixels; iterator++ )
+        {
+            out[iterator * 3 + 0] = film[iterator * 4 + 0] / (float)settings->Samples;
+            out[iterator * 3 + 1] = film[iterator * 4 + 1] / (float)settings->Samples;
+            out[iterator * 3 + 2] = film[iterator * 4 + 2] / (float)settings->Samples;
+        }
+    }
+
+done:
+    pthread_mutex_unlock( &impl->lock );
+
+    return status;
+}
+
+static VulkanComputeTracerInterface vulkan_compute_tracer_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_compute_tracer_object_QueryInterface,
+    vulkan_compute_tracer_object_AddRef,
+    vulkan_compute_tracer_object_Release,
+    /* VulkanComputeTracerObject Methods */
+    vulkan_compute_tracer_object_LoadScene,
+    vulkan_compute_tracer_object_Render
+};
+
+static TR_STATUS
+CreatePipelines(
+    IN struct vulkan_compute_tracer_object *impl,
+    IN VulkanPipelineCacheObject *cache
+) {
+    VkDescriptorSetLayoutBinding bindings[VulkanComputeTracerBinding_Count];
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    const VkPushConstantRange constants = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(TracerConstants) };
+    VkPipelineLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    VkShaderModule modules[VulkanComputeTracerKernel_Count] = {};
+    VkComputePipelineCreateInfo pipelineInfos[VulkanComputeTracerKernel_Count];
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    TR_STATUS status = T_SUCCESS;
+    VkResult result;
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < VulkanComputeTracerBinding_Count; iterator++ )
+        bindings[iterator] = (VkDescriptorSetLayoutBinding){ iterator, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr };
+
+    setLayoutInfo.bindingCount = VulkanComputeTracerBinding_Count;
+    setLayoutInfo.pBindings = bindings;
+    if ( vkCreateDescriptorSetLayout( impl->handle, &setLayoutInfo, &VulkanAllocationCallbacks, &impl->setLayout ) != VK_SUCCESS ) return T_ERROR;
+
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &impl->setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &constants;
+    if ( vkCreatePipelineLayout( impl->handle, &layoutInfo, &VulkanAllocationCallbacks, &impl->layout ) != VK_SUCCESS ) return T_ERROR;
+
+    for ( iterator = 0; iterator < VulkanComputeTracerKernel_Count; iterator++ )
+    {
+        VkShaderModuleCreateInfo moduleInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+
+        moduleInfo.codeSize = KernelCode[iterator].Size;
+        moduleInfo.pCode = KernelCode[iterator].Code;
+        if ( vkCreateShaderModule( impl->handle, &moduleInfo, &VulkanAllocationCallbacks, &modules[iterator] ) != VK_SUCCESS )
+        {
+            status = T_ERROR;
+            goto done;
+        }
+
+        pipelineInfos[iterator] = (VkComputePipelineCreateInfo){ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+        pipelineInfos[iterator].stage = (VkPipelineShaderStageCreateInfo){ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+        pipelineInfos[iterator].stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfos[iterator].stage.module = modules[iterator];
+        pipelineInfos[iterator].stage.pName = "main";
+        pipelineInfos[iterator].layout = impl->layout;
+        pipelineInfos[iterator].basePipelineIndex = -1;
+    }
+
+    if ( cache ) cache->lpVtbl->get_Handle( cache, &pipelineCache );
+
+    {
+        TR_ZONE( "VulkanComputeTracer::CreatePipelines" );
+
+        if ( (result = vkCreateComputePipelines( impl->handle, pipelineCache, VulkanComputeTracerKernel_Count, pipelineInfos,
+                                                 &VulkanAllocationCallbacks, impl->pipelines )) != VK_SUCCESS )
+        {
+            ERROR( "Failed to create the path tracing pipelines, error was %d\n", result );
+            memset( impl->pipelines, 0, sizeof(impl->pipelines) );
+            status = T_ERROR;
+        }
+    }
+
+done:
+    // Pipelines do not need their modules once created.
+    for ( iterator = 0; iterator < VulkanComputeTracerKernel_Count; iterator++ )
+        if ( modules[iterator] ) vkDestroyShaderModule( impl->handle, modules[iterator], &VulkanAllocationCallbacks );
+
+    return status;
+}
+
+static TR_STATUS
+CreateCommands(
+    IN struct vulkan_compute_tracer_object *impl
+) {
+    const VkDescriptorPoolSize poolSize = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VulkanComputeTracerBinding_Count };
+    VkDescriptorPoolCreateInfo descriptorPoolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    VkDescriptorSetAllocateInfo setInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    VkCommandBufferAllocateInfo commandsInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    TR_STATUS status;
+
+    descriptorPoolInfo.maxSets = 1;
+    descriptorPoolInfo.poolSizeCount = 1;
+    descriptorPoolInfo.pPoolSizes = &poolSize;
+    if ( vkCreateDescriptorPool( impl->handle, &descriptorPoolInfo, &VulkanAllocationCallbacks, &impl->descriptorPool ) != VK_SUCCESS ) return T_ERROR;
+
+    setInfo.descriptorPool = impl->descriptorPool;
+    setInfo.descriptorSetCount = 1;
+    setInfo.pSetLayouts = &impl->setLayout;
+    if ( vkAllocateDescriptorSets( impl->handle, &setInfo, &impl->set ) != VK_SUCCESS ) return T_ERROR;
+
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    impl->queue->lpVtbl->get_FamilyIndex( impl->queue, &poolInfo.queueFamilyIndex );
+    if ( vkCreateCommandPool( impl->handle, &poolInfo, &VulkanAllocationCallbacks, &impl->pool ) != VK_SUCCESS ) return T_ERROR;
+
+    commandsInfo.commandPool = impl->pool;
+    commandsInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandsInfo.commandBufferCount = 1;
+    if ( vkAllocateCommandBuffers( impl->handle, &commandsInfo, &impl->commands ) != VK_SUCCESS ) return T_ERROR;
+
+    if ( vkCreateFence( impl->handle, &fenceInfo, &VulkanAllocationCallbacks, &impl->fence ) != VK_SUCCESS ) return T_ERROR;
+
+    // The queue headers do not depend on the image size.
+    if ( FAILED( status = CreateBuffer( impl, TRACER_QUEUE_COUNT * sizeof(TracerQueueHeader),
+                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, VulkanAllocationFlags_None,
+                                        &impl->buffers[VulkanComputeTracerBinding_Queues] ) ) )
+        return status;
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API new_vulkan_compute_tracer_object_override_device_and_allocator_and_cache( IN VulkanDeviceObject *device, IN VulkanAllocatorObject *allocator, OPTIONAL IN VulkanPipelineCacheObject *cache, OUT VulkanComputeTracerObject **out )
+{
+    struct vulkan_compute_tracer_object *impl;
+    const VulkanPhysicalDeviceInfo *info;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanComputeTracer::Create" );
+
+    TRACE( "device %p, allocator %p, cache %p, out %p\n", device, allocator, cache, out );
+
+    if ( !device || !allocator || !out ) throw_NullPtrException();
+
+    device->lpVtbl->get_Info( device, &info );
+    if ( info->Properties.limits.maxPerStageDescriptorStorageBuffers < VulkanComputeTracerBinding_Count )
+    {
+        WARN( "%s binds only %u storage buffers per stage, the compute tracer needs %u\n", info->Properties.deviceName,
+              info->Properties.limits.maxPerStageDescriptorStorageBuffers, VulkanComputeTracerBinding_Count );
+        return T_NOTIMPL;
+    }
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_compute_tracer_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanComputeTracerObject_iface.lpVtbl = &vulkan_compute_tracer_interface;
+    impl->device = device;
+    impl->allocator = allocator;
+    impl->ref = 1;
+
+    device->lpVtbl->AddRef( device );
+    allocator->lpVtbl->AddRef( allocator );
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    if ( FAILED( status = device->lpVtbl->GetQueue( device, VulkanQueueRole_Compute, &impl->queue ) ) ||
+         FAILED( status = new_vulkan_profiler_object_override_device_and_queue( device, impl->queue, "Compute Tracer", &impl->profiler ) ) ||
+         FAILED( status = CreatePipelines( impl, cache ) ) ||
+         FAILED( status = CreateCommands( impl ) ) )
+    {
+        ERROR( "Failed to create the compute tracer on %s\n", info->Properties.deviceName );
+        DestroyTracer( impl );
+        return status;
+    }
+
+    WriteDescriptors( impl, VulkanComputeTracerBinding_Queues, 1 );
+
+    *out = &impl->VulkanComputeTracerObject_iface;
+
+    TRACE( "created VulkanComputeTracerObject %p\n", *out );
+
+    return T_SUCCESS;
+}
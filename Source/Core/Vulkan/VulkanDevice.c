@@ -25,26 +25,25 @@
  *  Description: Vulkan device representation.
  */
 
-#include <Core/Vulkan/VulkanDevice.h>
+#include <Core/Vulkan/Vulkan.h>
+#include <Core/Instrumentation/Zones.h>
+
+#define VULKAN_NO_FAMILY ((TRUInt)-1)
 
 static struct vulkan_device_object *impl_from_VulkanDeviceObject( VulkanDeviceObject *iface )
 {
     return CONTAINING_RECORD( iface, struct vulkan_device_object, VulkanDeviceObject_iface );
 }
 
-static TR_STATUS vulkan_device_object_QueryInterface( VulkanDeviceObject *iface, const TRUUID uuid, void **out )
-{
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+DEFINE_SLAB_CACHE( vulkan_device_object, MEMORY_TAG_VULKAN );
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_VulkanDeviceObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( vulkan_device_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_device_object, VulkanDeviceObject_iface ),
+    INTERFACE_ENTRY( VulkanDeviceObject, vulkan_device_object, VulkanDeviceObject_iface ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS vulkan_device_object_QueryInterface( VulkanDeviceObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_device_object_interfaces, impl_from_VulkanDeviceObject( iface ), uuid, out );
 }
 
 static TRLong vulkan_device_object_AddRef( VulkanDeviceObject *iface )
@@ -62,54 +61,56 @@ static TRLong vulkan_device_object_Release( VulkanDeviceObject *iface )
     TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
     if ( !(removed - 1) )
     {
-        free( impl );
+        TRUInt iterator;
+
+        vkDestroyDevice( impl->device, &VulkanAllocationCallbacks );
+        for ( iterator = 0; iterator < impl->slotCount; iterator++ )
+            pthread_mutex_destroy( &impl->slots[iterator].Lock );
+
+        impl->instance->lpVtbl->Release( impl->instance );
+        SlabFree( &vulkan_device_object_cache, impl );
     }
     return removed;
 }
 
 static TR_STATUS vulkan_device_object_SupportsExtension( VulkanDeviceObject *iface, TRCString extension, TRBool *out )
 {
-    TRUInt iterator;
-    VkResult result = VK_SUCCESS;
-    TR_STATUS status = T_SUCCESS;
-    TRUInt extensionCount = 0;
-    VkExtensionProperties *extensions = nullptr;
-
     struct vulkan_device_object *impl = impl_from_VulkanDeviceObject( iface );
 
     TRACE( "iface %p, extension %s, out %p\n", iface, extension, out );
 
-    *out = false;
+    *out = VulkanInventoryHasExtension( impl->info, extension );
 
-    result = vkEnumerateDeviceExtensionProperties( impl->device, nullptr, &extensionCount, nullptr );
-    if ( result != VK_SUCCESS )
-    {
-        ERROR( "Vulkan device extension enumeration failed with %d\n", result );
-        return T_ERROR;
-    }
+    return T_SUCCESS;
+}
 
-    if (!(extensions = malloc( sizeof(VkExtensionProperties) * extensionCount ))) return T_OUTOFMEMORY;
+static TR_STATUS vulkan_device_object_GetQueue( VulkanDeviceObject *iface, VulkanQueueRole role, VulkanQueueObject **out )
+{
+    struct vulkan_device_object *impl = impl_from_VulkanDeviceObject( iface );
 
-    result = vkEnumerateDeviceExtensionProperties( impl->device, nullptr, &extensionCount, extensions );
-    if ( result != VK_SUCCESS )
-    {
-        ERROR( "Vulkan device extension enumeration failed with %d\n", result );
-        free( extensions );
-        return T_ERROR;
-    }
+    TRACE( "iface %p, role %d, out %p\n", iface, role, out );
 
-    for ( iterator = 0; iterator < extensionCount; iterator++ )
-    {
-        if ( !strcmp( extensions[iterator].extensionName, extension ) )
-        {
-            *out = true;
-            break;
-        }
-    }
+    if ( (TRUInt)role >= VulkanQueueRole_Count ) return T_INVALIDARG;
 
-    free( extensions );
+    return new_vulkan_queue_object_override_device_and_slot( iface, impl->roles[role], out );
+}
 
-    return status;
+static TR_STATUS vulkan_device_object_get_Handle( VulkanDeviceObject *iface, VkDevice *out )
+{
+    const struct vulkan_device_object *impl = impl_from_VulkanDeviceObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->device;
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_device_object_get_Info( VulkanDeviceObject *iface, const VulkanPhysicalDeviceInfo **out )
+{
+    const struct vulkan_device_object *impl = impl_from_VulkanDeviceObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->info;
+    return T_SUCCESS;
 }
 
 static VulkanDeviceInterface vulkan_device_interface =
@@ -119,24 +120,221 @@ static VulkanDeviceInterface vulkan_device_interface =
     vulkan_device_object_AddRef,
     vulkan_device_object_Release,
     /* VulkanDeviceObject Methods */
-    vulkan_device_object_SupportsExtension
-
+    vulkan_device_object_SupportsExtension,
+    vulkan_device_object_GetQueue,
+    vulkan_device_object_get_Handle,
+    vulkan_device_object_get_Info
 };
 
-TR_STATUS TR_API new_vulkan_device_object_override_device( IN VkPhysicalDevice device, OUT VulkanDeviceObject **out )
+static TRUInt
+FindQueueFamily(
+    IN const VulkanPhysicalDeviceInfo *info,
+    IN VkQueueFlags required,
+    IN VkQueueFlags excluded
+) {
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < info->QueueFamilyCount; iterator++ )
+    {
+        const VkQueueFlags flags = info->QueueFamilies[iterator].queueFlags;
+
+        if ( info->QueueFamilies[iterator].queueCount && (flags & required) == required && !(flags & excluded) )
+            return iterator;
+    }
+
+    return VULKAN_NO_FAMILY;
+}
+
+/**
+ * Compute prefers a family without graphics, the asynchronous compute queues, and
+ * transfer one without either, the DMA engines. A role without a family of its own
+ * gets another queue of a family already in use, and shares that family's last
+ * queue once the family runs out.
+ */
+static void
+AssignQueues(
+    IN OUT struct vulkan_device_object *impl,
+    OUT TRUInt *families
+) {
+    const VulkanPhysicalDeviceInfo *info = impl->info;
+    TRUInt family[VulkanQueueRole_Count];
+    TRUInt role, iterator;
+
+    if ( (family[VulkanQueueRole_Graphics] = FindQueueFamily( info, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0 )) == VULKAN_NO_FAMILY )
+        family[VulkanQueueRole_Graphics] = FindQueueFamily( info, VK_QUEUE_GRAPHICS_BIT, 0 );
+
+    if ( (family[VulkanQueueRole_Compute] = FindQueueFamily( info, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT )) == VULKAN_NO_FAMILY )
+        family[VulkanQueueRole_Compute] = family[VulkanQueueRole_Graphics];
+
+    // Graphics and compute queues can always transfer, even when they don't say so.
+    if ( (family[VulkanQueueRole_Transfer] = FindQueueFamily( info, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT )) == VULKAN_NO_FAMILY )
+        family[VulkanQueueRole_Transfer] = family[VulkanQueueRole_Compute];
+
+    impl->slotCount = 0;
+
+    for ( role = 0; role < VulkanQueueRole_Count; role++ )
+    {
+        const TRUInt available = info->QueueFamilies[family[role]].queueCount;
+        VulkanQueueSlot *last = nullptr;
+
+        for ( iterator = 0; iterator < impl->slotCount; iterator++ )
+            if ( impl->slots[iterator].Family == family[role] )
+                last = &impl->slots[iterator];
+
+        if ( last && last->Index + 1 >= available )
+        {
+            impl->roles[role] = last;
+            continue;
+        }
+
+        impl->roles[role] = &impl->slots[impl->slotCount++];
+        impl->roles[role]->Family = family[role];
+        impl->roles[role]->Index = last ? last->Index + 1 : 0;
+    }
+
+    for ( role = 0; role < VulkanQueueRole_Count; role++ )
+        families[role] = family[role];
+}
+
+static TRCString
+QueueSharing(
+    IN const struct vulkan_device_object *impl,
+    IN VulkanQueueRole role
+) {
+    if ( impl->roles[role] == impl->roles[VulkanQueueRole_Graphics] )
+        return "shared with graphics";
+    if ( role == VulkanQueueRole_Transfer && impl->roles[role] == impl->roles[VulkanQueueRole_Compute] )
+        return "shared with compute";
+    if ( impl->roles[role]->Family == impl->roles[VulkanQueueRole_Graphics]->Family )
+        return "own queue, graphics family";
+    return "dedicated family";
+}
+
+static TR_STATUS
+CreateLogicalDevice(
+    IN OUT struct vulkan_device_object *impl
+) {
+    static const float priorities[VulkanQueueRole_Count] = { 1.0f, 1.0f, 1.0f };
+    VkDeviceQueueCreateInfo queueInfos[VulkanQueueRole_Count] = {0};
+    VkDeviceCreateInfo createInfo = {0};
+    VkPhysicalDeviceVulkan12Features features12 = {0};
+    VkPhysicalDeviceAccelerationStructureFeaturesKHR accelerationFeatures = {0};
+    TRCString extensions[5];
+    TRUInt families[VulkanQueueRole_Count];
+    TRUInt queueInfoCount = 0, extensionCount = 0;
+    TRUInt iterator, search;
+    VkResult result;
+
+    const VulkanPhysicalDeviceInfo *info = impl->info;
+
+    TR_ZONE( "VulkanDevice::CreateLogicalDevice" );
+
+    AssignQueues( impl, families );
+
+    for ( iterator = 0; iterator < impl->slotCount; iterator++ )
+    {
+        for ( search = 0; search < queueInfoCount; search++ )
+            if ( queueInfos[search].queueFamilyIndex == impl->slots[iterator].Family )
+                break;
+
+        if ( search == queueInfoCount )
+        {
+            queueInfos[queueInfoCount].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueInfos[queueInfoCount].queueFamilyIndex = impl->slots[iterator].Family;
+            queueInfos[queueInfoCount].pQueuePriorities = priorities;
+            queueInfoCount++;
+        }
+
+        queueInfos[search].queueCount++;
+    }
+
+    if ( VulkanInventoryHasExtension( info, VK_KHR_SWAPCHAIN_EXTENSION_NAME ) )
+        extensions[extensionCount++] = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+
+    if ( info->CalibratedTimestamps )
+        extensions[extensionCount++] = VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME;
+
+    if ( info->AccelerationStructures )
+    {
+        extensions[extensionCount++] = VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME;
+        extensions[extensionCount++] = VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME;
+    }
+
+    if ( info->RayTracing )
+        extensions[extensionCount++] = VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME;
+
+    // Timeline semaphores pace the staging ring, device addresses feed acceleration structure builds.
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.timelineSemaphore = info->Features12.timelineSemaphore;
+    features12.bufferDeviceAddress = info->Features12.bufferDeviceAddress;
+
+    if ( info->AccelerationStructures )
+    {
+        accelerationFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR;
+        accelerationFeatures.accelerationStructure = VK_TRUE;
+        features12.pNext = &accelerationFeatures;
+    }
+
+    createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = info->Features12.sType ? &features12 : nullptr;
+    createInfo.queueCreateInfoCount = queueInfoCount;
+    createInfo.pQueueCreateInfos = queueInfos;
+    createInfo.enabledExtensionCount = extensionCount;
+    createInfo.ppEnabledExtensionNames = extensions;
+
+    result = vkCreateDevice( info->Device, &createInfo, &VulkanAllocationCallbacks, &impl->device );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Vulkan logical device creation on %s failed with %d\n", info->Properties.deviceName, result );
+        return T_ERROR;
+    }
+
+    for ( iterator = 0; iterator < impl->slotCount; iterator++ )
+    {
+        vkGetDeviceQueue( impl->device, impl->slots[iterator].Family, impl->slots[iterator].Index, &impl->slots[iterator].Queue );
+        pthread_mutex_init( &impl->slots[iterator].Lock, nullptr );
+    }
+
+    INFO( "Vulkan: %s queues: graphics family %u, compute family %u (%s), transfer family %u (%s)\n",
+          info->Properties.deviceName, families[VulkanQueueRole_Graphics],
+          families[VulkanQueueRole_Compute], QueueSharing( impl, VulkanQueueRole_Compute ),
+          families[VulkanQueueRole_Transfer], QueueSharing( impl, VulkanQueueRole_Transfer ) );
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API new_vulkan_device_object_override_device( IN VulkanObject *instance, IN const VulkanPhysicalDeviceInfo *info, OUT VulkanDeviceObject **out )
 {
+    TR_STATUS status;
     struct vulkan_device_object *impl;
 
-    TRACE( "out %p\n", out );
+    TRACE( "instance %p, info %p, out %p\n", instance, info, out );
 
-    if ( !out ) throw_NullPtrException();
+    if ( !instance || !info || !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &vulkan_device_object_cache ))) return T_OUTOFMEMORY;
     impl->VulkanDeviceObject_iface.lpVtbl = &vulkan_device_interface;
-    impl->device = device;
+    impl->instance = instance;
+    impl->info = info;
+    impl->device = VK_NULL_HANDLE;
     impl->ref = 1;
 
+    if ( !info->Score )
+    {
+        ERROR( "Vulkan device %s has no graphics queue\n", info->Properties.deviceName );
+        SlabFree( &vulkan_device_object_cache, impl );
+        return T_NOINIT;
+    }
+
+    if ( FAILED( status = CreateLogicalDevice( impl ) ) )
+    {
+        SlabFree( &vulkan_device_object_cache, impl );
+        return status;
+    }
+
+    instance->lpVtbl->AddRef( instance );
+
     *out = &impl->VulkanDeviceObject_iface;
 
     TRACE( "created VulkanDeviceObject %p\n", *out );
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanInventory.c
+ *  Description: One time snapshot and scoring of the physical devices of an instance.
+ */
+
+#include <string.h>
+
+#include <Core/Vulkan/VulkanInventory.h>
+#include <Core/Instrumentation/Zones.h>
+#include <Core/Memory/Memory.h>
+#include <IO/Logging.h>
+
+#define INVENTORY_MIB (1024ull * 1024ull)
+#define INVENTORY_VRAM_BITS 48
+
+static TRUInt
+ExtensionHash(
+    IN TRCString name
+) {
+    // FNV-1a
+    TRUInt hash = 2166136261u;
+
+    while ( *name )
+    {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static TR_STATUS
+BuildExtensionSet(
+    IN OUT VulkanPhysicalDeviceInfo *info
+) {
+    TRUInt buckets = 16;
+    TRUInt iterator;
+
+    // At most half full, so probe chains stay short.
+    while ( buckets < info->ExtensionCount * 2 )
+        buckets <<= 1;
+
+    if (!(info->ExtensionSet = TRCalloc( buckets, sizeof(TRUInt), MEMORY_TAG_VULKAN ))) return T_OUTOFMEMORY;
+    info->ExtensionSetMask = buckets - 1;
+
+    for ( iterator = 0; iterator < info->ExtensionCount; iterator++ )
+    {
+        TRUInt bucket = ExtensionHash( info->Extensions[iterator].extensionName ) & info->ExtensionSetMask;
+
+        while ( info->ExtensionSet[bucket] )
+            bucket = (bucket + 1) & info->ExtensionSetMask;
+
+        info->ExtensionSet[bucket] = iterator + 1;
+    }
+
+    return T_SUCCESS;
+}
+
+static TRULong
+TypeRank(
+    IN VkPhysicalDeviceType type
+) {
+    switch ( type )
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return 4;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 3;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return 2;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:            return 0; // lavapipe and friends
+        default:                                     return 1;
+    }
+}
+
+static TRCString
+TypeName(
+    IN VkPhysicalDeviceType type
+) {
+    switch ( type )
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return "discrete";
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return "integrated";
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return "virtual";
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:            return "cpu";
+        default:                                     return "other";
+    }
+}
+
+/**
+ * Compared as a plain number: the device type first, then ray tracing support, then
+ * device local memory in MiB. One more bit keeps a CPU device above an unusable one.
+ */
+static void
+ScoreDevice(
+    IN OUT VulkanPhysicalDeviceInfo *info
+) {
+    TRULong vram = info->DeviceLocalBytes / INVENTORY_MIB;
+    TRBool graphics = false;
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < info->QueueFamilyCount; iterator++ )
+        if ( info->QueueFamilies[iterator].queueFlags & VK_QUEUE_GRAPHICS_BIT )
+            graphics = true;
+
+    if ( !graphics )
+    {
+        info->Score = 0;
+        return;
+    }
+
+    if ( vram >= (1ull << INVENTORY_VRAM_BITS) )
+        vram = (1ull << INVENTORY_VRAM_BITS) - 1;
+
+    info->Score = (TypeRank( info->Properties.deviceType ) + 1) << 56
+                | (TRULong)(info->RayTracing ? 1 : 0) << INVENTORY_VRAM_BITS
+                | vram;
+}
+
+// Whether device timestamps can be read together with CLOCK_MONOTONIC, the clock zones use.
+static TRBool
+SupportsMonotonicCalibration(
+    IN VkInstance instance,
+    IN const VulkanPhysicalDeviceInfo *info
+) {
+    PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT getTimeDomains;
+    VkTimeDomainEXT domains[8];
+    TRUInt domainCount = sizeof(domains) / sizeof(*domains);
+    TRUInt iterator;
+
+    if ( !VulkanInventoryHasExtension( info, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME ) ) return false;
+
+    getTimeDomains = (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)
+        vkGetInstanceProcAddr( instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT" );
+    if ( !getTimeDomains ) return false;
+
+    if ( getTimeDomains( info->Device, &domainCount, domains ) < VK_SUCCESS ) return false;
+
+    for ( iterator = 0; iterator < domainCount; iterator++ )
+        if ( domains[iterator] == VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT )
+            return true;
+
+    return false;
+}
+
+static void
+QueryAccelerationStructures(
+    IN OUT VulkanPhysicalDeviceInfo *info
+) {
+    VkPhysicalDeviceFeatures2 features = {0};
+    VkPhysicalDeviceProperties2 properties = {0};
+
+    info->AccelerationStructureFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR;
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &info->AccelerationStructureFeatures;
+    vkGetPhysicalDeviceFeatures2( info->Device, &features );
+    info->AccelerationStructureFeatures.pNext = nullptr;
+
+    info->AccelerationStructureProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &info->AccelerationStructureProperties;
+    vkGetPhysicalDeviceProperties2( info->Device, &properties );
+    info->AccelerationStructureProperties.pNext = nullptr;
+}
+
+static TR_STATUS
+SnapshotDevice(
+    IN VkInstance instance,
+    IN VkPhysicalDevice device,
+    OUT VulkanPhysicalDeviceInfo *info
+) {
+    VkResult result;
+    TRUInt iterator;
+
+    info->Device = device;
+
+    vkGetPhysicalDeviceProperties( device, &info->Properties );
+    vkGetPhysicalDeviceFeatures( device, &info->Features );
+
+    if ( VK_API_VERSION_MAJOR( info->Properties.apiVersion ) > 1 || VK_API_VERSION_MINOR( info->Properties.apiVersion ) >= 2 )
+    {
+        VkPhysicalDeviceFeatures2 features = {0};
+
+        info->Features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &info->Features12;
+
+        vkGetPhysicalDeviceFeatures2( device, &features );
+        info->Features12.pNext = nullptr;
+    }
+    vkGetPhysicalDeviceMemoryProperties( device, &info->Memory );
+
+    vkGetPhysicalDeviceQueueFamilyProperties( device, &info->QueueFamilyCount, nullptr );
+    if ( info->QueueFamilyCount &&
+         !(info->QueueFamilies = TRAlloc( sizeof(VkQueueFamilyProperties) * info->QueueFamilyCount, MEMORY_TAG_VULKAN )) )
+        return T_OUTOFMEMORY;
+    vkGetPhysicalDeviceQueueFamilyProperties( device, &info->QueueFamilyCount, info->QueueFamilies );
+
+    result = vkEnumerateDeviceExtensionProperties( device, nullptr, &info->ExtensionCount, nullptr );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Vulkan device extension enumeration failed with %d\n", result );
+        return T_ERROR;
+    }
+
+    if ( info->ExtensionCount &&
+         !(info->Extensions = TRAlloc( sizeof(VkExtensionProperties) * info->ExtensionCount, MEMORY_TAG_VULKAN )) )
+        return T_OUTOFMEMORY;
+
+    result = vkEnumerateDeviceExtensionProperties( device, nullptr, &info->ExtensionCount, info->Extensions );
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Vulkan device extension enumeration failed with %d\n", result );
+        return T_ERROR;
+    }
+
+    if ( FAILED( BuildExtensionSet( info ) ) ) return T_OUTOFMEMORY;
+
+    if ( info->Features12.sType && VulkanInventoryHasExtension( info, VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME ) )
+        QueryAccelerationStructures( info );
+
+    for ( iterator = 0; iterator < info->Memory.memoryHeapCount; iterator++ )
+        if ( info->Memory.memoryHeaps[iterator].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT )
+            info->DeviceLocalBytes += info->Memory.memoryHeaps[iterator].size;
+
+    info->AccelerationStructures = VulkanInventoryHasExtension( info, VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME )
+                                && VulkanInventoryHasExtension( info, VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME )
+                                && info->AccelerationStructureFeatures.accelerationStructure
+                                && info->Features12.bufferDeviceAddress;
+    info->RayTracing = info->AccelerationStructures
+                    && VulkanInventoryHasExtension( info, VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME );
+    info->CalibratedTimestamps = SupportsMonotonicCalibration( instance, info );
+
+    ScoreDevice( info );
+
+    INFO( "Vulkan: found %s (%s), %llu MiB device local, ray tracing %s, score %#llx\n",
+          info->Properties.deviceName, TypeName( info->Properties.deviceType ),
+          (unsigned long long)(info->DeviceLocalBytes / INVENTORY_MIB), info->RayTracing ? "yes" : "no",
+          (unsigned long long)info->Score );
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API
+VulkanInventoryCreate(
+    IN VkInstance instance,
+    OUT VulkanPhysicalDeviceInfo **devices,
+    OUT TRUInt *count
+) {
+    TR_STATUS status;
+    VkResult result;
+    VkPhysicalDevice *vkDevices;
+    VulkanPhysicalDeviceInfo *infos;
+    TRUInt deviceCount = 0;
+    TRUInt iterator;
+
+    TR_ZONE( "Vulkan::Inventory" );
+
+    if ( !devices || !count ) throw_NullPtrException();
+
+    *devices = nullptr;
+    *count = 0;
+
+    result = vkEnumeratePhysicalDevices( instance, &deviceCount, nullptr );
+    if ( result != VK_SUCCESS || !deviceCount )
+    {
+        ERROR( "Vulkan device enumeration failed with %d\n", result );
+        return T_ERROR;
+    }
+
+    if (!(vkDevices = TRAlloc( sizeof(VkPhysicalDevice) * deviceCount, MEMORY_TAG_VULKAN ))) return T_OUTOFMEMORY;
+
+    result = vkEnumeratePhysicalDevices( instance, &deviceCount, vkDevices );
+    if ( result != VK_SUCCESS && result != VK_INCOMPLETE )
+    {
+        ERROR( "Vulkan device enumeration failed with %d\n", result );
+        TRFree( vkDevices );
+        return T_ERROR;
+    }
+
+    if (!(infos = TRCalloc( deviceCount, sizeof(VulkanPhysicalDeviceInfo), MEMORY_TAG_VULKAN )))
+    {
+        TRFree( vkDevices );
+        return T_OUTOFMEMORY;
+    }
+
+    for ( iterator = 0; iterator < deviceCount; iterator++ )
+    {
+        if ( FAILED( status = SnapshotDevice( instance, vkDevices[iterator], &infos[iterator] ) ) )
+        {
+            VulkanInventoryFree( infos, deviceCount );
+            TRFree( vkDevices );
+            return status;
+        }
+    }
+
+    TRFree( vkDevices );
+
+    *devices = infos;
+    *count = deviceCount;
+
+    return T_SUCCESS;
+}
+
+void TR_API
+VulkanInventoryFree(
+    IN VulkanPhysicalDeviceInfo *devices,
+    IN TRUInt count
+) {
+    TRUInt iterator;
+
+    if ( !devices )
+        return;
+
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        TRFree( devices[iterator].QueueFamilies );
+        TRFree( devices[iterator].Extensions );
+        TRFree( devices[iterator].ExtensionSet );
+    }
+
+    TRFree( devices );
+}
+
+TRBool TR_API
+VulkanInventoryHasExtension(
+    IN const VulkanPhysicalDeviceInfo *info,
+    IN TRCString extension
+) {
+    TRUInt bucket = ExtensionHash( extension ) & info->ExtensionSetMask;
+
+    while ( info->ExtensionSet[bucket] )
+    {
+        if ( !strcmp( info->Extensions[info->ExtensionSet[bucket] - 1].extensionName, extension ) )
+            return true;
+
+        bucket = (bucket + 1) & info->ExtensionSetMask;
+    }
+
+    return false;
+}
+
+TR_STATUS TR_API
+VulkanInventoryBest(
+    IN const VulkanPhysicalDeviceInfo *devices,
+    IN TRUInt count,
+    OUT const VulkanPhysicalDeviceInfo **out
+) {
+    const VulkanPhysicalDeviceInfo *best = nullptr;
+    TRUInt iterator;
+
+    if ( !out ) throw_NullPtrException();
+
+    for ( iterator = 0; iterator < count; iterator++ )
+        if ( devices[iterator].Score && (!best || devices[iterator].Score > best->Score) )
+            best = &devices[iterator];
+
+    if ( !(*out = best) )
+        return T_NOINIT;
+
+    return T_SUCCESS;
+}
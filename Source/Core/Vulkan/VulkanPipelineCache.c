@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanPipelineCache.c
+ *  Description: Keeps compiled pipelines on disk between runs.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include <Core/Vulkan/VulkanPipelineCache.h>
+#include <Core/Instrumentation/Zones.h>
+#include <Core/Memory/Memory.h>
+
+#define PIPELINE_CACHE_MAGIC 0x43505254u            // "TRPC"
+#define PIPELINE_CACHE_VERSION 1
+#define PIPELINE_CACHE_MAX_SIZE (256ull << 20)      // Anything larger is not something we wrote
+
+/**
+ * Precedes the driver's blob, whose own header only tells the device it was made for.
+ * The checksum catches files cut short, drivers are not required to.
+ */
+typedef struct _TR_PipelineCacheFileHeader
+{
+    TRUInt Magic;
+    TRUInt Version;
+    TRULong Size;
+    TRUInt Checksum;
+    TRUInt Reserved;
+} PipelineCacheFileHeader;
+
+static struct vulkan_pipeline_cache_object *impl_from_VulkanPipelineCacheObject( VulkanPipelineCacheObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_pipeline_cache_object, VulkanPipelineCacheObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_pipeline_cache_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_pipeline_cache_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_pipeline_cache_object, VulkanPipelineCacheObject_iface ),
+    INTERFACE_ENTRY( VulkanPipelineCacheObject, vulkan_pipeline_cache_object, VulkanPipelineCacheObject_iface ) );
+
+static TR_STATUS
+MakeDirectories(
+    IN TRString path
+) {
+    for ( TRString iter = path + 1; ; iter++ )
+    {
+        if ( *iter != '/' && *iter != '\0' ) continue;
+
+        const TRChar separator = *iter;
+        *iter = '\0';
+        const TRInt result = mkdir( path, 0700 );
+        *iter = separator;
+
+        if ( result && errno != EEXIST ) return T_ACCESSDENIED;
+        if ( separator == '\0' ) return T_SUCCESS;
+    }
+}
+
+// $XDG_CACHE_HOME/TraceRayer/pipelines/<vendor>-<device>-<driver>-<uuid>.bin
+static TR_STATUS
+CacheFilePath(
+    IN const VulkanPhysicalDeviceInfo *info,
+    OUT TRString *out
+) {
+    TRCString base = getenv( "XDG_CACHE_HOME" );
+    TRCString suffix = "";
+    TRString path;
+    TR_STATUS status;
+    TRInt length;
+    TRUInt i;
+
+    // Relative paths are invalid per the XDG spec and have to be ignored.
+    if ( !base || *base != '/' )
+    {
+        if ( !(base = getenv( "HOME" )) || *base != '/' ) return T_FILE_NOT_FOUND;
+        suffix = "/.cache";
+    }
+
+    if (!(path = TRAlloc( PATH_MAX, MEMORY_TAG_PATH ))) return T_OUTOFMEMORY;
+
+    length = snprintf( path, PATH_MAX, "%s%s/TraceRayer/pipelines", base, suffix );
+    if ( length >= PATH_MAX - 64 )
+    {
+        TRFree( path );
+        return T_INVALIDARG;
+    }
+
+    if ( FAILED( status = MakeDirectories( path ) ) )
+    {
+        TRFree( path );
+        return status;
+    }
+
+    length += snprintf( path + length, PATH_MAX - length, "/%08x-%08x-%08x-",
+                        info->Properties.vendorID, info->Properties.deviceID, info->Properties.driverVersion );
+    for ( i = 0; i < VK_UUID_SIZE; i++ )
+        length += snprintf( path + length, PATH_MAX - length, "%02x", info->Properties.pipelineCacheUUID[i] );
+    snprintf( path + length, PATH_MAX - length, ".bin" );
+
+    *out = path;
+    return T_SUCCESS;
+}
+
+static TRCString
+ValidateBlob(
+    IN const VulkanPhysicalDeviceInfo *info,
+    IN const PipelineCacheFileHeader *header,
+    IN const void *blob
+) {
+    VkPipelineCacheHeaderVersionOne driverHeader;
+
+    if ( crc32( 0, blob, header->Size ) != header->Checksum ) return "checksum mismatch";
+    if ( header->Size < sizeof(driverHeader) ) return "truncated";
+
+    memcpy( &driverHeader, blob, sizeof(driverHeader) );
+    if ( driverHeader.headerSize < sizeof(driverHeader) || driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE )
+        return "unknown header";
+
+    if ( driverHeader.vendorID != info->Properties.vendorID || driverHeader.deviceID != info->Properties.deviceID ||
+         memcmp( driverHeader.pipelineCacheUUID, info->Properties.pipelineCacheUUID, VK_UUID_SIZE ) )
+        return "made for another device or driver";
+
+    return nullptr;
+}
+
+// Leaves *out nullptr on a cold start or when the file cannot be trusted.
+static void
+LoadBlob(
+    IN const struct vulkan_pipeline_cache_object *impl,
+    IN const VulkanPhysicalDeviceInfo *info,
+    OUT void **out,
+    OUT TRSize *size
+) {
+    PipelineCacheFileHeader header;
+    TRCString reason = nullptr;
+    void *blob = nullptr;
+    FILE *file;
+
+    TR_ZONE( "VulkanPipelineCache::Load" );
+
+    *out = nullptr;
+    *size = 0;
+
+    if ( !(file = fopen( impl->path, "rb" )) ) return;
+
+    if ( fread( &header, sizeof(header), 1, file ) != 1 || header.Magic != PIPELINE_CACHE_MAGIC )
+        reason = "not a pipeline cache";
+    else if ( header.Version != PIPELINE_CACHE_VERSION )
+        reason = "unsupported version";
+    else if ( header.Size > PIPELINE_CACHE_MAX_SIZE )
+        reason = "too large";
+    else if ( !(blob = TRAlloc( header.Size, MEMORY_TAG_VULKAN )) )
+        reason = "out of memory";
+    else if ( fread( blob, 1, header.Size, file ) != header.Size || fgetc( file ) != EOF )
+        reason = "truncated";
+    else
+        reason = ValidateBlob( info, &header, blob );
+
+    fclose( file );
+
+    if ( reason )
+    {
+        WARN( "Ignoring pipeline cache %s: %s\n", impl->path, reason );
+        TRFree( blob );
+        return;
+    }
+
+    *out = blob;
+    *size = header.Size;
+}
+
+static TR_STATUS
+WriteAll(
+    IN TRInt fd,
+    IN const void *data,
+    IN TRSize size
+) {
+    const TRChar *iter = data;
+
+    while ( size )
+    {
+        const ssize_t written = write( fd, iter, size );
+
+        if ( written < 0 && errno == EINTR ) continue;
+        if ( written <= 0 ) return T_ERROR;
+
+        iter += written;
+        size -= written;
+    }
+
+    return T_SUCCESS;
+}
+
+// Written next to the destination and renamed over it, so readers only ever see whole files.
+static TR_STATUS
+WriteAtomically(
+    IN TRCString path,
+    IN const PipelineCacheFileHeader *header,
+    IN const void *blob
+) {
+    TRChar temporary[PATH_MAX];
+    TR_STATUS status;
+    TRInt fd;
+
+    snprintf( temporary, sizeof(temporary), "%s.XXXXXX", path );
+    if ( (fd = mkstemp( temporary )) < 0 ) return T_ACCESSDENIED;
+
+    status = WriteAll( fd, header, sizeof(*header) );
+    if ( !FAILED( status ) ) status = WriteAll( fd, blob, header->Size );
+    if ( !FAILED( status ) && fsync( fd ) ) status = T_ERROR;
+    if ( close( fd ) ) status = T_ERROR;
+    if ( !FAILED( status ) && rename( temporary, path ) ) status = T_ERROR;
+
+    if ( FAILED( status ) ) unlink( temporary );
+
+    return status;
+}
+
+static TR_STATUS vulkan_pipeline_cache_object_QueryInterface( VulkanPipelineCacheObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_pipeline_cache_object_interfaces, impl_from_VulkanPipelineCacheObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_pipeline_cache_object_AddRef( VulkanPipelineCacheObject *iface )
+{
+    struct vulkan_pipeline_cache_object *impl = impl_from_VulkanPipelineCacheObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TR_STATUS vulkan_pipeline_cache_object_Save( VulkanPipelineCacheObject *iface );
+
+static TRLong vulkan_pipeline_cache_object_Release( VulkanPipelineCacheObject *iface )
+{
+    struct vulkan_pipeline_cache_object *impl = impl_from_VulkanPipelineCacheObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) )
+    {
+        if ( impl->cache )
+        {
+            vulkan_pipeline_cache_object_Save( iface );
+            vkDestroyPipelineCache( impl->handle, impl->cache, &VulkanAllocationCallbacks );
+        }
+        TRFree( impl->path );
+        pthread_mutex_destroy( &impl->lock );
+        impl->device->lpVtbl->Release( impl->device );
+        SlabFree( &vulkan_pipeline_cache_object_cache, impl );
+    }
+    return removed;
+}
+
+static TR_STATUS vulkan_pipeline_cache_object_get_Handle( VulkanPipelineCacheObject *iface, VkPipelineCache *out )
+{
+    const struct vulkan_pipeline_cache_object *impl = impl_from_VulkanPipelineCacheObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->cache;
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_pipeline_cache_object_get_LoadedSize( VulkanPipelineCacheObject *iface, TRSize *out )
+{
+    const struct vulkan_pipeline_cache_object *impl = impl_from_VulkanPipelineCacheObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->loadedSize;
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_pipeline_cache_object_Save( VulkanPipelineCacheObject *iface )
+{
+    struct vulkan_pipeline_cache_object *impl = impl_from_VulkanPipelineCacheObject( iface );
+    PipelineCacheFileHeader header = { PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION };
+    TR_STATUS status = T_SUCCESS;
+    void *blob = nullptr;
+    VkResult result;
+    TRSize size;
+
+    TR_ZONE( "VulkanPipelineCache::Save" );
+
+    TRACE( "iface %p\n", iface );
+
+    // Kept in memory only when there is nowhere to put it.
+    if ( !impl->path ) return T_SUCCESS;
+
+    pthread_mutex_lock( &impl->lock );
+
+    // Caches only grow, the same size means nothing new was compiled.
+    do
+    {
+        TRFree( blob );
+        blob = nullptr;
+
+        if ( (result = vkGetPipelineCacheData( impl->handle, impl->cache, &size, nullptr )) != VK_SUCCESS ) break;
+        if ( size == impl->savedSize ) break;
+
+        if (!(blob = TRAlloc( size, MEMORY_TAG_VULKAN )))
+        {
+            status = T_OUTOFMEMORY;
+            break;
+        }
+    } while ( (result = vkGetPipelineCacheData( impl->handle, impl->cache, &size, blob )) == VK_INCOMPLETE );
+
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Failed to read back the pipeline cache, error was %d\n", result );
+        status = T_ERROR;
+    }
+    else if ( blob )
+    {
+        header.Size = size;
+        header.Checksum = crc32( 0, blob, size );
+
+        if ( FAILED( status = WriteAtomically( impl->path, &header, blob ) ) )
+            ERROR( "Failed to write the pipeline cache to %s\n", impl->path );
+        else
+        {
+            INFO( "Saved %zu bytes of pipelines to %s\n", size, impl->path );
+            impl->savedSize = size;
+        }
+    }
+
+    pthread_mutex_unlock( &impl->lock );
+
+    TRFree( blob );
+
+    return status;
+}
+
+static VulkanPipelineCacheInterface vulkan_pipeline_cache_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_pipeline_cache_object_QueryInterface,
+    vulkan_pipeline_cache_object_AddRef,
+    vulkan_pipeline_cache_object_Release,
+    /* VulkanPipelineCacheObject Methods */
+    vulkan_pipeline_cache_object_get_Handle,
+    vulkan_pipeline_cache_object_get_LoadedSize,
+    vulkan_pipeline_cache_object_Save
+};
+
+TR_STATUS TR_API new_vulkan_pipeline_cache_object_override_device( IN VulkanDeviceObject *device, OUT VulkanPipelineCacheObject **out )
+{
+    VkPipelineCacheCreateInfo createInfo = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    struct vulkan_pipeline_cache_object *impl;
+    const VulkanPhysicalDeviceInfo *info;
+    void *blob = nullptr;
+    TR_STATUS status;
+    VkResult result;
+
+    TR_ZONE( "VulkanPipelineCache::Create" );
+
+    TRACE( "device %p, out %p\n", device, out );
+
+    if ( !device || !out ) throw_NullPtrException();
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_pipeline_cache_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanPipelineCacheObject_iface.lpVtbl = &vulkan_pipeline_cache_interface;
+    impl->device = device;
+    impl->ref = 1;
+
+    device->lpVtbl->AddRef( device );
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    device->lpVtbl->get_Info( device, &info );
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    if ( FAILED( status = CacheFilePath( info, &impl->path ) ) )
+        WARN( "No cache directory for pipelines, they are compiled again on every run. Error was %d\n", status );
+    else
+        LoadBlob( impl, info, &blob, &impl->loadedSize );
+
+    createInfo.initialDataSize = impl->loadedSize;
+    createInfo.pInitialData = blob;
+    result = vkCreatePipelineCache( impl->handle, &createInfo, &VulkanAllocationCallbacks, &impl->cache );
+
+    // Drivers may still turn down a blob they wrote, start over rather than going without a cache.
+    if ( result != VK_SUCCESS && blob )
+    {
+        WARN( "The driver rejected the pipeline cache %s with %d, starting empty\n", impl->path, result );
+        impl->loadedSize = 0;
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache( impl->handle, &createInfo, &VulkanAllocationCallbacks, &impl->cache );
+    }
+
+    TRFree( blob );
+
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Failed to create a pipeline cache, error was %d\n", result );
+        vulkan_pipeline_cache_object_Release( &impl->VulkanPipelineCacheObject_iface );
+        return T_ERROR;
+    }
+
+    impl->savedSize = impl->loadedSize;
+
+    if ( impl->loadedSize )
+        INFO( "Loaded %zu bytes of pipelines from %s\n", impl->loadedSize, impl->path );
+
+    *out = &impl->VulkanPipelineCacheObject_iface;
+
+    TRACE( "created VulkanPipelineCacheObject %p\n", *out );
+
+    return T_SUCCESS;
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanProfiler.c
+ *  Description: GPU scope timing with timestamp queries, read back a few frames late.
+ */
+
+#include <string.h>
+
+#include <Core/Vulkan/VulkanProfiler.h>
+
+#define PROFILER_FRAME_QUERIES (VULKAN_PROFILER_MAX_SCOPES * 2)
+
+static struct vulkan_profiler_object *impl_from_VulkanProfilerObject( VulkanProfilerObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_profiler_object, VulkanProfilerObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_profiler_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_profiler_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_profiler_object, VulkanProfilerObject_iface ),
+    INTERFACE_ENTRY( VulkanProfilerObject, vulkan_profiler_object, VulkanProfilerObject_iface ) );
+
+static inline TRULong
+TicksToNanoseconds(
+    IN const struct vulkan_profiler_object *impl,
+    IN TRULong from,
+    IN TRULong to
+) {
+    return (TRULong)((TRFloat)((to - from) & impl->validMask) * impl->period);
+}
+
+/**
+ * Turns the frame's queries into results, skipping scopes the device has not finished or
+ * that were never ended. Must be called with the lock held.
+ */
+static void
+ResolveFrame(
+    IN struct vulkan_profiler_object *impl,
+    IN TRUInt slot
+) {
+    VulkanProfilerFrame *frame = &impl->frames[slot];
+    TRULong queries[PROFILER_FRAME_QUERIES][2];     // Value and availability
+    TRULong gpuNow = 0, cpuNow = 0, origin = 0;
+    TRBool calibrated = false, first = true;
+    TRUInt count = atomic_load( &frame->Count );
+    TRUInt iterator;
+    VkResult result;
+
+    impl->resultCount = 0;
+
+    if ( count > VULKAN_PROFILER_MAX_SCOPES ) count = VULKAN_PROFILER_MAX_SCOPES;
+    if ( !count ) return;
+
+    result = vkGetQueryPoolResults( impl->handle, impl->pool, slot * PROFILER_FRAME_QUERIES, count * 2,
+                                    sizeof(queries), queries, sizeof(*queries),
+                                    VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT );
+    if ( result != VK_SUCCESS && result != VK_NOT_READY ) return;
+
+    if ( impl->getCalibratedTimestamps )
+    {
+        const VkCalibratedTimestampInfoEXT domains[2] =
+        {
+            { VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, nullptr, VK_TIME_DOMAIN_DEVICE_EXT },
+            { VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, nullptr, VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT }
+        };
+        TRULong now[2], deviation;
+
+        if ( impl->getCalibratedTimestamps( impl->handle, 2, domains, now, &deviation ) == VK_SUCCESS )
+        {
+            gpuNow = now[0];
+            cpuNow = now[1];
+            calibrated = true;
+        }
+    }
+
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        const TRULong *begin = queries[iterator * 2];
+        const TRULong *end = queries[iterator * 2 + 1];
+        VulkanProfilerResult *out = &impl->results[impl->resultCount];
+
+        if ( !begin[1] || !end[1] ) continue;
+
+        if ( first ) origin = begin[0];
+        first = false;
+
+        out->Name = frame->Names[iterator];
+        out->Duration = TicksToNanoseconds( impl, begin[0], end[0] );
+        out->Start = calibrated ? cpuNow - TicksToNanoseconds( impl, begin[0], gpuNow )
+                                : frame->CpuStart + TicksToNanoseconds( impl, origin, begin[0] );
+
+        ZoneTrackRecord( impl->track, out->Name, out->Start, out->Duration );
+        impl->resultCount++;
+    }
+}
+
+static TR_STATUS vulkan_profiler_object_QueryInterface( VulkanProfilerObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_profiler_object_interfaces, impl_from_VulkanProfilerObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_profiler_object_AddRef( VulkanProfilerObject *iface )
+{
+    struct vulkan_profiler_object *impl = impl_from_VulkanProfilerObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_profiler_object_Release( VulkanProfilerObject *iface )
+{
+    struct vulkan_profiler_object *impl = impl_from_VulkanProfilerObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) )
+    {
+        if ( impl->pool ) vkDestroyQueryPool( impl->handle, impl->pool, &VulkanAllocationCallbacks );
+        pthread_mutex_destroy( &impl->lock );
+        impl->device->lpVtbl->Release( impl->device );
+        SlabFree( &vulkan_profiler_object_cache, impl );
+    }
+    return removed;
+}
+
+static TR_STATUS vulkan_profiler_object_BeginFrame( VulkanProfilerObject *iface, VkCommandBuffer commands )
+{
+    struct vulkan_profiler_object *impl = impl_from_VulkanProfilerObject( iface );
+    VulkanProfilerFrame *frame;
+    TRUInt slot;
+
+    TRACE( "iface %p, commands %p\n", iface, (void *)commands );
+
+    if ( !impl->enabled ) return T_SUCCESS;
+
+    pthread_mutex_lock( &impl->lock );
+
+    // The oldest frame, its slot is reused for the new one.
+    slot = (impl->current + 1) % VULKAN_PROFILER_LATENCY;
+    frame = &impl->frames[slot];
+
+    if ( frame->Active ) ResolveFrame( impl, slot );
+
+    vkCmdResetQueryPool( commands, impl->pool, slot * PROFILER_FRAME_QUERIES, PROFILER_FRAME_QUERIES );
+    atomic_store( &frame->Count, 0 );
+    frame->CpuStart = ZoneTimestamp();
+    frame->Active = true;
+    impl->current = slot;
+
+    pthread_mutex_unlock( &impl->lock );
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_profiler_object_BeginScope( VulkanProfilerObject *iface, VkCommandBuffer commands, TRCString name, TRUInt *scope )
+{
+    struct vulkan_profiler_object *impl = impl_from_VulkanProfilerObject( iface );
+    VulkanProfilerFrame *frame = &impl->frames[impl->current];
+    TRUInt index;
+
+    TRACE( "iface %p, commands %p, name %s, scope %p\n", iface, (void *)commands, name, scope );
+
+    if ( !scope ) throw_NullPtrException();
+
+    *scope = VULKAN_PROFILER_NO_SCOPE;
+
+    if ( !impl->enabled || !frame->Active ) return T_SUCCESS;
+    if ( (index = atomic_fetch_add( &frame->Count, 1 )) >= VULKAN_PROFILER_MAX_SCOPES ) return T_SUCCESS;
+
+    frame->Names[index] = name;
+    *scope = impl->current * PROFILER_FRAME_QUERIES + index * 2;
+
+    vkCmdWriteTimestamp( commands, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, impl->pool, *scope );
+
+    return T_SUCCESS;
+}
+
+static void vulkan_profiler_object_EndScope( VulkanProfilerObject *iface, VkCommandBuffer commands, TRUInt scope )
+{
+    const struct vulkan_profiler_object *impl = impl_from_VulkanProfilerObject( iface );
+
+    TRACE( "iface %p, commands %p, scope %u\n", iface, (void *)commands, scope );
+
+    if ( scope == VULKAN_PROFILER_NO_SCOPE ) return;
+
+    vkCmdWriteTimestamp( commands, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, impl->pool, scope + 1 );
+}
+
+static TR_STATUS vulkan_profiler_object_GetResults( VulkanProfilerObject *iface, VulkanProfilerResult *out, TRUInt capacity, TRUInt *count )
+{
+    struct vulkan_profiler_object *impl = impl_from_VulkanProfilerObject( iface );
+
+    TRACE( "iface %p, out %p, capacity %u, count %p\n", iface, out, capacity, count );
+
+    if ( !count || (!out && capacity) ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->lock );
+    *count = impl->resultCount < capacity ? impl->resultCount : capacity;
+    memcpy( out, impl->results, sizeof(*out) * *count );
+    pthread_mutex_unlock( &impl->lock );
+
+    return T_SUCCESS;
+}
+
+static VulkanProfilerInterface vulkan_profiler_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_profiler_object_QueryInterface,
+    vulkan_profiler_object_AddRef,
+    vulkan_profiler_object_Release,
+    /* VulkanProfilerObject Methods */
+    vulkan_profiler_object_BeginFrame,
+    vulkan_profiler_object_BeginScope,
+    vulkan_profiler_object_EndScope,
+    vulkan_profiler_object_GetResults
+};
+
+TR_STATUS TR_API new_vulkan_profiler_object_override_device_and_queue( IN VulkanDeviceObject *device, IN VulkanQueueObject *queue, IN TRCString name, OUT VulkanProfilerObject **out )
+{
+    VkQueryPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    struct vulkan_profiler_object *impl;
+    const VulkanPhysicalDeviceInfo *info;
+    TRUInt family, validBits;
+    VkResult result;
+
+    TRACE( "device %p, queue %p, name %s, out %p\n", device, queue, name, out );
+
+    if ( !device || !queue || !name || !out ) throw_NullPtrException();
+
+    device->lpVtbl->get_Info( device, &info );
+    queue->lpVtbl->get_FamilyIndex( queue, &family );
+    validBits = info->QueueFamilies[family].timestampValidBits;
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_profiler_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanProfilerObject_iface.lpVtbl = &vulkan_profiler_interface;
+    impl->device = device;
+    impl->current = VULKAN_PROFILER_LATENCY - 1;
+    impl->ref = 1;
+
+    device->lpVtbl->AddRef( device );
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    // Such queues still work, their scopes just are not timed.
+    if ( !validBits )
+    {
+        WARN( "Queue family %u of %s has no timestamps, %s scopes are not timed\n", family, info->Properties.deviceName, name );
+        *out = &impl->VulkanProfilerObject_iface;
+        return T_SUCCESS;
+    }
+
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = VULKAN_PROFILER_LATENCY * PROFILER_FRAME_QUERIES;
+    if ( (result = vkCreateQueryPool( impl->handle, &poolInfo, &VulkanAllocationCallbacks, &impl->pool )) != VK_SUCCESS )
+    {
+        ERROR( "Failed to create a timestamp query pool, error was %d\n", result );
+        vulkan_profiler_object_Release( &impl->VulkanProfilerObject_iface );
+        return T_ERROR;
+    }
+
+    impl->enabled = true;
+    impl->validMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    impl->period = info->Properties.limits.timestampPeriod;
+    impl->track = ZoneTrackCreate( name );
+
+    if ( info->CalibratedTimestamps )
+        impl->getCalibratedTimestamps = (PFN_vkGetCalibratedTimestampsEXT)vkGetDeviceProcAddr( impl->handle, "vkGetCalibratedTimestampsEXT" );
+
+    *out = &impl->VulkanProfilerObject_iface;
+
+    TRACE( "created VulkanProfilerObject %p\n", *out );
+
+    return T_SUCCESS;
+}
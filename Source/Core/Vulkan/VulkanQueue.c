@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanQueue.c
+ *  Description: Thread-safe submission to the queues of a logical device.
+ */
+
+#include <Core/Vulkan/VulkanQueue.h>
+#include <Core/Vulkan/VulkanDevice.h>
+#include <Core/Instrumentation/Zones.h>
+
+static struct vulkan_queue_object *impl_from_VulkanQueueObject( VulkanQueueObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_queue_object, VulkanQueueObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_queue_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_queue_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_queue_object, VulkanQueueObject_iface ),
+    INTERFACE_ENTRY( VulkanQueueObject, vulkan_queue_object, VulkanQueueObject_iface ) );
+
+static TR_STATUS vulkan_queue_object_QueryInterface( VulkanQueueObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_queue_object_interfaces, impl_from_VulkanQueueObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_queue_object_AddRef( VulkanQueueObject *iface )
+{
+    struct vulkan_queue_object *impl = impl_from_VulkanQueueObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_queue_object_Release( VulkanQueueObject *iface )
+{
+    struct vulkan_queue_object *impl = impl_from_VulkanQueueObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) )
+    {
+        impl->device->lpVtbl->Release( impl->device );
+        SlabFree( &vulkan_queue_object_cache, impl );
+    }
+    return removed;
+}
+
+static TR_STATUS vulkan_queue_object_Submit( VulkanQueueObject *iface, const VkSubmitInfo *submits, TRUInt count, VkFence fence )
+{
+    VkResult result;
+
+    struct vulkan_queue_object *impl = impl_from_VulkanQueueObject( iface );
+
+    TR_ZONE( "VulkanQueue::Submit" );
+
+    TRACE( "iface %p, submits %p, count %u, fence %p\n", iface, submits, count, (void *)fence );
+
+    pthread_mutex_lock( &impl->slot->Lock );
+    result = vkQueueSubmit( impl->slot->Queue, count, submits, fence );
+    pthread_mutex_unlock( &impl->slot->Lock );
+
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Vulkan queue submission on family %u failed with %d\n", impl->slot->Family, result );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_queue_object_WaitIdle( VulkanQueueObject *iface )
+{
+    VkResult result;
+
+    struct vulkan_queue_object *impl = impl_from_VulkanQueueObject( iface );
+
+    TR_ZONE( "VulkanQueue::WaitIdle" );
+
+    TRACE( "iface %p\n", iface );
+
+    pthread_mutex_lock( &impl->slot->Lock );
+    result = vkQueueWaitIdle( impl->slot->Queue );
+    pthread_mutex_unlock( &impl->slot->Lock );
+
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Waiting on the vulkan queue of family %u failed with %d\n", impl->slot->Family, result );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_queue_object_Present( VulkanQueueObject *iface, const VkPresentInfoKHR *present, VkResult *result )
+{
+    VkResult presented;
+
+    struct vulkan_queue_object *impl = impl_from_VulkanQueueObject( iface );
+
+    TR_ZONE( "VulkanQueue::Present" );
+
+    TRACE( "iface %p, present %p, result %p\n", iface, present, result );
+
+    if ( !present ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->slot->Lock );
+    presented = vkQueuePresentKHR( impl->slot->Queue, present );
+    pthread_mutex_unlock( &impl->slot->Lock );
+
+    if ( result ) *result = presented;
+
+    if ( presented != VK_SUCCESS && presented != VK_SUBOPTIMAL_KHR && presented != VK_ERROR_OUT_OF_DATE_KHR )
+    {
+        ERROR( "Vulkan presentation on family %u failed with %d\n", impl->slot->Family, presented );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_queue_object_get_FamilyIndex( VulkanQueueObject *iface, TRUInt *out )
+{
+    const struct vulkan_queue_object *impl = impl_from_VulkanQueueObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->slot->Family;
+    return T_SUCCESS;
+}
+
+static VulkanQueueInterface vulkan_queue_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_queue_object_QueryInterface,
+    vulkan_queue_object_AddRef,
+    vulkan_queue_object_Release,
+    /* VulkanQueueObject Methods */
+    vulkan_queue_object_Submit,
+    vulkan_queue_object_WaitIdle,
+    vulkan_queue_object_Present,
+    vulkan_queue_object_get_FamilyIndex
+};
+
+TR_STATUS TR_API new_vulkan_queue_object_override_device_and_slot( IN VulkanDeviceObject *device, IN VulkanQueueSlot *slot, OUT VulkanQueueObject **out )
+{
+    struct vulkan_queue_object *impl;
+
+    TRACE( "device %p, slot %p, out %p\n", device, slot, out );
+
+    if ( !device || !slot || !out ) throw_NullPtrException();
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_queue_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanQueueObject_iface.lpVtbl = &vulkan_queue_interface;
+    impl->device = device;
+    impl->slot = slot;
+    impl->ref = 1;
+
+    device->lpVtbl->AddRef( device );
+
+    *out = &impl->VulkanQueueObject_iface;
+
+    TRACE( "created VulkanQueueObject %p\n", *out );
+
+    return T_SUCCESS;
+}
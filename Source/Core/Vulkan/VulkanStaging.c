@@ -0,0 +1,579 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanStaging.c
+ *  Description: A persistently mapped ring buffer batching uploads onto the transfer queue.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <Core/Vulkan/VulkanStaging.h>
+#include <Core/Instrumentation/Zones.h>
+
+// Every power of two texel block size divides it.
+#define STAGING_MIN_ALIGNMENT 16
+
+static struct vulkan_staging_object *impl_from_VulkanStagingObject( VulkanStagingObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_staging_object, VulkanStagingObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_staging_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_staging_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_staging_object, VulkanStagingObject_iface ),
+    INTERFACE_ENTRY( VulkanStagingObject, vulkan_staging_object, VulkanStagingObject_iface ) );
+
+static inline VkDeviceSize
+AlignUp(
+    IN VkDeviceSize value,
+    IN VkDeviceSize alignment
+) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static TR_STATUS
+WaitForValue(
+    IN struct vulkan_staging_object *impl,
+    IN TRULong value
+) {
+    VkSemaphoreWaitInfo waitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+    VkResult result;
+
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &impl->timeline;
+    waitInfo.pValues = &value;
+
+    if ( (result = vkWaitSemaphores( impl->handle, &waitInfo, UINT64_MAX )) != VK_SUCCESS )
+    {
+        ERROR( "Waiting for staging batch %lu failed with %d\n", value, result );
+        return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+// Must be called with the lock held.
+static TR_STATUS
+Retire(
+    IN struct vulkan_staging_object *impl,
+    IN TRULong value
+) {
+    TR_STATUS status;
+
+    if ( value <= impl->completed ) return T_SUCCESS;
+
+    vkGetSemaphoreCounterValue( impl->handle, impl->timeline, &impl->completed );
+    if ( value > impl->completed )
+    {
+        TR_ZONE( "VulkanStaging::Stall" );
+
+        impl->statistics.Stalls++;
+        if ( FAILED( status = WaitForValue( impl, value ) ) ) return status;
+        impl->completed = value;
+    }
+
+    impl->lastCompletion = ZoneTimestamp();
+    return T_SUCCESS;
+}
+
+// Moves the tail to the start of the oldest batch the device has not finished, the batches
+// after the current one being the oldest.
+static void
+UpdateTail(
+    IN struct vulkan_staging_object *impl
+) {
+    TRULong completed;
+    TRUInt i;
+
+    if ( impl->submitted > impl->completed )
+    {
+        vkGetSemaphoreCounterValue( impl->handle, impl->timeline, &completed );
+        if ( completed > impl->completed )
+        {
+            impl->completed = completed;
+            impl->lastCompletion = ZoneTimestamp();
+        }
+    }
+
+    for ( i = 1; i <= VULKAN_STAGING_BATCH_COUNT; i++ )
+    {
+        const TRUInt index = (impl->current + i) % VULKAN_STAGING_BATCH_COUNT;
+        const VulkanStagingBatch *batch = &impl->batches[index];
+
+        if ( batch->Value > impl->completed || (index == impl->current && batch->Copies) )
+        {
+            impl->tail = batch->Start;
+            impl->empty = false;
+            return;
+        }
+    }
+
+    impl->head = impl->tail = 0;
+    impl->empty = true;
+}
+
+// Must be called with the lock held.
+static TR_STATUS
+SubmitCurrent(
+    IN struct vulkan_staging_object *impl
+) {
+    VkTimelineSemaphoreSubmitInfo timelineInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    VulkanStagingBatch *batch = &impl->batches[impl->current];
+    TRULong value = impl->submitted + 1;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanStaging::Submit" );
+
+    if ( !batch->Recording ) return T_SUCCESS;
+    batch->Recording = false;
+
+    if ( vkEndCommandBuffer( batch->Commands ) != VK_SUCCESS )
+    {
+        ERROR( "Failed to record staging batch %lu\n", value );
+        batch->Copies = 0;
+        return T_ERROR;
+    }
+
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &value;
+
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch->Commands;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &impl->timeline;
+
+    // Its part of the ring is free again either way.
+    if ( FAILED( status = impl->queue->lpVtbl->Submit( impl->queue, &submitInfo, 1, VK_NULL_HANDLE ) ) )
+    {
+        batch->Copies = 0;
+        return status;
+    }
+
+    batch->Value = impl->submitted = value;
+    impl->statistics.Submits++;
+
+    // The next batch is the oldest, its command buffer is reused once the device is done with it.
+    impl->current = (impl->current + 1) % VULKAN_STAGING_BATCH_COUNT;
+    impl->batches[impl->current].Copies = 0;
+
+    return Retire( impl, impl->batches[impl->current].Value );
+}
+
+// Finds room for size bytes after the head, waiting for or submitting batches when the ring
+// is full. Must be called with the lock held.
+static TR_STATUS
+Reserve(
+    IN struct vulkan_staging_object *impl,
+    IN VkDeviceSize size,
+    OUT VkDeviceSize *out
+) {
+    TR_STATUS status;
+    VkDeviceSize offset;
+    TRUInt i;
+
+    for ( ;; )
+    {
+        UpdateTail( impl );
+
+        if ( impl->empty )
+        {
+            offset = 0;
+            break;
+        }
+
+        offset = AlignUp( impl->head, impl->alignment );
+        if ( impl->head > impl->tail )
+        {
+            if ( offset + size <= impl->size ) break;
+
+            // Wraps around, the end of the ring stays unused until the tail passes it.
+            if ( size <= impl->tail )
+            {
+                offset = 0;
+                break;
+            }
+        }
+        else if ( impl->head < impl->tail && offset + size <= impl->tail ) break;
+
+        // Full, wait for the oldest batch in flight.
+        for ( i = 1; i <= VULKAN_STAGING_BATCH_COUNT; i++ )
+        {
+            const VulkanStagingBatch *batch = &impl->batches[(impl->current + i) % VULKAN_STAGING_BATCH_COUNT];
+
+            if ( batch->Value > impl->completed )
+            {
+                if ( FAILED( status = Retire( impl, batch->Value ) ) ) return status;
+                break;
+            }
+        }
+        if ( i <= VULKAN_STAGING_BATCH_COUNT ) continue;
+
+        // Nothing in flight, the current batch fills the ring by itself.
+        if ( FAILED( status = SubmitCurrent( impl ) ) ) return status;
+    }
+
+    impl->head = offset + size;
+    *out = offset;
+    return T_SUCCESS;
+}
+
+// Must be called with the lock held.
+static TR_STATUS
+BeginCurrent(
+    IN struct vulkan_staging_object *impl,
+    IN VkDeviceSize offset
+) {
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    VulkanStagingBatch *batch = &impl->batches[impl->current];
+
+    if ( !batch->Copies ) batch->Start = offset;
+    if ( batch->Recording ) return T_SUCCESS;
+
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if ( vkBeginCommandBuffer( batch->Commands, &beginInfo ) != VK_SUCCESS )
+    {
+        ERROR( "Failed to begin a staging batch\n" );
+        return T_ERROR;
+    }
+
+    batch->Recording = true;
+    batch->Copies = 0;
+
+    if ( !impl->firstCopy ) impl->firstCopy = ZoneTimestamp();
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+FlushCallback(
+    IN UnknownObject *invoker,
+    IN void *param,
+    OUT PropVariant *result
+) {
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( (VulkanStagingObject *)invoker );
+    const TRULong value = (TRULong)(uintptr_t)param;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanStaging::Wait" );
+
+    if ( FAILED( status = WaitForValue( impl, value ) ) ) return status;
+
+    pthread_mutex_lock( &impl->lock );
+    if ( value > impl->completed )
+    {
+        impl->completed = value;
+        impl->lastCompletion = ZoneTimestamp();
+    }
+    pthread_mutex_unlock( &impl->lock );
+
+    result->type = VT_UI64;
+    result->ulongVal = value;
+
+    return T_SUCCESS;
+}
+
+static void
+DestroyStaging(
+    IN struct vulkan_staging_object *impl
+) {
+    if ( impl->submitted ) WaitForValue( impl, impl->submitted );
+
+    if ( impl->timeline ) vkDestroySemaphore( impl->handle, impl->timeline, &VulkanAllocationCallbacks );
+    if ( impl->pool ) vkDestroyCommandPool( impl->handle, impl->pool, &VulkanAllocationCallbacks );
+    if ( impl->buffer ) vkDestroyBuffer( impl->handle, impl->buffer, &VulkanAllocationCallbacks );
+    if ( impl->memory.Memory ) impl->allocator->lpVtbl->Free( impl->allocator, &impl->memory );
+
+    if ( impl->queue ) impl->queue->lpVtbl->Release( impl->queue );
+    impl->allocator->lpVtbl->Release( impl->allocator );
+    impl->device->lpVtbl->Release( impl->device );
+
+    pthread_mutex_destroy( &impl->lock );
+    SlabFree( &vulkan_staging_object_cache, impl );
+}
+
+static TR_STATUS vulkan_staging_object_QueryInterface( VulkanStagingObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_staging_object_interfaces, impl_from_VulkanStagingObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_staging_object_AddRef( VulkanStagingObject *iface )
+{
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_staging_object_Release( VulkanStagingObject *iface )
+{
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) )
+    {
+        if ( impl->batches[impl->current].Copies )
+            WARN( "Dropping %u staged copies that were never flushed\n", impl->batches[impl->current].Copies );
+        DestroyStaging( impl );
+    }
+    return removed;
+}
+
+static TR_STATUS vulkan_staging_object_UploadBuffer( VulkanStagingObject *iface, VkBuffer destination, VkDeviceSize offset, const void *data, VkDeviceSize size )
+{
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( iface );
+    const TRChar *source = data;
+    TR_STATUS status = T_SUCCESS;
+
+    TR_ZONE( "VulkanStaging::UploadBuffer" );
+
+    TRACE( "iface %p, destination %p, offset %lu, data %p, size %lu\n", iface, (void *)destination, offset, data, size );
+
+    if ( !data && size ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->lock );
+
+    // Chunks of half the ring, so one can be written while the previous one is copied.
+    while ( size )
+    {
+        VkBufferCopy region;
+        const VkDeviceSize chunk = size < impl->size / 2 ? size : impl->size / 2;
+
+        if ( FAILED( status = Reserve( impl, chunk, &region.srcOffset ) ) ) break;
+        if ( FAILED( status = BeginCurrent( impl, region.srcOffset ) ) ) break;
+
+        memcpy( (TRChar *)impl->memory.Mapped + region.srcOffset, source, chunk );
+
+        region.dstOffset = offset;
+        region.size = chunk;
+        vkCmdCopyBuffer( impl->batches[impl->current].Commands, impl->buffer, destination, 1, &region );
+
+        impl->batches[impl->current].Copies++;
+        impl->statistics.Copies++;
+        impl->statistics.Bytes += chunk;
+
+        source += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+
+    pthread_mutex_unlock( &impl->lock );
+
+    return status;
+}
+
+static TR_STATUS vulkan_staging_object_UploadImage( VulkanStagingObject *iface, VkImage destination, const VkBufferImageCopy *region, const void *data, VkDeviceSize size )
+{
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( iface );
+    VkBufferImageCopy copy;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanStaging::UploadImage" );
+
+    TRACE( "iface %p, destination %p, region %p, data %p, size %lu\n", iface, (void *)destination, region, data, size );
+
+    if ( !region || !data ) throw_NullPtrException();
+    if ( size > impl->size / 2 )
+    {
+        WARN( "Image upload of %lu bytes does not fit a staging ring of %lu bytes\n", size, impl->size );
+        return T_INVALIDARG;
+    }
+
+    copy = *region;
+
+    pthread_mutex_lock( &impl->lock );
+
+    if ( !FAILED( status = Reserve( impl, size, &copy.bufferOffset ) ) &&
+         !FAILED( status = BeginCurrent( impl, copy.bufferOffset ) ) )
+    {
+        memcpy( (TRChar *)impl->memory.Mapped + copy.bufferOffset, data, size );
+
+        vkCmdCopyBufferToImage( impl->batches[impl->current].Commands, impl->buffer, destination,
+                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy );
+
+        impl->batches[impl->current].Copies++;
+        impl->statistics.Copies++;
+        impl->statistics.Bytes += size;
+    }
+
+    pthread_mutex_unlock( &impl->lock );
+
+    return status;
+}
+
+static TR_STATUS vulkan_staging_object_Flush( VulkanStagingObject *iface, AsyncOperationObject **out )
+{
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( iface );
+    TR_STATUS status;
+    TRULong value;
+
+    TR_ZONE( "VulkanStaging::Flush" );
+
+    TRACE( "iface %p, out %p\n", iface, out );
+
+    pthread_mutex_lock( &impl->lock );
+    status = SubmitCurrent( impl );
+    value = impl->submitted;
+    pthread_mutex_unlock( &impl->lock );
+
+    if ( FAILED( status ) || !out ) return status;
+
+    // Timeline values fit in the parameter on every platform we build for.
+    return new_async_operation_object_override_callback( (UnknownObject *)iface, (void *)(uintptr_t)value, FlushCallback, out );
+}
+
+static TR_STATUS vulkan_staging_object_get_Statistics( VulkanStagingObject *iface, VulkanStagingStatistics *out )
+{
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+
+    pthread_mutex_lock( &impl->lock );
+    *out = impl->statistics;
+    out->MegabytesPerSecond = impl->lastCompletion > impl->firstCopy && impl->firstCopy
+        ? (TRFloat)out->Bytes / (1 << 20) / ((TRFloat)(impl->lastCompletion - impl->firstCopy) / 1e9)
+        : 0.0;
+    pthread_mutex_unlock( &impl->lock );
+
+    return T_SUCCESS;
+}
+
+static void vulkan_staging_object_ResetStatistics( VulkanStagingObject *iface )
+{
+    struct vulkan_staging_object *impl = impl_from_VulkanStagingObject( iface );
+    TRACE( "iface %p\n", iface );
+
+    pthread_mutex_lock( &impl->lock );
+    memset( &impl->statistics, 0, sizeof(impl->statistics) );
+    impl->firstCopy = impl->lastCompletion = 0;
+    pthread_mutex_unlock( &impl->lock );
+}
+
+static VulkanStagingInterface vulkan_staging_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_staging_object_QueryInterface,
+    vulkan_staging_object_AddRef,
+    vulkan_staging_object_Release,
+    /* VulkanStagingObject Methods */
+    vulkan_staging_object_UploadBuffer,
+    vulkan_staging_object_UploadImage,
+    vulkan_staging_object_Flush,
+    vulkan_staging_object_get_Statistics,
+    vulkan_staging_object_ResetStatistics
+};
+
+static TR_STATUS
+CreateRing(
+    IN struct vulkan_staging_object *impl
+) {
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    VkCommandBufferAllocateInfo commandsInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    VkSemaphoreTypeCreateInfo timelineInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    VkCommandBuffer commands[VULKAN_STAGING_BATCH_COUNT];
+    TR_STATUS status;
+    TRUInt i;
+
+    bufferInfo.size = impl->size;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if ( vkCreateBuffer( impl->handle, &bufferInfo, &VulkanAllocationCallbacks, &impl->buffer ) != VK_SUCCESS ) return T_ERROR;
+
+    // Written once by the host and read once by the device, write-combined memory is fine.
+    if ( FAILED( status = impl->allocator->lpVtbl->AllocateForBuffer( impl->allocator, impl->buffer,
+                                                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                                      0, VulkanAllocationFlags_Mapped, &impl->memory ) ) )
+        return status;
+
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    impl->queue->lpVtbl->get_FamilyIndex( impl->queue, &poolInfo.queueFamilyIndex );
+    if ( vkCreateCommandPool( impl->handle, &poolInfo, &VulkanAllocationCallbacks, &impl->pool ) != VK_SUCCESS ) return T_ERROR;
+
+    commandsInfo.commandPool = impl->pool;
+    commandsInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandsInfo.commandBufferCount = VULKAN_STAGING_BATCH_COUNT;
+    if ( vkAllocateCommandBuffers( impl->handle, &commandsInfo, commands ) != VK_SUCCESS ) return T_ERROR;
+    for ( i = 0; i < VULKAN_STAGING_BATCH_COUNT; i++ )
+        impl->batches[i].Commands = commands[i];
+
+    timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue = 0;
+    semaphoreInfo.pNext = &timelineInfo;
+    if ( vkCreateSemaphore( impl->handle, &semaphoreInfo, &VulkanAllocationCallbacks, &impl->timeline ) != VK_SUCCESS ) return T_ERROR;
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API new_vulkan_staging_object_override_device_and_allocator_and_size( IN VulkanDeviceObject *device, IN VulkanAllocatorObject *allocator, IN VkDeviceSize size, OUT VulkanStagingObject **out )
+{
+    struct vulkan_staging_object *impl;
+    const VulkanPhysicalDeviceInfo *info;
+    TR_STATUS status;
+
+    TRACE( "device %p, allocator %p, size %lu, out %p\n", device, allocator, size, out );
+
+    if ( !device || !allocator || !out ) throw_NullPtrException();
+
+    device->lpVtbl->get_Info( device, &info );
+    if ( !info->Features12.timelineSemaphore )
+    {
+        WARN( "%s has no timeline semaphores, cannot create a staging ring\n", info->Properties.deviceName );
+        return T_NOTIMPL;
+    }
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_staging_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanStagingObject_iface.lpVtbl = &vulkan_staging_interface;
+    impl->device = device;
+    impl->allocator = allocator;
+    impl->empty = true;
+    impl->ref = 1;
+
+    impl->alignment = info->Properties.limits.optimalBufferCopyOffsetAlignment;
+    if ( impl->alignment < STAGING_MIN_ALIGNMENT ) impl->alignment = STAGING_MIN_ALIGNMENT;
+    impl->size = AlignUp( size, impl->alignment );
+
+    device->lpVtbl->AddRef( device );
+    allocator->lpVtbl->AddRef( allocator );
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    if ( FAILED( status = device->lpVtbl->GetQueue( device, VulkanQueueRole_Transfer, &impl->queue ) ) ||
+         FAILED( status = CreateRing( impl ) ) )
+    {
+        ERROR( "Failed to create a staging ring of %lu bytes\n", impl->size );
+        DestroyStaging( impl );
+        return status;
+    }
+
+    *out = &impl->VulkanStagingObject_iface;
+
+    TRACE( "created VulkanStagingObject %p\n", *out );
+
+    return T_SUCCESS;
+}
@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: VulkanSwapchain.c
+ *  Description: Swapchains on the surfaces of UI windows, with frames in flight.
+ */
+
+#include <stdint.h>
+
+#include <Core/Vulkan/VulkanSwapchain.h>
+#include <Core/Instrumentation/Zones.h>
+
+static const VkPresentModeKHR PresentModes[] =
+{
+    [VulkanPresentMode_Fifo] = VK_PRESENT_MODE_FIFO_KHR,
+    [VulkanPresentMode_Mailbox] = VK_PRESENT_MODE_MAILBOX_KHR,
+    [VulkanPresentMode_Immediate] = VK_PRESENT_MODE_IMMEDIATE_KHR,
+};
+
+static struct vulkan_swapchain_object *impl_from_VulkanSwapchainObject( VulkanSwapchainObject *iface )
+{
+    return CONTAINING_RECORD( iface, struct vulkan_swapchain_object, VulkanSwapchainObject_iface );
+}
+
+DEFINE_SLAB_CACHE( vulkan_swapchain_object, MEMORY_TAG_VULKAN );
+
+DEFINE_INTERFACE_TABLE( vulkan_swapchain_object,
+    INTERFACE_ENTRY( UnknownObject, vulkan_swapchain_object, VulkanSwapchainObject_iface ),
+    INTERFACE_ENTRY( VulkanSwapchainObject, vulkan_swapchain_object, VulkanSwapchainObject_iface ) );
+
+static TRUInt
+Clamp(
+    IN TRUInt value,
+    IN TRUInt min,
+    IN TRUInt max
+) {
+    return value < min ? min : value > max ? max : value;
+}
+
+static VulkanPresentMode
+ChoosePresentMode(
+    IN struct vulkan_swapchain_object *impl
+) {
+    VkPresentModeKHR modes[16];
+    TRUInt iterator, count = sizeof(modes) / sizeof(*modes);
+
+    // VK_INCOMPLETE only drops modes past the first 16, there are fewer than that.
+    if ( vkGetPhysicalDeviceSurfacePresentModesKHR( impl->physical, impl->surface, &count, modes ) < 0 )
+        return VulkanPresentMode_Fifo;
+
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        if ( modes[iterator] == PresentModes[impl->requestedMode] )
+            return impl->requestedMode;
+    }
+
+    if ( impl->requestedMode != VulkanPresentMode_Fifo )
+        WARN( "Vulkan: present mode %d is not supported by the surface, using FIFO\n", impl->requestedMode );
+
+    return VulkanPresentMode_Fifo;
+}
+
+static VkSurfaceFormatKHR
+ChooseFormat(
+    IN struct vulkan_swapchain_object *impl
+) {
+    VkSurfaceFormatKHR formats[64];
+    TRUInt iterator, count = sizeof(formats) / sizeof(*formats);
+    const VkSurfaceFormatKHR fallback = { VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+
+    if ( vkGetPhysicalDeviceSurfaceFormatsKHR( impl->physical, impl->surface, &count, formats ) < 0 || !count )
+        return fallback;
+
+    // Blits from the linear film into an sRGB image encode it on the way.
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        if ( formats[iterator].colorSpace != VK_COLOR_SPACE_SRGB_NONLINEAR_KHR ) continue;
+        if ( formats[iterator].format == VK_FORMAT_B8G8R8A8_SRGB || formats[iterator].format == VK_FORMAT_R8G8B8A8_SRGB )
+            return formats[iterator];
+    }
+
+    return formats[0].format == VK_FORMAT_UNDEFINED ? fallback : formats[0];
+}
+
+static void
+DestroyImages(
+    IN struct vulkan_swapchain_object *impl
+) {
+    TRUInt iterator;
+
+    for ( iterator = 0; iterator < impl->imageCount; iterator++ )
+    {
+        if ( impl->images[iterator].View ) vkDestroyImageView( impl->handle, impl->images[iterator].View, &VulkanAllocationCallbacks );
+        if ( impl->images[iterator].Rendered ) vkDestroySemaphore( impl->handle, impl->images[iterator].Rendered, &VulkanAllocationCallbacks );
+    }
+
+    TRFree( impl->images );
+    impl->images = nullptr;
+    impl->imageCount = 0;
+}
+
+static TR_STATUS
+CreateImages(
+    IN struct vulkan_swapchain_object *impl
+) {
+    VkImage images[16];
+    VkImageViewCreateInfo viewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    TRUInt iterator, count = sizeof(images) / sizeof(*images);
+
+    if ( vkGetSwapchainImagesKHR( impl->handle, impl->swapchain, &count, images ) != VK_SUCCESS ) return T_ERROR;
+
+    if ( !(impl->images = TRCalloc( count, sizeof(VulkanSwapchainImage), MEMORY_TAG_VULKAN )) ) return T_OUTOFMEMORY;
+    impl->imageCount = count;
+
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = impl->format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    for ( iterator = 0; iterator < count; iterator++ )
+    {
+        impl->images[iterator].Image = viewInfo.image = images[iterator];
+        if ( vkCreateImageView( impl->handle, &viewInfo, &VulkanAllocationCallbacks, &impl->images[iterator].View ) != VK_SUCCESS ||
+             vkCreateSemaphore( impl->handle, &semaphoreInfo, &VulkanAllocationCallbacks, &impl->images[iterator].Rendered ) != VK_SUCCESS )
+            return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+Recreate(
+    IN struct vulkan_swapchain_object *impl
+) {
+    VkSwapchainCreateInfoKHR createInfo = { VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR };
+    VkSurfaceCapabilitiesKHR capabilities;
+    VkSurfaceFormatKHR format;
+    VkSwapchainKHR old = impl->swapchain;
+    VkExtent2D requested;
+    VkResult result;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanSwapchain::Recreate" );
+
+    pthread_mutex_lock( &impl->lock );
+    requested = impl->requested;
+    impl->resized = false;
+    pthread_mutex_unlock( &impl->lock );
+
+    if ( vkGetPhysicalDeviceSurfaceCapabilitiesKHR( impl->physical, impl->surface, &capabilities ) != VK_SUCCESS )
+    {
+        ERROR( "Vulkan: Failed to query the surface capabilities\n" );
+        return T_ERROR;
+    }
+
+    // The surface either dictates its size or leaves it to us.
+    if ( capabilities.currentExtent.width != UINT32_MAX )
+        requested = capabilities.currentExtent;
+    else
+    {
+        requested.width = Clamp( requested.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width );
+        requested.height = Clamp( requested.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height );
+    }
+
+    // Minimized, tried again at every AcquireFrame until the window has an area.
+    if ( !requested.width || !requested.height )
+    {
+        impl->stale = true;
+        return T_NOINIT;
+    }
+
+    // Rendering to and presenting from the old images is done once the queue is idle.
+    if ( FAILED(( status = impl->queue->lpVtbl->WaitIdle( impl->queue ) )) ) return status;
+
+    format = ChooseFormat( impl );
+    impl->mode = ChoosePresentMode( impl );
+
+    createInfo.surface = impl->surface;
+    createInfo.minImageCount = capabilities.minImageCount + 1;
+    if ( capabilities.maxImageCount && createInfo.minImageCount > capabilities.maxImageCount )
+        createInfo.minImageCount = capabilities.maxImageCount;
+    createInfo.imageFormat = format.format;
+    createInfo.imageColorSpace = format.colorSpace;
+    createInfo.imageExtent = requested;
+    createInfo.imageArrayLayers = 1;
+    createInfo.imageUsage = (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT) & capabilities.supportedUsageFlags;
+    createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    createInfo.preTransform = capabilities.currentTransform;
+    createInfo.compositeAlpha = capabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR ?
+        VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR :
+        (VkCompositeAlphaFlagBitsKHR)(capabilities.supportedCompositeAlpha & -capabilities.supportedCompositeAlpha);
+    createInfo.presentMode = PresentModes[impl->mode];
+    createInfo.clipped = VK_TRUE;
+    createInfo.oldSwapchain = old;
+
+    result = vkCreateSwapchainKHR( impl->handle, &createInfo, &VulkanAllocationCallbacks, &impl->swapchain );
+
+    DestroyImages( impl );
+    if ( old ) vkDestroySwapchainKHR( impl->handle, old, &VulkanAllocationCallbacks );
+
+    if ( result != VK_SUCCESS )
+    {
+        ERROR( "Vulkan swapchain creation failed with %d\n", result );
+        impl->swapchain = VK_NULL_HANDLE;
+        return T_ERROR;
+    }
+
+    impl->format = format.format;
+    impl->extent = requested;
+
+    if ( FAILED(( status = CreateImages( impl ) )) )
+    {
+        impl->stale = true;
+        return status;
+    }
+
+    impl->stale = false;
+
+    INFO( "Vulkan: swapchain of %u %ux%u images, present mode %d\n", impl->imageCount, requested.width, requested.height, impl->mode );
+
+    return T_SUCCESS;
+}
+
+static void
+DestroySwapchain(
+    IN struct vulkan_swapchain_object *impl
+) {
+    TRUInt iterator;
+
+    if ( impl->queue )
+    {
+        impl->queue->lpVtbl->WaitIdle( impl->queue );
+        impl->queue->lpVtbl->Release( impl->queue );
+    }
+
+    DestroyImages( impl );
+    if ( impl->swapchain ) vkDestroySwapchainKHR( impl->handle, impl->swapchain, &VulkanAllocationCallbacks );
+
+    for ( iterator = 0; iterator < impl->slotCount; iterator++ )
+    {
+        if ( impl->slots[iterator].Acquired ) vkDestroySemaphore( impl->handle, impl->slots[iterator].Acquired, &VulkanAllocationCallbacks );
+        if ( impl->slots[iterator].Fence ) vkDestroyFence( impl->handle, impl->slots[iterator].Fence, &VulkanAllocationCallbacks );
+    }
+
+    if ( impl->surface ) impl->instance->lpVtbl->DestroySurface( impl->instance, impl->surface );
+
+    impl->device->lpVtbl->Release( impl->device );
+    impl->instance->lpVtbl->Release( impl->instance );
+
+    pthread_mutex_destroy( &impl->lock );
+    SlabFree( &vulkan_swapchain_object_cache, impl );
+}
+
+static TR_STATUS vulkan_swapchain_object_QueryInterface( VulkanSwapchainObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &vulkan_swapchain_object_interfaces, impl_from_VulkanSwapchainObject( iface ), uuid, out );
+}
+
+static TRLong vulkan_swapchain_object_AddRef( VulkanSwapchainObject *iface )
+{
+    struct vulkan_swapchain_object *impl = impl_from_VulkanSwapchainObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong vulkan_swapchain_object_Release( VulkanSwapchainObject *iface )
+{
+    struct vulkan_swapchain_object *impl = impl_from_VulkanSwapchainObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub(&impl->ref, 1);
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) ) DestroySwapchain( impl );
+    return removed;
+}
+
+static TR_STATUS vulkan_swapchain_object_AcquireFrame( VulkanSwapchainObject *iface, VulkanSwapchainFrame *out )
+{
+    VulkanSwapchainImage *image;
+    VulkanSwapchainSlot *slot;
+    VkResult result;
+    TR_STATUS status;
+    TRUInt index, attempt;
+    TRBool resized;
+
+    struct vulkan_swapchain_object *impl = impl_from_VulkanSwapchainObject( iface );
+
+    TR_ZONE( "VulkanSwapchain::AcquireFrame" );
+
+    TRACE( "iface %p, out %p\n", iface, out );
+
+    if ( !out ) throw_NullPtrException();
+
+    slot = &impl->slots[impl->slot];
+
+    // The slot's last frame has to be done before its semaphore and fence are reused.
+    if ( vkWaitForFences( impl->handle, 1, &slot->Fence, VK_TRUE, UINT64_MAX ) != VK_SUCCESS )
+    {
+        ERROR( "Waiting on frame %u failed\n", impl->slot );
+        return T_ERROR;
+    }
+
+    pthread_mutex_lock( &impl->lock );
+    resized = impl->resized;
+    pthread_mutex_unlock( &impl->lock );
+
+    for ( attempt = 0; ; attempt++ )
+    {
+        if ( ( resized || impl->stale || !impl->swapchain ) && FAILED(( status = Recreate( impl ) )) ) return status;
+        resized = false;
+
+        result = vkAcquireNextImageKHR( impl->handle, impl->swapchain, UINT64_MAX, slot->Acquired, VK_NULL_HANDLE, &index );
+        if ( result == VK_SUCCESS ) break;
+        if ( result == VK_SUBOPTIMAL_KHR )
+        {
+            // Still presentable, recreated after this frame.
+            impl->stale = true;
+            break;
+        }
+        if ( result != VK_ERROR_OUT_OF_DATE_KHR || attempt )
+        {
+            ERROR( "Vulkan image acquisition failed with %d\n", result );
+            return T_ERROR;
+        }
+
+        impl->stale = true;
+    }
+
+    image = &impl->images[index];
+
+    // Frames in flight and images need not match, the image may still be in use by another slot.
+    if ( image->Fence && image->Fence != slot->Fence )
+        vkWaitForFences( impl->handle, 1, &image->Fence, VK_TRUE, UINT64_MAX );
+    image->Fence = slot->Fence;
+
+    // Only now, an early return above has to leave the fence signaled for the next wait.
+    vkResetFences( impl->handle, 1, &slot->Fence );
+    impl->acquired = index;
+
+    out->Frame = impl->slot;
+    out->ImageIndex = index;
+    out->Image = image->Image;
+    out->View = image->View;
+    out->Format = impl->format;
+    out->Extent = impl->extent;
+    out->Acquired = slot->Acquired;
+    out->Rendered = image->Rendered;
+    out->Fence = slot->Fence;
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_swapchain_object_Present( VulkanSwapchainObject *iface, const VulkanSwapchainFrame *frame )
+{
+    VkPresentInfoKHR presentInfo = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
+    VkResult result;
+    TR_STATUS status;
+
+    struct vulkan_swapchain_object *impl = impl_from_VulkanSwapchainObject( iface );
+
+    TR_ZONE( "VulkanSwapchain::Present" );
+
+    TRACE( "iface %p, frame %p\n", iface, frame );
+
+    if ( !frame ) throw_NullPtrException();
+
+    if ( frame->Frame != impl->slot || frame->ImageIndex != impl->acquired )
+    {
+        ERROR( "Frame %u image %u was not the one acquired\n", frame->Frame, frame->ImageIndex );
+        return T_INVALIDARG;
+    }
+
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &impl->images[impl->acquired].Rendered;
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &impl->swapchain;
+    presentInfo.pImageIndices = &impl->acquired;
+
+    status = impl->queue->lpVtbl->Present( impl->queue, &presentInfo, &result );
+
+    impl->acquired = UINT32_MAX;
+    impl->slot = (impl->slot + 1) % impl->slotCount;
+    if ( result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR ) impl->stale = true;
+
+    return status;
+}
+
+static TR_STATUS vulkan_swapchain_object_Resize( VulkanSwapchainObject *iface, TRUInt width, TRUInt height )
+{
+    struct vulkan_swapchain_object *impl = impl_from_VulkanSwapchainObject( iface );
+
+    TRACE( "iface %p, width %u, height %u\n", iface, width, height );
+
+    pthread_mutex_lock( &impl->lock );
+    impl->requested = (VkExtent2D){ width, height };
+    impl->resized = true;
+    pthread_mutex_unlock( &impl->lock );
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_swapchain_object_get_Extent( VulkanSwapchainObject *iface, VkExtent2D *out )
+{
+    const struct vulkan_swapchain_object *impl = impl_from_VulkanSwapchainObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->extent;
+    return T_SUCCESS;
+}
+
+static TR_STATUS vulkan_swapchain_object_get_PresentMode( VulkanSwapchainObject *iface, VulkanPresentMode *out )
+{
+    const struct vulkan_swapchain_object *impl = impl_from_VulkanSwapchainObject( iface );
+    TRACE( "iface %p, out %p\n", iface, out );
+    if ( !out ) throw_NullPtrException();
+    *out = impl->mode;
+    return T_SUCCESS;
+}
+
+static VulkanSwapchainInterface vulkan_swapchain_interface =
+{
+    /* UnknownObject Methods */
+    vulkan_swapchain_object_QueryInterface,
+    vulkan_swapchain_object_AddRef,
+    vulkan_swapchain_object_Release,
+    /* VulkanSwapchainObject Methods */
+    vulkan_swapchain_object_AcquireFrame,
+    vulkan_swapchain_object_Present,
+    vulkan_swapchain_object_Resize,
+    vulkan_swapchain_object_get_Extent,
+    vulkan_swapchain_object_get_PresentMode
+};
+
+static TR_STATUS
+CreateSlots(
+    IN struct vulkan_swapchain_object *impl
+) {
+    VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    TRUInt iterator;
+
+    // Signaled, so the first AcquireFrame of every slot does not wait.
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for ( iterator = 0; iterator < impl->slotCount; iterator++ )
+    {
+        if ( vkCreateSemaphore( impl->handle, &semaphoreInfo, &VulkanAllocationCallbacks, &impl->slots[iterator].Acquired ) != VK_SUCCESS ||
+             vkCreateFence( impl->handle, &fenceInfo, &VulkanAllocationCallbacks, &impl->slots[iterator].Fence ) != VK_SUCCESS )
+            return T_ERROR;
+    }
+
+    return T_SUCCESS;
+}
+
+static TR_STATUS
+CheckPresentSupport(
+    IN struct vulkan_swapchain_object *impl
+) {
+    VkBool32 supported = VK_FALSE;
+    TRUInt family;
+
+    impl->queue->lpVtbl->get_FamilyIndex( impl->queue, &family );
+
+    if ( vkGetPhysicalDeviceSurfaceSupportKHR( impl->physical, family, impl->surface, &supported ) != VK_SUCCESS ) return T_ERROR;
+
+    if ( !supported )
+    {
+        ERROR( "Vulkan: The graphics queue family %u cannot present to the window\n", family );
+        return T_NOTIMPL;
+    }
+
+    return T_SUCCESS;
+}
+
+TR_STATUS TR_API new_vulkan_swapchain_object_override_instance_and_device_and_window( IN VulkanObject *instance, IN VulkanDeviceObject *device, IN const WindowRepresentation *window, IN const VulkanSwapchainSettings *settings, OUT VulkanSwapchainObject **out )
+{
+    struct vulkan_swapchain_object *impl;
+    const VulkanPhysicalDeviceInfo *info;
+    TRBool swapchains;
+    TR_STATUS status;
+
+    TR_ZONE( "VulkanSwapchain::Create" );
+
+    TRACE( "instance %p, device %p, window %p, settings %p, out %p\n", instance, device, window, settings, out );
+
+    if ( !instance || !device || !window || !settings || !out ) throw_NullPtrException();
+
+    if ( settings->PresentMode > VulkanPresentMode_Immediate ) return T_INVALIDARG;
+
+    device->lpVtbl->get_Info( device, &info );
+    device->lpVtbl->SupportsExtension( device, VK_KHR_SWAPCHAIN_EXTENSION_NAME, &swapchains );
+    if ( !swapchains )
+    {
+        WARN( "%s cannot present to windows\n", info->Properties.deviceName );
+        return T_NOTIMPL;
+    }
+
+    // Freed in Release();
+    if (!(impl = SlabAlloc( &vulkan_swapchain_object_cache ))) return T_OUTOFMEMORY;
+    impl->VulkanSwapchainObject_iface.lpVtbl = &vulkan_swapchain_interface;
+    impl->instance = instance;
+    impl->device = device;
+    impl->physical = info->Device;
+    impl->requestedMode = impl->mode = settings->PresentMode;
+    impl->slotCount = settings->FramesInFlight ? Clamp( settings->FramesInFlight, 1, VULKAN_SWAPCHAIN_MAX_FRAMES ) : VULKAN_SWAPCHAIN_DEFAULT_FRAMES;
+    impl->acquired = UINT32_MAX;
+    impl->requested = (VkExtent2D){ settings->Width, settings->Height };
+    impl->ref = 1;
+
+    instance->lpVtbl->AddRef( instance );
+    device->lpVtbl->AddRef( device );
+    device->lpVtbl->get_Handle( device, &impl->handle );
+    pthread_mutex_init( &impl->lock, nullptr );
+
+    if ( FAILED(( status = instance->lpVtbl->CreateSurface( instance, window, &impl->surface ) )) ||
+         FAILED(( status = device->lpVtbl->GetQueue( device, VulkanQueueRole_Graphics, &impl->queue ) )) ||
+         FAILED(( status = CheckPresentSupport( impl ) )) ||
+         FAILED(( status = CreateSlots( impl ) )) )
+    {
+        ERROR( "Failed to create a swapchain on %s\n", info->Properties.deviceName );
+        DestroySwapchain( impl );
+        return status;
+    }
+
+    // A window without area yet gets its swapchain at the first AcquireFrame after a Resize.
+    if ( FAILED(( status = Recreate( impl ) )) && status != T_NOINIT )
+    {
+        DestroySwapchain( impl );
+        return status;
+    }
+
+    *out = &impl->VulkanSwapchainObject_iface;
+
+    TRACE( "created VulkanSwapchainObject %p\n", *out );
+
+    return T_SUCCESS;
+}
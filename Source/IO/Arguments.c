@@ -34,10 +34,25 @@
 
 GlobalArguments GlobalArgumentsDefault =
 {
-    .GPUName = "AMD Radeon RX 5600 XT (RADV NAVI10)",
+    .GPUName = nullptr,                             // Picked by score unless given
     .LogLevel = 3,
     .LogFile = nullptr,
     .ColoredTerminalOutput = true,
+    .LogMaxSize = 64,
+    .LogMaxSegments = 8,
+    .LogRotateInterval = 0,
+    .LogFsync = "interval",
+    .LogDirectIO = false,
+    .LogCompress = true,
+    .TraceRate = 1000,
+    .TraceBurst = 100,
+    .TraceSample = 1,
+    .TraceOut = nullptr,
+    .PerfCounters = false,
+    .StartupProfile = false,
+    .BenchmarkStartup = nullptr,
+    .BenchmarkRender = nullptr,
+    .BenchmarkRecording = nullptr,
 };
 
 static TR_STATUS
@@ -51,6 +66,36 @@ InitGlobalArguments()
     Available_Arguments[4].Value = &GlobalArgumentsDefault.LogFile;
     // --colored-terminal-output
     Available_Arguments[5].Value = &GlobalArgumentsDefault.ColoredTerminalOutput;
+    // --log-max-size
+    Available_Arguments[6].Value = &GlobalArgumentsDefault.LogMaxSize;
+    // --log-max-segments
+    Available_Arguments[7].Value = &GlobalArgumentsDefault.LogMaxSegments;
+    // --log-rotate-interval
+    Available_Arguments[8].Value = &GlobalArgumentsDefault.LogRotateInterval;
+    // --log-fsync
+    Available_Arguments[9].Value = &GlobalArgumentsDefault.LogFsync;
+    // --log-direct-io
+    Available_Arguments[10].Value = &GlobalArgumentsDefault.LogDirectIO;
+    // --log-compress
+    Available_Arguments[11].Value = &GlobalArgumentsDefault.LogCompress;
+    // --trace-rate
+    Available_Arguments[12].Value = &GlobalArgumentsDefault.TraceRate;
+    // --trace-burst
+    Available_Arguments[13].Value = &GlobalArgumentsDefault.TraceBurst;
+    // --trace-sample
+    Available_Arguments[14].Value = &GlobalArgumentsDefault.TraceSample;
+    // --trace-out
+    Available_Arguments[15].Value = &GlobalArgumentsDefault.TraceOut;
+    // --perf-counters
+    Available_Arguments[16].Value = &GlobalArgumentsDefault.PerfCounters;
+    // --startup-profile
+    Available_Arguments[17].Value = &GlobalArgumentsDefault.StartupProfile;
+    // --benchmark-startup
+    Available_Arguments[18].Value = &GlobalArgumentsDefault.BenchmarkStartup;
+    // --benchmark-render
+    Available_Arguments[19].Value = &GlobalArgumentsDefault.BenchmarkRender;
+    // --benchmark-recording
+    Available_Arguments[20].Value = &GlobalArgumentsDefault.BenchmarkRecording;
 
     return T_SUCCESS;
 }
@@ -81,6 +126,10 @@ ParseCommandLineArguments(
             {
                 if ( strncmp( arguments[iterator] + 2, Available_Arguments[secondIterator].Name, strlen( Available_Arguments[secondIterator].Name ) ) == 0 )
                 {
+                    // Don't let a previous argument's value leak into a bare boolean flag.
+                    val = nullptr;
+                    valSize = 0;
+
                     /**
                      *  There are 2 situations here:
                      *      --arg=val
@@ -25,6 +25,7 @@
 
 #include <IO/FetchResources.h>
 #include <IO/Logging.h>
+#include <Core/Memory/Memory.h>
 
 #ifdef __linux__
 #include <linux/limits.h>
@@ -51,32 +52,32 @@ FetchResource(
     // First pass: Binary root
     path = "./Resources";
     resourcePathSize = strlen( pathBuf ) + strlen( path ) + strlen( resourceName ) + 4;
-    resourcePath = (TRString)malloc( resourcePathSize * sizeof( TRChar ) );
+    resourcePath = (TRString)TRAlloc( resourcePathSize * sizeof( TRChar ), MEMORY_TAG_PATH );
     snprintf( resourcePath, resourcePathSize, "%s/%s/%s", pathBuf, path, resourceName );
     status = FetchPath( resourcePath, false, T_READ, outResourcePath );
-    free( resourcePath );
+    TRFree( resourcePath );
     if ( !FAILED( status ) ) return T_SUCCESS;
 
     // Second pass: Source dir
     path = "../Resources";
     resourcePathSize = strlen( pathBuf ) + strlen( path ) + strlen( resourceName ) + 5;
-    resourcePath = (TRString)malloc( resourcePathSize * sizeof( TRChar ) );
+    resourcePath = (TRString)TRAlloc( resourcePathSize * sizeof( TRChar ), MEMORY_TAG_PATH );
     snprintf( resourcePath, resourcePathSize, "%s/%s/%s", pathBuf, path, resourceName );
     TRACE(" resourcePath is %s\n", resourcePath);
     status = FetchPath( resourcePath, false, T_READ, outResourcePath );
-    free( resourcePath );
+    TRFree( resourcePath );
     if ( !FAILED( status ) ) return T_SUCCESS;
 
     // Third pass: Install dir
     path = RESOURCE_DIR;
     resourcePathSize = strlen( path ) + strlen( resourceName ) + 3;
-    resourcePath = (TRString)malloc( resourcePathSize * sizeof( TRChar ) );
+    resourcePath = (TRString)TRAlloc( resourcePathSize * sizeof( TRChar ), MEMORY_TAG_PATH );
     snprintf( resourcePath, resourcePathSize, "%s/%s", path, resourceName );
     status = FetchPath( resourcePath, false, T_READ, outResourcePath );
 
     if ( FAILED( status ) )
         ERROR( "Failed to fetch resources! Make sure %s exists!\n", resourcePath );
-    free( resourcePath );
+    TRFree( resourcePath );
 
     return status;
 }
@@ -0,0 +1,743 @@
+/*
+ * Copyright (c) 2025 Weather
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ *  Module: LogSink.c
+ *  Description: Buffered, size capped and rotating log file writer.
+ */
+
+#define _GNU_SOURCE // O_DIRECT
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <zlib.h>
+
+#include <IO/LogSink.h>
+#include <Core/Memory/Memory.h>
+
+// O_DIRECT wants the buffer address, the length and the file offset aligned to the logical block size.
+#define LOG_SINK_ALIGNMENT 4096
+#define LOG_SINK_DEFAULT_BUFFER_SIZE (1024 * 1024)
+#define LOG_SINK_TICK 1
+
+#define ALIGN_UP( value, alignment ) \
+    (((value) + (alignment) - 1) & ~((TRSize)(alignment) - 1))
+
+/**
+ * NOTE: Nothing in here may use INFO/WARN/ERROR/TRACE. Those end up in WriteLogSink()
+ *       and would deadlock on the sink lock. Problems are reported on stderr instead.
+ */
+struct _TR_LogSink
+{
+    LogSinkOptions options;
+    TRString location;
+
+    // --- Active segment, only touched by the writer thread after OpenLogSink() --- //
+    TRInt fd;
+    TRBool directIO;
+    TRBool dirty;
+    off_t fileSize;
+    TRChar *carry;          // Unaligned tail of the last direct write. It is rewritten in place by the next one.
+    TRSize carryLength;
+    time_t segmentOpened;
+    time_t lastSync;
+    TRULong segmentSerial;
+
+    // --- Double buffer, guarded by lock --- //
+    TRChar *buffers[2];
+    TRSize used[2];
+    TRSize capacity;
+    TRInt front;
+    TRBool backPending;
+    TRULong dropped;
+    TRBool running;
+    TRBool flushRequested;
+    TRBool syncRequested;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t drained;
+    pthread_t writer;
+
+    // --- Closed segments waiting for compression and pruning, guarded by compressLock --- //
+    TRString *pending;
+    TRSize pendingCount;
+    TRSize pendingCapacity;
+    TRBool compressorStarted;
+    TRBool compressorRunning;
+    pthread_mutex_t compressLock;
+    pthread_cond_t compressWake;
+    pthread_t compressor;
+};
+
+static TR_STATUS
+OpenSegment(
+    IN struct _TR_LogSink *sink
+) {
+    struct stat statInfo;
+    off_t blockStart;
+    ssize_t readBytes;
+
+    sink->directIO = false;
+    sink->dirty = false;
+    sink->carryLength = 0;
+    sink->fd = -1;
+
+    if ( sink->options.DirectIO )
+    {
+        sink->fd = open( sink->location, O_RDWR | O_CREAT | O_CLOEXEC | O_DIRECT, 0644 );
+        if ( sink->fd >= 0 )
+            sink->directIO = true;
+        else
+            fprintf( stderr, "LogSink: O_DIRECT is not available for %s (%s), using buffered writes.\n", sink->location, strerror( errno ) );
+    }
+
+    if ( sink->fd < 0 )
+        sink->fd = open( sink->location, O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+
+    if ( sink->fd < 0 )
+    {
+        fprintf( stderr, "LogSink: Could not open %s (%s)\n", sink->location, strerror( errno ) );
+        return errno == EACCES ? T_ACCESSDENIED : T_HANDLE;
+    }
+
+    if ( fstat( sink->fd, &statInfo ) )
+    {
+        close( sink->fd );
+        sink->fd = -1;
+        return T_HANDLE;
+    }
+
+    sink->fileSize = statInfo.st_size;
+    sink->segmentOpened = time( nullptr );
+    sink->lastSync = sink->segmentOpened;
+
+    if ( sink->directIO && sink->fileSize % LOG_SINK_ALIGNMENT )
+    {
+        // Appending to an existing file. Pick up its partial last block so the next write can rewrite it.
+        blockStart = sink->fileSize - sink->fileSize % LOG_SINK_ALIGNMENT;
+        readBytes = pread( sink->fd, sink->carry, LOG_SINK_ALIGNMENT, blockStart );
+        if ( readBytes != sink->fileSize - blockStart )
+        {
+            fprintf( stderr, "LogSink: Could not read the tail of %s, using buffered writes.\n", sink->location );
+            close( sink->fd );
+            sink->options.DirectIO = false;
+            return OpenSegment( sink );
+        }
+        sink->carryLength = readBytes;
+    }
+
+    return T_SUCCESS;
+}
+
+static void
+CloseSegment(
+    IN struct _TR_LogSink *sink
+) {
+    if ( sink->fd < 0 )
+        return;
+
+    if ( sink->options.FsyncPolicy != LOG_FSYNC_NEVER )
+        fdatasync( sink->fd );
+
+    close( sink->fd );
+    sink->fd = -1;
+}
+
+static TR_STATUS
+WriteSegment(
+    IN struct _TR_LogSink *sink,
+    IN TRChar *data,
+    IN TRSize length
+) {
+    TRSize total = length;
+    TRSize padded;
+    TRSize written = 0;
+    ssize_t result;
+    off_t base = sink->fileSize;
+
+    if ( sink->fd < 0 )
+        return T_HANDLE;
+
+    if ( sink->directIO )
+    {
+        // Every buffer has 2 * LOG_SINK_ALIGNMENT bytes of slack for the carried tail and the padding.
+        memmove( data + sink->carryLength, data, length );
+        memcpy( data, sink->carry, sink->carryLength );
+        total += sink->carryLength;
+        base -= (off_t)sink->carryLength;
+        padded = ALIGN_UP( total, LOG_SINK_ALIGNMENT );
+        memset( data + total, 0, padded - total );
+    }
+    else
+        padded = total;
+
+    while ( written < padded )
+    {
+        result = pwrite( sink->fd, data + written, padded - written, base + (off_t)written );
+        if ( result < 0 )
+        {
+            if ( errno == EINTR )
+                continue;
+            fprintf( stderr, "LogSink: Write to %s failed (%s), %zu bytes lost.\n", sink->location, strerror( errno ), length );
+            return T_ERROR;
+        }
+        written += result;
+    }
+
+    sink->fileSize = base + (off_t)total;
+    sink->dirty = true;
+
+    if ( sink->directIO )
+    {
+        // Drop the zero padding again, it gets overwritten by the next aligned write.
+        if ( padded != total && ftruncate( sink->fd, sink->fileSize ) )
+            fprintf( stderr, "LogSink: Could not truncate %s (%s)\n", sink->location, strerror( errno ) );
+
+        sink->carryLength = total % LOG_SINK_ALIGNMENT;
+        memcpy( sink->carry, data + total - sink->carryLength, sink->carryLength );
+    }
+
+    return T_SUCCESS;
+}
+
+static TRInt
+CompareSegmentNames(
+    IN const void *first,
+    IN const void *second
+) {
+    return strcmp( *(TRString const *)first, *(TRString const *)second );
+}
+
+static void
+PruneSegments(
+    IN struct _TR_LogSink *sink
+) {
+    DIR *directory;
+    struct dirent *entry;
+    TRString locationCopy;
+    TRString directoryName;
+    TRString baseName;
+    TRString *names = nullptr;
+    TRString *reallocNames;
+    TRSize nameCount = 0;
+    TRSize nameCapacity = 0;
+    TRSize prefixLength;
+    TRSize iterator;
+    TRChar path[PATH_MAX];
+
+    if ( !sink->options.MaxSegments )
+        return;
+
+    if ( !(locationCopy = TRStrdup( sink->location, MEMORY_TAG_LOGGING )) )
+        return;
+
+    directoryName = dirname( locationCopy );
+    baseName = strrchr( sink->location, '/' ) ? strrchr( sink->location, '/' ) + 1 : sink->location;
+    prefixLength = strlen( baseName );
+
+    if ( !(directory = opendir( directoryName )) )
+    {
+        TRFree( locationCopy );
+        return;
+    }
+
+    // Closed segments are named <log>.<YYYYmmdd-HHMMSS>.<serial>[.gz], so sorting by name sorts by age.
+    while ( (entry = readdir( directory )) )
+    {
+        if ( strncmp( entry->d_name, baseName, prefixLength ) || entry->d_name[prefixLength] != '.' )
+            continue;
+        if ( entry->d_name[prefixLength + 1] < '0' || entry->d_name[prefixLength + 1] > '9' )
+            continue;
+        if ( strstr( entry->d_name, ".tmp" ) )
+            continue;
+
+        if ( nameCount == nameCapacity )
+        {
+            nameCapacity = nameCapacity ? nameCapacity * 2 : 16;
+            if ( !(reallocNames = TRRealloc( names, nameCapacity * sizeof( *names ), MEMORY_TAG_LOGGING )) )
+                break;
+            names = reallocNames;
+        }
+        if ( !(names[nameCount] = TRStrdup( entry->d_name, MEMORY_TAG_LOGGING )) )
+            break;
+        nameCount++;
+    }
+    closedir( directory );
+
+    qsort( names, nameCount, sizeof( *names ), CompareSegmentNames );
+
+    for ( iterator = 0; iterator < nameCount; iterator++ )
+    {
+        if ( nameCount - iterator > sink->options.MaxSegments )
+        {
+            snprintf( path, sizeof( path ), "%s/%s", directoryName, names[iterator] );
+            if ( unlink( path ) )
+                fprintf( stderr, "LogSink: Could not remove old segment %s (%s)\n", path, strerror( errno ) );
+        }
+        TRFree( names[iterator] );
+    }
+
+    TRFree( names );
+    TRFree( locationCopy );
+}
+
+static TRBool
+CompressSegment(
+    IN TRCString path
+) {
+    TRChar buffer[64 * 1024];
+    TRChar temporaryPath[PATH_MAX];
+    TRChar compressedPath[PATH_MAX];
+    TRBool success = true;
+    ssize_t readBytes;
+    gzFile compressed;
+    TRInt input;
+
+    snprintf( temporaryPath, sizeof( temporaryPath ), "%s.gz.tmp", path );
+    snprintf( compressedPath, sizeof( compressedPath ), "%s.gz", path );
+
+    if ( (input = open( path, O_RDONLY | O_CLOEXEC )) < 0 )
+        return false;
+
+    if ( !(compressed = gzopen( temporaryPath, "wb6" )) )
+    {
+        close( input );
+        return false;
+    }
+
+    while ( (readBytes = read( input, buffer, sizeof( buffer ) )) > 0 )
+    {
+        if ( gzwrite( compressed, buffer, (unsigned)readBytes ) != readBytes )
+        {
+            success = false;
+            break;
+        }
+    }
+
+    if ( readBytes < 0 )
+        success = false;
+    if ( gzclose( compressed ) != Z_OK )
+        success = false;
+    close( input );
+
+    if ( success && !rename( temporaryPath, compressedPath ) )
+    {
+        unlink( path );
+        return true;
+    }
+
+    fprintf( stderr, "LogSink: Could not compress %s, keeping it uncompressed.\n", path );
+    unlink( temporaryPath );
+    return false;
+}
+
+static void *
+CompressorThread(
+    IN void *param
+) {
+    TRString path;
+    struct _TR_LogSink *sink = param;
+
+    pthread_mutex_lock( &sink->compressLock );
+    for ( ;; )
+    {
+        while ( !sink->pendingCount && sink->compressorRunning )
+            pthread_cond_wait( &sink->compressWake, &sink->compressLock );
+
+        if ( !sink->pendingCount )
+            break;
+
+        path = sink->pending[0];
+        memmove( sink->pending, sink->pending + 1, --sink->pendingCount * sizeof( *sink->pending ) );
+        pthread_mutex_unlock( &sink->compressLock );
+
+        if ( sink->options.Compress )
+            CompressSegment( path );
+        PruneSegments( sink );
+        TRFree( path );
+
+        pthread_mutex_lock( &sink->compressLock );
+    }
+    pthread_mutex_unlock( &sink->compressLock );
+
+    return nullptr;
+}
+
+static void
+QueueClosedSegment(
+    IN struct _TR_LogSink *sink,
+    IN TRString path
+) {
+    TRString *reallocPending;
+
+    pthread_mutex_lock( &sink->compressLock );
+    if ( sink->pendingCount == sink->pendingCapacity )
+    {
+        sink->pendingCapacity = sink->pendingCapacity ? sink->pendingCapacity * 2 : 4;
+        if ( !(reallocPending = TRRealloc( sink->pending, sink->pendingCapacity * sizeof( *sink->pending ), MEMORY_TAG_LOGGING )) )
+        {
+            pthread_mutex_unlock( &sink->compressLock );
+            TRFree( path );
+            return;
+        }
+        sink->pending = reallocPending;
+    }
+    sink->pending[sink->pendingCount++] = path;
+    pthread_cond_signal( &sink->compressWake );
+    pthread_mutex_unlock( &sink->compressLock );
+}
+
+static void
+RotateSegment(
+    IN struct _TR_LogSink *sink,
+    IN time_t now
+) {
+    TRChar stamp[32];
+    TRString closedPath;
+    TRSize closedPathSize;
+    struct tm timeInfo;
+
+    if ( !sink->fileSize )
+    {
+        sink->segmentOpened = now;
+        return;
+    }
+
+    CloseSegment( sink );
+
+    localtime_r( &now, &timeInfo );
+    strftime( stamp, sizeof( stamp ), "%Y%m%d-%H%M%S", &timeInfo );
+
+    closedPathSize = strlen( sink->location ) + strlen( stamp ) + 24;
+    if ( (closedPath = TRAlloc( closedPathSize, MEMORY_TAG_LOGGING )) )
+    {
+        snprintf( closedPath, closedPathSize, "%s.%s.%04lu", sink->location, stamp, sink->segmentSerial++ );
+        if ( rename( sink->location, closedPath ) )
+        {
+            fprintf( stderr, "LogSink: Could not rotate %s (%s)\n", sink->location, strerror( errno ) );
+            TRFree( closedPath );
+            closedPath = nullptr;
+        }
+    }
+
+    OpenSegment( sink );
+
+    if ( closedPath )
+        QueueClosedSegment( sink, closedPath );
+}
+
+static void
+MaintainSegment(
+    IN struct _TR_LogSink *sink,
+    IN time_t now,
+    IN TRBool syncRequested
+) {
+    if ( sink->fd < 0 )
+        return;
+
+    if ( sink->dirty && ( syncRequested ||
+         ( sink->options.FsyncPolicy == LOG_FSYNC_INTERVAL && now - sink->lastSync >= sink->options.FsyncInterval ) ) )
+    {
+        fdatasync( sink->fd );
+        sink->dirty = false;
+        sink->lastSync = now;
+    }
+
+    // Rotation happens at buffer granularity, so a segment may overshoot the cap by at most one buffer.
+    if ( ( sink->options.MaxSegmentSize && (TRSize)sink->fileSize >= sink->options.MaxSegmentSize ) ||
+         ( sink->options.RotateInterval && now - sink->segmentOpened >= sink->options.RotateInterval ) )
+        RotateSegment( sink, now );
+}
+
+static void *
+WriterThread(
+    IN void *param
+) {
+    struct timespec deadline;
+    TRBool syncRequested;
+    TRInt back;
+    TRInt noticeLength;
+    struct _TR_LogSink *sink = param;
+
+    pthread_mutex_lock( &sink->lock );
+    while ( sink->running || sink->backPending || sink->used[sink->front] )
+    {
+        if ( sink->running && !sink->backPending && !sink->flushRequested )
+        {
+            clock_gettime( CLOCK_REALTIME, &deadline );
+            deadline.tv_sec += LOG_SINK_TICK;
+            pthread_cond_timedwait( &sink->wake, &sink->lock, &deadline );
+        }
+
+        // Hand partially filled buffers over on every tick so records reach the file in time.
+        if ( !sink->backPending && sink->used[sink->front] )
+        {
+            sink->front ^= 1;
+            sink->backPending = true;
+        }
+
+        syncRequested = sink->syncRequested;
+        sink->flushRequested = false;
+        sink->syncRequested = false;
+
+        if ( sink->backPending )
+        {
+            back = sink->front ^ 1;
+            pthread_mutex_unlock( &sink->lock );
+
+            WriteSegment( sink, sink->buffers[back], sink->used[back] );
+
+            pthread_mutex_lock( &sink->lock );
+            sink->used[back] = 0;
+            sink->backPending = false;
+
+            if ( sink->dropped )
+            {
+                noticeLength = snprintf( sink->buffers[sink->front] + sink->used[sink->front], sink->capacity - sink->used[sink->front],
+                                         "// --- log sink fell behind, dropped %lu records --- //\n", sink->dropped );
+                if ( noticeLength > 0 && (TRSize)noticeLength < sink->capacity - sink->used[sink->front] )
+                {
+                    sink->used[sink->front] += noticeLength;
+                    sink->dropped = 0;
+                }
+            }
+        }
+        pthread_cond_broadcast( &sink->drained );
+
+        pthread_mutex_unlock( &sink->lock );
+        MaintainSegment( sink, time( nullptr ), syncRequested );
+        pthread_mutex_lock( &sink->lock );
+    }
+    pthread_mutex_unlock( &sink->lock );
+
+    return nullptr;
+}
+
+static void
+FreeLogSink(
+    IN struct _TR_LogSink *sink
+) {
+    TRSize iterator;
+
+    for ( iterator = 0; iterator < sink->pendingCount; iterator++ )
+        TRFree( sink->pending[iterator] );
+    TRFree( sink->pending );
+    TRFree( sink->buffers[0] );
+    TRFree( sink->buffers[1] );
+    TRFree( sink->carry );
+    TRFree( sink->location );
+    pthread_mutex_destroy( &sink->lock );
+    pthread_cond_destroy( &sink->wake );
+    pthread_cond_destroy( &sink->drained );
+    pthread_mutex_destroy( &sink->compressLock );
+    pthread_cond_destroy( &sink->compressWake );
+    TRFree( sink );
+}
+
+TR_STATUS
+ParseLogFsyncPolicy(
+    IN TRCString name,
+    OUT LogFsyncPolicy *out
+) {
+    if ( !name || !out )
+        return T_INVALIDARG;
+
+    if ( !strcmp( name, "never" ) )
+        *out = LOG_FSYNC_NEVER;
+    else if ( !strcmp( name, "interval" ) )
+        *out = LOG_FSYNC_INTERVAL;
+    else if ( !strcmp( name, "on-error" ) )
+        *out = LOG_FSYNC_ON_ERROR;
+    else
+        return T_INVALIDARG;
+
+    return T_SUCCESS;
+}
+
+TR_STATUS
+OpenLogSink(
+    IN TRCString location,
+    IN const LogSinkOptions *options,
+    OUT LogSink **out
+) {
+    TR_STATUS status;
+    TRSize bufferBytes;
+    struct _TR_LogSink *sink;
+
+    if ( !location || !options || !out )
+        return T_INVALIDARG;
+
+    *out = nullptr;
+
+    if ( !(sink = TRCalloc( 1, sizeof( *sink ), MEMORY_TAG_LOGGING )) )
+        return T_OUTOFMEMORY;
+
+    sink->options = *options;
+    sink->capacity = ALIGN_UP( options->BufferSize ? options->BufferSize : LOG_SINK_DEFAULT_BUFFER_SIZE, LOG_SINK_ALIGNMENT );
+    sink->fd = -1;
+    pthread_mutex_init( &sink->lock, nullptr );
+    pthread_cond_init( &sink->wake, nullptr );
+    pthread_cond_init( &sink->drained, nullptr );
+    pthread_mutex_init( &sink->compressLock, nullptr );
+    pthread_cond_init( &sink->compressWake, nullptr );
+
+    bufferBytes = sink->capacity + 2 * LOG_SINK_ALIGNMENT;
+    if ( !(sink->location = TRStrdup( location, MEMORY_TAG_LOGGING )) ||
+         !(sink->buffers[0] = TRAlignedAlloc( LOG_SINK_ALIGNMENT, bufferBytes, MEMORY_TAG_LOGGING )) ||
+         !(sink->buffers[1] = TRAlignedAlloc( LOG_SINK_ALIGNMENT, bufferBytes, MEMORY_TAG_LOGGING )) ||
+         !(sink->carry = TRAlignedAlloc( LOG_SINK_ALIGNMENT, LOG_SINK_ALIGNMENT, MEMORY_TAG_LOGGING )) )
+    {
+        FreeLogSink( sink );
+        return T_OUTOFMEMORY;
+    }
+
+    status = OpenSegment( sink );
+    if ( FAILED( status ) )
+    {
+        FreeLogSink( sink );
+        return status;
+    }
+
+    sink->running = true;
+    if ( pthread_create( &sink->writer, nullptr, WriterThread, sink ) )
+    {
+        CloseSegment( sink );
+        FreeLogSink( sink );
+        return T_ERROR;
+    }
+
+    if ( sink->options.MaxSegmentSize || sink->options.RotateInterval )
+    {
+        sink->compressorRunning = true;
+        sink->compressorStarted = !pthread_create( &sink->compressor, nullptr, CompressorThread, sink );
+    }
+
+    *out = sink;
+
+    return T_SUCCESS;
+}
+
+TR_STATUS
+WriteLogSink(
+    IN LogSink *sink,
+    IN TRCString message,
+    IN TRSize length,
+    IN TRBool urgent
+) {
+    if ( !sink || !message )
+        return T_INVALIDARG;
+
+    // A single record never spans both buffers.
+    if ( length > sink->capacity )
+        length = sink->capacity;
+
+    pthread_mutex_lock( &sink->lock );
+    if ( !sink->running )
+    {
+        pthread_mutex_unlock( &sink->lock );
+        return T_ILLEGAL_METHOD_CALL;
+    }
+
+    if ( sink->used[sink->front] + length > sink->capacity )
+    {
+        if ( sink->backPending )
+        {
+            // The writer is still busy with the other buffer. Never block the caller on disk I/O.
+            sink->dropped++;
+            pthread_mutex_unlock( &sink->lock );
+            return T_OUTOFMEMORY;
+        }
+
+        sink->front ^= 1;
+        sink->backPending = true;
+        pthread_cond_signal( &sink->wake );
+    }
+
+    memcpy( sink->buffers[sink->front] + sink->used[sink->front], message, length );
+    sink->used[sink->front] += length;
+
+    if ( urgent && sink->options.FsyncPolicy == LOG_FSYNC_ON_ERROR )
+    {
+        sink->flushRequested = true;
+        sink->syncRequested = true;
+        pthread_cond_signal( &sink->wake );
+    }
+    pthread_mutex_unlock( &sink->lock );
+
+    return T_SUCCESS;
+}
+
+TR_STATUS
+FlushLogSink(
+    IN LogSink *sink
+) {
+    if ( !sink )
+        return T_INVALIDARG;
+
+    pthread_mutex_lock( &sink->lock );
+    while ( sink->running && ( sink->backPending || sink->used[sink->front] ) )
+    {
+        sink->flushRequested = true;
+        pthread_cond_signal( &sink->wake );
+        pthread_cond_wait( &sink->drained, &sink->lock );
+    }
+    pthread_mutex_unlock( &sink->lock );
+
+    return T_SUCCESS;
+}
+
+void
+CloseLogSink(
+    IN LogSink *sink
+) {
+    if ( !sink )
+        return;
+
+    // The writer drains both buffers before it exits.
+    pthread_mutex_lock( &sink->lock );
+    sink->running = false;
+    pthread_cond_signal( &sink->wake );
+    pthread_mutex_unlock( &sink->lock );
+    pthread_join( sink->writer, nullptr );
+
+    if ( sink->compressorStarted )
+    {
+        pthread_mutex_lock( &sink->compressLock );
+        sink->compressorRunning = false;
+        pthread_cond_signal( &sink->compressWake );
+        pthread_mutex_unlock( &sink->compressLock );
+        pthread_join( sink->compressor, nullptr );
+    }
+
+    CloseSegment( sink );
+    FreeLogSink( sink );
+}
@@ -30,11 +30,18 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <time.h>
+#include <sched.h>
 
 #include <IO/Logging.h>
+#include <Core/Memory/Memory.h>
+#include <IO/LogSink.h>
 #include <IO/Arguments.h>
 #include <Statics.h>
 
+static _Atomic(LogSink *) LogFileSink = nullptr;
+static _Atomic(TRLong) LogSinkWriters = 0;      // Threads inside WriteLogSink(), ShutdownLogging() waits them out
+static _Atomic(Log_Site *) LogSites = nullptr;
+
 static TR_STATUS
 ParseMessage(
     IN TRCString format,
@@ -57,7 +64,7 @@ ParseMessage(
 
     fmtSize = strlen(format) + 1;
 
-    buffer = (TRString)malloc( fmtSize * sizeof( TRChar ) );
+    buffer = (TRString)TRAlloc( fmtSize * sizeof( TRChar ), MEMORY_TAG_LOGGING );
     if ( !buffer )
         return T_OUTOFMEMORY;
     buffer[0] = '\0';
@@ -86,10 +93,10 @@ ParseMessage(
 
                 fmtSize += strlen( dateStr );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -125,10 +132,10 @@ ParseMessage(
                 }
                 fmtSize += strlen( timeStr );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -156,10 +163,10 @@ ParseMessage(
                 }
                 fmtSize += strlen( versionString );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -212,10 +219,10 @@ ParseMessage(
                 }
                 fmtSize += strlen( logCategoryStr );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -244,10 +251,10 @@ ParseMessage(
                 }
                 fmtSize += strlen( threadString );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -274,10 +281,10 @@ ParseMessage(
                 }
                 fmtSize += strlen( module );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -304,10 +311,10 @@ ParseMessage(
                 }
                 fmtSize += strlen( function );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -329,10 +336,10 @@ ParseMessage(
                 fmtSize -= strlen( "$MESSAGE" );
                 fmtSize += strlen( message );
 
-                reallocBuffer = realloc( buffer, fmtSize );
+                reallocBuffer = TRRealloc( buffer, fmtSize, MEMORY_TAG_LOGGING );
                 if ( !reallocBuffer )
                 {
-                    free( buffer );
+                    TRFree( buffer );
                     return T_OUTOFMEMORY;
                 }
 
@@ -370,6 +377,7 @@ TraceRayer_DEBUG(
     TRString parsedMessage;
     TRString buffer;
     TRSize bufferSize;
+    LogSink *sink;
 
     if ( GlobalArgumentsDefault.LogLevel < category )
         return;
@@ -379,7 +387,7 @@ TraceRayer_DEBUG(
     bufferSize = vsnprintf( nullptr, 0, fmt, ap_copy );
     va_end( ap_copy );
 
-    buffer = (TRString)malloc( bufferSize + 1 );
+    buffer = (TRString)TRAlloc( bufferSize + 1, MEMORY_TAG_LOGGING );
     if ( !buffer )
     {
         va_end( ap );
@@ -391,16 +399,131 @@ TraceRayer_DEBUG(
 
     ParseMessage( LOG_FORMAT, GlobalArgumentsDefault.ColoredTerminalOutput, category, threadId, module, function, buffer, &parsedMessage );
     fprintf( stdout, "%s", parsedMessage );
-    free(parsedMessage);
+    TRFree( parsedMessage );
 
-    if ( GlobalArgumentsDefault.LogFile )
+    // Counted before the sink is loaded, so ShutdownLogging() either sees this writer or it sees no sink.
+    atomic_fetch_add( &LogSinkWriters, 1 );
+    if (( sink = atomic_load( &LogFileSink ) ))
+    {
+        ParseMessage( LOG_FORMAT, false, category, threadId, module, function, buffer, &parsedMessage );
+        WriteLogSink( sink, parsedMessage, strlen( parsedMessage ), category == LOG_CATEGORY_ERROR );
+        TRFree( parsedMessage );
+    }
+    else if ( GlobalArgumentsDefault.LogFile && GlobalArgumentsDefault.LogFile->FileHandle )
     {
+        // Messages logged before InitializeLogging() has set up the sink.
         ParseMessage( LOG_FORMAT, false, category, threadId, module, function, buffer, &parsedMessage );
         fprintf( GlobalArgumentsDefault.LogFile->FileHandle, "%s", parsedMessage );
-        free(parsedMessage);
+        TRFree( parsedMessage );
+    }
+    atomic_fetch_sub( &LogSinkWriters, 1 );
+
+    TRFree( buffer );
+}
+
+static TRULong
+MonotonicNanoseconds()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (TRULong)now.tv_sec * 1000000000UL + (TRULong)now.tv_nsec;
+}
+
+static void
+SummariseLogSite(
+    IN Log_Site *site,
+    IN TRCString module,
+    IN TRCString function
+) {
+    TRChar countString[24];
+    TRULong suppressed = atomic_exchange( &site->Suppressed, 0 );
+
+    if ( !suppressed )
+        return;
+
+    if ( suppressed >= 1000000000UL )
+        snprintf( countString, sizeof( countString ), "%.1fG", (TRFloat)suppressed / 1e9 );
+    else if ( suppressed >= 1000000UL )
+        snprintf( countString, sizeof( countString ), "%.1fM", (TRFloat)suppressed / 1e6 );
+    else if ( suppressed >= 1000UL )
+        snprintf( countString, sizeof( countString ), "%.1fK", (TRFloat)suppressed / 1e3 );
+    else
+        snprintf( countString, sizeof( countString ), "%lu", suppressed );
+
+    TraceRayer_DEBUG( LOG_CATEGORY_TRACE, gettid(), module, function, "suppressed %s messages from %s::%s\n", countString, module, function );
+}
+
+static void
+SummariseLogSites()
+{
+    Log_Site *site;
+
+    for ( site = atomic_load( &LogSites ); site; site = site->Next )
+        SummariseLogSite( site, site->Module, site->Function );
+}
+
+TRBool TR_API
+AdmitLogSite(
+    IN Log_Site *site,
+    IN TRCString module,
+    IN TRCString function
+) {
+    TRBool registered = false;
+    TRULong now = 0;
+    TRULong arrival;
+    TRULong next;
+    TRULong interval;
+    TRULong lastSummary;
+
+    if ( GlobalArgumentsDefault.LogLevel < LOG_CATEGORY_TRACE )
+        return false;
+
+    if ( !atomic_load_explicit( &site->Registered, memory_order_acquire ) &&
+         atomic_compare_exchange_strong( &site->Registered, &registered, true ) )
+    {
+        // Remember the site for the summary at exit.
+        site->Module = module;
+        site->Function = function;
+        site->Next = atomic_load( &LogSites );
+        while ( !atomic_compare_exchange_weak( &LogSites, &site->Next, site ) );
+    }
+
+    if ( GlobalArgumentsDefault.TraceSample > 1 &&
+         atomic_fetch_add_explicit( &site->Counter, 1, memory_order_relaxed ) % (TRULong)GlobalArgumentsDefault.TraceSample )
+        goto _SUPPRESS;
+
+    if ( GlobalArgumentsDefault.TraceRate > 0 )
+    {
+        /**
+         * GCRA: Every message pushes the theoretical arrival time one emission interval into the future.
+         * A message conforms as long as that time stays within the burst tolerance from now.
+         */
+        now = MonotonicNanoseconds();
+        interval = 1000000000UL / (TRULong)GlobalArgumentsDefault.TraceRate;
+        arrival = atomic_load_explicit( &site->ArrivalTime, memory_order_relaxed );
+        do
+        {
+            next = ( arrival > now ? arrival : now ) + interval;
+            if ( next - now > interval * (TRULong)( GlobalArgumentsDefault.TraceBurst > 0 ? GlobalArgumentsDefault.TraceBurst : 1 ) )
+                goto _SUPPRESS;
+        } while ( !atomic_compare_exchange_weak_explicit( &site->ArrivalTime, &arrival, next, memory_order_relaxed, memory_order_relaxed ) );
+    }
+
+    if ( atomic_load_explicit( &site->Suppressed, memory_order_relaxed ) )
+    {
+        if ( !now )
+            now = MonotonicNanoseconds();
+        lastSummary = atomic_load_explicit( &site->LastSummary, memory_order_relaxed );
+        if ( now - lastSummary >= TRACE_SUMMARY_INTERVAL * 1000000000UL &&
+             atomic_compare_exchange_strong( &site->LastSummary, &lastSummary, now ) )
+            SummariseLogSite( site, module, function );
     }
 
-    free( buffer );
+    return true;
+
+_SUPPRESS:
+    atomic_fetch_add_explicit( &site->Suppressed, 1, memory_order_relaxed );
+    return false;
 }
 
 TRString TR_API debugstr_uuid( IN const uuid_t uuid )
@@ -410,10 +533,25 @@ TRString TR_API debugstr_uuid( IN const uuid_t uuid )
     return str;
 }
 
+static void
+ShutdownLogging()
+{
+    LogSink *sink = atomic_exchange( &LogFileSink, nullptr );
+
+    // GTK and async pool threads may still log during exit, the sink is freed once the last of them left it.
+    while ( atomic_load( &LogSinkWriters ) )
+        sched_yield();
+    CloseLogSink( sink );
+}
+
 TR_STATUS TR_API
 InitializeLogging()
 {
+    TR_STATUS status;
     TRString parsedMessage;
+    LogSinkOptions options = {};
+    LogSink *sink;
+
     if ( GlobalArgumentsDefault.LogFile && GlobalArgumentsDefault.LogFile->Location )
     {
         if ( GlobalArgumentsDefault.LogFile->IsDirectory )
@@ -421,10 +559,39 @@ InitializeLogging()
 
         if ( !GlobalArgumentsDefault.LogFile->FileHandle )
             return T_HANDLE;
+
+        status = ParseLogFsyncPolicy( GlobalArgumentsDefault.LogFsync, &options.FsyncPolicy );
+        if ( FAILED( status ) )
+        {
+            fprintf( stderr, "Invalid --log-fsync policy '%s', expected never, interval or on-error.\n", GlobalArgumentsDefault.LogFsync );
+            return status;
+        }
+
+        options.BufferSize = LOGFILE_BUFFER_SIZE;
+        options.MaxSegmentSize = (TRSize)GlobalArgumentsDefault.LogMaxSize * 1024 * 1024;
+        options.RotateInterval = GlobalArgumentsDefault.LogRotateInterval;
+        options.MaxSegments = (TRUInt)GlobalArgumentsDefault.LogMaxSegments;
+        options.FsyncInterval = LOGFILE_FSYNC_INTERVAL;
+        options.DirectIO = GlobalArgumentsDefault.LogDirectIO;
+        options.Compress = GlobalArgumentsDefault.LogCompress;
+
+        status = OpenLogSink( GlobalArgumentsDefault.LogFile->Location, &options, &sink );
+        if ( FAILED( status ) )
+            return status;
+        atomic_store( &LogFileSink, sink );
+
+        // The sink owns its own descriptor from here on.
+        fclose( GlobalArgumentsDefault.LogFile->FileHandle );
+        GlobalArgumentsDefault.LogFile->FileHandle = nullptr;
+
+        atexit( ShutdownLogging );
     }
 
+    // Runs before ShutdownLogging(), so the summaries still make it into the log file.
+    atexit( SummariseLogSites );
+
     ParseMessage( LOGFILE_HEADER, GlobalArgumentsDefault.ColoredTerminalOutput, LOG_CATEGORY_INFO, 0, nullptr, nullptr, nullptr, &parsedMessage );
     printf("%s", parsedMessage);
-    free(parsedMessage);
+    TRFree( parsedMessage );
     return T_SUCCESS;
 }
\ No newline at end of file
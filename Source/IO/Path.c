@@ -40,6 +40,7 @@
 #endif
 
 #include <IO/Path.h>
+#include <Core/Memory/Memory.h>
 
 TR_STATUS
 FetchPath(
@@ -51,14 +52,12 @@ FetchPath(
     TRPath *newPath;
     TRString name;
     TRInt acs = 0;
+    TRBool isDirectory = false;
 
     if ( !path || *path == '\0' || !pathObject ) throw_NullPtrException();
 
     *pathObject = nullptr;
 
-    newPath = (TRPath *)calloc( 1, sizeof( *newPath ) );
-    if ( !newPath ) return T_OUTOFMEMORY;
-
     if ( strlen( path ) >= PATH_MAX )
         return T_INVALIDARG;
 
@@ -100,7 +99,7 @@ FetchPath(
         if ( FAILED( stat( path, &statInfo ) ) )
             return T_ERROR;
 
-        newPath->IsDirectory = S_ISDIR( statInfo.st_mode );
+        isDirectory = S_ISDIR( statInfo.st_mode );
     }
     else
     {
@@ -108,9 +107,8 @@ FetchPath(
         TRString lastSlash;
 
         // The root should still be accessible
-        rootPath = (TRString)malloc( (strlen( path ) + 1) * sizeof( TRChar ) );
+        rootPath = TRStrdup( path, MEMORY_TAG_PATH );
         if ( !rootPath ) return T_OUTOFMEMORY;
-        strcpy( rootPath, path );
 
         lastSlash = strrchr( rootPath, '/' );
         if ( lastSlash )
@@ -118,25 +116,35 @@ FetchPath(
 
         if ( FAILED( access( rootPath, F_OK ) ) )
         {
-            free ( rootPath );
+            TRFree( rootPath );
             return T_FILE_NOT_FOUND;
         }
 
         // Write access is necessary because we'll need to create a file here.
         if ( FAILED( access( rootPath, F_OK | W_OK | R_OK ) ) )
         {
-            free ( rootPath );
+            TRFree( rootPath );
             return T_ACCESSDENIED;
         }
 
-        free ( rootPath );
+        TRFree( rootPath );
+    }
+
+    // Freed in FreePath();
+    newPath = (TRPath *)TRCalloc( 1, sizeof( *newPath ), MEMORY_TAG_PATH );
+    if ( !newPath ) return T_OUTOFMEMORY;
+
+    name = strrchr( path, '/' ) ? strrchr( path, '/' ) + 1 : path;
+    newPath->Location = (TRString)TRAlloc( PATH_MAX * sizeof( TRChar ), MEMORY_TAG_PATH );
+    newPath->Name = TRStrdup( name, MEMORY_TAG_PATH );
+    if ( !newPath->Location || !newPath->Name )
+    {
+        FreePath( newPath );
+        return T_OUTOFMEMORY;
     }
 
-    newPath->Location = (TRString)malloc( PATH_MAX * sizeof( TRChar ) );
     realpath( path, newPath->Location );
-    name = strrchr( path, '/' ) + 1;
-    newPath->Name = (TRString)malloc( (strlen( name ) + 1) * sizeof( TRChar ) );
-    strcpy( newPath->Name, name );
+    newPath->IsDirectory = isDirectory;
     newPath->Access = accessType;
 
     switch ( accessType )
@@ -184,11 +192,27 @@ FetchSubpath(
     if ( !pathObject->IsDirectory )
         return T_ILLEGAL_METHOD_CALL;
 
-    newPath = (TRString)malloc( PATH_MAX * sizeof( TRChar ) );
+    newPath = (TRString)TRAlloc( PATH_MAX * sizeof( TRChar ), MEMORY_TAG_PATH );
+    if ( !newPath ) return T_OUTOFMEMORY;
     snprintf( newPath, PATH_MAX, "%s/%s", pathObject->Location, name );
 
     status = FetchPath( newPath, create, accessType, outPath );
-    free( newPath );
+    TRFree( newPath );
 
     return status;
+}
+
+void
+FreePath(
+    IN TRPath *pathObject
+) {
+    if ( !pathObject )
+        return;
+
+    if ( pathObject->FileHandle )
+        fclose( pathObject->FileHandle );
+
+    TRFree( pathObject->Location );
+    TRFree( pathObject->Name );
+    TRFree( pathObject );
 }
\ No newline at end of file
@@ -29,6 +29,8 @@
 
 #include <UI/Representation.h>
 #include <UI/GTK/GTK.h>
+#include <Core/Instrumentation/Zones.h>
+#include <Core/Instrumentation/StartupBenchmark.h>
 
 static struct gtk_object *impl_from_GTKObject( GTKObject *iface )
 {
@@ -37,37 +39,51 @@ static struct gtk_object *impl_from_GTKObject( GTKObject *iface )
 
 static void ActivationCallback( GtkApplication *app, void *user_data )
 {
-    GSList *snapshot = nullptr;
-    GSList *handlerList;
-    SignalHandler *handler;
-
     struct gtk_object *impl = impl_from_GTKObject( (GTKObject *)user_data );
 
+    TR_ZONE( "GTK::Activation" );
+
     TRACE( "app %p, user_data %p\n", app, user_data );
 
-    g_mutex_lock( &impl->OnActivation_mutex );
-    if ( impl->OnActivation_events )
-        snapshot = g_slist_copy( impl->OnActivation_events );
-    g_mutex_unlock( &impl->OnActivation_mutex );
+    StartupMark( "gtk-activate" );
 
-    for ( handlerList = snapshot; handlerList; handlerList = g_slist_next( handlerList ) )
-    {
-        handler = (SignalHandler *)handlerList->data;
-        // guard against being null
-        if ( handler && handler->callback )
-        {
-            // The object's app is now in an activated context
-            impl->isInActivationThread = true;
-            handler->callback( (UnknownObject *)user_data, handler->user_data );
-            // The object's app exited the context
-            impl->isInActivationThread = false;
-        }
-    }
+    // The object's app is in an activated context while the handlers run
+    impl->isInActivationThread = true;
+    SignalEventEmit( &impl->OnActivation_event, (UnknownObject *)user_data );
+    impl->isInActivationThread = false;
+}
+
+DEFINE_SLAB_CACHE( gtk_object, MEMORY_TAG_OBJECT );
 
-    g_slist_free( snapshot );
+DEFINE_INTERFACE_TABLE( gtk_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_object, GTKObject_iface ),
+    INTERFACE_ENTRY( GTKObject, gtk_object, GTKObject_iface ) );
+
+static TR_STATUS gtk_object_QueryInterface( GTKObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_object_interfaces, impl_from_GTKObject( iface ), uuid, out );
 }
 
-DEFINE_SHALLOW_UNKNOWNOBJECT( GTKObject, gtk_object )
+static TRLong gtk_object_AddRef( GTKObject *iface )
+{
+    struct gtk_object *impl = impl_from_GTKObject( iface );
+    const TRLong added = atomic_fetch_add( &impl->ref, 1 ) + 1;
+    TRACE( "iface %p increasing ref count to %ld\n", iface, added );
+    return added;
+}
+
+static TRLong gtk_object_Release( GTKObject *iface )
+{
+    struct gtk_object *impl = impl_from_GTKObject( iface );
+    const ATOMIC(TRLong) removed = atomic_fetch_sub( &impl->ref, 1 );
+    TRACE( "iface %p decreasing ref count to %ld\n", iface, removed - 1 );
+    if ( !(removed - 1) )
+    {
+        SignalEventClear( &impl->OnActivation_event );
+        SlabFree( &gtk_object_cache, impl );
+    }
+    return removed;
+}
 
 TR_STATUS gtk_object_CreateWindow( GTKObject *iface, GTKWindowObject **out )
 {
@@ -99,71 +115,33 @@ static TR_STATUS gtk_object_RunApplication( GTKObject *iface )
     return g_application_run( G_APPLICATION( impl->app ), 0, nullptr );
 }
 
-static TR_STATUS gtk_object_eventadd_OnActivation( GTKObject *iface, SignalCallback callback, void *context, TRULong *token )
+static TR_STATUS gtk_object_Quit( GTKObject *iface )
 {
-    SignalHandler *handler;
-    TRULong randomNum = RANDOM();
-
-    struct gtk_object *impl = impl_from_GTKObject( iface );
-
-    TRACE( "iface %p, callback %p, context %p, token %p\n", iface, callback, context, token );
+    const struct gtk_object *impl = impl_from_GTKObject( iface );
 
-    g_mutex_lock( &impl->OnActivation_mutex );
-    handler = g_new0( SignalHandler, 1 );
-    if ( !handler )
-    {
-        g_mutex_unlock( &impl->OnActivation_mutex );
-        return T_OUTOFMEMORY;
-    }
-    handler->callback = callback;
-    handler->id = randomNum * randomNum % 9000000000000000ULL + 1000000000000000ULL;
-    handler->user_data = context;
-    impl->OnActivation_events = g_slist_prepend( impl->OnActivation_events, handler );
-    if ( !impl->OnActivation_events )
-    {
-        g_mutex_unlock( &impl->OnActivation_mutex );
-        g_free( handler );
-        return T_OUTOFMEMORY;
-    }
-    g_mutex_unlock( &impl->OnActivation_mutex );
+    TRACE( "iface %p\n", iface );
 
-    *token = handler->id;
+    g_application_quit( G_APPLICATION( impl->app ) );
 
     return T_SUCCESS;
 }
 
-static TR_STATUS gtk_object_eventremove_OnActivation( GTKObject *iface, TRULong token )
+static TR_STATUS gtk_object_eventadd_OnActivation( GTKObject *iface, SignalCallback callback, void *context, SignalDestroyNotify destroy, TRULong *token )
 {
-    GSList *handlerList;
-    SignalHandler *found = nullptr;
-    SignalHandler *current;
-
     struct gtk_object *impl = impl_from_GTKObject( iface );
 
-    TRACE( "iface %p, token %ld\n", iface, token );
+    TRACE( "iface %p, callback %p, context %p, token %p\n", iface, callback, context, token );
 
-    g_mutex_lock( &impl->OnActivation_mutex );
-    for ( handlerList = impl->OnActivation_events; handlerList; handlerList = g_slist_next( handlerList ) )
-    {
-        current = (SignalHandler *)handlerList->data;
-        if ( current->id == token )
-        {
-            found = current;
-            break;
-        }
-    }
-    if ( !found )
-    {
-        g_mutex_unlock( &impl->OnActivation_mutex );
-        return T_NOINIT;
-    }
+    return SignalEventAdd( &impl->OnActivation_event, callback, context, destroy, token );
+}
 
-    impl->OnActivation_events = g_slist_remove( impl->OnActivation_events, found );
-    g_mutex_unlock( &impl->OnActivation_mutex );
+static TR_STATUS gtk_object_eventremove_OnActivation( GTKObject *iface, TRULong token )
+{
+    struct gtk_object *impl = impl_from_GTKObject( iface );
 
-    g_free( found );
+    TRACE( "iface %p, token %ld\n", iface, token );
 
-    return T_SUCCESS;
+    return SignalEventRemove( &impl->OnActivation_event, token );
 }
 
 static void gtk_object_CurrentPlatform( GTKObject *iface, Platform *out )
@@ -217,6 +195,7 @@ static GTKInterface gtk_interface =
     gtk_object_CreateWindow,
     gtk_object_RunApplication,
     gtk_object_CurrentPlatform,
+    gtk_object_Quit,
     gtk_object_eventadd_OnActivation,
     gtk_object_eventremove_OnActivation
 };
@@ -228,16 +207,17 @@ TR_STATUS TR_API new_gtk_object( IN TRCString appName, OUT GTKObject **out )
     TRACE( "appName %s, out %p\n", appName, out );
 
     gtk_init();
+    StartupMark( "gtk-init" );
 
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_object_cache ))) return T_OUTOFMEMORY;
 
     impl->GTKObject_iface.lpVtbl = &gtk_interface;
     impl->app = gtk_application_new( appName, G_APPLICATION_DEFAULT_FLAGS );
     atomic_init( &impl->ref, 1 );
-    g_mutex_init( &impl->OnActivation_mutex );
+    SignalEventInit( &impl->OnActivation_event );
 
     *out = &impl->GTKObject_iface;
 
@@ -32,33 +32,16 @@ static struct gtk_box_object *impl_from_GTKBoxObject( GTKBoxObject *iface )
     return CONTAINING_RECORD( iface, struct gtk_box_object, GTKBoxObject_iface );
 }
 
-static TR_STATUS gtk_box_object_QueryInterface( GTKBoxObject *iface, const TRUUID uuid, void **out )
-{
-    const struct gtk_box_object *impl = impl_from_GTKBoxObject( iface );
-
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
-
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKBoxObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_SLAB_CACHE( gtk_box_object, MEMORY_TAG_OBJECT );
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
-    {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKBoxObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( gtk_box_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_box_object, GTKBoxObject_iface ),
+    INTERFACE_ENTRY( GTKBoxObject, gtk_box_object, GTKBoxObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_box_object, GTKWidgetObject_impl ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS gtk_box_object_QueryInterface( GTKBoxObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_box_object_interfaces, impl_from_GTKBoxObject( iface ), uuid, out );
 }
 
 static TRLong gtk_box_object_AddRef( GTKBoxObject *iface )
@@ -78,7 +61,7 @@ static TRLong gtk_box_object_Release( GTKBoxObject *iface )
     {
         if ( impl->GTKWidgetObject_impl )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
-        free( impl );
+        SlabFree( &gtk_box_object_cache, impl );
     }
     return removed;
 }
@@ -127,7 +110,7 @@ TR_STATUS TR_API new_gtk_box_object_override_orientation_and_spacing( IN GtkOrie
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_box_object_cache ))) return T_OUTOFMEMORY;
     impl->GTKBoxObject_iface.lpVtbl = &gtk_box_interface;
     impl->ref = 1;
 
@@ -32,33 +32,16 @@ static struct gtk_drawing_area_object *impl_from_GTKDrawingAreaObject( GTKDrawin
     return CONTAINING_RECORD( iface, struct gtk_drawing_area_object, GTKDrawingAreaObject_iface );
 }
 
-static TR_STATUS gtk_drawing_area_object_QueryInterface( GTKDrawingAreaObject *iface, const TRUUID uuid, void **out )
-{
-    const struct gtk_drawing_area_object *impl = impl_from_GTKDrawingAreaObject( iface );
-
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
-
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKDrawingAreaObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_SLAB_CACHE( gtk_drawing_area_object, MEMORY_TAG_OBJECT );
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
-    {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKDrawingAreaObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( gtk_drawing_area_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_drawing_area_object, GTKDrawingAreaObject_iface ),
+    INTERFACE_ENTRY( GTKDrawingAreaObject, gtk_drawing_area_object, GTKDrawingAreaObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_drawing_area_object, GTKWidgetObject_impl ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS gtk_drawing_area_object_QueryInterface( GTKDrawingAreaObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_drawing_area_object_interfaces, impl_from_GTKDrawingAreaObject( iface ), uuid, out );
 }
 
 static TRLong gtk_drawing_area_object_AddRef( GTKDrawingAreaObject *iface )
@@ -78,7 +61,7 @@ static TRLong gtk_drawing_area_object_Release( GTKDrawingAreaObject *iface )
     {
         if ( impl->GTKWidgetObject_impl )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
-        free( impl );
+        SlabFree( &gtk_drawing_area_object_cache, impl );
     }
     return removed;
 }
@@ -102,7 +85,7 @@ TR_STATUS TR_API new_gtk_drawing_area_object( OUT GTKDrawingAreaObject **out )
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_drawing_area_object_cache ))) return T_OUTOFMEMORY;
     impl->GTKDrawingAreaObject_iface.lpVtbl = &gtk_drawing_area_interface;
     impl->ref = 1;
 
@@ -32,33 +32,16 @@ static struct gtk_label_object *impl_from_GTKLabelObject( GTKLabelObject *iface
     return CONTAINING_RECORD( iface, struct gtk_label_object, GTKLabelObject_iface );
 }
 
-static TR_STATUS gtk_label_object_QueryInterface( GTKLabelObject *iface, const TRUUID uuid, void **out )
-{
-    const struct gtk_label_object *impl = impl_from_GTKLabelObject( iface );
-
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
-
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKLabelObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_SLAB_CACHE( gtk_label_object, MEMORY_TAG_OBJECT );
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
-    {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKLabelObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( gtk_label_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_label_object, GTKLabelObject_iface ),
+    INTERFACE_ENTRY( GTKLabelObject, gtk_label_object, GTKLabelObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_label_object, GTKWidgetObject_impl ) );
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS gtk_label_object_QueryInterface( GTKLabelObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_label_object_interfaces, impl_from_GTKLabelObject( iface ), uuid, out );
 }
 
 static TRLong gtk_label_object_AddRef( GTKLabelObject *iface )
@@ -78,7 +61,7 @@ static TRLong gtk_label_object_Release( GTKLabelObject *iface )
     {
         if ( impl->GTKWidgetObject_impl )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
-        free( impl );
+        SlabFree( &gtk_label_object_cache, impl );
     }
     return removed;
 }
@@ -103,7 +86,7 @@ TR_STATUS TR_API new_gtk_label_object_override_text( IN TRCString text, OUT GTKL
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_label_object_cache ))) return T_OUTOFMEMORY;
     impl->GTKLabelObject_iface.lpVtbl = &gtk_picture_interface;
     impl->ref = 1;
 
@@ -32,33 +32,16 @@ static struct gtk_overlay_object *impl_from_GTKOverlayObject( GTKOverlayObject *
     return CONTAINING_RECORD( iface, struct gtk_overlay_object, GTKOverlayObject_iface );
 }
 
-static TR_STATUS gtk_overlay_object_QueryInterface( GTKOverlayObject *iface, const TRUUID uuid, void **out )
-{
-    const struct gtk_overlay_object *impl = impl_from_GTKOverlayObject( iface );
-
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+DEFINE_SLAB_CACHE( gtk_overlay_object, MEMORY_TAG_OBJECT );
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKOverlayObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( gtk_overlay_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_overlay_object, GTKOverlayObject_iface ),
+    INTERFACE_ENTRY( GTKOverlayObject, gtk_overlay_object, GTKOverlayObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_overlay_object, GTKWidgetObject_impl ) );
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
-    {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKOverlayObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
-    }
-
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS gtk_overlay_object_QueryInterface( GTKOverlayObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_overlay_object_interfaces, impl_from_GTKOverlayObject( iface ), uuid, out );
 }
 
 static TRLong gtk_overlay_object_AddRef( GTKOverlayObject *iface )
@@ -80,7 +63,7 @@ static TRLong gtk_overlay_object_Release( GTKOverlayObject *iface )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
         if ( impl->ChildWidget )
             impl->ChildWidget->lpVtbl->Release( impl->ChildWidget );
-        free( impl );
+        SlabFree( &gtk_overlay_object_cache, impl );
     }
     return removed;
 }
@@ -194,7 +177,7 @@ TR_STATUS TR_API new_gtk_overlay_object( OUT GTKOverlayObject **out )
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_overlay_object_cache ))) return T_OUTOFMEMORY;
     impl->GTKOverlayObject_iface.lpVtbl = &gtk_overlay_interface;
     impl->ref = 1;
 
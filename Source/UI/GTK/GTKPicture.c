@@ -26,39 +26,82 @@
  */
 
 #include <UI/GTK/GTKPicture.h>
+#include <Core/Instrumentation/Zones.h>
+#include <Core/Memory/Memory.h>
 
 static struct gtk_picture_object *impl_from_GTKPictureObject( GTKPictureObject *iface )
 {
     return CONTAINING_RECORD( iface, struct gtk_picture_object, GTKPictureObject_iface );
 }
 
-static TR_STATUS gtk_picture_object_QueryInterface( GTKPictureObject *iface, const TRUUID uuid, void **out )
+DEFINE_SLAB_CACHE( gtk_picture_object, MEMORY_TAG_OBJECT );
+
+// Copies the decoded pixels into memory charged to MEMORY_TAG_TEXTURE, so pictures show up in the memory report.
+static GdkTexture *ChargeTexture( GdkTexture *decoded )
 {
-    const struct gtk_picture_object *impl = impl_from_GTKPictureObject( iface );
+    const TRSize width = gdk_texture_get_width( decoded ), height = gdk_texture_get_height( decoded );
+    const TRSize stride = width * 4;
+    GdkTexture *texture;
+    GBytes *bytes;
+    guchar *pixels;
+
+    if (!(pixels = TRAlloc( stride * height, MEMORY_TAG_TEXTURE ))) return g_object_ref( decoded );
+
+    gdk_texture_download( decoded, pixels, stride );
+    bytes = g_bytes_new_with_free_func( pixels, stride * height, TRFree, pixels );
+    texture = gdk_memory_texture_new( (int)width, (int)height, GDK_MEMORY_DEFAULT, bytes, stride );
+    g_bytes_unref( bytes );
+
+    return texture;
+}
 
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+static void DecodeTexture( GTask *task, void *source, void *path, GCancellable *cancellable )
+{
+    GFile *file;
+    GdkTexture *decoded, *texture;
+    GError *error = nullptr;
+
+    TR_ZONE( "GTKPicture::DecodeTexture" );
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKPictureObject ) )
+    file = g_file_new_for_path( path );
+    decoded = gdk_texture_new_from_file( file, &error );
+    g_object_unref( file );
+
+    if ( !decoded )
     {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
+        g_task_return_error( task, error );
+        return;
     }
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
+    texture = ChargeTexture( decoded );
+    g_object_unref( decoded );
+    g_task_return_pointer( task, texture, g_object_unref );
+}
+
+static void TextureDecoded( GObject *picture, GAsyncResult *result, void *user_data )
+{
+    GdkTexture *texture;
+    GError *error = nullptr;
+
+    if (!(texture = g_task_propagate_pointer( G_TASK( result ), &error )))
     {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKPictureObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
+        ERROR( "Could not decode %s: %s\n", (TRCString)g_task_get_task_data( G_TASK( result ) ), error->message );
+        g_error_free( error );
+        return;
     }
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+    gtk_picture_set_paintable( GTK_PICTURE( picture ), GDK_PAINTABLE( texture ) );
+    g_object_unref( texture );
+}
+
+DEFINE_INTERFACE_TABLE( gtk_picture_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_picture_object, GTKPictureObject_iface ),
+    INTERFACE_ENTRY( GTKPictureObject, gtk_picture_object, GTKPictureObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_picture_object, GTKWidgetObject_impl ) );
+
+static TR_STATUS gtk_picture_object_QueryInterface( GTKPictureObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_picture_object_interfaces, impl_from_GTKPictureObject( iface ), uuid, out );
 }
 
 static TRLong gtk_picture_object_AddRef( GTKPictureObject *iface )
@@ -78,33 +121,20 @@ static TRLong gtk_picture_object_Release( GTKPictureObject *iface )
     {
         if ( impl->GTKWidgetObject_impl )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
-        free( impl );
+        SlabFree( &gtk_picture_object_cache, impl );
     }
     return removed;
 }
 
 static TR_STATUS gtk_picture_object_GetPictureRect( GTKPictureObject *iface, GdkRectangle *out )
 {
-    TR_STATUS status;
-    GtkWidget *pictureWidget;
-    GdkPaintable *paintable;
-    GTKWidgetObject *widget;
+    const struct gtk_picture_object *impl = impl_from_GTKPictureObject( iface );
 
     TRACE( "iface %p, out %p\n", iface, out );
 
     if ( !out ) throw_NullPtrException();
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_GTKWidgetObject, (void **)&widget );
-    if ( FAILED( status ) ) return status;
-
-    status = widget->lpVtbl->get_Widget( widget, &pictureWidget );
-    if ( FAILED( status ) ) return status;
-
-    paintable = gtk_picture_get_paintable( GTK_PICTURE( pictureWidget ) );
-    out->width = gdk_paintable_get_intrinsic_width( paintable );
-    out->height = gdk_paintable_get_intrinsic_height( paintable );
-
-    widget->lpVtbl->Release( widget );
+    *out = impl->PictureRect;
 
     return T_SUCCESS;
 }
@@ -123,7 +153,7 @@ TR_STATUS TR_API new_gtk_picture_object_override_path( IN TRPath *imagePath, OUT
 {
     TR_STATUS status;
     GtkWidget *picture;
-    GdkTexture *texture;
+    GTask *task;
     struct gtk_picture_object *impl;
 
     TRACE( "out %p\n", out );
@@ -131,14 +161,22 @@ TR_STATUS TR_API new_gtk_picture_object_override_path( IN TRPath *imagePath, OUT
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_picture_object_cache ))) return T_OUTOFMEMORY;
     impl->GTKPictureObject_iface.lpVtbl = &gtk_picture_interface;
     impl->ref = 1;
 
-    texture = gdk_texture_new_from_file( g_file_new_for_path( imagePath->Location ), nullptr );
+    // Only the header is read here, the pixels are decoded off the main thread and show up once they are ready.
+    impl->PictureRect = (GdkRectangle){ 0 };
+    if ( !gdk_pixbuf_get_file_info( imagePath->Location, &impl->PictureRect.width, &impl->PictureRect.height ) )
+        WARN( "Could not read the size of %s\n", imagePath->Location );
 
-    picture = gtk_picture_new_for_paintable( GDK_PAINTABLE( texture ) );
-    g_object_unref( texture );
+    picture = gtk_picture_new();
+
+    // The task holds a reference to the picture until the texture is set.
+    task = g_task_new( picture, nullptr, TextureDecoded, nullptr );
+    g_task_set_task_data( task, g_strdup( imagePath->Location ), g_free );
+    g_task_run_in_thread( task, DecodeTexture );
+    g_object_unref( task );
 
     status = new_gtk_widget_object_override_widget( picture, &impl->GTKWidgetObject_impl );
     if ( FAILED( status ) ) return status;
@@ -32,33 +32,16 @@ static struct gtk_spinner_object *impl_from_GTKSpinnerObject( GTKSpinnerObject *
     return CONTAINING_RECORD( iface, struct gtk_spinner_object, GTKSpinnerObject_iface );
 }
 
-static TR_STATUS gtk_spinner_object_QueryInterface( GTKSpinnerObject *iface, const TRUUID uuid, void **out )
-{
-    const struct gtk_spinner_object *impl = impl_from_GTKSpinnerObject( iface );
+DEFINE_SLAB_CACHE( gtk_spinner_object, MEMORY_TAG_OBJECT );
 
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
-
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKSpinnerObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( gtk_spinner_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_spinner_object, GTKSpinnerObject_iface ),
+    INTERFACE_ENTRY( GTKSpinnerObject, gtk_spinner_object, GTKSpinnerObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_spinner_object, GTKWidgetObject_impl ) );
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
-    {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKSpinnerObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
-    }
-
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS gtk_spinner_object_QueryInterface( GTKSpinnerObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_spinner_object_interfaces, impl_from_GTKSpinnerObject( iface ), uuid, out );
 }
 
 static TRLong gtk_spinner_object_AddRef( GTKSpinnerObject *iface )
@@ -78,7 +61,7 @@ static TRLong gtk_spinner_object_Release( GTKSpinnerObject *iface )
     {
         if ( impl->GTKWidgetObject_impl )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
-        free( impl );
+        SlabFree( &gtk_spinner_object_cache, impl );
     }
     return removed;
 }
@@ -138,7 +121,7 @@ TR_STATUS TR_API new_gtk_spinner_object( OUT GTKSpinnerObject **out )
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_spinner_object_cache ))) return T_OUTOFMEMORY;
     impl->GTKSpinnerObject_iface.lpVtbl = &gtk_drawing_area_interface;
     impl->ref = 1;
 
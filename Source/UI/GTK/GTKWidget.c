@@ -101,7 +101,7 @@ TR_STATUS TR_API new_gtk_widget_object_override_widget( IN GtkWidget *widget, OU
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_widget_object_cache ))) return T_OUTOFMEMORY;
 
     impl->GTKWidgetObject_iface.lpVtbl = &gtk_widget_interface;
     impl->Widget = widget;
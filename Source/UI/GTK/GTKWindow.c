@@ -29,73 +29,92 @@
 
 #include <libadwaita-1/adwaita.h>
 
-static bool OnDelete_Registered = false;
-
 static struct gtk_window_object *impl_from_GTKWindowObject( GTKWindowObject *iface )
 {
     return CONTAINING_RECORD( iface, struct gtk_window_object, GTKWindowObject_iface );
 }
 
+DEFINE_SLAB_CACHE( gtk_window_object, MEMORY_TAG_OBJECT );
+
 static gboolean DeleteCallback( GtkWidget *widget, void *user_data )
 {
-    GSList *snapshot = nullptr;
-    GSList *handlerList;
-    SignalHandler *handler;
     auto const window = (GTKWindowObject *)user_data;
 
     struct gtk_window_object *impl = impl_from_GTKWindowObject( window );
 
-    if ( !OnDelete_Registered ) return false;
-
     TRACE( "widget %p, user_data %p\n", widget, user_data );
 
-    g_mutex_lock( &impl->OnDelete_mutex );
-    if ( impl->OnDelete_events )
-        snapshot = g_slist_copy( impl->OnDelete_events );
-    g_mutex_unlock( &impl->OnDelete_mutex );
+    SignalEventEmit( &impl->OnDelete_event, (UnknownObject *)window );
 
-    for ( handlerList = snapshot; handlerList; handlerList = g_slist_next( handlerList ) )
-    {
-        handler = (SignalHandler *)handlerList->data;
-        // guard against being null
-        if ( handler && handler->callback )
-        {
-            handler->callback( (UnknownObject *)window, handler->user_data );
-        }
-    }
+    return false;
+}
 
-    g_slist_free( snapshot );
+static gboolean ResizeTick( GtkWidget *widget, GdkFrameClock *clock, void *user_data )
+{
+    auto const window = (GTKWindowObject *)user_data;
 
-    return false;
+    struct gtk_window_object *impl = impl_from_GTKWindowObject( window );
+
+    SignalEventFlush( &impl->OnResize_event, (UnknownObject *)window );
+
+    return G_SOURCE_REMOVE;
 }
 
-static TR_STATUS gtk_window_object_QueryInterface( GTKWindowObject *iface, const TRUUID uuid, void **out )
+static void ReleaseTickWindow( void *user_data )
 {
-    const struct gtk_window_object *impl = impl_from_GTKWindowObject( iface );
+    auto const window = (GTKWindowObject *)user_data;
+    window->lpVtbl->Release( window );
+}
 
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+static gboolean FirstFrameTick( GtkWidget *widget, GdkFrameClock *clock, void *user_data )
+{
+    auto const window = (GTKWindowObject *)user_data;
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKWindowObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+    struct gtk_window_object *impl = impl_from_GTKWindowObject( window );
+
+    SignalEventEmit( &impl->OnFirstFrame_event, (UnknownObject *)window );
+
+    return G_SOURCE_REMOVE;
+}
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
+static void MapCallback( GtkWidget *widget, void *user_data )
+{
+    auto const window = (GTKWindowObject *)user_data;
+
+    // Only the first map has a first frame, later ones just show the window again.
+    g_signal_handlers_disconnect_by_func( widget, MapCallback, user_data );
+
+    window->lpVtbl->AddRef( window );
+    gtk_widget_add_tick_callback( widget, FirstFrameTick, window, ReleaseTickWindow );
+}
+
+static void SizeCallback( GObject *object, GParamSpec *pspec, void *user_data )
+{
+    auto const window = (GTKWindowObject *)user_data;
+    GdkRectangle rect;
+
+    struct gtk_window_object *impl = impl_from_GTKWindowObject( window );
+
+    rect = impl->WindowRect;
+    gtk_window_get_default_size( GTK_WINDOW( object ), &rect.width, &rect.height );
+    impl->WindowRect = rect;
+
+    // Every further change until the next frame only updates WindowRect.
+    if ( SignalEventPost( &impl->OnResize_event ) )
     {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKWindowObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
+        window->lpVtbl->AddRef( window );
+        gtk_widget_add_tick_callback( GTK_WIDGET( object ), ResizeTick, window, ReleaseTickWindow );
     }
+}
 
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+DEFINE_INTERFACE_TABLE( gtk_window_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_window_object, GTKWindowObject_iface ),
+    INTERFACE_ENTRY( GTKWindowObject, gtk_window_object, GTKWindowObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_window_object, GTKWidgetObject_impl ) );
+
+static TR_STATUS gtk_window_object_QueryInterface( GTKWindowObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_window_object_interfaces, impl_from_GTKWindowObject( iface ), uuid, out );
 }
 
 static TRLong gtk_window_object_AddRef( GTKWindowObject *iface )
@@ -117,7 +136,10 @@ static TRLong gtk_window_object_Release( GTKWindowObject *iface )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
         if ( impl->ChildWidget )
             impl->ChildWidget->lpVtbl->Release( impl->ChildWidget );
-        free( impl );
+        SignalEventClear( &impl->OnDelete_event );
+        SignalEventClear( &impl->OnResize_event );
+        SignalEventClear( &impl->OnFirstFrame_event );
+        SlabFree( &gtk_window_object_cache, impl );
     }
     return removed;
 }
@@ -267,91 +289,58 @@ static TR_STATUS gtk_window_object_Show( GTKWindowObject *iface )
     return status;
 }
 
-static TR_STATUS gtk_window_object_eventadd_OnDelete( GTKWindowObject *iface, SignalCallback callback, void *context, TRULong *token )
+static TR_STATUS gtk_window_object_eventadd_OnDelete( GTKWindowObject *iface, SignalCallback callback, void *context, SignalDestroyNotify destroy, TRULong *token )
 {
-    TR_STATUS status;
-    GtkWidget *window;
-    GTKWidgetObject *widgetObject;
-    SignalHandler *handler;
-    TRULong randomNum = RANDOM();
-
     struct gtk_window_object *impl = impl_from_GTKWindowObject( iface );
 
     TRACE( "iface %p, callback %p, context %p, token %p\n", iface, callback, context, token );
 
-    status = iface->lpVtbl->QueryInterface( iface, IID_GTKWidgetObject, (void**)&widgetObject );
-    if ( FAILED( status ) ) return status;
-
-    status = widgetObject->lpVtbl->get_Widget( widgetObject, &window );
-    if ( FAILED( status ) ) return status;
-
-    widgetObject->lpVtbl->Release( widgetObject );
+    return SignalEventAdd( &impl->OnDelete_event, callback, context, destroy, token );
+}
 
-    g_mutex_lock( &impl->OnDelete_mutex );
-    handler = g_new0( SignalHandler, 1 );
-    if ( !handler )
-    {
-        g_mutex_unlock( &impl->OnDelete_mutex );
-        return T_OUTOFMEMORY;
-    }
-    handler->callback = callback;
-    handler->id = randomNum * randomNum % 9000000000000000ULL + 1000000000000000ULL;
-    handler->user_data = context;
-    impl->OnDelete_events = g_slist_prepend( impl->OnDelete_events, handler );
+static TR_STATUS gtk_window_object_eventremove_OnDelete( GTKWindowObject *iface, TRULong token )
+{
+    struct gtk_window_object *impl = impl_from_GTKWindowObject( iface );
 
-    OnDelete_Registered = true;
+    TRACE( "iface %p, token %ld\n", iface, token );
 
-    if ( !impl->OnDelete_events )
-    {
-        g_mutex_unlock( &impl->OnDelete_mutex );
-        g_free( handler );
-        return T_OUTOFMEMORY;
-    }
-    g_mutex_unlock( &impl->OnDelete_mutex );
+    return SignalEventRemove( &impl->OnDelete_event, token );
+}
 
-    *token = handler->id;
+static TR_STATUS gtk_window_object_eventadd_OnResize( GTKWindowObject *iface, SignalCallback callback, void *context, SignalDestroyNotify destroy, TRULong *token )
+{
+    struct gtk_window_object *impl = impl_from_GTKWindowObject( iface );
 
-    TRACE( "added event with token id %llu\n", *token );
+    TRACE( "iface %p, callback %p, context %p, token %p\n", iface, callback, context, token );
 
-    return T_SUCCESS;
+    return SignalEventAdd( &impl->OnResize_event, callback, context, destroy, token );
 }
 
-static TR_STATUS gtk_window_object_eventremove_OnDelete( GTKWindowObject *iface, TRULong token )
+static TR_STATUS gtk_window_object_eventremove_OnResize( GTKWindowObject *iface, TRULong token )
 {
-    GSList *handlerList;
-    SignalHandler *found = nullptr;
-    SignalHandler *current;
-
     struct gtk_window_object *impl = impl_from_GTKWindowObject( iface );
 
     TRACE( "iface %p, token %ld\n", iface, token );
 
-    g_mutex_lock( &impl->OnDelete_mutex );
-    for ( handlerList = impl->OnDelete_events; handlerList; handlerList = g_slist_next( handlerList ) )
-    {
-        current = (SignalHandler *)handlerList->data;
-        if ( current->id == token )
-        {
-            found = current;
-            break;
-        }
-    }
-    if ( !found )
-    {
-        g_mutex_unlock( &impl->OnDelete_mutex );
-        return T_NOINIT;
-    }
+    return SignalEventRemove( &impl->OnResize_event, token );
+}
 
-    impl->OnDelete_events = g_slist_remove( impl->OnDelete_events, found );
+static TR_STATUS gtk_window_object_eventadd_OnFirstFrame( GTKWindowObject *iface, SignalCallback callback, void *context, SignalDestroyNotify destroy, TRULong *token )
+{
+    struct gtk_window_object *impl = impl_from_GTKWindowObject( iface );
+
+    TRACE( "iface %p, callback %p, context %p, token %p\n", iface, callback, context, token );
 
-    if ( !impl->OnDelete_events )
-        OnDelete_Registered = false;
+    return SignalEventAdd( &impl->OnFirstFrame_event, callback, context, destroy, token );
+}
 
-    g_mutex_unlock( &impl->OnDelete_mutex );
+static TR_STATUS gtk_window_object_eventremove_OnFirstFrame( GTKWindowObject *iface, TRULong token )
+{
+    struct gtk_window_object *impl = impl_from_GTKWindowObject( iface );
 
-    g_free( found );
+    TRACE( "iface %p, token %ld\n", iface, token );
 
-    return T_SUCCESS;
+    return SignalEventRemove( &impl->OnFirstFrame_event, token );
 }
 
 static GTKWindowInterface gtk_window_interface =
@@ -370,7 +359,11 @@ static GTKWindowInterface gtk_window_interface =
     gtk_window_object_SetResizable,
     gtk_window_object_Show,
     gtk_window_object_eventadd_OnDelete,
-    gtk_window_object_eventremove_OnDelete
+    gtk_window_object_eventremove_OnDelete,
+    gtk_window_object_eventadd_OnResize,
+    gtk_window_object_eventremove_OnResize,
+    gtk_window_object_eventadd_OnFirstFrame,
+    gtk_window_object_eventremove_OnFirstFrame
 };
 
 TR_STATUS TR_API new_gtk_window_object( IN GtkApplication *app, OUT GTKWindowObject **out )
@@ -385,12 +378,13 @@ TR_STATUS TR_API new_gtk_window_object( IN GtkApplication *app, OUT GTKWindowObj
     if ( !out || !app ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_window_object_cache ))) return T_OUTOFMEMORY;
 
     impl->GTKWindowObject_iface.lpVtbl = &gtk_window_interface;
-    impl->OnDelete_events = nullptr; // <-- TODO: OnDelete_events gets mutated here. Find the cause.
     impl->Representation.windowType = WindowType_GTK;
-    g_mutex_init( &impl->OnDelete_mutex );
+    SignalEventInit( &impl->OnDelete_event );
+    SignalEventInit( &impl->OnResize_event );
+    SignalEventInit( &impl->OnFirstFrame_event );
     atomic_init( &impl->ref, 1 );
 
     window = adw_window_new();
@@ -437,6 +431,9 @@ TR_STATUS TR_API new_gtk_window_object( IN GtkApplication *app, OUT GTKWindowObj
     *out = &impl->GTKWindowObject_iface;
 
     g_signal_connect( window, "close-request", G_CALLBACK( DeleteCallback ), *out );
+    g_signal_connect( window, "notify::default-width", G_CALLBACK( SizeCallback ), *out );
+    g_signal_connect( window, "notify::default-height", G_CALLBACK( SizeCallback ), *out );
+    g_signal_connect( window, "map", G_CALLBACK( MapCallback ), *out );
 
     TRACE( "created GTKWindowObject %p\n", *out );
 
@@ -32,33 +32,16 @@ static struct gtk_window_handle_object *impl_from_GTKWindowHandleObject( GTKWind
     return CONTAINING_RECORD( iface, struct gtk_window_handle_object, GTKWindowHandleObject_iface );
 }
 
-static TR_STATUS gtk_window_handle_object_QueryInterface( GTKWindowHandleObject *iface, const TRUUID uuid, void **out )
-{
-    const struct gtk_window_handle_object *impl = impl_from_GTKWindowHandleObject( iface );
-
-    TRACE( "iface %p, uuid %s, out %p\n", iface, debugstr_uuid( uuid ), out );
+DEFINE_SLAB_CACHE( gtk_window_handle_object, MEMORY_TAG_OBJECT );
 
-    if ( !uuid_compare( uuid, IID_UnknownObject ) || !uuid_compare( uuid, IID_GTKWindowHandleObject ) )
-    {
-        iface->lpVtbl->AddRef( iface );
-        *out = iface;
-        return T_SUCCESS;
-    }
+DEFINE_INTERFACE_TABLE( gtk_window_handle_object,
+    INTERFACE_ENTRY( UnknownObject, gtk_window_handle_object, GTKWindowHandleObject_iface ),
+    INTERFACE_ENTRY( GTKWindowHandleObject, gtk_window_handle_object, GTKWindowHandleObject_iface ),
+    INTERFACE_ENTRY_MEMBER( GTKWidgetObject, gtk_window_handle_object, GTKWidgetObject_impl ) );
 
-    if ( !uuid_compare( uuid, IID_GTKWidgetObject ) )
-    {
-        if ( !impl->GTKWidgetObject_impl )
-        {
-            ERROR( "Subclass GTKWidgetObject for GTKWindowObject %p is not initialized yet!\n", iface );
-            return T_NOINIT;
-        }
-        impl->GTKWidgetObject_impl->lpVtbl->AddRef( impl->GTKWidgetObject_impl );
-        *out = impl->GTKWidgetObject_impl;
-        return T_SUCCESS;
-    }
-
-    ERROR( "uuid %s is not implemented! returning T_NOTIMPL\n", debugstr_uuid( uuid ) );
-    return T_NOTIMPL;
+static TR_STATUS gtk_window_handle_object_QueryInterface( GTKWindowHandleObject *iface, const TRUUID uuid, void **out )
+{
+    return QueryInterfaceFromTable( &gtk_window_handle_object_interfaces, impl_from_GTKWindowHandleObject( iface ), uuid, out );
 }
 
 static TRLong gtk_window_handle_object_AddRef( GTKWindowHandleObject *iface )
@@ -80,7 +63,7 @@ static TRLong gtk_window_handle_object_Release( GTKWindowHandleObject *iface )
             impl->GTKWidgetObject_impl->lpVtbl->Release( impl->GTKWidgetObject_impl );
         if ( impl->ChildWidget )
             impl->ChildWidget->lpVtbl->Release( impl->ChildWidget );
-        free( impl );
+        SlabFree( &gtk_window_handle_object_cache, impl );
     }
     return removed;
 }
@@ -157,7 +140,7 @@ TR_STATUS TR_API new_gtk_window_handle_object( OUT GTKWindowHandleObject **out )
     if ( !out ) throw_NullPtrException();
 
     // Freed in Release();
-    if (!(impl = calloc( 1, sizeof(*impl) ))) return T_OUTOFMEMORY;
+    if (!(impl = SlabAlloc( &gtk_window_handle_object_cache ))) return T_OUTOFMEMORY;
     impl->GTKWindowHandleObject_iface.lpVtbl = &gtk_drawing_area_interface;
     impl->ref = 1;
 
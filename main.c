@@ -29,15 +29,44 @@
 
 #include <IO/Arguments.h>
 #include <IO/Logging.h>
+#include <Core/Instrumentation/Zones.h>
+#include <Core/Instrumentation/PerfCounters.h>
+#include <Core/Instrumentation/StartupBenchmark.h>
+#include <Core/Memory/Memory.h>
+#include <ObjectRegistry.h>
 #include <Application/Application.h>
+#include <Application/RecordingBenchmark.h>
+#include <Application/RenderBenchmark.h>
 
 int main( const int argc, char **argv )
 {
     TR_STATUS status;
+    StartupMark( "main" );
     status = ParseCommandLineArguments( argc, argv );
     if ( FAILED( status ) ) return status;
+    StartupMark( "arguments" );
     status = InitializeLogging();
     if ( FAILED( status ) ) return status;
+    StartupMark( "logging" );
+
+    // Everything below registers its exit report with atexit(). Handlers run in reverse order,
+    // so the reports come out before ShutdownLogging() closes the log sink.
+    status = InitializeMemoryAccounting();
+    if ( FAILED( status ) ) return status;
+    status = InitializeObjectRegistry();
+    if ( FAILED( status ) ) return status;
+    status = InitializeZones( GlobalArgumentsDefault.TraceOut );
+    if ( FAILED( status ) ) return status;
+    status = InitializePerfCounters( GlobalArgumentsDefault.PerfCounters );
+    if ( FAILED( status ) ) return status;
+    status = InitializeStartupBenchmark( GlobalArgumentsDefault.BenchmarkStartup );
+    if ( FAILED( status ) ) return status;
+
+    // Headless, the window never opens.
+    if ( GlobalArgumentsDefault.BenchmarkRender )
+        return RunRenderBenchmark( GlobalArgumentsDefault.BenchmarkRender );
+    if ( GlobalArgumentsDefault.BenchmarkRecording )
+        return RunRecordingBenchmark( GlobalArgumentsDefault.BenchmarkRecording );
 
     return InitApplication();
 }